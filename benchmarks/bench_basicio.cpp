@@ -0,0 +1,134 @@
+// Benchmarks of the BasicIo backends
+#include "benchmarks.hpp"
+
+#include <basicio.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+using namespace Exiv2;
+
+namespace
+{
+    const char* const largeFile = "ReaganLargeTiff.tiff";
+
+    //! Read the file in chunks of state.range(0) bytes
+    void BM_FileIoRead(benchmark::State& state)
+    {
+        FileIo io(Bench::testFile(largeFile));
+        Bench::Bytes buf(static_cast<size_t>(state.range(0)));
+        for (auto _ : state) {
+            io.open();
+            while (io.read(&buf[0], buf.size()) > 0) {}
+            io.close();
+        }
+        Bench::setBytesProcessed(state, io.size());
+    }
+
+    void BM_FileIoGetb(benchmark::State& state)
+    {
+        FileIo io(Bench::testFile(largeFile));
+        io.open();
+        const size_t size = std::min<size_t>(io.size(), 64 * 1024);
+        for (auto _ : state) {
+            io.seek(0, BasicIo::beg);
+            int sum = 0;
+            for (size_t i = 0; i < size; ++i) sum += io.getb();
+            benchmark::DoNotOptimize(sum);
+        }
+        Bench::setBytesProcessed(state, size);
+    }
+
+    void BM_FileIoMmap(benchmark::State& state)
+    {
+        FileIo io(Bench::testFile(largeFile));
+        io.open();
+        for (auto _ : state) {
+            const byte* data = io.mmap();
+            benchmark::DoNotOptimize(data[io.size() - 1]);
+            io.munmap();
+        }
+    }
+
+    //! Write the file in chunks of state.range(0) bytes to a temporary file
+    void BM_FileIoWrite(benchmark::State& state)
+    {
+        const Bench::Bytes data = Bench::readTestFile(largeFile);
+        const size_t chunk = static_cast<size_t>(state.range(0));
+        FileIo io("exiv2-benchmark.tmp");
+        for (auto _ : state) {
+            io.open("w+b");
+            for (size_t i = 0; i < data.size(); i += chunk) {
+                io.write(&data[i], std::min(chunk, data.size() - i));
+            }
+            io.close();
+        }
+        std::remove(io.path().c_str());
+        Bench::setBytesProcessed(state, data.size());
+    }
+
+    //! Write the file in chunks of state.range(0) bytes to memory
+    void BM_MemIoWrite(benchmark::State& state)
+    {
+        const Bench::Bytes data = Bench::readTestFile(largeFile);
+        const size_t chunk = static_cast<size_t>(state.range(0));
+        for (auto _ : state) {
+            MemIo io;
+            for (size_t i = 0; i < data.size(); i += chunk) {
+                io.write(&data[i], std::min(chunk, data.size() - i));
+            }
+            benchmark::DoNotOptimize(io.size());
+        }
+        Bench::setBytesProcessed(state, data.size());
+    }
+
+    void BM_MemIoRead(benchmark::State& state)
+    {
+        const Bench::Bytes data = Bench::readTestFile(largeFile);
+        MemIo io(&data[0], data.size());
+        Bench::Bytes buf(static_cast<size_t>(state.range(0)));
+        for (auto _ : state) {
+            io.seek(0, BasicIo::beg);
+            while (io.read(&buf[0], buf.size()) > 0) {}
+        }
+        Bench::setBytesProcessed(state, data.size());
+    }
+
+    //! Transfer a memory buffer to memory and to a file, like writeMetadata does
+    void BM_MemIoTransfer(benchmark::State& state)
+    {
+        const Bench::Bytes data = Bench::readTestFile(largeFile);
+        MemIo target;
+        for (auto _ : state) {
+            MemIo src;
+            src.write(&data[0], data.size());
+            target.transfer(src);
+            benchmark::DoNotOptimize(target.size());
+        }
+        Bench::setBytesProcessed(state, data.size());
+    }
+
+    void BM_FileIoTransfer(benchmark::State& state)
+    {
+        const Bench::Bytes data = Bench::readTestFile(largeFile);
+        FileIo target("exiv2-benchmark.tmp");
+        for (auto _ : state) {
+            MemIo src;
+            src.write(&data[0], data.size());
+            target.transfer(src);
+            benchmark::DoNotOptimize(target.size());
+        }
+        std::remove(target.path().c_str());
+        Bench::setBytesProcessed(state, data.size());
+    }
+}
+
+BENCHMARK(BM_FileIoRead)->Arg(4096)->Arg(64 * 1024);
+BENCHMARK(BM_FileIoGetb);
+BENCHMARK(BM_FileIoMmap);
+BENCHMARK(BM_FileIoWrite)->Arg(4096)->Arg(64 * 1024);
+BENCHMARK(BM_MemIoWrite)->Arg(16)->Arg(4096);
+BENCHMARK(BM_MemIoRead)->Arg(4096);
+BENCHMARK(BM_MemIoTransfer);
+BENCHMARK(BM_FileIoTransfer);
@@ -0,0 +1,246 @@
+// Benchmarks of the image formats: type detection, reading, writing and printing the structure
+#include "benchmarks.hpp"
+
+#include <exif.hpp>
+#include <image.hpp>
+#include <tiffimage.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace Exiv2;
+
+namespace
+{
+    void put16(Bench::Bytes& buf, uint16_t v)
+    {
+        for (int i = 0; i < 2; ++i) buf.push_back(static_cast<byte>(v >> (8 * i)));
+    }
+
+    void put64(Bench::Bytes& buf, uint64_t v)
+    {
+        for (int i = 0; i < 8; ++i) buf.push_back(static_cast<byte>(v >> (8 * i)));
+    }
+
+    //! Little endian BigTIFF header and IFD0 of \em entries ASCII tags, with their 16 byte values at \em values
+    Bench::Bytes bigTiffIfd(uint16_t entries, uint64_t values)
+    {
+        Bench::Bytes buf = {'I', 'I', 0x2b, 0x00, 0x08, 0x00, 0x00, 0x00};
+        put64(buf, 16);
+        put64(buf, entries);
+        for (uint16_t i = 0; i < entries; ++i) {
+            put16(buf, static_cast<uint16_t>(0xc000 + i));
+            put16(buf, 2);
+            put64(buf, 16);
+            put64(buf, values + 16 * i);
+        }
+        put64(buf, 0);
+        return buf;
+    }
+
+    //! The values of the tags of bigTiffIfd()
+    Bench::Bytes bigTiffValues(uint16_t entries)
+    {
+        Bench::Bytes buf;
+        for (uint16_t i = 0; i < entries; ++i) {
+            const char value[16] = "BigTIFF value";
+            buf.insert(buf.end(), value, value + 16);
+        }
+        return buf;
+    }
+
+    //! Little endian BigTIFF with an IFD0 of \em entries ASCII tags, each with a 16 byte value
+    Bench::Bytes bigTiff(uint16_t entries)
+    {
+        Bench::Bytes buf = bigTiffIfd(entries, 16 + 8 + 20 * entries + 8);
+        const Bench::Bytes values = bigTiffValues(entries);
+        buf.insert(buf.end(), values.begin(), values.end());
+        return buf;
+    }
+
+    /*!
+      @brief A sparse BigTIFF file of 5 GB, with IFD0 at the start and the
+             values of its 256 tags at the end. Written when it is first used
+             and removed when the program ends.
+     */
+    class SparseBigTiff {
+    public:
+        static const uint16_t entries = 256;
+
+        SparseBigTiff() : path_("exiv2-benchmark-bigtiff-5gb.tif")
+        {
+            const uint64_t values = 5ULL << 30;
+            std::ofstream file(path_.c_str(), std::ios::binary);
+            const Bench::Bytes ifd = bigTiffIfd(entries, values);
+            file.write(reinterpret_cast<const char*>(&ifd[0]), static_cast<std::streamsize>(ifd.size()));
+            file.seekp(static_cast<std::streamoff>(values));
+            const Bench::Bytes data = bigTiffValues(entries);
+            file.write(reinterpret_cast<const char*>(&data[0]), static_cast<std::streamsize>(data.size()));
+            good_ = file.good();
+        }
+        ~SparseBigTiff() { std::remove(path_.c_str()); }
+        SparseBigTiff(const SparseBigTiff& rhs) = delete;
+        SparseBigTiff& operator=(const SparseBigTiff& rhs) = delete;
+
+        const std::string& path() const { return path_; }
+        bool good() const { return good_; }
+
+    private:
+        const std::string path_;
+        bool good_;
+    };
+
+    const SparseBigTiff& sparseBigTiff()
+    {
+        static const SparseBigTiff file;
+        return file;
+    }
+
+    void BM_GetType(benchmark::State& state, const char* file)
+    {
+        const Bench::Bytes data = Bench::readTestFile(file);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(ImageFactory::getType(&data[0], static_cast<long>(data.size())));
+        }
+    }
+
+    void BM_OpenReadMetadata(benchmark::State& state, const char* file)
+    {
+        const std::string path = Bench::testFile(file);
+        for (auto _ : state) {
+            Image::UniquePtr image = ImageFactory::open(path);
+            image->readMetadata();
+            benchmark::DoNotOptimize(image->exifData().count());
+        }
+    }
+
+    //! Read the metadata, decoding the TIFF subtrees with state.range(0) threads
+    void BM_ReadMetadataThreads(benchmark::State& state, const char* file)
+    {
+        const std::string path = Bench::testFile(file);
+        TiffParser::setDecodeThreads(static_cast<unsigned int>(state.range(0)));
+        for (auto _ : state) {
+            Image::UniquePtr image = ImageFactory::open(path);
+            image->readMetadata();
+            benchmark::DoNotOptimize(image->exifData().count());
+        }
+        TiffParser::setDecodeThreads(1);
+    }
+
+    void BM_BigTiffReadMetadata(benchmark::State& state)
+    {
+        const Bench::Bytes data = bigTiff(static_cast<uint16_t>(state.range(0)));
+        for (auto _ : state) {
+            Image::UniquePtr image = ImageFactory::open(&data[0], data.size());
+            image->readMetadata();
+            benchmark::DoNotOptimize(image->exifData().count());
+        }
+        Bench::setBytesProcessed(state, data.size());
+    }
+
+    //! Read the metadata of a BigTIFF file of more than 4 GB through FileIo, which maps the whole file
+    void BM_BigTiffReadMetadataSparseFile(benchmark::State& state)
+    {
+        if (sizeof(size_t) < 8) {
+            state.SkipWithError("The file cannot be memory mapped");
+            return;
+        }
+        const SparseBigTiff& file = sparseBigTiff();
+        if (!file.good()) {
+            state.SkipWithError("Failed to write the sparse file");
+            return;
+        }
+        for (auto _ : state) {
+            Image::UniquePtr image = ImageFactory::open(file.path());
+            image->readMetadata();
+            benchmark::DoNotOptimize(image->exifData().count());
+        }
+    }
+
+    //! Read the image and write its metadata back unchanged
+    void BM_WriteMetadataRoundTrip(benchmark::State& state, const char* file)
+    {
+        const Bench::Bytes data = Bench::readTestFile(file);
+        for (auto _ : state) {
+            Image::UniquePtr image = ImageFactory::open(&data[0], data.size());
+            image->readMetadata();
+            image->writeMetadata();
+            benchmark::DoNotOptimize(image->io().size());
+        }
+        Bench::setBytesProcessed(state, data.size());
+    }
+
+    //! Read the image, change one tag and write the metadata
+    void BM_EditOneTag(benchmark::State& state, const char* file)
+    {
+        const Bench::Bytes data = Bench::readTestFile(file);
+        for (auto _ : state) {
+            Image::UniquePtr image = ImageFactory::open(&data[0], data.size());
+            image->readMetadata();
+            image->exifData()["Exif.Image.Software"] = "Exiv2 benchmark";
+            image->writeMetadata();
+            benchmark::DoNotOptimize(image->io().size());
+        }
+        Bench::setBytesProcessed(state, data.size());
+    }
+
+    void BM_PrintStructure(benchmark::State& state, const char* file, PrintStructureOption option)
+    {
+        const Bench::Bytes data = Bench::readTestFile(file);
+        Image::UniquePtr image = ImageFactory::open(&data[0], data.size());
+        for (auto _ : state) {
+            std::ostringstream os;
+            image->printStructure(os, option);
+            benchmark::DoNotOptimize(os.str().size());
+        }
+    }
+}
+
+BENCHMARK_CAPTURE(BM_GetType, jpeg, "Reagan.jpg");
+BENCHMARK_CAPTURE(BM_GetType, tiff, "Reagan.tiff");
+BENCHMARK_CAPTURE(BM_GetType, png, "ReaganSmallPng.png");
+BENCHMARK_CAPTURE(BM_GetType, jp2, "Reagan.jp2");
+BENCHMARK_CAPTURE(BM_GetType, psd, "exiv2-photoshop.psd");
+BENCHMARK_CAPTURE(BM_GetType, crw, "exiv2-canon-powershot-s40.crw");
+BENCHMARK_CAPTURE(BM_GetType, pgf, "imagemagick.pgf");
+BENCHMARK_CAPTURE(BM_GetType, webp, "exiv2-bug1199.webp");
+BENCHMARK_CAPTURE(BM_GetType, xmp, "BlueSquare.xmp");
+
+BENCHMARK_CAPTURE(BM_OpenReadMetadata, jpeg, "Reagan.jpg");
+BENCHMARK_CAPTURE(BM_OpenReadMetadata, jpeg_large, "ReaganLargeJpg.jpg");
+BENCHMARK_CAPTURE(BM_OpenReadMetadata, tiff, "Reagan.tiff");
+BENCHMARK_CAPTURE(BM_OpenReadMetadata, tiff_large, "ReaganLargeTiff.tiff");
+BENCHMARK_CAPTURE(BM_OpenReadMetadata, png, "ReaganSmallPng.png");
+BENCHMARK_CAPTURE(BM_OpenReadMetadata, jp2, "Reagan.jp2");
+BENCHMARK_CAPTURE(BM_OpenReadMetadata, psd, "exiv2-photoshop.psd");
+BENCHMARK_CAPTURE(BM_OpenReadMetadata, crw, "exiv2-canon-powershot-s40.crw");
+BENCHMARK_CAPTURE(BM_OpenReadMetadata, pgf, "imagemagick.pgf");
+BENCHMARK_CAPTURE(BM_OpenReadMetadata, webp, "exiv2-bug1199.webp");
+BENCHMARK_CAPTURE(BM_OpenReadMetadata, xmp, "BlueSquare.xmp");
+BENCHMARK_CAPTURE(BM_OpenReadMetadata, exv_nikon, "_DSC8437.exv");
+BENCHMARK_CAPTURE(BM_OpenReadMetadata, exv_pentax, "RAW_PENTAX_K100.exv");
+
+BENCHMARK_CAPTURE(BM_ReadMetadataThreads, exv_nikon, "_DSC8437.exv")->Arg(1)->Arg(2)->Arg(4);
+BENCHMARK_CAPTURE(BM_ReadMetadataThreads, exv_pentax, "RAW_PENTAX_K100.exv")->Arg(1)->Arg(2)->Arg(4);
+
+BENCHMARK(BM_BigTiffReadMetadata)->Arg(16)->Arg(256);
+BENCHMARK(BM_BigTiffReadMetadataSparseFile);
+
+BENCHMARK_CAPTURE(BM_WriteMetadataRoundTrip, jpeg, "Reagan.jpg");
+BENCHMARK_CAPTURE(BM_WriteMetadataRoundTrip, tiff, "Reagan.tiff");
+BENCHMARK_CAPTURE(BM_WriteMetadataRoundTrip, png, "ReaganSmallPng.png");
+BENCHMARK_CAPTURE(BM_WriteMetadataRoundTrip, jp2, "Reagan.jp2");
+BENCHMARK_CAPTURE(BM_WriteMetadataRoundTrip, psd, "exiv2-photoshop.psd");
+BENCHMARK_CAPTURE(BM_WriteMetadataRoundTrip, webp, "exiv2-bug1199.webp");
+
+BENCHMARK_CAPTURE(BM_EditOneTag, jpeg, "Reagan.jpg");
+BENCHMARK_CAPTURE(BM_EditOneTag, tiff, "Reagan.tiff");
+BENCHMARK_CAPTURE(BM_EditOneTag, tiff_large, "ReaganLargeTiff.tiff");
+
+BENCHMARK_CAPTURE(BM_PrintStructure, jpeg_basic, "Reagan.jpg", kpsBasic);
+BENCHMARK_CAPTURE(BM_PrintStructure, jpeg_json, "Reagan.jpg", kpsJson);
+BENCHMARK_CAPTURE(BM_PrintStructure, tiff_recursive, "Reagan.tiff", kpsRecursive);
+BENCHMARK_CAPTURE(BM_PrintStructure, tiff_json, "Reagan.tiff", kpsJson);
+BENCHMARK_CAPTURE(BM_PrintStructure, png_basic, "ReaganSmallPng.png", kpsBasic);
@@ -0,0 +1,56 @@
+// Benchmarks of the IPTC parser
+#include "benchmarks.hpp"
+
+#include <image.hpp>
+#include <iptc.hpp>
+
+using namespace Exiv2;
+
+namespace
+{
+    //! The IPTC data of \em file
+    IptcData iptcDataOf(const char* file)
+    {
+        Image::UniquePtr image = ImageFactory::open(Bench::testFile(file));
+        image->readMetadata();
+        return image->iptcData();
+    }
+
+    void BM_IptcDecode(benchmark::State& state, const char* file)
+    {
+        const DataBuf buf = IptcParser::encode(iptcDataOf(file));
+        for (auto _ : state) {
+            IptcData iptcData;
+            IptcParser::decode(iptcData, buf.pData_, buf.size_);
+            benchmark::DoNotOptimize(iptcData.count());
+        }
+        Bench::setBytesProcessed(state, buf.size_);
+    }
+
+    void BM_IptcEncode(benchmark::State& state, const char* file)
+    {
+        const IptcData iptcData = iptcDataOf(file);
+        size_t size = 0;
+        for (auto _ : state) {
+            Blob blob;
+            IptcParser::encode(blob, iptcData);
+            size = blob.size();
+            benchmark::DoNotOptimize(size);
+        }
+        Bench::setBytesProcessed(state, size);
+    }
+
+    void BM_IptcKey(benchmark::State& state)
+    {
+        for (auto _ : state) {
+            IptcKey key("Iptc.Application2.Caption");
+            benchmark::DoNotOptimize(key.tag());
+        }
+    }
+}
+
+BENCHMARK_CAPTURE(BM_IptcDecode, jpeg, "Reagan.jpg");
+BENCHMARK_CAPTURE(BM_IptcDecode, smiley, "smiley1.jpg");
+BENCHMARK_CAPTURE(BM_IptcEncode, jpeg, "Reagan.jpg");
+BENCHMARK_CAPTURE(BM_IptcEncode, smiley, "smiley1.jpg");
+BENCHMARK(BM_IptcKey);
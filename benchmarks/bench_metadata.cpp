@@ -0,0 +1,162 @@
+// Benchmarks of the Exif metadata: key parsing, printing and sorting
+#include "benchmarks.hpp"
+
+#include <exif.hpp>
+#include <image.hpp>
+#include <makernote_int.hpp>
+#include <tags.hpp>
+#include <tags_int.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace Exiv2;
+
+namespace
+{
+    //! The Exif data of \em file
+    ExifData exifDataOf(const char* file)
+    {
+        Image::UniquePtr image = ImageFactory::open(Bench::testFile(file));
+        image->readMetadata();
+        return image->exifData();
+    }
+
+    void BM_ExifKeyFromString(benchmark::State& state, const char* key)
+    {
+        for (auto _ : state) {
+            ExifKey exifKey(key);
+            benchmark::DoNotOptimize(exifKey.tag());
+        }
+    }
+
+    void BM_ExifKeyFromTag(benchmark::State& state)
+    {
+        for (auto _ : state) {
+            ExifKey exifKey(0x829a, "Photo");
+            benchmark::DoNotOptimize(exifKey.key().size());
+        }
+    }
+
+    //! Print the tags of the makernote of \em file, like exiv2 -pt
+    void BM_PrintMakernote(benchmark::State& state, const char* file)
+    {
+        const ExifData exifData = exifDataOf(file);
+        int64_t tags = 0;
+        for (auto _ : state) {
+            std::ostringstream os;
+            for (auto&& exifdatum : exifData) {
+                if (!ExifTags::isMakerGroup(exifdatum.groupName())) continue;
+                exifdatum.write(os, &exifData);
+                ++tags;
+            }
+            benchmark::DoNotOptimize(os.str().size());
+        }
+        state.SetItemsProcessed(tags);
+    }
+
+    const char* const noConfigPath = "exiv2-benchmark-no-config.ini";
+    const char* const lensConfigPath = "exiv2-benchmark-config.ini";
+
+    /*!
+      @brief Write a configuration file with lens entries in the [lens] sections of the makernotes, \em key = \em lens
+             among other lenses
+     */
+    void writeLensConfig(const std::string& key, const std::string& lens)
+    {
+        std::ofstream file(lensConfigPath, std::ios::binary);
+        const char* const sections[] = {"canon", "minolta", "nikon", "olympus", "pentax", "sony"};
+        for (auto&& section : sections) {
+            file << "[" << section << "]\n";
+            for (int i = 0; i < 50; ++i) {
+                file << 60000 + i << " = Lens " << i << "\n";
+            }
+            file << key << " = " << lens << "\n";
+        }
+    }
+
+    /*!
+      @brief Print the lens of \em file with the print function of \em key, like exiv2 -pt. The configuration is
+             read from a temporary file. With \em config it has an entry for the lens, which replaces the lookup in
+             the lens tables, otherwise there is no such file.
+     */
+    void BM_PrintLens(benchmark::State& state, const char* file, const char* key, bool config)
+    {
+        const ExifData exifData = exifDataOf(file);
+        const ExifData::const_iterator pos = exifData.findKey(ExifKey(key));
+        if (pos == exifData.end()) {
+            state.SkipWithError("lens tag not found");
+            return;
+        }
+        // The print functions of the library objects linked into the benchmarks, which use the path set here
+        const TagInfo* tagInfo = Internal::tagInfo(pos->tag(), static_cast<Internal::IfdId>(pos->ifdId()));
+        if (config) {
+            writeLensConfig(pos->value().toString(), "Configured lens");
+            Internal::setExiv2ConfigPath(lensConfigPath);
+        } else {
+            std::remove(noConfigPath);
+            Internal::setExiv2ConfigPath(noConfigPath);
+        }
+        std::string lens;
+        for (auto _ : state) {
+            std::ostringstream os;
+            tagInfo->printFct_(os, pos->value(), &exifData);
+            lens = os.str();
+            benchmark::DoNotOptimize(lens.size());
+        }
+        state.SetLabel(lens);
+        Internal::setExiv2ConfigPath(Internal::getExiv2ConfigPath());
+        std::remove(lensConfigPath);
+    }
+
+    void BM_SortByKey(benchmark::State& state, const char* file)
+    {
+        const ExifData exifData = exifDataOf(file);
+        for (auto _ : state) {
+            ExifData copy(exifData);
+            copy.sortByKey();
+            benchmark::DoNotOptimize(copy.begin());
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * exifData.count());
+    }
+
+    void BM_FindKey(benchmark::State& state, const char* file, const char* key)
+    {
+        const ExifData exifData = exifDataOf(file);
+        const ExifKey exifKey(key);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(exifData.findKey(exifKey));
+        }
+    }
+}
+
+BENCHMARK_CAPTURE(BM_ExifKeyFromString, image, "Exif.Image.Make");
+BENCHMARK_CAPTURE(BM_ExifKeyFromString, photo, "Exif.Photo.ExposureTime");
+BENCHMARK_CAPTURE(BM_ExifKeyFromString, makernote, "Exif.NikonLd3.LensIDNumber");
+BENCHMARK_CAPTURE(BM_ExifKeyFromString, unknown, "Exif.Photo.0x1234");
+BENCHMARK(BM_ExifKeyFromTag);
+
+BENCHMARK_CAPTURE(BM_PrintMakernote, canon, "CanonEF100mmF2.8LMacroISUSM.exv");
+BENCHMARK_CAPTURE(BM_PrintMakernote, nikon, "_DSC8437.exv");
+BENCHMARK_CAPTURE(BM_PrintMakernote, olympus, "exiv2-olympus-c8080wz.jpg");
+BENCHMARK_CAPTURE(BM_PrintMakernote, pentax, "RAW_PENTAX_K100.exv");
+BENCHMARK_CAPTURE(BM_PrintMakernote, sony, "exiv2-bug1145a.exv");
+BENCHMARK_CAPTURE(BM_PrintMakernote, fuji, "FujiTagsDRangeAutoRating1.jpg");
+BENCHMARK_CAPTURE(BM_PrintMakernote, panasonic, "exiv2-bug825a.exv");
+
+BENCHMARK_CAPTURE(BM_PrintLens, canon_no_config, "CanonEF100mmF2.8LMacroISUSM.exv", "Exif.CanonCs.LensType", false);
+BENCHMARK_CAPTURE(BM_PrintLens, canon_config, "CanonEF100mmF2.8LMacroISUSM.exv", "Exif.CanonCs.LensType", true);
+BENCHMARK_CAPTURE(BM_PrintLens, nikon_no_config, "_DSC8437.exv", "Exif.NikonLd3.LensIDNumber", false);
+BENCHMARK_CAPTURE(BM_PrintLens, nikon_config, "_DSC8437.exv", "Exif.NikonLd3.LensIDNumber", true);
+BENCHMARK_CAPTURE(BM_PrintLens, pentax_no_config, "RAW_PENTAX_K100.exv", "Exif.Pentax.LensType", false);
+BENCHMARK_CAPTURE(BM_PrintLens, pentax_config, "RAW_PENTAX_K100.exv", "Exif.Pentax.LensType", true);
+BENCHMARK_CAPTURE(BM_PrintLens, sony_no_config, "exiv2-bug1145a.exv", "Exif.Sony1.LensID", false);
+BENCHMARK_CAPTURE(BM_PrintLens, sony_config, "exiv2-bug1145a.exv", "Exif.Sony1.LensID", true);
+
+BENCHMARK_CAPTURE(BM_SortByKey, nikon, "_DSC8437.exv");
+BENCHMARK_CAPTURE(BM_SortByKey, pentax, "RAW_PENTAX_K100.exv");
+
+BENCHMARK_CAPTURE(BM_FindKey, first, "_DSC8437.exv", "Exif.Image.Make");
+BENCHMARK_CAPTURE(BM_FindKey, makernote, "_DSC8437.exv", "Exif.NikonLd3.LensIDNumber");
@@ -0,0 +1,131 @@
+// Benchmarks of the XMP parser and of the conversions between Exif, IPTC and XMP
+#include "benchmarks.hpp"
+
+#include <convert.hpp>
+#include <image.hpp>
+#include <properties.hpp>
+#include <xmp_exiv2.hpp>
+
+#include <string>
+
+using namespace Exiv2;
+
+namespace
+{
+    //! The XMP packet of \em file, an image or a sidecar
+    std::string xmpPacketOf(const char* file)
+    {
+        Image::UniquePtr image = ImageFactory::open(Bench::testFile(file));
+        image->readMetadata();
+        return image->xmpPacket();
+    }
+
+    void BM_XmpDecode(benchmark::State& state, const char* file)
+    {
+        const std::string packet = xmpPacketOf(file);
+        for (auto _ : state) {
+            XmpData xmpData;
+            XmpParser::decode(xmpData, packet);
+            benchmark::DoNotOptimize(xmpData.count());
+        }
+        Bench::setBytesProcessed(state, packet.size());
+    }
+
+    void BM_XmpEncode(benchmark::State& state, const char* file)
+    {
+        XmpData xmpData;
+        XmpParser::decode(xmpData, xmpPacketOf(file));
+        size_t size = 0;
+        for (auto _ : state) {
+            std::string packet;
+            XmpParser::encode(packet, xmpData);
+            size = packet.size();
+            benchmark::DoNotOptimize(size);
+        }
+        Bench::setBytesProcessed(state, size);
+    }
+
+    void BM_XmpKey(benchmark::State& state)
+    {
+        for (auto _ : state) {
+            XmpKey key("Xmp.dc.description");
+            benchmark::DoNotOptimize(key.tagName().size());
+        }
+    }
+
+    //! The XMP data of \em image, or the XMP converted from its Exif data if it has none
+    XmpData xmpDataOf(const Image& image)
+    {
+        XmpData xmpData = image.xmpData();
+        if (xmpData.empty()) copyExifToXmp(image.exifData(), xmpData);
+        return xmpData;
+    }
+
+    void BM_CopyExifToXmp(benchmark::State& state, const char* file)
+    {
+        Image::UniquePtr image = ImageFactory::open(Bench::testFile(file));
+        image->readMetadata();
+        for (auto _ : state) {
+            XmpData xmpData;
+            copyExifToXmp(image->exifData(), xmpData);
+            benchmark::DoNotOptimize(xmpData.count());
+        }
+    }
+
+    void BM_CopyXmpToExif(benchmark::State& state, const char* file)
+    {
+        Image::UniquePtr image = ImageFactory::open(Bench::testFile(file));
+        image->readMetadata();
+        const XmpData xmpData = xmpDataOf(*image);
+        for (auto _ : state) {
+            ExifData exifData;
+            copyXmpToExif(xmpData, exifData);
+            benchmark::DoNotOptimize(exifData.count());
+        }
+    }
+
+    //! Synchronize the Exif and XMP data of \em file again after they were synchronized once
+    void BM_SyncExifWithXmp(benchmark::State& state, const char* file)
+    {
+        Image::UniquePtr image = ImageFactory::open(Bench::testFile(file));
+        image->readMetadata();
+        ExifData exifData = image->exifData();
+        XmpData xmpData = xmpDataOf(*image);
+        syncExifWithXmp(exifData, xmpData);
+        for (auto _ : state) {
+            syncExifWithXmp(exifData, xmpData);
+            benchmark::DoNotOptimize(xmpData.count());
+        }
+    }
+
+    void BM_CopyIptcToXmp(benchmark::State& state, const char* file)
+    {
+        Image::UniquePtr image = ImageFactory::open(Bench::testFile(file));
+        image->readMetadata();
+        for (auto _ : state) {
+            XmpData xmpData;
+            copyIptcToXmp(image->iptcData(), xmpData);
+            benchmark::DoNotOptimize(xmpData.count());
+        }
+    }
+}
+
+BENCHMARK_CAPTURE(BM_XmpDecode, jpeg, "Reagan.jpg");
+BENCHMARK_CAPTURE(BM_XmpDecode, sidecar, "BlueSquare.xmp");
+BENCHMARK_CAPTURE(BM_XmpEncode, jpeg, "Reagan.jpg");
+BENCHMARK_CAPTURE(BM_XmpEncode, sidecar, "BlueSquare.xmp");
+BENCHMARK(BM_XmpKey);
+
+BENCHMARK_CAPTURE(BM_CopyExifToXmp, jpeg, "Reagan.jpg");
+BENCHMARK_CAPTURE(BM_CopyExifToXmp, exv_nikon, "_DSC8437.exv");
+BENCHMARK_CAPTURE(BM_CopyExifToXmp, exv_pentax, "RAW_PENTAX_K100.exv");
+BENCHMARK_CAPTURE(BM_CopyExifToXmp, large_xmp, "exiv2-bug922.jpg");
+BENCHMARK_CAPTURE(BM_CopyXmpToExif, jpeg, "Reagan.jpg");
+BENCHMARK_CAPTURE(BM_CopyXmpToExif, exv_nikon, "_DSC8437.exv");
+BENCHMARK_CAPTURE(BM_CopyXmpToExif, exv_pentax, "RAW_PENTAX_K100.exv");
+BENCHMARK_CAPTURE(BM_CopyXmpToExif, large_xmp, "exiv2-bug922.jpg");
+BENCHMARK_CAPTURE(BM_SyncExifWithXmp, jpeg, "Reagan.jpg");
+BENCHMARK_CAPTURE(BM_SyncExifWithXmp, exv_nikon, "_DSC8437.exv");
+BENCHMARK_CAPTURE(BM_SyncExifWithXmp, exv_pentax, "RAW_PENTAX_K100.exv");
+BENCHMARK_CAPTURE(BM_SyncExifWithXmp, large_xmp, "exiv2-bug922.jpg");
+BENCHMARK_CAPTURE(BM_CopyIptcToXmp, jpeg, "Reagan.jpg");
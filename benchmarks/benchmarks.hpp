@@ -0,0 +1,36 @@
+// Helpers shared by the benchmarks
+#pragma once
+
+#include <basicio.hpp>
+#include <types.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+namespace Bench
+{
+    typedef std::vector<Exiv2::byte> Bytes;
+
+    //! Path of \em file in the test data
+    inline std::string testFile(const std::string& file)
+    {
+        return std::string(TESTDATA_PATH) + "/" + file;
+    }
+
+    //! The contents of \em file in the test data
+    inline Bytes readTestFile(const std::string& file)
+    {
+        Exiv2::FileIo io(testFile(file));
+        if (io.open() != 0) return Bytes();
+        Exiv2::DataBuf buf = io.read(io.size());
+        return Bytes(buf.pData_, buf.pData_ + buf.size_);
+    }
+
+    //! Report the throughput of \em bytes processed per iteration
+    inline void setBytesProcessed(benchmark::State& state, size_t bytes)
+    {
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(bytes));
+    }
+}
@@ -0,0 +1,18 @@
+#include <benchmark/benchmark.h>
+
+#include <exiv2/error.hpp>
+#include <exiv2/properties.hpp>
+
+int main(int argc, char** argv)
+{
+    // Warnings about the test data are not part of the measurements
+    Exiv2::LogMsg::setLevel(Exiv2::LogMsg::mute);
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+
+    Exiv2::XmpProperties::unregisterNs();
+    return 0;
+}
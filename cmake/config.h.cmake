@@ -9,6 +9,9 @@
 // Define if you require webready support.
 #cmakedefine EXV_ENABLE_WEBREADY
 
+// Define to collect the counters and timers of the Stats class.
+#cmakedefine EXV_ENABLE_STATS
+
 // Define if you have the `gmtime_r' function.
 #cmakedefine EXV_HAVE_GMTIME_R
 
@@ -41,6 +44,12 @@
 // Define if you have the munmap function.
 #cmakedefine EXV_HAVE_MUNMAP
 
+// Define if you have the writev function.
+#cmakedefine EXV_HAVE_WRITEV
+
+// Define if you have the copy_file_range function.
+#cmakedefine EXV_HAVE_COPY_FILE_RANGE
+
 /* Define if you have the <unistd.h> header file. */
 #cmakedefine EXV_HAVE_UNISTD_H
 
@@ -9,6 +9,7 @@ endif()
 set(EXV_ENABLE_WEBREADY  ${EXIV2_ENABLE_WEBREADY})
 set(EXV_HAVE_LENSDATA    ${EXIV2_ENABLE_LENSDATA})
 set(EXV_HAVE_PRINTUCS2   ${EXIV2_ENABLE_PRINTUCS2})
+set(EXV_ENABLE_STATS     ${EXIV2_ENABLE_STATS})
 
 set(EXV_PACKAGE_NAME     ${PROJECT_NAME})
 set(EXV_PACKAGE_VERSION  ${PROJECT_VERSION})
@@ -25,6 +26,8 @@ check_cxx_symbol_exists(gmtime_r    time.h         EXV_HAVE_GMTIME_R)
 check_cxx_symbol_exists(mmap        sys/mman.h     EXV_HAVE_MMAP )
 check_cxx_symbol_exists(munmap      sys/mman.h     EXV_HAVE_MUNMAP )
 check_cxx_symbol_exists(strerror_r  string.h       EXV_HAVE_STRERROR_R )
+check_cxx_symbol_exists(writev      sys/uio.h      EXV_HAVE_WRITEV )
+check_cxx_symbol_exists(copy_file_range unistd.h   EXV_HAVE_COPY_FILE_RANGE )
 
 check_cxx_source_compiles( "
 #include <string.h>
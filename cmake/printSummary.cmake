@@ -56,6 +56,7 @@ OptionOutput( "Building webready support:          " EXIV2_ENABLE_WEBREADY
 if    ( EXIV2_ENABLE_WEBREADY )
     OptionOutput( "USE Libcurl for HttpIo:             " EXIV2_ENABLE_CURL           )
 endif ( EXIV2_ENABLE_WEBREADY )
+OptionOutput( "Counters and timers (stats):        " EXIV2_ENABLE_STATS              )
 
 if (WIN32)
     OptionOutput( "Dynamic runtime override:           " EXIV2_ENABLE_DYNAMIC_RUNTIME)
@@ -66,6 +67,7 @@ OptionOutput( "Building samples:                   " EXIV2_BUILD_SAMPLES
 OptionOutput( "Building PO files:                  " EXIV2_BUILD_PO                  )
 OptionOutput( "Building unit tests:                " EXIV2_BUILD_UNIT_TESTS          )
 OptionOutput( "Building fuzz tests:                " EXIV2_BUILD_FUZZ_TESTS          )
+OptionOutput( "Building benchmarks:                " EXIV2_BUILD_BENCHMARKS          )
 OptionOutput( "Building doc:                       " EXIV2_BUILD_DOC                 )
 OptionOutput( "Building with boost::regex          " EXV_NEED_BOOST_REGEX            )
 OptionOutput( "Building with coverage flags:       " BUILD_WITH_COVERAGE             )
@@ -27,7 +27,9 @@
 #include "types.hpp"
 
 // + standard includes
+#include <cstdio>       // for std::FILE
 #include <memory>       // for std::auto_ptr
+#include <vector>
 
 // *****************************************************************************
 // namespace extensions
@@ -49,6 +51,12 @@ constexpr size_t operator"" _z(unsigned long long n)
 // *****************************************************************************
 // class definitions
 
+    //! A block of memory with data for a BasicIo, see BasicIo::writev() and MemIo::blocks()
+    struct IoBlock {
+        const byte* data_;  //!< Start of the block
+        size_t size_;       //!< Size of the block
+    };
+
     /// @brief An interface for simple binary IO.
     ///
     /// Designed to have semantics and names similar to those of C style FILE* operations. Subclasses should all
@@ -99,6 +107,22 @@ constexpr size_t operator"" _z(unsigned long long n)
         /// @return The value of the byte written if successful;<BR> EOF if failure;
         virtual int putb(byte data) = 0;
 
+        /// @brief Write blocks of memory one after the other, like one write() of the blocks joined. Current IO
+        /// position is advanced by the number of bytes written. Subclasses write the blocks at once, e.g., with
+        /// one system call, the default implementation writes them one by one.
+        /// @param blocks Pointer to the blocks. There must be at least \em count blocks
+        /// @param count Number of blocks to be written.
+        /// @return Number of bytes written to IO source successfully;<BR> 0 if failure;
+        virtual size_t writev(const IoBlock* blocks, size_t count);
+
+        /// @brief Copy data from another instance. Reading starts at the source's current IO position; both IO
+        /// positions are advanced by the number of bytes copied. Unlike write(BasicIo&), only \em rcount bytes are
+        /// copied and subclasses avoid copying the data through a buffer where they can.
+        /// @param src Reference to another BasicIo instance.
+        /// @param rcount Number of bytes to copy.
+        /// @return Number of bytes copied successfully;<BR> 0 if failure;
+        virtual size_t copyRange(BasicIo& src, size_t rcount);
+
         /// @brief Read data from the IO source. Reading starts at the current IO position and the position is
         /// advanced by the number of bytes read.
         /// @param rcount Maximum number of bytes to read.
@@ -287,6 +311,14 @@ constexpr size_t operator"" _z(unsigned long long n)
         /// @return The value of the byte written if successful;<BR> EOF if failure;
         int putb(byte data) override;
 
+        /// @brief Write blocks of memory to the file, with one writev() call where it is available and the blocks
+        /// are not small.
+        size_t writev(const IoBlock* blocks, size_t count) override;
+
+        /// @brief Copy data from another BasicIo instance to the file. The data of another FileIo is copied with
+        /// copy_file_range() where it is available, the blocks of a MemIo are written as they are.
+        size_t copyRange(BasicIo& src, size_t rcount) override;
+
         DataBuf read(size_t rcount) noexcept override;
 
         size_t read(byte* buf, size_t rcount) override;
@@ -360,6 +392,8 @@ constexpr size_t operator"" _z(unsigned long long n)
     /// A copy-on-write implementation ensures that the data passed in is only copied when necessary, i.e., as soon
     /// as data is written to the MemIo. The original data is only used for reading. If writes are performed, the
     /// changed data can be retrieved using the read methods (since the data used in construction is never modified).
+    /// The data written is kept in a list of blocks, so that growing the MemIo doesn't copy the data written before.
+    /// mmap() joins the blocks when it is called, transfer() to a FileIo writes them as they are.
     /// @note If read only usage of this class is common, it might be worth creating a specialized readonly class or
     /// changing this one to have a readonly mode.
     class EXIV2API MemIo : public BasicIo {
@@ -409,6 +443,12 @@ constexpr size_t operator"" _z(unsigned long long n)
 
         int putb(byte data) override;
 
+        /// @brief Write blocks of memory to the memory area, reserving the memory for all of them at once.
+        size_t writev(const IoBlock* blocks, size_t count) override;
+
+        /// @brief Copy data from another BasicIo instance, reading it straight into the memory area.
+        size_t copyRange(BasicIo& src, size_t rcount) override;
+
         DataBuf read(size_t rcount) noexcept override;
 
         size_t read(byte* buf, size_t rcount) override;
@@ -431,10 +471,15 @@ constexpr size_t operator"" _z(unsigned long long n)
         /// @return 0 if successful;<BR> Nonzero if failure;
         int seek(int64 offset, Position pos) override;
 
-        /// @brief In this case, it just returns a pointer to the memory array start.
+        /// @brief In this case, it just returns a pointer to the memory array start. The memory array is kept in
+        /// blocks while it grows, they are joined into one block on the first call.
         byte* mmap(bool /*isWriteable*/ =false) override;
 
         int munmap() override;
+
+        /// @brief Return the blocks of memory which hold the data, in order. Unlike mmap(), this doesn't join them
+        /// into one block. The blocks are valid until the next write to or transfer from this object.
+        virtual std::vector<IoBlock> blocks();
         //@}
 
         //! @name Accessors
@@ -462,6 +507,12 @@ constexpr size_t operator"" _z(unsigned long long n)
 
         //@}
 
+    protected:
+        /// @brief Append data at the end of the memory block without moving the IO position.
+        /// @param data Pointer to data. Data must be at least \em count bytes long
+        /// @param count Number of bytes to append.
+        void append(const byte* data, size_t count);
+
     private:
 
         // Pimpl idiom
@@ -470,7 +521,77 @@ constexpr size_t operator"" _z(unsigned long long n)
 
     }; // class MemIo
 
-    /// @brief Provides binary IO for the data from stdin and data uri path.
+    /// @brief Provides binary IO for the data from stdin, without a temporary file.
+    ///
+    /// The data is read into memory on demand, only as far as it is read or sought to. Reading the metadata of
+    /// e.g. a JPEG image thus reads the input up to the image data only. Operations which need all of the data
+    /// (size(), mmap(), seeks relative to the end and writes) read the rest of the input first. transfer()
+    /// replaces the data and stops reading the input.
+    class EXIV2API StdinIo : public MemIo {
+    public:
+        //! @name Creators
+        //@{
+        /// @brief Constructor that reads the data from stdin.
+        /// @throw Error if stdin is a terminal.
+        StdinIo();
+        /// @brief Constructor that reads the data from \em input, e.g., a pipe. The stream remains owned by the
+        /// caller and must not be closed before the StdinIo.
+        explicit StdinIo(std::FILE* input);
+        //@}
+
+        //! @name Manipulators
+        //@{
+        size_t write(const byte* data, size_t wcount) override;
+
+        size_t write(BasicIo& src) override;
+
+        int putb(byte data) override;
+
+        size_t writev(const IoBlock* blocks, size_t count) override;
+
+        size_t copyRange(BasicIo& src, size_t rcount) override;
+
+        DataBuf read(size_t rcount) noexcept override;
+
+        size_t read(byte* buf, size_t rcount) override;
+
+        int getb() override;
+
+        /// @brief Replace the data with the data of \em src, the rest of the input is not read.
+        void transfer(BasicIo& src) override;
+
+        int seek(int64 offset, Position pos) override;
+
+        byte* mmap(bool isWriteable =false) override;
+
+        std::vector<IoBlock> blocks() override;
+        //@}
+
+        //! @name Accessors
+        //@{
+        /// @brief Read all of the input and return its size.
+        size_t size() const override;
+
+        //! Returns "-", the path of stdin on the command line
+        std::string path() const override;
+#ifdef EXV_UNICODE_PATH
+        /// @brief Like path() but returns the path in an std::wstring.
+        /// @note This function is only available on Windows.
+        std::wstring wpath() const override;
+#endif
+        //@}
+
+    private:
+        /// @brief Read the input until at least \em minSize bytes are in memory or the input ends.
+        /// @throw Error if reading the input fails
+        void fill(size_t minSize);
+
+        // DATA
+        std::FILE* input_;   //!< The input, 0 when all of it is in memory
+    }; // class StdinIo
+
+    /// @brief Provides binary IO for the data from stdin and data uri path, through a temporary file. StdinIo
+    /// provides binary IO for the data from stdin without one.
     class EXIV2API XPathIo : public FileIo {
     public:
         /// @brief The extension of the temporary file which is created when getting input data to read metadata. This
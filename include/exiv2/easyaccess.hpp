@@ -31,6 +31,9 @@
 // included header files
 #include "exif.hpp"
 
+// + standard includes
+#include <vector>
+
 namespace Exiv2 {
 
 // *****************************************************************************
@@ -82,4 +85,44 @@ namespace Exiv2 {
     //! Return the AF point
     EXIV2API ExifData::const_iterator afPoint(const ExifData& ed);
 
+    //! Identifiers of the easy access values, for looking up several of them with easyAccess()
+    enum EasyAccessId {
+        eaOrientation,       //!< See orientation()
+        eaIsoSpeed,          //!< See isoSpeed()
+        eaFlashBias,         //!< See flashBias()
+        eaExposureMode,      //!< See exposureMode()
+        eaSceneMode,         //!< See sceneMode()
+        eaMacroMode,         //!< See macroMode()
+        eaImageQuality,      //!< See imageQuality()
+        eaWhiteBalance,      //!< See whiteBalance()
+        eaLensName,          //!< See lensName()
+        eaSaturation,        //!< See saturation()
+        eaSharpness,         //!< See sharpness()
+        eaContrast,          //!< See contrast()
+        eaSceneCaptureType,  //!< See sceneCaptureType()
+        eaMeteringMode,      //!< See meteringMode()
+        eaMake,              //!< See make()
+        eaModel,             //!< See model()
+        eaExposureTime,      //!< See exposureTime()
+        eaFNumber,           //!< See fNumber()
+        eaSubjectDistance,   //!< See subjectDistance()
+        eaSerialNumber,      //!< See serialNumber()
+        eaFocalLength,       //!< See focalLength()
+        eaAfPoint            //!< See afPoint()
+    };
+
+    /*!
+      @brief Look up several easy access values in a single pass over \em ed.
+
+      The result is the same as calling the individual easy access functions,
+      but the metadata container is only searched once.
+
+      @param ed  The %Exif metadata container to search
+      @param ids The easy access values to look up
+      @return One iterator for each element of \em ids, in the same order.
+              Values which are not available are returned as ed.end().
+     */
+    EXIV2API std::vector<ExifData::const_iterator> easyAccess(const ExifData& ed,
+                                                              const std::vector<EasyAccessId>& ids);
+
 } // namespace Exiv2
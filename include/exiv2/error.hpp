@@ -119,10 +119,19 @@ namespace Exiv2 {
                  the log message handler to 0 (or set the log level to \c mute).
          */
         static void setHandler(Handler handler);
+        /*!
+          @brief Set a log message handler for the calling thread only. It is
+                 used instead of the handler set with setHandler() as long as
+                 that is not 0, e.g., to collect the messages of a task. Set it
+                 to 0 to use the handler of setHandler() again.
+         */
+        static void setThreadHandler(Handler handler);
         //! Return the current log level
         static Level level();
         //! Return the current log message handler
         static Handler handler();
+        //! Return the log message handler of the calling thread, 0 if it has none
+        static Handler threadHandler();
         //! The default log handler. Sends the log message to standard error.
         static void defaultHandler(int level, const char* s);
 
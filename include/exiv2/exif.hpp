@@ -36,6 +36,7 @@
 
 // + standard includes
 #include <list>
+#include <memory>
 
 // *****************************************************************************
 // namespace extensions
@@ -52,6 +53,7 @@ namespace Exiv2
     {
         template <typename T>
         friend Exifdatum& setValue(Exifdatum&, const T&);
+        friend class ExifData;
 
     public:
         //! @name Creators
@@ -129,6 +131,8 @@ namespace Exiv2
         const char* ifdName() const;
         //! Return the index (unique id of this key within the original IFD)
         int idx() const;
+        /// @brief Return true if the %Exifdatum was added or changed after ExifData::setOrigin() was called.
+        bool modified() const;
 
         /// @brief Write value to a data buffer and return the number of bytes written.
         ///
@@ -173,6 +177,7 @@ namespace Exiv2
     private:
         ExifKey::UniquePtr key_;  //!< Key
         Value::UniquePtr value_;  //!< Value
+        bool modified_;           //!< Added or changed after ExifData::setOrigin()
     };
 
     /// @brief Access to a Exif thumbnail image.
@@ -307,6 +312,12 @@ namespace Exiv2
     //! Container type to hold all metadata
     typedef std::list<Exifdatum> ExifMetadata;
 
+    namespace Internal
+    {
+        //! Indexed lookup of the makernote print functions, see makernote_int.hpp
+        ExifMetadata::const_iterator findIndexedKey(const ExifData& exifData, const std::string& key);
+    }
+
     /// @brief A container for EXIF data. This is a top-level class of the library. The container holds Exifdatum
     /// objects.
     ///
@@ -319,14 +330,34 @@ namespace Exiv2
     /// - extract and delete Exif thumbnail (JPEG and TIFF thumbnails)
     class EXIV2API ExifData
     {
+        friend ExifMetadata::const_iterator Internal::findIndexedKey(const ExifData& exifData, const std::string& key);
+
     public:
         //! ExifMetadata iterator type
         typedef ExifMetadata::iterator iterator;
         //! ExifMetadata const iterator type
         typedef ExifMetadata::const_iterator const_iterator;
 
+        //! @name Creators
+        //@{
+        //! Default constructor
+        ExifData();
+        //! Copy constructor, the copy has the same origin
+        ExifData(const ExifData& rhs);
+        //! Move constructor, takes the metadata and the origin of \em rhs without copying; \em rhs is empty afterwards
+        ExifData(ExifData&& rhs);
+        //! Destructor
+        ~ExifData();
+        //@}
+
         //! @name Manipulators
         //@{
+        /// @brief Assignment operator. The origin is not assigned, the result is untracked (see setOrigin()).
+        ExifData& operator=(const ExifData& rhs);
+        /// @brief Move assignment operator, takes the metadata of \em rhs without copying; \em rhs is empty afterwards.
+        /// The origin is not assigned, as with the assignment operator.
+        ExifData& operator=(ExifData&& rhs);
+
         /// @brief Returns a reference to the %Exifdatum that is associated with a particular \em key.
         /// If %ExifData does not already contain such an %Exifdatum, operator[] adds object \em Exifdatum(key).
         /// @note  Since operator[] might insert a new element, it can't be a const member function.
@@ -341,6 +372,10 @@ namespace Exiv2
         /// @throw Error if the makernote cannot be created
         void add(const Exifdatum& exifdatum);
 
+        /// @brief Move all Exifdatum instances of \em exifData to the end of the Exif metadata, without copying them.
+        /// \em exifData is empty afterwards. No duplicate checks are performed.
+        void append(ExifData& exifData);
+
         /// @brief Delete the Exifdatum at iterator position \em pos, return the position of the next exifdatum.
         /// Note that iterators into the metadata, including \em pos, are potentially invalidated by this call.
         iterator erase(iterator pos);
@@ -359,6 +394,13 @@ namespace Exiv2
         //! Sort metadata by tag
         void sortByTag();
 
+        /// @brief Set the \em origin of the metadata, usually the BasicIo it was read from, and mark all metadata as
+        /// unmodified. Changes made after that are tracked with Exifdatum::modified(), so that the metadata can be
+        /// written back to its origin by encoding only what was changed.
+        ///
+        /// Erasing metadata resets the origin to 0, copies keep it. An origin of 0 means that changes are not tracked.
+        void setOrigin(const void* origin);
+
         //! Begin of the metadata
         iterator begin()
         {
@@ -393,10 +435,19 @@ namespace Exiv2
         bool empty() const;
         //! Get the number of metadata entries
         long count() const;
+        /// @brief Return the origin set with setOrigin(), or 0 if metadata was erased since then.
+        const void* origin() const;
         //@}
 
     private:
+        //! Find the first Exifdatum with \em key with the index of the keys, see Internal::findIndexedKey()
+        const_iterator findIndexedKey(const std::string& key) const;
+
+        //! Internal state of ExifData, see setOrigin() and findIndexedKey()
+        struct Impl;
+
         ExifMetadata exifMetadata_;
+        std::unique_ptr<Impl> p_;
     };
 
     /// @brief Stateless parser class for Exif data. Images use this class to decode and encode binary Exif data.
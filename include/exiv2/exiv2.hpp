@@ -60,6 +60,7 @@
 #include "exiv2/psdimage.hpp"
 #include "exiv2/rafimage.hpp"
 #include "exiv2/rw2image.hpp"
+#include "exiv2/stats.hpp"
 
 #include "exiv2/tags.hpp"
 #include "exiv2/tgaimage.hpp"
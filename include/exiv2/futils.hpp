@@ -178,6 +178,15 @@ namespace Exiv2
     //! @brief Return the path of the current process.
     EXIV2API std::string getProcessPath();
 
+    /*!
+      @brief Read the Exiv2 configuration file (~/.exiv2, or exiv2.ini in the
+             user profile folder on Windows) again on the next lookup. The
+             library parses the file once and again when its size or
+             modification time changes, this forces it to be read if it was
+             changed otherwise.
+     */
+    EXIV2API void reloadExiv2Config();
+
     //! @brief Return vector of libraries in memory.
     EXIV2API std::vector<std::string> getLoadedLibraries();
 
@@ -31,6 +31,7 @@
 #include "xmp_exiv2.hpp"
 
 // + standard includes
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -38,6 +39,11 @@
 // namespace extensions
 namespace Exiv2
 {
+    namespace Internal
+    {
+        class SegmentIndex;
+    }
+
     // *****************************************************************************
     // class definitions
 
@@ -55,8 +61,8 @@ namespace Exiv2
     //! List of native previews. This is meant to be used only by the PreviewManager.
     typedef std::vector<NativePreview> NativePreviewList;
 
-    /// @brief Options for printStructure
-    typedef enum { kpsNone, kpsBasic, kpsXMP, kpsRecursive, kpsIccProfile, kpsIptcErase } PrintStructureOption;
+    /// @brief Options for printStructure. kpsJson prints one JSON object per line for each structural element.
+    typedef enum { kpsNone, kpsBasic, kpsXMP, kpsRecursive, kpsIccProfile, kpsIptcErase, kpsJson } PrintStructureOption;
 
     /// @brief Interface for an image. This is the top-level interface to the Exiv2 library.
     ///
@@ -362,6 +368,9 @@ namespace Exiv2
         //! Return tag type for given tag id.
         const char* typeName(uint16_t tag) const;
 
+        //! Return the index of the segments of the image, see Internal::SegmentIndex.
+        Internal::SegmentIndex& segmentIndex();
+
     public:
         Image& operator=(const Image& rhs) = delete;
         Image& operator=(const Image&& rhs) = delete;
@@ -375,9 +384,9 @@ namespace Exiv2
         bool writeXmpFromPacket_;     //!< Determines the source when writing XMP
         ByteOrder byteOrder_;         //!< Byte order
 
-        std::map<int, std::string> tags_;  //!< Map of tags
-        bool init_;                        //!< Flag marking if map of tags needs to be initialized
-
+        //! Internal state of the image, see segmentIndex()
+        struct Impl;
+        std::unique_ptr<Impl> p_;
     };
 
     //! Type for function pointer that creates new Image instances
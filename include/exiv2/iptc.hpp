@@ -304,6 +304,14 @@ namespace Exiv2 {
           @return Data buffer containing the binary IPTC data in IPTC IIM4 format.
          */
         static DataBuf encode(const IptcData& iptcData);
+        /*!
+          @brief Encode the IPTC datasets from \em iptcData to a binary
+                 representation in IPTC IIM4 format and append it to \em blob.
+
+          Like encode(const IptcData&), but the datasets are written in one
+          pass, without an intermediate buffer.
+         */
+        static void encode(Blob& blob, const IptcData& iptcData);
 
     private:
         // Constant data
@@ -212,6 +212,12 @@ namespace Exiv2
         /// segment.
         /// @return the next Jpeg segment marker if successful;<BR> -1 if a maker was not found before EOF
         int advanceToMarker() const;
+
+        /// @brief Identify the contents of a segment for the segment index.
+        /// @param marker The segment marker.
+        /// @param buf The first 36 bytes of the segment, starting with its size.
+        /// @return the kind of APPn segment, see jpgimage.cpp.
+        static uint32_t segmentId(int marker, const byte* buf);
         //@}
 
     };  // class JpegBase
@@ -180,6 +180,35 @@ namespace Exiv2 {
           @brief Return the preview image for the given preview properties.
          */
         PreviewImage getPreviewImage(const PreviewProperties& properties) const;
+        /*!
+          @brief Write the preview image for the given preview properties
+                 to \em dest, without creating a PreviewImage.
+
+          JPEG and native previews stored in the image are written directly
+          from the source image. For TIFF previews, only the TIFF structure is
+          encoded in memory, the strips or tiles are copied one by one from
+          the source image after it. The data is written at the current
+          position of \em dest, which must be open for writing.
+
+          @param properties Preview properties as returned by getPreviewProperties().
+          @param dest       Destination for the preview image.
+          @return The number of bytes written.
+         */
+        size_t writePreviewImage(const PreviewProperties& properties, BasicIo& dest) const;
+        /*!
+          @brief Write the preview image for the given preview properties
+                 to a file.
+
+          Like PreviewImage::writeFile(), a filename extension is appended to
+          \em path according to the image type of the preview image. An
+          existing file of the same name is overwritten. If the image has no
+          such preview image, no file is created.
+
+          @param properties Preview properties as returned by getPreviewProperties().
+          @param path       File name of the preview image without extension.
+          @return The number of bytes written.
+         */
+        size_t writePreviewImage(const PreviewProperties& properties, const std::string& path) const;
         //@}
 
     private:
@@ -0,0 +1,100 @@
+// ***************************************************************** -*- C++ -*-
+/*
+ * Copyright (C) 2004-2018 Exiv2 authors
+ * This program is part of the Exiv2 distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, 5th Floor, Boston, MA 02110-1301 USA.
+ */
+/*!
+  @file    stats.hpp
+  @brief   Counters and timers of the hot paths of the library
+ */
+#pragma once
+
+// *****************************************************************************
+#include "exiv2lib_export.h"
+
+// included header files
+#include "config.h"
+
+// + standard includes
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// *****************************************************************************
+// namespace extensions
+namespace Exiv2 {
+
+// *****************************************************************************
+// class definitions
+
+    /*!
+      @brief Counters of the calls, the time and the bytes of the hot paths
+             of the library, to find out where the time goes when a file is
+             slow: I/O, type detection, TIFF parsing, XMP or IPTC parsing.
+
+      The counters are only collected if the library is built with the CMake
+      option EXIV2_ENABLE_STATS, otherwise they stay 0. Each thread counts in
+      its own counters, snapshot() adds up the counters of all threads,
+      including those which have ended. The times are inclusive: the time of
+      readMetadata() contains the time of the TIFF parser it calls.
+     */
+    class EXIV2API Stats {
+    public:
+        //! The instrumented operations
+        enum Counter {
+            imageFactoryOpen,   //!< ImageFactory::open(), opening the I/O and detecting the type
+            readMetadata,       //!< Image::readMetadata() of all formats
+            writeMetadata,      //!< Image::writeMetadata() of all formats
+            tiffDecode,         //!< Decoding TIFF structures, including Exif and makernotes
+            tiffEncode,         //!< Encoding TIFF structures
+            xmpDecode,          //!< XmpParser::decode(), bytes of the packet
+            xmpEncode,          //!< XmpParser::encode(), bytes of the packet
+            iptcDecode,         //!< IptcParser::decode(), bytes of the IPTC data
+            iptcEncode,         //!< IptcParser::encode(), bytes of the IPTC data
+            ioRead,             //!< Reads of BasicIo, bytes read (not timed)
+            ioWrite,            //!< Writes of BasicIo, bytes written (not timed)
+            ioSeek,             //!< Seeks of BasicIo (not timed)
+            ioMmap,             //!< Memory mappings of BasicIo, bytes mapped (not timed)
+            lastCounter         //!< Number of counters, not a counter
+        };
+
+        //! The counts of one counter
+        struct Entry {
+            uint64_t calls_;        //!< Number of calls
+            uint64_t nanoseconds_;  //!< Time spent in the calls, 0 if the counter is not timed
+            uint64_t bytes_;        //!< Bytes processed by the calls
+        };
+
+        //! The counts of all counters, indexed by Counter
+        typedef std::vector<Entry> Snapshot;
+
+        //! Return true if the library collects the counters
+        static bool enabled();
+        //! Return the counts of all threads
+        static Snapshot snapshot();
+        /*!
+          @brief Set the counters of all threads to 0. Calls which are running
+                 in other threads may be counted or not.
+         */
+        static void reset();
+        //! Return the name of \em counter, like "TiffParser::decode"
+        static const char* name(Counter counter);
+        //! Print the counters of \em snapshot which were used as a table
+        static std::ostream& print(std::ostream& os, const Snapshot& snapshot);
+    };
+
+}                                       // namespace Exiv2
@@ -166,6 +166,28 @@ namespace Exiv2 {
         */
         static WriteMethod encode(BasicIo& io, const byte* pData, size_t size, ByteOrder byteOrder,
                                   const ExifData& exifData, const IptcData& iptcData, const XmpData& xmpData);
+        /*!
+          @brief Set the number of threads used to decode one TIFF structure.
+                 This applies to all TIFF based metadata, including the Exif
+                 data of JPEG images and the raw formats.
+
+          With more than one thread, the parser reads and decodes the
+          independent subtrees of the structure, i.e., each sub-IFD including
+          the Exif IFD and each makernote, as parallel tasks, once the IFDs of
+          the top-level chain are read. The results are merged in the order in
+          which a sequential parser finds them, so the metadata and the log
+          messages are the same. If a subtree depends on another one, the
+          structure is decoded again sequentially. This pays off for large
+          files with many sub-IFDs and large makernotes, like DNG and NEF
+          images, rather than for files with a few dozen tags.
+
+          @param threads Maximum number of threads, including the calling
+                 one, usually not more than std::thread::hardware_concurrency().
+                 0 and 1 decode sequentially, which is the default.
+         */
+        static void setDecodeThreads(unsigned int threads);
+        //! Return the number of threads used to decode one TIFF structure
+        static unsigned int decodeThreads();
 
     }; // class TiffParser
 
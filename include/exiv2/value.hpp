@@ -1232,6 +1232,10 @@ namespace Exiv2 {
     template<> inline TypeId getType<float>() { return tiffFloat; }
     //! Specialization for a double
     template<> inline TypeId getType<double>() { return tiffDouble; }
+    //! Specialization for an unsigned long long
+    template<> inline TypeId getType<uint64_t>() { return unsignedLongLong; }
+    //! Specialization for a signed long long
+    template<> inline TypeId getType<int64_t>() { return signedLongLong; }
 
     // No default implementation: let the compiler/linker complain
     // template<typename T> inline TypeId getType() { return invalid; }
@@ -1351,6 +1355,10 @@ namespace Exiv2 {
     typedef ValueType<float> FloatValue;
     //! Double value type
     typedef ValueType<double> DoubleValue;
+    //! Unsigned long long value type
+    typedef ValueType<uint64_t> ULongLongValue;
+    //! Signed long long value type
+    typedef ValueType<int64_t> LongLongValue;
 
 // *****************************************************************************
 // free functions, template and inline definitions
@@ -1415,6 +1423,18 @@ namespace Exiv2 {
     {
         return getDouble(buf, byteOrder);
     }
+    // Specialization for an 8 byte unsigned long long value.
+    template<>
+    inline uint64_t getValue(const byte* buf, ByteOrder byteOrder)
+    {
+        return getULongLong(buf, byteOrder);
+    }
+    // Specialization for an 8 byte signed long long value.
+    template<>
+    inline int64_t getValue(const byte* buf, ByteOrder byteOrder)
+    {
+        return static_cast<int64_t>(getULongLong(buf, byteOrder));
+    }
 
     /*!
       @brief Convert a value of type T to data, write the data to the data buffer.
@@ -1501,6 +1521,24 @@ namespace Exiv2 {
     {
         return d2Data(buf, t, byteOrder);
     }
+    /*!
+      @brief Specialization to write an unsigned long long to the data buffer.
+             Return the number of bytes written.
+     */
+    template<>
+    inline long toData(byte* buf, uint64_t t, ByteOrder byteOrder)
+    {
+        return ull2Data(buf, t, byteOrder);
+    }
+    /*!
+      @brief Specialization to write a signed long long to the data buffer.
+             Return the number of bytes written.
+     */
+    template<>
+    inline long toData(byte* buf, int64_t t, ByteOrder byteOrder)
+    {
+        return ull2Data(buf, static_cast<uint64_t>(t), byteOrder);
+    }
 
     template<typename T>
     ValueType<T>::ValueType()
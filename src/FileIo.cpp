@@ -20,6 +20,7 @@
 #include "basicio.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 
 #include <sys/stat.h>   // for stat, chmod
 #include <sys/types.h>  // for stat, chmod
@@ -32,6 +33,14 @@
 #include <unistd.h>  // for getpid, stat
 #endif
 
+#ifdef EXV_HAVE_WRITEV
+#include <sys/uio.h>  // for writev
+#include <climits>    // for IOV_MAX
+#endif
+#if defined(EXV_HAVE_WRITEV) || defined(EXV_HAVE_COPY_FILE_RANGE)
+#include <cerrno>
+#endif
+
 // Platform specific headers for handling extended attributes (xattr)
 #if defined(__APPLE__)
 #include <sys/xattr.h>
@@ -44,12 +53,15 @@ typedef short nlink_t;
 #include <windows.h>
 #endif
 
+#include <algorithm>
 #include <cstdio>   // for remove, rename
 #include <cassert>      /// \todo check usages of assert and try to cover the negative case with unit tests.
 #include <fcntl.h>      // _O_BINARY in FileIo::FileIo
 #include <ctime>        // timestamp for the name of temporary file
 #include <iostream>
 #include <fstream>      // write the temporary file
+#include <limits>
+#include <vector>
 
 #define mode_t unsigned short
 
@@ -120,6 +132,13 @@ namespace Exiv2
         //! stat wrapper for internal use
         int stat(StructStat& buf) const;
 
+        /*!
+          @brief Write \em count blocks of memory at the current position,
+              with one writev() call where it is available.
+          @return Number of bytes written
+         */
+        size_t writeBlocks(const IoBlock* blocks, size_t count);
+
         Impl& operator=(const Impl& rhs) = delete;
         Impl& operator=(const Impl&& rhs) = delete;
         Impl(const Impl& rhs) = delete;
@@ -202,6 +221,74 @@ namespace Exiv2
         return std::fseek(fp_, offset, SEEK_SET);
     }
 
+    size_t FileIo::Impl::writeBlocks(const IoBlock* blocks, size_t count)
+    {
+        size_t writeTotal = 0;
+#ifdef EXV_HAVE_WRITEV
+        // Small blocks are cheaper to add to the buffer of the stream
+        size_t size = 0;
+        for (size_t i = 0; i < count && size < BUFSIZ; ++i) {
+            size += blocks[i].size_;
+        }
+        if (size < BUFSIZ) {
+            for (size_t i = 0; i < count; ++i) {
+                const size_t writeCount = std::fwrite(blocks[i].data_, 1, blocks[i].size_, fp_);
+                writeTotal += writeCount;
+                if (writeCount != blocks[i].size_)
+                    break;
+            }
+            return writeTotal;
+        }
+        // Write past the stream to the file descriptor and continue the
+        // stream at the end of the data written
+        if (std::fflush(fp_) != 0)
+            return 0;
+        const int fd = fileno(fp_);
+        std::vector<iovec> iov;
+        iov.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (blocks[i].size_ > 0) {
+                iovec v;
+                v.iov_base = const_cast<byte*>(blocks[i].data_);
+                v.iov_len = blocks[i].size_;
+                iov.push_back(v);
+            }
+        }
+        size_t first = 0;
+        while (first < iov.size()) {
+            const int n = static_cast<int>(std::min(iov.size() - first, static_cast<size_t>(IOV_MAX)));
+            const ssize_t written = ::writev(fd, &iov[first], n);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                break;
+            writeTotal += static_cast<size_t>(written);
+            // Skip the blocks written, the rest of a block partly written is left
+            size_t rest = static_cast<size_t>(written);
+            while (first < iov.size() && rest >= iov[first].iov_len) {
+                rest -= iov[first].iov_len;
+                ++first;
+            }
+            if (rest > 0) {
+                iov[first].iov_base = static_cast<byte*>(iov[first].iov_base) + rest;
+                iov[first].iov_len -= rest;
+            }
+        }
+        // Positions past 2 GB do not fit in a long on 32 bit systems
+        const off_t pos = ::lseek(fd, 0, SEEK_CUR);
+        if (pos == -1 || ::fseeko(fp_, pos, SEEK_SET) != 0)
+            return 0;
+#else
+        for (size_t i = 0; i < count; ++i) {
+            const size_t writeCount = std::fwrite(blocks[i].data_, 1, blocks[i].size_, fp_);
+            writeTotal += writeCount;
+            if (writeCount != blocks[i].size_)
+                break;
+        }
+#endif
+        return writeTotal;
+    }
+
     int FileIo::Impl::stat(StructStat& buf) const
     {
         int ret = 0;
@@ -306,6 +393,7 @@ namespace Exiv2
         }
         p_->mappedLength_ = size();
         p_->isWriteable_ = isWriteable;
+        EXV_STATS_COUNT(ioMmap, p_->mappedLength_);
         if (p_->isWriteable_ && p_->switchMode(Impl::opWrite) != 0) {
 #ifdef EXV_UNICODE_PATH
             if (p_->wpMode_ == Impl::wpUnicode) {
@@ -455,7 +543,9 @@ namespace Exiv2
     {
         if (p_->fp_ == nullptr || p_->switchMode(Impl::opWrite) != 0)
             return 0;
-        return std::fwrite(data, 1, wcount, p_->fp_);
+        const size_t writeCount = std::fwrite(data, 1, wcount, p_->fp_);
+        EXV_STATS_COUNT(ioWrite, writeCount);
+        return writeCount;
     }
 
     size_t FileIo::write(BasicIo& src)
@@ -465,6 +555,12 @@ namespace Exiv2
             return 0;
         }
 
+        MemIo* memIo = dynamic_cast<MemIo*>(&src);
+        if (memIo) {
+            // Optimization if src is an instance of MemIo: write its blocks
+            return copyRange(src, memIo->size() - static_cast<size_t>(memIo->tell()));
+        }
+
         byte buf[4096];
         size_t readCount = 0;
         size_t writeTotal = 0;
@@ -481,6 +577,86 @@ namespace Exiv2
         return writeTotal;
     }
 
+    size_t FileIo::writev(const IoBlock* blocks, size_t count)
+    {
+        if (p_->fp_ == nullptr || p_->switchMode(Impl::opWrite) != 0)
+            return 0;
+        const size_t writeCount = p_->writeBlocks(blocks, count);
+        EXV_STATS_COUNT(ioWrite, writeCount);
+        return writeCount;
+    }
+
+    size_t FileIo::copyRange(BasicIo& src, size_t rcount)
+    {
+        if (p_->fp_ == nullptr || static_cast<BasicIo*>(this) == &src || !src.isopen() ||
+            p_->switchMode(Impl::opWrite) != 0) {
+            return 0;
+        }
+
+        MemIo* memIo = dynamic_cast<MemIo*>(&src);
+        if (memIo) {
+            // Write the blocks of the range as they are
+            const size_t start = static_cast<size_t>(memIo->tell());
+            std::vector<IoBlock> blocks = memIo->blocks();
+            size_t skip = start;
+            size_t first = 0;
+            while (first < blocks.size() && skip >= blocks[first].size_) {
+                skip -= blocks[first].size_;
+                ++first;
+            }
+            if (first == blocks.size())
+                return 0;
+            blocks[first].data_ += skip;
+            blocks[first].size_ -= skip;
+            size_t last = first;
+            size_t size = blocks[first].size_;
+            while (size < rcount && last + 1 < blocks.size()) {
+                size += blocks[++last].size_;
+            }
+            if (size > rcount)
+                blocks[last].size_ -= size - rcount;
+            const size_t writeTotal = p_->writeBlocks(&blocks[first], last - first + 1);
+            memIo->seek(static_cast<int64>(start + writeTotal), BasicIo::beg);
+            EXV_STATS_COUNT(ioWrite, writeTotal);
+            return writeTotal;
+        }
+
+#ifdef EXV_HAVE_COPY_FILE_RANGE
+        FileIo* fileIo = dynamic_cast<FileIo*>(&src);
+        if (fileIo && fileIo->p_->switchMode(Impl::opRead) == 0) {
+            // Copy in the kernel, between the positions of the streams
+            const off_t offIn = ::ftello(fileIo->p_->fp_);
+            const off_t offOut = ::ftello(p_->fp_);
+            if (offIn >= 0 && offOut >= 0 && std::fflush(p_->fp_) == 0) {
+                loff_t posIn = offIn;
+                loff_t posOut = offOut;
+                size_t copyTotal = 0;
+                bool failed = false;
+                while (copyTotal < rcount) {
+                    const ssize_t n = ::copy_file_range(fileno(fileIo->p_->fp_), &posIn, fileno(p_->fp_), &posOut,
+                                                        rcount - copyTotal, 0);
+                    if (n < 0 && errno == EINTR)
+                        continue;
+                    if (n < 0)
+                        failed = true;
+                    if (n <= 0)
+                        break;
+                    copyTotal += static_cast<size_t>(n);
+                }
+                ::fseeko(fileIo->p_->fp_, posIn, SEEK_SET);
+                ::fseeko(p_->fp_, posOut, SEEK_SET);
+                // Not supported for the files, e.g., across file systems on
+                // older kernels: copy through a buffer
+                if (!failed || copyTotal > 0) {
+                    EXV_STATS_COUNT(ioWrite, copyTotal);
+                    return copyTotal;
+                }
+            }
+        }
+#endif
+        return BasicIo::copyRange(src, rcount);
+    }
+
     void FileIo::transfer(BasicIo& src)
     {
         const bool wasOpen = (p_->fp_ != nullptr);
@@ -754,6 +930,7 @@ namespace Exiv2
     {
         if (p_->fp_ == nullptr || p_->switchMode(Impl::opWrite) != 0)
             return EOF;
+        EXV_STATS_COUNT(ioWrite, 1);
         return putc(data, p_->fp_);
     }
 
@@ -761,6 +938,7 @@ namespace Exiv2
     {
         if (p_->switchMode(Impl::opSeek) != 0)
             return 1;
+        EXV_STATS_COUNT(ioSeek, 0);
 
         int fileSeek = 0;
         switch (pos) {
@@ -868,13 +1046,16 @@ namespace Exiv2
         if (p_->fp_ == nullptr || p_->switchMode(Impl::opRead) != 0) {
             return 0;
         }
-        return std::fread(buf, 1, rcount, p_->fp_);
+        const size_t readCount = std::fread(buf, 1, rcount, p_->fp_);
+        EXV_STATS_COUNT(ioRead, readCount);
+        return readCount;
     }
 
     int FileIo::getb()
     {
         if (p_->fp_ == nullptr || p_->switchMode(Impl::opRead) != 0)
             return EOF;
+        EXV_STATS_COUNT(ioRead, 1);
         return getc(p_->fp_);
     }
 
@@ -1081,4 +1262,162 @@ namespace Exiv2
         return XPathIo::writeDataToFile(orgPath);
     }
 #endif
+
+    namespace {
+        //! Argument of StdinIo::fill() to read all of the input
+        const size_t allOfTheInput = std::numeric_limits<size_t>::max();
+
+        //! Return the end of \em count bytes at \em position, limited to allOfTheInput
+        size_t endOf(int64 position, size_t count)
+        {
+            const size_t pos = static_cast<size_t>(position);
+            return count > allOfTheInput - pos ? allOfTheInput : pos + count;
+        }
+    }
+
+    StdinIo::StdinIo()
+        : input_(stdin)
+    {
+        if (isatty(fileno(stdin)))
+            throw Error(kerInputDataReadFailed);
+#if defined(_MSC_VER) || defined(__MINGW__)
+        // convert stdin to binary
+        if (_setmode(_fileno(stdin), _O_BINARY) == -1)
+            throw Error(kerInputDataReadFailed);
+#endif
+    }
+
+    StdinIo::StdinIo(std::FILE* input)
+        : input_(input)
+    {
+    }
+
+    void StdinIo::fill(size_t minSize)
+    {
+        byte buf[64 * 1024];
+        while (input_ != nullptr && MemIo::size() < minSize) {
+            // fread returns less than requested only at the end of the input or on an error
+            const size_t count = std::fread(buf, 1, sizeof(buf), input_);
+            if (count < sizeof(buf) && std::ferror(input_)) {
+                throw Error(kerInputDataReadFailed);
+            }
+            append(buf, count);
+            if (count < sizeof(buf)) {
+                input_ = nullptr;
+            }
+        }
+    }
+
+    size_t StdinIo::write(const byte* data, size_t wcount)
+    {
+        fill(allOfTheInput);
+        return MemIo::write(data, wcount);
+    }
+
+    size_t StdinIo::write(BasicIo& src)
+    {
+        fill(allOfTheInput);
+        return MemIo::write(src);
+    }
+
+    int StdinIo::putb(byte data)
+    {
+        fill(allOfTheInput);
+        return MemIo::putb(data);
+    }
+
+    DataBuf StdinIo::read(size_t rcount) noexcept
+    {
+        try {
+            fill(endOf(tell(), rcount));
+            // Like MemIo::read(), without reading all of the input for the size
+            if (rcount > MemIo::size()) {
+                return {};
+            }
+            DataBuf buf(rcount);
+            buf.size_ = read(buf.pData_, buf.size_);
+            return buf;
+        } catch (const AnyError&) {
+            return {};
+        }
+    }
+
+    size_t StdinIo::read(byte* buf, size_t rcount)
+    {
+        fill(endOf(tell(), rcount));
+        return MemIo::read(buf, rcount);
+    }
+
+    int StdinIo::getb()
+    {
+        fill(endOf(tell(), 1));
+        return MemIo::getb();
+    }
+
+    void StdinIo::transfer(BasicIo& src)
+    {
+        input_ = nullptr;
+        MemIo::transfer(src);
+    }
+
+    int StdinIo::seek(int64 offset, Position pos)
+    {
+        switch (pos) {
+            case BasicIo::beg:
+                if (offset > 0)
+                    fill(endOf(0, static_cast<size_t>(offset)));
+                break;
+            case BasicIo::cur:
+                if (offset > 0)
+                    fill(endOf(tell(), static_cast<size_t>(offset)));
+                break;
+            case BasicIo::end:
+                fill(allOfTheInput);
+                break;
+        }
+        return MemIo::seek(offset, pos);
+    }
+
+    byte* StdinIo::mmap(bool isWriteable)
+    {
+        fill(allOfTheInput);
+        return MemIo::mmap(isWriteable);
+    }
+
+    size_t StdinIo::writev(const IoBlock* blocks, size_t count)
+    {
+        fill(allOfTheInput);
+        return MemIo::writev(blocks, count);
+    }
+
+    size_t StdinIo::copyRange(BasicIo& src, size_t rcount)
+    {
+        fill(allOfTheInput);
+        return MemIo::copyRange(src, rcount);
+    }
+
+    std::vector<IoBlock> StdinIo::blocks()
+    {
+        fill(allOfTheInput);
+        return MemIo::blocks();
+    }
+
+    size_t StdinIo::size() const
+    {
+        // Reading the input only completes the data in memory, it doesn't change it
+        const_cast<StdinIo*>(this)->fill(allOfTheInput);
+        return MemIo::size();
+    }
+
+    std::string StdinIo::path() const
+    {
+        return "-";
+    }
+
+#ifdef EXV_UNICODE_PATH
+    std::wstring StdinIo::wpath() const
+    {
+        return EXV_WIDEN("-");
+    }
+#endif
 }
@@ -20,8 +20,11 @@
 #include "basicio.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 
+#include <algorithm>
 #include <cstring>  // std::memcpy
+#include <vector>
 #include <cassert>      /// \todo check usages of assert and try to cover the negative case with unit tests.
 
 namespace Exiv2
@@ -32,9 +35,17 @@ namespace Exiv2
     public:
         Impl() = default;
         Impl(const byte* data, size_t size)
-            : data_(const_cast<byte*>(data))
-            , size_(size)
+            : size_(size)
         {
+            if (data != nullptr) {
+                Block block = {const_cast<byte*>(data), 0, size};
+                blocks_.push_back(block);
+                sizeAlloced_ = size;
+            }
+        }
+        ~Impl()
+        {
+            release();
         }
 
         Impl& operator=(const Impl& rhs) = delete;
@@ -42,16 +53,33 @@ namespace Exiv2
         Impl(const Impl& rhs) = delete;
         Impl(const Impl&& rhs) = delete;
 
+        //! A block of the memory area
+        struct Block {
+            byte* data_;     //!< Start of the block
+            size_t offset_;  //!< Offset of the block in the memory area
+            size_t size_;    //!< Size of the block
+        };
+
         // DATA
-        byte* data_{nullptr};     //!< Pointer to the start of the memory area
-        size_t idx_{0};           //!< Index into the memory area
-        size_t size_{0};          //!< Size of the memory area
-        size_t sizeAlloced_{0};   //!< Size of the allocated buffer
-        bool isMalloced_{false};  //!< Was the buffer allocated?
-        bool eof_{false};         //!< EOF indicator
+        std::vector<Block> blocks_;  //!< The memory area, one block until it grows
+        size_t idx_{0};              //!< Index into the memory area
+        size_t size_{0};             //!< Size of the data in the memory area
+        size_t sizeAlloced_{0};      //!< Size of all blocks
+        bool isMalloced_{false};     //!< Were the blocks allocated? Else there is at most one, borrowed block
+        bool eof_{false};            //!< EOF indicator
 
         // METHODS
         void reserve(size_t wcount);  //!< Reserve memory
+        //! Return the index of the block which contains \em offset, which must be less than sizeAlloced_
+        size_t find(size_t offset) const;
+        //! Copy \em count bytes of \em data to the memory area at idx_, which must have room for them
+        void copyIn(const byte* data, size_t count);
+        //! Copy \em count bytes of the memory area at idx_ to \em buf, they must be in the memory area
+        void copyOut(byte* buf, size_t count) const;
+        //! Join the blocks into one, return the start of the memory area
+        byte* linearise();
+        //! Free the blocks, if they were allocated, and forget them
+        void release();
     };
 
     void MemIo::Impl::reserve(size_t wcount)
@@ -67,32 +95,110 @@ namespace Exiv2
             if (data == nullptr) {
                 throw Error(kerMallocFailed);
             }
-            if (data_ != nullptr) {
-                std::memcpy(data, data_, size_);
+            if (size_ > 0 && !blocks_.empty()) {
+                std::memcpy(data, blocks_[0].data_, size_);
             }
-            data_ = data;
+            Block block = {data, 0, size};
+            blocks_.assign(1, block);
             sizeAlloced_ = size;
             isMalloced_ = true;
         }
 
         if (need > size_) {
             if (need > sizeAlloced_) {
-                blockSize = 2 * sizeAlloced_;
-                if (blockSize > maxBlockSize)
-                    blockSize = maxBlockSize;
-                // Allocate in blocks
-                size_t want = blockSize * (1 + need / blockSize);
-                data_ = (byte*)std::realloc(data_, want);
-                if (data_ == nullptr) {
+                // Append a block, the data in the blocks already allocated is
+                // not moved. The blocks double in size up to maxBlockSize.
+                blockSize = std::min(std::max(sizeAlloced_, blockSize), maxBlockSize);
+                const size_t want = std::max(blockSize, need - sizeAlloced_);
+                byte* data = (byte*)std::malloc(want);
+                if (data == nullptr) {
                     throw Error(kerMallocFailed);
                 }
-                sizeAlloced_ = want;
-                isMalloced_ = true;
+                Block block = {data, sizeAlloced_, want};
+                blocks_.push_back(block);
+                sizeAlloced_ += want;
             }
             size_ = need;
         }
     }
 
+    size_t MemIo::Impl::find(size_t offset) const
+    {
+        if (blocks_.size() == 1) {
+            return 0;
+        }
+        // The last block which starts at or before offset
+        size_t lo = 0;
+        size_t hi = blocks_.size();
+        while (hi - lo > 1) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (blocks_[mid].offset_ <= offset) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    void MemIo::Impl::copyIn(const byte* data, size_t count)
+    {
+        size_t pos = idx_;
+        for (size_t i = find(pos); count > 0; ++i) {
+            const Block& block = blocks_[i];
+            const size_t n = std::min(count, block.offset_ + block.size_ - pos);
+            std::memcpy(block.data_ + (pos - block.offset_), data, n);
+            data += n;
+            pos += n;
+            count -= n;
+        }
+    }
+
+    void MemIo::Impl::copyOut(byte* buf, size_t count) const
+    {
+        size_t pos = idx_;
+        for (size_t i = find(pos); count > 0; ++i) {
+            const Block& block = blocks_[i];
+            const size_t n = std::min(count, block.offset_ + block.size_ - pos);
+            std::memcpy(buf, block.data_ + (pos - block.offset_), n);
+            buf += n;
+            pos += n;
+            count -= n;
+        }
+    }
+
+    byte* MemIo::Impl::linearise()
+    {
+        if (blocks_.size() > 1) {
+            byte* data = (byte*)std::malloc(size_);
+            if (data == nullptr) {
+                throw Error(kerMallocFailed);
+            }
+            const size_t idx = idx_;
+            idx_ = 0;
+            copyOut(data, size_);
+            idx_ = idx;
+            release();
+            Block block = {data, 0, size_};
+            blocks_.push_back(block);
+            sizeAlloced_ = size_;
+            isMalloced_ = true;
+        }
+        return blocks_.empty() ? nullptr : blocks_[0].data_;
+    }
+
+    void MemIo::Impl::release()
+    {
+        if (isMalloced_) {
+            for (auto&& block : blocks_) {
+                std::free(block.data_);
+            }
+        }
+        blocks_.clear();
+        sizeAlloced_ = 0;
+        isMalloced_ = false;
+    }
+
     MemIo::MemIo()
         : p_(new Impl())
     {
@@ -103,21 +209,17 @@ namespace Exiv2
     {
     }
 
-    MemIo::~MemIo()
-    {
-        if (p_->isMalloced_) {
-            std::free(p_->data_);
-        }
-    }
+    MemIo::~MemIo() = default;
 
     size_t MemIo::write(const byte* data, size_t wcount)
     {
         p_->reserve(wcount);
         assert(p_->isMalloced_);
         if (data != nullptr) {
-            std::memcpy(&p_->data_[p_->idx_], data, wcount);
+            p_->copyIn(data, wcount);
         }
         p_->idx_ += wcount;
+        EXV_STATS_COUNT(ioWrite, wcount);
         return wcount;
     }
 
@@ -139,21 +241,67 @@ namespace Exiv2
         return writeTotal;
     }
 
+    size_t MemIo::writev(const IoBlock* blocks, size_t count)
+    {
+        size_t wcount = 0;
+        for (size_t i = 0; i < count; ++i) {
+            wcount += blocks[i].size_;
+        }
+        p_->reserve(wcount);
+        assert(p_->isMalloced_);
+        for (size_t i = 0; i < count; ++i) {
+            if (blocks[i].data_ != nullptr) {
+                p_->copyIn(blocks[i].data_, blocks[i].size_);
+            }
+            p_->idx_ += blocks[i].size_;
+        }
+        EXV_STATS_COUNT(ioWrite, wcount);
+        return wcount;
+    }
+
+    size_t MemIo::copyRange(BasicIo& src, size_t rcount)
+    {
+        if (static_cast<BasicIo*>(this) == &src || rcount == 0)
+            return 0;
+        const size_t size = p_->size_;
+        p_->reserve(rcount);
+        assert(p_->isMalloced_);
+        // Read the data straight into the blocks
+        size_t copyTotal = 0;
+        try {
+            for (size_t i = p_->find(p_->idx_); copyTotal < rcount; ++i) {
+                const Impl::Block& block = p_->blocks_[i];
+                const size_t pos = p_->idx_ + copyTotal;
+                const size_t n = std::min(rcount - copyTotal, block.offset_ + block.size_ - pos);
+                const size_t readCount = src.read(block.data_ + (pos - block.offset_), n);
+                copyTotal += readCount;
+                if (readCount != n)
+                    break;
+            }
+        } catch (const AnyError&) {
+            p_->size_ = std::max(size, p_->idx_ + copyTotal);
+            throw;
+        }
+        p_->idx_ += copyTotal;
+        p_->size_ = std::max(size, p_->idx_);
+        EXV_STATS_COUNT(ioWrite, copyTotal);
+        return copyTotal;
+    }
+
     void MemIo::transfer(BasicIo& src)
     {
         MemIo* memIo = dynamic_cast<MemIo*>(&src);
         if (memIo) {
             // Optimization if src is another instance of MemIo
-            if (p_->isMalloced_) {
-                std::free(p_->data_);
-            }
+            p_->release();
             p_->idx_ = 0;
-            p_->data_ = memIo->p_->data_;
+            p_->blocks_.swap(memIo->p_->blocks_);
             p_->size_ = memIo->p_->size_;
+            p_->sizeAlloced_ = memIo->p_->sizeAlloced_;
             p_->isMalloced_ = memIo->p_->isMalloced_;
             memIo->p_->idx_ = 0;
-            memIo->p_->data_ = 0;
             memIo->p_->size_ = 0;
+            memIo->p_->sizeAlloced_ = 0;
             memIo->p_->isMalloced_ = false;
         } else {
             // Generic reopen to reset position to start
@@ -168,16 +316,28 @@ namespace Exiv2
             throw Error(kerMemoryTransferFailed, strError());
     }
 
+    void MemIo::append(const byte* data, size_t count)
+    {
+        const size_t idx = p_->idx_;
+        p_->idx_ = p_->size_;
+        p_->reserve(count);
+        p_->copyIn(data, count);
+        p_->idx_ = idx;
+    }
+
     int MemIo::putb(byte data)
     {
         p_->reserve(1);
         assert(p_->isMalloced_);
-        p_->data_[p_->idx_++] = data;
+        const Impl::Block& block = p_->blocks_[p_->find(p_->idx_)];
+        block.data_[p_->idx_++ - block.offset_] = data;
+        EXV_STATS_COUNT(ioWrite, 1);
         return data;
     }
 
     int MemIo::seek(int64 offset, Position pos)
     {
+        EXV_STATS_COUNT(ioSeek, 0);
         int64 newIdx = 0;
 
         switch (pos) {
@@ -207,7 +367,22 @@ namespace Exiv2
 
     byte* MemIo::mmap(bool /*isWriteable*/)
     {
-        return p_->data_;
+        EXV_STATS_COUNT(ioMmap, p_->size_);
+        return p_->linearise();
+    }
+
+    std::vector<IoBlock> MemIo::blocks()
+    {
+        std::vector<IoBlock> blocks;
+        blocks.reserve(p_->blocks_.size());
+        for (auto&& block : p_->blocks_) {
+            if (block.offset_ >= p_->size_) {
+                break;
+            }
+            IoBlock ioBlock = {block.data_, std::min(block.size_, p_->size_ - block.offset_)};
+            blocks.push_back(ioBlock);
+        }
+        return blocks;
     }
 
     int MemIo::munmap()
@@ -258,13 +433,14 @@ namespace Exiv2
     {
         size_t avail = std::max(p_->size_ - p_->idx_, 0_z);
         size_t allow = std::min(rcount, avail);
-        if (p_->data_ == nullptr) {
+        if (p_->blocks_.empty()) {
             throw Error(kerCallFailed, "std::memcpy with src == nullptr");
         }
-        std::memcpy(buf, &p_->data_[p_->idx_], allow);
+        p_->copyOut(buf, allow);
         p_->idx_ += allow;
         if (rcount > avail)
             p_->eof_ = true;
+        EXV_STATS_COUNT(ioRead, allow);
         return allow;
     }
 
@@ -274,7 +450,9 @@ namespace Exiv2
             p_->eof_ = true;
             return EOF;
         }
-        return p_->data_[p_->idx_++];
+        EXV_STATS_COUNT(ioRead, 1);
+        const Impl::Block& block = p_->blocks_[p_->find(p_->idx_)];
+        return block.data_[p_->idx_++ - block.offset_];
     }
 
     int MemIo::error() const
@@ -36,7 +36,10 @@
 // + standard includes
 #include <sys/stat.h>   // for stat()
 #include <sys/types.h>  // for stat()
+#include <cstdio>
 #include <fstream>
+#include <string>
+#include <vector>
 #ifdef EXV_HAVE_UNISTD_H
 #include <unistd.h>  // for stat()
 #endif
@@ -136,6 +139,14 @@ namespace
      */
     int dontOverwrite(const std::string& path);
 
+    /*!
+      @brief Write the data of \em image to stdout if it was read from stdin
+             (\em path is "-"), to use exiv2 as a filter in a pipeline:
+             exiv2 -M"set Exif.Image.Artist Me" - < in.jpg > out.jpg
+             The messages of the action are sent to stderr meanwhile.
+     */
+    void pipeToStdout(const std::string& path, Exiv2::Image* image);
+
     /*!
       @brief Output a text with a given minimum number of chars, honoring
              multi-byte characters correctly. Replace code in the form
@@ -147,6 +158,49 @@ namespace
 
     //! Print image Structure information
     int printStructure(std::ostream& out, Exiv2::PrintStructureOption option, const std::string& path);
+
+    /*!
+      @brief Buffered writer of the records of the print modes j and b. A
+             record has the file, key, type, count, raw bytes and interpreted
+             value of a metadatum.
+
+      JSON lines are objects with the members "file", "key", "type" (the
+      type name), "count", "raw" (base64) and "value". Binary records are a
+      32 bit length of the rest of the record, the 16 bit type id, the 32 bit
+      count and, each with a 32 bit length, the file, key, raw bytes and
+      value. All numbers are little endian. Suppressed values are null in
+      JSON and have the length 0xffffffff.
+     */
+    class RecordWriter
+    {
+    public:
+        //! C'tor, writes binary records if \em binary is true, else JSON lines
+        RecordWriter(std::ostream& os, bool binary);
+        //! D'tor, writes the buffered records
+        ~RecordWriter();
+        //! Add a record, \em raw and \em value are 0 if the value is suppressed
+        void add(const std::string& file, const std::string& key, const Exiv2::Metadatum& md,
+                 const std::vector<Exiv2::byte>* raw, const std::string* value);
+        //! Write the buffered records to the stream
+        void flush();
+
+    private:
+        void addJson(const std::string& file, const std::string& key, const Exiv2::Metadatum& md,
+                     const std::vector<Exiv2::byte>* raw, const std::string* value);
+        void addBinary(const std::string& file, const std::string& key, const Exiv2::Metadatum& md,
+                       const std::vector<Exiv2::byte>* raw, const std::string* value);
+        //! Append \em n bytes of \em value, little endian
+        void appendNumber(uint32_t value, int n);
+        //! Append a binary field with its length, null for none
+        void appendField(const char* data, size_t size);
+        //! Append a JSON string, invalid UTF-8 bytes are escaped as Latin-1 characters
+        void appendJsonString(const std::string& str);
+
+        std::ostream& os_;
+        bool binary_;
+        std::string buf_;
+        std::vector<char> base64_;
+    };
 }  // namespace
 
 // *****************************************************************************
@@ -229,6 +283,16 @@ namespace Action
                 case Params::pmRecursive:
                     rc = printStructure(std::cout, Exiv2::kpsRecursive, path_);
                     break;
+                case Params::pmStructureJson:
+                    rc = printStructure(std::cout, Exiv2::kpsJson, path_);
+                    break;
+                case Params::pmListJson:
+                    rc = printRecords(false);
+                    break;
+                case Params::pmListBinary:
+                    _setmode(_fileno(stdout), O_BINARY);
+                    rc = printRecords(true);
+                    break;
                 case Params::pmXMP:
                     if (option == Exiv2::kpsNone)
                         option = Exiv2::kpsXMP;
@@ -491,6 +555,64 @@ namespace Action
         return printMetadata(image.get());
     }
 
+    int Print::printRecords(bool binary)
+    {
+        if (!Exiv2::fileExists(path_, true)) {
+            std::cerr << path_ << ": " << _("Failed to open the file\n");
+            return -1;
+        }
+        Exiv2::Image::UniquePtr image = Exiv2::ImageFactory::open(path_);
+        assert(image.get() != 0);
+        image->readMetadata();
+
+        const Params& params = Params::instance();
+        const Exiv2::ExifData& exifData = image->exifData();
+        RecordWriter writer(std::cout, binary);
+        std::vector<Exiv2::byte> raw;
+        std::string value;
+        bool ret = false;
+        auto print = [&](const Exiv2::Metadatum& md) {
+            const std::string key = md.key();
+            if (!grepTag(key) || !keyTag(key))
+                return;
+            if (params.unknown_ && md.tagName().substr(0, 2) == "0x")
+                return;
+            ret = true;
+            if (params.binary_ && md.size() > 128 &&
+                (md.typeId() == Exiv2::undefined || md.typeId() == Exiv2::unsignedByte ||
+                 md.typeId() == Exiv2::signedByte)) {
+                writer.add(path_, key, md, nullptr, nullptr);
+                return;
+            }
+            if (md.familyName()[0] == 'X') {
+                // XMP values have no binary form, the raw bytes are the text
+                const std::string text = md.toString();
+                raw.assign(text.begin(), text.end());
+            } else {
+                raw.resize(md.size());
+                if (!raw.empty())
+                    md.copy(&raw[0], image->byteOrder());
+            }
+            const Exiv2::CommentValue* pcv = nullptr;
+            if (key == "Exif.Photo.UserComment")
+                pcv = dynamic_cast<const Exiv2::CommentValue*>(&md.value());
+            value = pcv ? pcv->comment(params.charset_.c_str()) : md.print(&exifData);
+            writer.add(path_, key, md, &raw, &value);
+        };
+        for (auto&& md : exifData) {
+            print(md);
+        }
+        for (auto&& md : image->iptcData()) {
+            print(md);
+        }
+        for (auto&& md : image->xmpData()) {
+            print(md);
+        }
+
+        // With -g or -K, return 1 if no matching tags were found
+        return (!params.greps_.empty() || !params.keys_.empty()) && !ret ? 1 : 0;
+    }
+
     int Print::printMetadata(const Exiv2::Image* image)
     {
         bool ret = false;
@@ -882,6 +1004,7 @@ namespace Action
 
         if (0 == rc) {
             image->writeMetadata();
+            pipeToStdout(path, image.get());
             if (Params::instance().preserve_)
                 ts.touch(path);
         }
@@ -1058,7 +1181,7 @@ namespace Action
             if (*n == 0) {
                 // Write all previews
                 for (int num = 0; num < static_cast<int>(pvList.size()); ++num) {
-                    writePreviewFile(pvMgr.getPreviewImage(pvList[num]), num + 1);
+                    writePreviewFile(pvMgr, pvList[num], num + 1);
                 }
                 break;
             }
@@ -1066,7 +1189,7 @@ namespace Action
                 std::cerr << path_ << ": " << _("Image does not have preview") << " " << *n << "\n";
                 continue;
             }
-            writePreviewFile(pvMgr.getPreviewImage(pvList[*n - 1]), *n);
+            writePreviewFile(pvMgr, pvList[*n - 1], *n);
         }
         return 0;
     }
@@ -1104,20 +1227,21 @@ namespace Action
         return rc;
     }
 
-    void Extract::writePreviewFile(const Exiv2::PreviewImage& pvImg, int num) const
+    void Extract::writePreviewFile(const Exiv2::PreviewManager& pvMgr,
+                                   const Exiv2::PreviewProperties& pvProps, int num) const
     {
         std::string pvFile = newFilePath(path_, "-preview") + Exiv2::toString(num);
-        std::string pvPath = pvFile + pvImg.extension();
+        std::string pvPath = pvFile + pvProps.extension_;
         if (dontOverwrite(pvPath))
             return;
         if (Params::instance().verbose_) {
-            std::cout << _("Writing preview") << " " << num << " (" << pvImg.mimeType() << ", ";
-            if (pvImg.width() != 0 && pvImg.height() != 0) {
-                std::cout << pvImg.width() << "x" << pvImg.height() << " " << _("pixels") << ", ";
+            std::cout << _("Writing preview") << " " << num << " (" << pvProps.mimeType_ << ", ";
+            if (pvProps.width_ != 0 && pvProps.height_ != 0) {
+                std::cout << pvProps.width_ << "x" << pvProps.height_ << " " << _("pixels") << ", ";
             }
-            std::cout << pvImg.size() << " " << _("bytes") << ") " << _("to file") << " " << pvPath << std::endl;
+            std::cout << pvProps.size_ << " " << _("bytes") << ") " << _("to file") << " " << pvPath << std::endl;
         }
-        const size_t rc = pvImg.writeFile(pvFile);
+        const size_t rc = pvMgr.writePreviewImage(pvProps, pvFile);
         if (rc == 0) {
             std::cerr << path_ << ": " << _("Image does not have preview") << " " << num << "\n";
         }
@@ -1316,6 +1440,7 @@ namespace Action
 
             // Save both exif and iptc metadata
             image->writeMetadata();
+            pipeToStdout(path, image.get());
 
             if (Params::instance().preserve_)
                 ts.touch(path);
@@ -1536,6 +1661,7 @@ namespace Action
 
         if (rc == 0) {
             image->writeMetadata();
+            pipeToStdout(path, image.get());
             if (Params::instance().preserve_)
                 ts.touch(path);
         }
@@ -1671,6 +1797,7 @@ namespace Action
                 exifData["Exif.Photo.ISOSpeedRatings"] = os.str();
             }
             image->writeMetadata();
+            pipeToStdout(path, image.get());
             if (Params::instance().preserve_)
                 ts.touch(path);
 
@@ -1739,6 +1866,7 @@ namespace Action
             // Remove BOM and convert value from source charset to UCS-2, but keep byte order
             pos->setValue(comment);
             image->writeMetadata();
+            pipeToStdout(path, image.get());
             if (Params::instance().preserve_)
                 ts.touch(path);
 
@@ -2154,6 +2282,22 @@ namespace
         return 0;
     }
 
+    void pipeToStdout(const std::string& path, Exiv2::Image* image)
+    {
+        if (path != "-")
+            return;
+        Exiv2::BasicIo& io = image->io();
+        if (io.open() != 0) {
+            throw Exiv2::Error(Exiv2::kerDataSourceOpenFailed, io.path(), Exiv2::strError());
+        }
+        Exiv2::IoCloser closer(io);
+        const Exiv2::byte* data = io.mmap();
+        // Not through std::cout, which carries the messages to stderr meanwhile
+        _setmode(_fileno(stdout), O_BINARY);
+        std::fwrite(data, 1, io.size(), stdout);
+        std::fflush(stdout);
+    }
+
     std::ostream& operator<<(std::ostream& os, std::pair<std::string, int> strAndWidth)
     {
         const std::string& str(strAndWidth.first);
@@ -2175,4 +2319,169 @@ namespace
         image->printStructure(out, option);
         return 0;
     }
+
+    RecordWriter::RecordWriter(std::ostream& os, bool binary) : os_(os), binary_(binary)
+    {
+    }
+
+    RecordWriter::~RecordWriter()
+    {
+        flush();
+    }
+
+    void RecordWriter::add(const std::string& file, const std::string& key, const Exiv2::Metadatum& md,
+                           const std::vector<Exiv2::byte>* raw, const std::string* value)
+    {
+        if (binary_) {
+            addBinary(file, key, md, raw, value);
+        } else {
+            addJson(file, key, md, raw, value);
+        }
+        if (buf_.size() >= 64 * 1024) {
+            flush();
+        }
+    }
+
+    void RecordWriter::flush()
+    {
+        os_.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+        os_.flush();
+        buf_.clear();
+    }
+
+    void RecordWriter::addJson(const std::string& file, const std::string& key, const Exiv2::Metadatum& md,
+                               const std::vector<Exiv2::byte>* raw, const std::string* value)
+    {
+        buf_ += "{\"file\":";
+        appendJsonString(file);
+        buf_ += ",\"key\":";
+        appendJsonString(key);
+        buf_ += ",\"type\":";
+        const char* typeName = md.typeName();
+        char typeId[12];
+        if (!typeName) {
+            std::snprintf(typeId, sizeof(typeId), "0x%04x", md.typeId());
+            typeName = typeId;
+        }
+        appendJsonString(typeName);
+        buf_ += ",\"count\":";
+        buf_ += std::to_string(md.count());
+        buf_ += ",\"raw\":";
+        if (raw) {
+            base64_.resize(4 * ((raw->size() + 2) / 3) + 1);
+            Exiv2::base64encode(raw->empty() ? nullptr : &(*raw)[0], raw->size(), &base64_[0], base64_.size());
+            buf_ += '"';
+            buf_ += &base64_[0];
+            buf_ += '"';
+        } else {
+            buf_ += "null";
+        }
+        buf_ += ",\"value\":";
+        if (value) {
+            appendJsonString(*value);
+        } else {
+            buf_ += "null";
+        }
+        buf_ += "}\n";
+    }
+
+    void RecordWriter::addBinary(const std::string& file, const std::string& key, const Exiv2::Metadatum& md,
+                                 const std::vector<Exiv2::byte>* raw, const std::string* value)
+    {
+        const size_t start = buf_.size();
+        appendNumber(0, 4);
+        appendNumber(md.typeId(), 2);
+        appendNumber(static_cast<uint32_t>(md.count()), 4);
+        appendField(file.data(), file.size());
+        appendField(key.data(), key.size());
+        if (raw) {
+            appendField(reinterpret_cast<const char*>(raw->empty() ? nullptr : &(*raw)[0]), raw->size());
+        } else {
+            appendNumber(0xffffffff, 4);
+        }
+        if (value) {
+            appendField(value->data(), value->size());
+        } else {
+            appendNumber(0xffffffff, 4);
+        }
+        const size_t length = buf_.size() - start - 4;
+        for (int i = 0; i < 4; ++i) {
+            buf_[start + i] = static_cast<char>(length >> (8 * i));
+        }
+    }
+
+    void RecordWriter::appendNumber(uint32_t value, int n)
+    {
+        for (int i = 0; i < n; ++i) {
+            buf_ += static_cast<char>(value >> (8 * i));
+        }
+    }
+
+    void RecordWriter::appendField(const char* data, size_t size)
+    {
+        appendNumber(static_cast<uint32_t>(size), 4);
+        buf_.append(data, size);
+    }
+
+    void RecordWriter::appendJsonString(const std::string& str)
+    {
+        static const char hex[] = "0123456789abcdef";
+        buf_ += '"';
+        const size_t size = str.size();
+        for (size_t i = 0; i < size;) {
+            const unsigned char c = static_cast<unsigned char>(str[i]);
+            if (c >= 0x20 && c < 0x80) {
+                if (c == '"' || c == '\\')
+                    buf_ += '\\';
+                buf_ += static_cast<char>(c);
+                ++i;
+                continue;
+            }
+            // Length of a valid UTF-8 sequence starting at i, 0 if there is none
+            size_t n = 0;
+            if (c >= 0xc2 && c <= 0xdf)
+                n = 2;
+            else if (c >= 0xe0 && c <= 0xef)
+                n = 3;
+            else if (c >= 0xf0 && c <= 0xf4)
+                n = 4;
+            if (n > size - i)
+                n = 0;
+            for (size_t j = 1; j < n; ++j) {
+                if ((static_cast<unsigned char>(str[i + j]) & 0xc0) != 0x80)
+                    n = 0;
+            }
+            if (n > 2) {
+                // No overlong forms, surrogates or code points above U+10FFFF
+                const unsigned char c1 = static_cast<unsigned char>(str[i + 1]);
+                if ((c == 0xe0 && c1 < 0xa0) || (c == 0xed && c1 > 0x9f) || (c == 0xf0 && c1 < 0x90) ||
+                    (c == 0xf4 && c1 > 0x8f))
+                    n = 0;
+            }
+            if (n > 0) {
+                buf_.append(str, i, n);
+                i += n;
+                continue;
+            }
+            // Control characters and invalid UTF-8 bytes
+            switch (c) {
+                case '\n':
+                    buf_ += "\\n";
+                    break;
+                case '\r':
+                    buf_ += "\\r";
+                    break;
+                case '\t':
+                    buf_ += "\\t";
+                    break;
+                default:
+                    buf_ += "\\u00";
+                    buf_ += hex[c >> 4];
+                    buf_ += hex[c & 0xf];
+                    break;
+            }
+            ++i;
+        }
+        buf_ += '"';
+    }
 }  // namespace
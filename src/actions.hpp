@@ -132,6 +132,8 @@ namespace Action
         int printSummary();
         //! Print Exif, IPTC and XMP metadata in user defined format
         int printList();
+        //! Print Exif, IPTC and XMP metadata as JSON lines or binary records
+        int printRecords(bool binary);
         //! Return true if key should be printed, else false
         bool grepTag(const std::string& key);
         //! Return true if key should be printed, else false
@@ -226,7 +228,8 @@ namespace Action
         //! @brief Write one preview image to a file. The filename is composed by removing the suffix from the image
         //! filename and appending "-preview<num>" and the appropriate suffix (".jpg" or ".tif"), depending on the
         //! format of the Exif thumbnail image.
-        void writePreviewFile(const Exiv2::PreviewImage& pvImg, int num) const;
+        void writePreviewFile(const Exiv2::PreviewManager& pvMgr,
+                              const Exiv2::PreviewProperties& pvProps, int num) const;
         //! @brief Write embedded iccProfile files.
         int writeIccProfile(const std::string& path) const;
 
@@ -21,6 +21,8 @@
 #include "enforce.hpp"
 #include "error.hpp"
 
+#include <algorithm>
+
 namespace Exiv2
 {
     BasicIo::BasicIo()
@@ -35,6 +37,39 @@ namespace Exiv2
         enforce(!error(), kerInputDataReadFailed);
     }
 
+    size_t BasicIo::writev(const IoBlock* blocks, size_t count)
+    {
+        size_t writeTotal = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const size_t writeCount = write(blocks[i].data_, blocks[i].size_);
+            writeTotal += writeCount;
+            if (writeCount != blocks[i].size_)
+                break;
+        }
+        return writeTotal;
+    }
+
+    size_t BasicIo::copyRange(BasicIo& src, size_t rcount)
+    {
+        if (this == &src)
+            return 0;
+        byte buf[64 * 1024];
+        size_t copyTotal = 0;
+        while (copyTotal < rcount) {
+            const size_t readCount = src.read(buf, std::min(sizeof(buf), rcount - copyTotal));
+            if (readCount == 0)
+                break;
+            const size_t writeCount = write(buf, readCount);
+            copyTotal += writeCount;
+            if (writeCount != readCount) {
+                // try to reset back to where write stopped
+                src.seek(static_cast<int64>(writeCount) - static_cast<int64>(readCount), BasicIo::cur);
+                break;
+            }
+        }
+        return copyTotal;
+    }
+
     IoCloser::IoCloser(BasicIo& bio)
         : bio_(bio)
     {
@@ -3,12 +3,17 @@
 #include "safe_op.hpp"
 #include "exif.hpp"
 #include "error.hpp"
+#include "futils.hpp"
+#include "stats_int.hpp"
 #include "image_int.hpp"
 #include "enforce.hpp"
+#include "tiffcomposite_int.hpp"
+#include "tiffimage_int.hpp"
 
 #include <cassert>
 #include <limits>
 #include <iostream>
+#include <sstream>
 
 namespace Exiv2
 {
@@ -165,12 +170,49 @@ namespace Exiv2
                 // overrides
                 void readMetadata()
                 {
-
+                    EXV_STATS_TIMER(readMetadata, 0);
+                    BasicIo& io = Image::io();
+                    if (io.open() != 0) {
+                        throw Error(kerDataSourceOpenFailed, io.path(), strError());
+                    }
+                    IoCloser closer(io);
+                    clearMetadata();
+
+                    // Decode with the TIFF parser on the memory mapped file, like
+                    // TiffImage::readMetadata, reading the IFDs with 64-bit offsets
+                    Internal::BigTiffHeader bigTiffHeader;
+                    Internal::TiffHeader tiffHeader;
+                    Internal::TiffHeaderBase* pHeader = &bigTiffHeader;
+                    if (header_.format() == Header::StandardTiff) pHeader = &tiffHeader;
+                    // The header check of isBigTiffType() is lenient, the parser needs a valid header
+                    if (!pHeader->read(io.mmap(), io.size())) return;
+                    const ByteOrder bo = Internal::TiffParserWorker::decode(exifData_,
+                                                                            iptcData_,
+                                                                            xmpData_,
+                                                                            io.mmap(),
+                                                                            io.size(),
+                                                                            Internal::Tag::root,
+                                                                            Internal::TiffMapping::findDecoder,
+                                                                            pHeader);
+                    setByteOrder(bo);
+
+                    // read profile from the metadata
+                    ExifData::iterator pos = exifData_.findKey(ExifKey("Exif.Image.InterColorProfile"));
+                    if (pos != exifData_.end()) {
+                        const size_t size = pos->count() * pos->typeSize();
+                        if (size == 0) {
+                            throw Error(kerFailedToReadImageData);
+                        }
+                        iccProfile_.alloc(static_cast<long>(size));
+                        pos->copy(iccProfile_.pData_, bo);
+                    }
                 }
 
                 void writeMetadata()
                 {
-
+                    EXV_STATS_TIMER(writeMetadata, 0);
+                    // Todo: implement me!
+                    throw Error(kerWritingImageFormatUnsupported, "BigTIFF");
                 }
 
                 std::string mimeType() const
@@ -180,7 +222,8 @@ namespace Exiv2
 
                 void printStructure(std::ostream& os, PrintStructureOption option, int depth)
                 {
-                    printIFD(os, option, header_.dirOffset(), depth - 1);
+                    Internal::IoView view(Image::io());
+                    printIFD(view, os, option, header_.dirOffset(), depth - 1);
                 }
 
             private:
@@ -188,9 +231,9 @@ namespace Exiv2
                 int dataSize_;
                 bool doSwap_;
 
-                void printIFD(std::ostream& out, PrintStructureOption option, uint64_t dir_offset, int depth)
+                void printIFD(Internal::IoView& view, std::ostream& out, PrintStructureOption option, uint64_t dir_offset, int depth)
                 {
-                    BasicIo& io = Image::io();
+                    const std::string& path = view.io().path();
 
                     // Fix for https://github.com/Exiv2/exiv2/issues/712
                     // A malicious file can cause a very deep recursion, leading to
@@ -209,21 +252,33 @@ namespace Exiv2
                     bool bFirst  = true;
 
                     // buffer
-                    bool bPrint = true;
+                    const bool bJson = option == kpsJson;
+                    const bool bPrint = !bJson;
+                    const bool bRecurse = option == kpsRecursive || bJson;
+                    // output for one line, written in one go
+                    std::string line;
 
                     do
                     {
                         // Read top of directory
-                        io.seek(static_cast<int64>(dir_offset), BasicIo::beg);
-
-                        const uint64_t entries = readData(header_.format() == Header::StandardTiff? 2: 8);
+                        uint64_t position = dir_offset;
+                        const int entriesSize = header_.format() == Header::StandardTiff? 2: 8;
+                        const uint64_t entries = readData(view, position, entriesSize);
+                        position += entriesSize;
                         const bool tooBig = entries > 500;
 
                         if ( bFirst && bPrint )
                         {
-                            out << Internal::indent(depth) << "STRUCTURE OF BIGTIFF FILE " << io.path() << std::endl;
+                            line = Internal::indent(depth) + "STRUCTURE OF BIGTIFF FILE " + path + '\n';
                             if (tooBig)
-                                out << Internal::indent(depth) << "entries = " << entries << std::endl;
+                                line += Internal::indent(depth) + "entries = " + std::to_string(entries) + '\n';
+                            out.write(line.data(), line.size());
+                        }
+                        if ( bJson )
+                        {
+                            Internal::JsonRecord record("BigTIFF", bFirst ? "structure" : "ifd", depth);
+                            if ( bFirst ) record.add("path", path);
+                            record.add("offset", dir_offset).add("entries", entries).write(out);
                         }
 
                         if (tooBig)
@@ -233,18 +288,22 @@ namespace Exiv2
                         for ( uint64_t i = 0; i < entries; i ++ )
                         {
                             if ( bFirst && bPrint )
-                                out << Internal::indent(depth)
-                                    << " address |    tag                           |     "
-                                    << " type |    count |    offset | value\n";
+                            {
+                                line = Internal::indent(depth)
+                                     + " address |    tag                           |     "
+                                     + " type |    count |    offset | value\n";
+                                out.write(line.data(), line.size());
+                            }
 
                             bFirst = false;
 
-                            const uint16_t tag   = (uint16_t) readData(2);
-                            const uint16_t type  = (uint16_t) readData(2);
-                            const uint64_t count = readData(dataSize_);
-                            const DataBuf  data  = io.read(dataSize_);        // Read data as raw value. what should be done about it will be decided depending on type
-
-                            std::string sp = "" ; // output spacer
+                            const uint16_t tag   = (uint16_t) readData(view, position, 2);
+                            const uint16_t type  = (uint16_t) readData(view, position + 2, 2);
+                            const uint64_t count = readData(view, position + 4, dataSize_);
+                            position += 4 + dataSize_;
+                            DataBuf  data(dataSize_);        // Read data as raw value. what should be done about it will be decided depending on type
+                            data.size_ = static_cast<long>(view.read(data.pData_, position, dataSize_));
+                            position += dataSize_;
 
                             //prepare to print the value
                             // TODO: figure out what's going on with kount
@@ -276,7 +335,7 @@ namespace Exiv2
                                 throw Error(kerInvalidMalloc);             // again more than 2^64
 
                             const uint64_t allocate = size*count + pad;
-                            if ( allocate > io.size() ) {
+                            if ( allocate > view.size() ) {
                                 throw Error(kerInvalidMalloc);
                             }
 
@@ -290,143 +349,143 @@ namespace Exiv2
                             const bool usePointer = (size_t) count*size > (size_t) dataSize_;
 
                             if ( usePointer )                          // read into buffer
-                            {
-                                size_t   restore = io.tell();          // save
-                                io.seek(static_cast<int64>(offset), BasicIo::beg);         // position
-                                io.read(buf.pData_, (long) count * size);     // read
-                                io.seek(restore, BasicIo::beg);        // restore
-                            }
+                                view.read(buf.pData_, offset, static_cast<size_t>(count) * size);
                             else  // use 'data' as data :)
                                 std::memcpy(buf.pData_, data.pData_, (size_t) count * size);     // copy data
 
-                            if ( bPrint )
+                            const uint64_t entrySize = header_.format() == Header::StandardTiff? 12: 20;
+                            const uint64_t address = dir_offset + 2 + i * entrySize;
+
+                            std::string value;
+                            const char* sp = ""; // output spacer
+                            if ( isShortType(type) )
                             {
-                                const uint64_t entrySize = header_.format() == Header::StandardTiff? 12: 20;
-                                const uint64_t address = dir_offset + 2 + i * entrySize;
-
-                                out << Internal::indent(depth)
-                                    << Internal::stringFormat("%8u | %#06x %-25s |%10s |%9u |",
-                                        static_cast<size_t>(address), tag, tagName(tag).c_str(), typeName(type), count)
-                                    <<(usePointer ? Internal::stringFormat("%10u | ",(size_t)offset)
-                                                  : Internal::stringFormat("%10s | ",""))
-                                    ;
-                                if ( isShortType(type) )
+                                for ( size_t k = 0 ; k < kount ; k++ )
                                 {
-                                    for ( size_t k = 0 ; k < kount ; k++ )
-                                    {
-                                        out << sp << byteSwap2(buf, k*size, doSwap_);
-                                        sp = " ";
-                                    }
+                                    value += sp + std::to_string(byteSwap2(buf, k*size, doSwap_));
+                                    sp = " ";
                                 }
-                                else if ( isLongType(type) )
+                            }
+                            else if ( isLongType(type) )
+                            {
+                                for ( size_t k = 0 ; k < kount ; k++ )
                                 {
-                                    for ( size_t k = 0 ; k < kount ; k++ )
-                                    {
-                                        out << sp << byteSwap4(buf, k*size, doSwap_);
-                                        sp = " ";
-                                    }
+                                    value += sp + std::to_string(byteSwap4(buf, k*size, doSwap_));
+                                    sp = " ";
                                 }
-                                else if ( isLongLongType(type) )
+                            }
+                            else if ( isLongLongType(type) )
+                            {
+                                for ( size_t k = 0 ; k < kount ; k++ )
                                 {
-                                    for ( size_t k = 0 ; k < kount ; k++ )
-                                    {
-                                        out << sp << byteSwap8(buf, k*size, doSwap_);
-                                        sp = " ";
-                                    }
+                                    value += sp + std::to_string(byteSwap8(buf, k*size, doSwap_));
+                                    sp = " ";
                                 }
-                                else if ( isRationalType(type) )
+                            }
+                            else if ( isRationalType(type) )
+                            {
+                                for ( size_t k = 0 ; k < kount ; k++ )
                                 {
-                                    for ( size_t k = 0 ; k < kount ; k++ )
-                                    {
-                                        uint32_t a = byteSwap4(buf, k*size+0, doSwap_);
-                                        uint32_t b = byteSwap4(buf, k*size+4, doSwap_);
-                                        out << sp << a << "/" << b;
-                                        sp = " ";
-                                    }
+                                    uint32_t a = byteSwap4(buf, k*size+0, doSwap_);
+                                    uint32_t b = byteSwap4(buf, k*size+4, doSwap_);
+                                    value += sp + std::to_string(a) + "/" + std::to_string(b);
+                                    sp = " ";
                                 }
-                                else if ( isStringType(type) )
-                                    out << sp << Internal::binaryToString(makeSlice(buf, 0, static_cast<size_t>(kount)));
+                            }
+                            else if ( isStringType(type) && kount )
+                            {
+                                std::ostringstream os;
+                                os << Internal::binaryToString(makeSlice(buf.pData_, 0, static_cast<size_t>(kount)));
+                                value = os.str();
+                            }
 
-                                sp = kount == count ? "" : " ...";
-                                out << sp << std::endl;
+                            if ( kount != count ) value += " ...";
 
-                                if ( option == kpsRecursive &&
-                                        (tag == 0x8769 /* ExifTag */ || tag == 0x014a/*SubIFDs*/ || type == tiffIfd || type == tiffIfd8) )
+                            if ( bPrint )
+                            {
+                                line = Internal::indent(depth)
+                                     + Internal::stringFormat("%8u | %#06x %-25s |%10s |%9u |",
+                                           static_cast<size_t>(address), tag, tagName(tag).c_str(), typeName(type), count)
+                                     + (usePointer ? Internal::stringFormat("%10u | ",(size_t)offset)
+                                                   : Internal::stringFormat("%10s | ",""))
+                                     + value + '\n';
+                                out.write(line.data(), line.size());
+                            }
+                            else
+                            {
+                                Internal::JsonRecord record("BigTIFF", "entry", depth);
+                                record.add("address", address).add("tag", tag).add("name", tagName(tag))
+                                      .add("type", typeName(type)).add("count", count);
+                                if ( usePointer ) record.add("offset", offset);
+                                record.add("value", value).write(out);
+                            }
+
+                            if ( bRecurse &&
+                                    (tag == 0x8769 /* ExifTag */ || tag == 0x014a/*SubIFDs*/ || type == tiffIfd || type == tiffIfd8) )
+                            {
+                                for ( size_t k = 0 ; k < count ; k++ )
                                 {
-                                    for ( size_t k = 0 ; k < count ; k++ )
-                                    {
-                                        const size_t restore = io.tell();
-                                        const uint64_t ifdOffset = type == tiffIfd8?
-                                            byteSwap8(buf, k*size, doSwap_):
-                                            byteSwap4(buf, k*size, doSwap_);
-
-                                        printIFD(out, option, ifdOffset, depth);
-                                        io.seek(restore, BasicIo::beg);
-                                    }
+                                    const uint64_t ifdOffset = type == tiffIfd8?
+                                        byteSwap8(buf, k*size, doSwap_):
+                                        byteSwap4(buf, k*size, doSwap_);
+
+                                    printIFD(view, out, option, ifdOffset, depth);
                                 }
-                                else if ( option == kpsRecursive && tag == 0x83bb /* IPTCNAA */ )
-                                {
-                                    if (Safe::add(count, offset) > io.size()) {
-                                        throw Error(kerCorruptedMetadata);
-                                    }
-
-                                    const size_t restore = io.tell();
-                                    io.seek(static_cast<int64>(offset), BasicIo::beg);  // position
-                                    std::vector<byte> bytes(static_cast<size_t>(count)) ;  // allocate memory
-                                    // TODO: once we have C++11 use bytes.data()
-                                    const size_t read_bytes = io.read(&bytes[0], static_cast<long>(count));
-                                    io.seek(restore, BasicIo::beg);
-                                    // TODO: once we have C++11 use bytes.data()
-                                    IptcData::printStructure(out, makeSliceUntil(&bytes[0], read_bytes), depth);
+                            }
+                            else if ( option == kpsRecursive && tag == 0x83bb /* IPTCNAA */ )
+                            {
+                                if (Safe::add(count, offset) > view.size()) {
+                                    throw Error(kerCorruptedMetadata);
+                                }
+
+                                std::vector<byte> bytes(static_cast<size_t>(count)) ;  // allocate memory
+                                const size_t read_bytes = view.read(bytes.data(), offset, bytes.size());
+                                IptcData::printStructure(out, makeSliceUntil(bytes.data(), read_bytes), depth);
 
+                            }
+                            else if ( option == kpsRecursive && tag == 0x927c /* MakerNote */ && count > 10)
+                            {
+                                long jump= 10           ;
+                                byte     bytes[20]          ;
+                                const char* chars = (const char*) &bytes[0] ;
+                                std::memset(bytes, 0, sizeof(bytes));
+                                view.read(bytes, dir_offset, jump);
+                                bytes[jump]=0               ;
+                                out.flush();
+                                if ( ::strcmp("Nikon",chars) == 0 )
+                                {
+                                  // tag is an embedded tiff
+                                  std::cerr << "Nikon makernote" << std::endl;
+                                  // printTiffStructure(memIo,out,option,depth);
+                                  // TODO: fix it
                                 }
-                                else if ( option == kpsRecursive && tag == 0x927c /* MakerNote */ && count > 10)
+                                else
                                 {
-                                    size_t   restore = io.tell();  // save
-
-                                    long jump= 10           ;
-                                    byte     bytes[20]          ;
-                                    const char* chars = (const char*) &bytes[0] ;
-                                    io.seek(static_cast<int64>(dir_offset), BasicIo::beg);  // position
-                                    io.read(bytes,jump    )     ;  // read
-                                    bytes[jump]=0               ;
-                                    if ( ::strcmp("Nikon",chars) == 0 )
-                                    {
-                                      // tag is an embedded tiff
-                                      std::vector<byte> nikon_bytes(static_cast<size_t>(count - jump));
-
-                                      io.read(&nikon_bytes.at(0), (long)nikon_bytes.size());
-                                      MemIo memIo(&nikon_bytes.at(0), (long)count - jump); // create a file
-                                      std::cerr << "Nikon makernote" << std::endl;
-                                      // printTiffStructure(memIo,out,option,depth);
-                                      // TODO: fix it
-                                    }
-                                    else
-                                    {
-                                        // tag is an IFD
-                                        io.seek(0, BasicIo::beg);  // position
-                                        std::cerr << "makernote" << std::endl;
-                                        printIFD(out,option,offset,depth);
-                                    }
-
-                                    io.seek(restore,BasicIo::beg); // restore
+                                    // tag is an IFD
+                                    std::cerr << "makernote" << std::endl;
+                                    printIFD(view, out, option, offset, depth);
                                 }
                             }
                         }
 
-                        const uint64_t nextDirOffset = readData(dataSize_);
+                        const uint64_t nextDirOffset = readData(view, position, dataSize_);
 
                         dir_offset = tooBig ? 0 : nextDirOffset;
                         out.flush();
                     } while (dir_offset != 0);
 
                     if ( bPrint )
-                        out << Internal::indent(depth) << "END " << io.path() << std::endl;
+                    {
+                        line = Internal::indent(depth) + "END " + path + '\n';
+                        out.write(line.data(), line.size());
+                        out.flush();
+                    }
                 }
 
-                uint64_t readData(int size) const
+                uint64_t readData(Internal::IoView& view, uint64_t position, int size) const
                 {
-                    const DataBuf data = Image::io().read(size);
+                    DataBuf data(size);
+                    data.size_ = static_cast<long>(view.read(data.pData_, position, size));
                     enforce(data.size_ != 0, kerCorruptedMetadata);
 
                     uint64_t result = 0;
@@ -30,6 +30,7 @@
 #include "bmpimage.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 #include "image.hpp"
 
 // + standard includes
@@ -70,6 +71,7 @@ namespace Exiv2
 
     void BmpImage::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Exiv2::BmpImage::readMetadata: Reading Windows bitmap file " << io_->path() << "\n";
 #endif
@@ -114,6 +116,7 @@ namespace Exiv2
 
     void BmpImage::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
         // Todo: implement me!
         throw(Error(kerWritingImageFormatUnsupported, "BMP"));
     }
@@ -28,6 +28,7 @@
 #include "types.hpp"
 #include "makernote_int.hpp"
 #include "canonmn_int.hpp"
+#include "lensdb_int.hpp"
 #include "tags_int.hpp"
 #include "value.hpp"
 #include "exif.hpp"
@@ -72,7 +73,7 @@ namespace Exiv2 {
                                   const ExifData* metadata);
 
     //! ModelId, tag 0x0010
-    extern const TagDetails canonModelId[] = {
+    extern constexpr TagDetails canonModelId[] = {
         { (long int)0x1010000, "PowerShot A30" },
         { (long int)0x1040000, "PowerShot S300 / Digital IXUS 300 / IXY Digital 300" },
         { (long int)0x1060000, "PowerShot A20" },
@@ -221,8 +222,8 @@ namespace Exiv2 {
         { (long int)0x3090000, "PowerShot SX150 IS" },
         { (long int)0x3100000, "PowerShot ELPH 510 HS / IXUS 1100 HS / IXY 51S" },
         { (long int)0x3110000, "PowerShot S100 (new)" },
-        { (long int)0x3130000, "PowerShot SX40 HS" },
         { (long int)0x3120000, "PowerShot ELPH 310 HS / IXUS 230 HS / IXY 600F" },
+        { (long int)0x3130000, "PowerShot SX40 HS" },
         { (long int)0x3140000, "IXY 32S" },
         { (long int)0x3160000, "PowerShot A1300" },
         { (long int)0x3170000, "PowerShot A810" },
@@ -374,11 +375,11 @@ namespace Exiv2 {
         { (long int)0x80000327, "EOS Rebel T5 / 1200D / Kiss X70" },
         { (long int)0x80000328, "EOS-1D X MARK II" },
         { (long int)0x80000331, "EOS M" },
-        { (long int)0x80000350, "EOS 80D" },
-        { (long int)0x80000355, "EOS M2" },
         { (long int)0x80000346, "EOS Rebel SL1 / 100D / Kiss X7" },
         { (long int)0x80000347, "EOS Rebel T6s / 760D / 8000D" },
         { (long int)0x80000349, "EOS 5D Mark IV" },
+        { (long int)0x80000350, "EOS 80D" },
+        { (long int)0x80000355, "EOS M2" },
         { (long int)0x80000382, "EOS 5DS" },
         { (long int)0x80000393, "EOS Rebel T6i / 750D / Kiss X8i" },
         { (long int)0x80000401, "EOS 5DS R" },
@@ -386,6 +387,7 @@ namespace Exiv2 {
         { (long int)0x80000405, "EOS Rebel T7i / 800D / Kiss X9i" },
         { (long int)0x80000408, "EOS 77D / 9000D" }
     };
+    static_assert(isSorted(canonModelId, EXV_COUNTOF(canonModelId)), "canonModelId must be sorted by value");
 
     //! SerialNumberFormat, tag 0x0015
     extern const TagDetails canonSerialNumberFormat[] = {
@@ -740,7 +742,7 @@ namespace Exiv2 {
     };
 
     //! LensType, tag 0x0016
-    extern const TagDetails canonCsLensType[] = {
+    extern constexpr TagDetails canonCsLensType[] = {
         {   1, "Canon EF 50mm f/1.8"                                        },
         {   2, "Canon EF 28mm f/2.8"                                        },
         {   3, "Canon EF 135mm f/2.8 Soft"                                  },
@@ -1106,6 +1108,14 @@ namespace Exiv2 {
         {36912,"Canon EF-S 18-135mm f/3.5-5.6 IS USM"                       },
         {65535,"n/a"                                                        }
     };
+    static_assert(isSorted(canonCsLensType, EXV_COUNTOF(canonCsLensType)), "canonCsLensType must be sorted by value");
+
+    //! Index of canonCsLensType
+    static const TagDetailsIndex& canonLensIndex()
+    {
+        static const TagDetailsIndex index = makeLensIndex(canonCsLensType);
+        return index;
+    }
 
     //! A lens id and a pretty-print function for special treatment of the id.
     struct LensIdFct {
@@ -1709,7 +1719,7 @@ namespace Exiv2 {
             return os;
         }
 
-        ExifData::const_iterator pos = metadata->findKey(ExifKey("Exif.Image.Model"));
+        ExifData::const_iterator pos = findIndexedKey(*metadata, "Exif.Image.Model");
         if (pos == metadata->end())
             return os << "(" << value << ")";
 
@@ -1749,8 +1759,7 @@ namespace Exiv2 {
             return os << value;
         }
 
-        ExifKey key("Exif.CanonCs.Lens");
-        ExifData::const_iterator pos = metadata->findKey(key);
+        ExifData::const_iterator pos = findIndexedKey(*metadata, "Exif.CanonCs.Lens");
         if (pos != metadata->end() && pos->value().count() >= 3 && pos->value().typeId() == unsignedShort) {
             float fu = pos->value().toFloat(2);
             if (fu != 0.0) {
@@ -1815,9 +1824,9 @@ namespace Exiv2 {
     {
         try {
             // 1140
-            const ExifData::const_iterator itModel = metadata->findKey(ExifKey("Exif.Image.Model"));
-            const ExifData::const_iterator itLens  = metadata->findKey(ExifKey("Exif.CanonCs.Lens"));
-            const ExifData::const_iterator itApert = metadata->findKey(ExifKey("Exif.CanonCs.MaxAperture"));
+            const ExifData::const_iterator itModel = findIndexedKey(*metadata, "Exif.Image.Model");
+            const ExifData::const_iterator itLens  = findIndexedKey(*metadata, "Exif.CanonCs.Lens");
+            const ExifData::const_iterator itApert = findIndexedKey(*metadata, "Exif.CanonCs.MaxAperture");
 
             if( itModel != metadata->end() && itModel->value().toString() == "Canon EOS 30D"
             &&  itLens  != metadata->end() && itLens->value().toString() == "24 24 1"
@@ -1827,7 +1836,7 @@ namespace Exiv2 {
             }
         } catch (std::exception&) {};
 
-        return EXV_PRINT_TAG(canonCsLensType)(os, value, metadata);
+        return printLens(os, canonLensIndex(), value);
     }
 
     //! Helper structure
@@ -1839,19 +1848,11 @@ namespace Exiv2 {
         std::string maxAperture_;               //!< Aperture
     };
 
-    //! Compare tag details with a lens entry
-    bool operator==(const TagDetails& td, const LensTypeAndFocalLengthAndMaxAperture& ltfl) {
-        return (   td.val_ == ltfl.lensType_
-                && std::string(td.label_).find(ltfl.focalLength_) != std::string::npos
-                && std::string(td.label_).find(ltfl.maxAperture_) != std::string::npos);
-    }
-
     //! extractLensFocalLength from metadata
     void extractLensFocalLength(LensTypeAndFocalLengthAndMaxAperture& ltfl,
                                 const ExifData* metadata)
     {
-        ExifKey key("Exif.CanonCs.Lens");
-        ExifData::const_iterator pos = metadata->findKey(key);
+        ExifData::const_iterator pos = findIndexedKey(*metadata, "Exif.CanonCs.Lens");
         ltfl.focalLengthMin_ = 0.0f;
         ltfl.focalLengthMax_ = 0.0f;
         if (pos != metadata->end()) {
@@ -1896,8 +1897,7 @@ namespace Exiv2 {
         if (ltfl.focalLengthMax_ == 0.0) return os << value;
         convertFocalLength(ltfl, 1.0);
 
-        ExifKey key("Exif.CanonCs.MaxAperture");
-        ExifData::const_iterator pos = metadata->findKey(key);
+        ExifData::const_iterator pos = findIndexedKey(*metadata, "Exif.CanonCs.MaxAperture");
         if (   pos != metadata->end()
             && pos->value().count() == 1
             && pos->value().typeId() == unsignedShort) {
@@ -1913,7 +1913,7 @@ namespace Exiv2 {
         }
         if (ltfl.maxAperture_.empty()) return os << value;
 
-        const TagDetails* td = find(canonCsLensType, ltfl);
+        const TagDetails* td = findLens(canonLensIndex(), ltfl.lensType_, ltfl.focalLength_, ltfl.maxAperture_);
         if (!td) return os << value;
         return os << td->label_;
     }
@@ -1935,7 +1935,7 @@ namespace Exiv2 {
 
         if (ltfl.focalLength_.empty()) return os << value;
 
-        const TagDetails* td = find(canonCsLensType, ltfl);
+        const TagDetails* td = findLens(canonLensIndex(), ltfl.lensType_, ltfl.focalLength_, ltfl.maxAperture_);
         if (!td) return os << value;
         return os << td->label_;
     }
@@ -1954,13 +1954,13 @@ namespace Exiv2 {
         extractLensFocalLength(ltfl, metadata);
         if (ltfl.focalLengthMax_ == 0.0) return os << value;
         convertFocalLength(ltfl, 1.0); // just lens
-        const TagDetails* td = find(canonCsLensType, ltfl);
+        const TagDetails* td = findLens(canonLensIndex(), ltfl.lensType_, ltfl.focalLength_, ltfl.maxAperture_);
         if (!td) {
             convertFocalLength(ltfl, 1.4); // lens + 1.4x TC
-            td = find(canonCsLensType, ltfl);
+            td = findLens(canonLensIndex(), ltfl.lensType_, ltfl.focalLength_, ltfl.maxAperture_);
             if (!td) {
                 convertFocalLength(ltfl, 2.0); // lens + 2x TC
-                td = find(canonCsLensType, ltfl);
+                td = findLens(canonLensIndex(), ltfl.lensType_, ltfl.focalLength_, ltfl.maxAperture_);
                 if (!td) return os << value;
             }
         }
@@ -1984,7 +1984,7 @@ namespace Exiv2 {
 
         const LensIdFct* lif = find(lensIdFct, value.toLong());
         if (!lif) {
-            return EXV_PRINT_TAG(canonCsLensType)(os, value, metadata);
+            return printLens(os, canonLensIndex(), value);
         }
         if (metadata && lif->fct_) {
             return lif->fct_(os, value, metadata);
@@ -42,6 +42,10 @@
 #include <iomanip>
 #include <ios>
 #include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iterator>
 #include <stdio.h> // for snprintf (C99)
 #ifdef _MSC_VER
 # define snprintf _snprintf
@@ -88,6 +92,108 @@ namespace {
       The return code indicates if the operation was successful.
      */
     bool getTextValue(std::string& value, const Exiv2::XmpData::iterator& pos);
+
+    /*!
+      @brief Positions of the entries of a metadata container, sorted by key
+             and collected in one pass over the container.
+
+      Used by the converter to skip conversion rules for which the source
+      container has no entries, and to find the entries of the others,
+      without parsing the rule's key and searching the container for it.
+      Entries of the container must be erased with erase() while the index
+      is used.
+     */
+    template <typename Data>
+    class KeyIndex {
+    public:
+        //! Iterator type of the container
+        typedef typename Data::iterator iterator;
+
+        //! Index the entries of \em md, or no container if \em md is 0.
+        void build(Data* md)
+        {
+            md_ = md;
+            entries_.clear();
+            if (md_ == 0) return;
+            entries_.reserve(static_cast<size_t>(md_->count()));
+            for (iterator i = md_->begin(); i != md_->end(); ++i) {
+                entries_.push_back(Entry(i->key(), i));
+            }
+            // Entries with the same key stay in the order of the container
+            std::stable_sort(entries_.begin(), entries_.end(), lessKey);
+        }
+        /*!
+          @brief Return true if the container has an entry with key \em key,
+                 or an XMP struct field or array item below \em key.
+         */
+        bool contains(const char* key) const;
+        /*!
+          @brief Return the first entry with key \em key in the order of the
+                 container, like findKey(), or the end of the container.
+         */
+        iterator find(const std::string& key) const
+        {
+            typename Entries::const_iterator i = std::lower_bound(entries_.begin(), entries_.end(), key, lessKeyThan<std::string>);
+            if (i == entries_.end() || i->first != key) return md_->end();
+            return i->second;
+        }
+        //! Erase the entry at \em pos from the container, return the position of the entry after it.
+        iterator erase(iterator pos)
+        {
+            if (pos == md_->end()) return pos;
+            typename Entries::iterator i = std::lower_bound(entries_.begin(), entries_.end(), pos->key(), lessKeyThan<std::string>);
+            while (i != entries_.end() && i->second != pos) ++i;
+            if (i != entries_.end()) entries_.erase(i);
+            return erase(pos, typename std::iterator_traits<iterator>::iterator_category());
+        }
+
+    private:
+        typedef std::pair<std::string, iterator> Entry;
+        typedef std::vector<Entry> Entries;
+
+        static bool lessKey(const Entry& lhs, const Entry& rhs) { return lhs.first < rhs.first; }
+        template <typename Key>
+        static bool lessKeyThan(const Entry& entry, const Key& key) { return entry.first < key; }
+
+        //! Erase from a list, the other positions stay valid
+        iterator erase(iterator pos, std::bidirectional_iterator_tag)
+        {
+            return md_->erase(pos);
+        }
+        //! Erase from a vector, the positions after \em pos move down by one
+        iterator erase(iterator pos, std::random_access_iterator_tag)
+        {
+            typedef typename std::iterator_traits<iterator>::difference_type Offset;
+            const iterator begin = md_->begin();
+            const Offset erased = pos - begin;
+            std::vector<Offset> offsets;
+            offsets.reserve(entries_.size());
+            for (auto&& entry : entries_) {
+                offsets.push_back(entry.second - begin);
+            }
+            const iterator next = md_->erase(pos);
+            for (size_t i = 0; i < entries_.size(); ++i) {
+                entries_[i].second = md_->begin() + (offsets[i] > erased ? offsets[i] - 1 : offsets[i]);
+            }
+            return next;
+        }
+
+        // DATA
+        Data* md_{nullptr};                     //!< Indexed container
+        Entries entries_;                       //!< Keys and positions of the entries
+    };
+
+    template <typename Data>
+    bool KeyIndex<Data>::contains(const char* key) const
+    {
+        if (entries_.empty()) return false;
+        const size_t len = std::strlen(key);
+        typename Entries::const_iterator i = std::lower_bound(entries_.begin(), entries_.end(), key, lessKeyThan<const char*>);
+        for (; i != entries_.end() && i->first.compare(0, len, key) == 0; ++i) {
+            if (i->first.size() == len || i->first[len] == '/' || i->first[len] == '[') return true;
+        }
+        return false;
+    }
 }
 
 // *****************************************************************************
@@ -292,6 +398,12 @@ namespace Exiv2 {
         //@}
 
     private:
+        /*!
+          @brief Return true if conversion function \em fct can be skipped
+                 because the source key \em from is not in the index of the
+                 source container.
+         */
+        bool skip(ConvertFct fct, const char* from) const;
         bool prepareExifTarget(const char* to, bool force =false);
         bool prepareIptcTarget(const char* to, bool force =false);
         bool prepareXmpTarget(const char* to, bool force =false);
@@ -305,6 +417,10 @@ namespace Exiv2 {
         IptcData *iptcData_;
         XmpData  *xmpData_;
         const char *iptcCharset_;
+        // Only the index of the source container of the current conversion is built
+        KeyIndex<ExifData> exifKeys_;           //!< Index of the Exif source metadata
+        KeyIndex<IptcData> iptcKeys_;           //!< Index of the IPTC source metadata
+        KeyIndex<XmpData>  xmpKeys_;            //!< Index of the XMP source metadata
 
     }; // class Converter
 
@@ -452,10 +568,14 @@ namespace Exiv2 {
 
     void Converter::cnvToXmp()
     {
+        exifKeys_.build(exifData_);
+        iptcKeys_.build(iptcData_);
+        xmpKeys_.build(0);
         for (unsigned int i = 0; i < EXV_COUNTOF(conversion_); ++i) {
             const Conversion& c = conversion_[i];
             if (   (c.metadataId_ == mdExif && exifData_)
                 || (c.metadataId_ == mdIptc && iptcData_)) {
+                if (skip(c.key1ToKey2_, c.key1_)) continue;
                 EXV_CALL_MEMBER_FN(*this, c.key1ToKey2_)(c.key1_, c.key2_);
             }
         }
@@ -463,15 +583,28 @@ namespace Exiv2 {
 
     void Converter::cnvFromXmp()
     {
+        exifKeys_.build(0);
+        iptcKeys_.build(0);
+        xmpKeys_.build(xmpData_);
         for (unsigned int i = 0; i < EXV_COUNTOF(conversion_); ++i) {
             const Conversion& c = conversion_[i];
             if (   (c.metadataId_ == mdExif && exifData_)
                 || (c.metadataId_ == mdIptc && iptcData_)) {
+                if (skip(c.key2ToKey1_, c.key2_)) continue;
                 EXV_CALL_MEMBER_FN(*this, c.key2ToKey1_)(c.key2_, c.key1_);
             }
         }
     }
 
+    bool Converter::skip(ConvertFct fct, const char* from) const
+    {
+        if (fct == &Converter::cnvNone) return true;
+        // These prepare (and possibly erase) the target before they look for the source
+        if (fct == &Converter::cnvXmpComment || fct == &Converter::cnvXmpArray) return false;
+        // Conversions only ever erase source entries, so the index is never missing a key
+        return !exifKeys_.contains(from) && !iptcKeys_.contains(from) && !xmpKeys_.contains(from);
+    }
+
     void Converter::cnvNone(const char*, const char*)
     {
         return;
@@ -508,7 +641,7 @@ namespace Exiv2 {
 
     void Converter::cnvExifValue(const char* from, const char* to)
     {
-        Exiv2::ExifData::iterator pos = exifData_->findKey(ExifKey(from));
+        Exiv2::ExifData::iterator pos = exifKeys_.find(from);
         if (pos == exifData_->end()) return;
         std::string value = pos->toString();
         if (!pos->value().ok()) {
@@ -519,12 +652,12 @@ namespace Exiv2 {
         }
         if (!prepareXmpTarget(to)) return;
         (*xmpData_)[to] = value;
-        if (erase_) exifData_->erase(pos);
+        if (erase_) exifKeys_.erase(pos);
     }
 
     void Converter::cnvExifComment(const char* from, const char* to)
     {
-        Exiv2::ExifData::iterator pos = exifData_->findKey(ExifKey(from));
+        Exiv2::ExifData::iterator pos = exifKeys_.find(from);
         if (pos == exifData_->end()) return;
         if (!prepareXmpTarget(to)) return;
         const CommentValue* cv = dynamic_cast<const CommentValue*>(&pos->value());
@@ -536,12 +669,12 @@ namespace Exiv2 {
         }
         // Todo: Convert to UTF-8 if necessary
         (*xmpData_)[to] = cv->comment();
-        if (erase_) exifData_->erase(pos);
+        if (erase_) exifKeys_.erase(pos);
     }
 
     void Converter::cnvExifArray(const char* from, const char* to)
     {
-        Exiv2::ExifData::iterator pos = exifData_->findKey(ExifKey(from));
+        Exiv2::ExifData::iterator pos = exifKeys_.find(from);
         if (pos == exifData_->end()) return;
         if (!prepareXmpTarget(to)) return;
         for (long i = 0; i < (long)pos->count(); ++i) {
@@ -554,12 +687,12 @@ namespace Exiv2 {
             }
             (*xmpData_)[to] = value;
         }
-        if (erase_) exifData_->erase(pos);
+        if (erase_) exifKeys_.erase(pos);
     }
 
     void Converter::cnvExifDate(const char* from, const char* to)
     {
-        Exiv2::ExifData::iterator pos = exifData_->findKey(ExifKey(from));
+        Exiv2::ExifData::iterator pos = exifKeys_.find(from);
         if (pos == exifData_->end()) return;
         if (!prepareXmpTarget(to)) return;
         int year, month, day, hour, min, sec;
@@ -628,12 +761,12 @@ namespace Exiv2 {
             buf[1] = '.'; // some locales use ','
             subsec = buf + 1;
 
-            Exiv2::ExifData::iterator datePos = exifData_->findKey(ExifKey("Exif.GPSInfo.GPSDateStamp"));
+            Exiv2::ExifData::iterator datePos = exifKeys_.find("Exif.GPSInfo.GPSDateStamp");
             if (datePos == exifData_->end()) {
-                datePos = exifData_->findKey(ExifKey("Exif.Photo.DateTimeOriginal"));
+                datePos = exifKeys_.find("Exif.Photo.DateTimeOriginal");
             }
             if (datePos == exifData_->end()) {
-                datePos = exifData_->findKey(ExifKey("Exif.Photo.DateTimeDigitized"));
+                datePos = exifKeys_.find("Exif.Photo.DateTimeDigitized");
             }
             if (datePos == exifData_->end()) {
 #ifndef SUPPRESS_WARNINGS
@@ -663,7 +796,7 @@ namespace Exiv2 {
         }
 
         if (subsecTag) {
-            ExifData::iterator subsec_pos = exifData_->findKey(ExifKey(subsecTag));
+            ExifData::iterator subsec_pos = exifKeys_.find(subsecTag);
             if (   subsec_pos != exifData_->end()
                 && subsec_pos->typeId() == asciiString) {
                 std::string ss = subsec_pos->toString();
@@ -673,7 +806,7 @@ namespace Exiv2 {
                     if (ok) subsec = std::string(".") + ss;
                 }
             }
-            if (erase_) exifData_->erase(subsec_pos);
+            if (erase_) exifKeys_.erase(subsec_pos);
         }
 
         if (subsec.size() > 10) subsec = subsec.substr(0, 10);
@@ -682,12 +815,12 @@ namespace Exiv2 {
         buf[sizeof(buf) - 1] = 0;
 
         (*xmpData_)[to] = buf;
-        if (erase_) exifData_->erase(pos);
+        if (erase_) exifKeys_.erase(pos);
     }
 
     void Converter::cnvExifVersion(const char* from, const char* to)
     {
-        Exiv2::ExifData::iterator pos = exifData_->findKey(ExifKey(from));
+        Exiv2::ExifData::iterator pos = exifKeys_.find(from);
         if (pos == exifData_->end()) return;
         if (!prepareXmpTarget(to)) return;
         std::ostringstream value;
@@ -695,12 +828,12 @@ namespace Exiv2 {
             value << static_cast<char>(pos->toLong(i));
         }
         (*xmpData_)[to] = value.str();
-        if (erase_) exifData_->erase(pos);
+        if (erase_) exifKeys_.erase(pos);
     }
 
     void Converter::cnvExifGPSVersion(const char* from, const char* to)
     {
-        Exiv2::ExifData::iterator pos = exifData_->findKey(ExifKey(from));
+        Exiv2::ExifData::iterator pos = exifKeys_.find(from);
         if (pos == exifData_->end()) return;
         if (!prepareXmpTarget(to)) return;
         std::ostringstream value;
@@ -709,12 +842,12 @@ namespace Exiv2 {
             value << pos->toLong(i);
         }
         (*xmpData_)[to] = value.str();
-        if (erase_) exifData_->erase(pos);
+        if (erase_) exifKeys_.erase(pos);
     }
 
     void Converter::cnvExifFlash(const char* from, const char* to)
     {
-        Exiv2::ExifData::iterator pos = exifData_->findKey(ExifKey(from));
+        Exiv2::ExifData::iterator pos = exifKeys_.find(from);
         if (pos == exifData_->end() || pos->count() == 0) return;
         if (!prepareXmpTarget(to)) return;
         int value = pos->toLong();
@@ -731,12 +864,12 @@ namespace Exiv2 {
         (*xmpData_)["Xmp.exif.Flash/exif:Function"] = static_cast<bool>((value >> 5) & 1);
         (*xmpData_)["Xmp.exif.Flash/exif:RedEyeMode"] = static_cast<bool>((value >> 6) & 1);
 
-        if (erase_) exifData_->erase(pos);
+        if (erase_) exifKeys_.erase(pos);
     }
 
     void Converter::cnvExifGPSCoord(const char* from, const char* to)
     {
-        Exiv2::ExifData::iterator pos = exifData_->findKey(ExifKey(from));
+        Exiv2::ExifData::iterator pos = exifKeys_.find(from);
         if (pos == exifData_->end()) return;
         if (!prepareXmpTarget(to)) return;
         if (pos->count() != 3) {
@@ -745,7 +878,7 @@ namespace Exiv2 {
 #endif
             return;
         }
-        Exiv2::ExifData::iterator refPos = exifData_->findKey(ExifKey(std::string(from) + "Ref"));
+        Exiv2::ExifData::iterator refPos = exifKeys_.find(std::string(from) + "Ref");
         if (refPos == exifData_->end()) {
 #ifndef SUPPRESS_WARNINGS
             EXV_WARNING << "Failed to convert " << from << " to " << to << "\n";
@@ -774,13 +907,13 @@ namespace Exiv2 {
             << refPos->toString().c_str()[0];
         (*xmpData_)[to] = oss.str();
 
-        if (erase_) exifData_->erase(pos);
-        if (erase_) exifData_->erase(refPos);
+        if (erase_) exifKeys_.erase(pos);
+        if (erase_) exifKeys_.erase(refPos);
     }
 
     void Converter::cnvXmpValue(const char* from, const char* to)
     {
-        Exiv2::XmpData::iterator pos = xmpData_->findKey(XmpKey(from));
+        Exiv2::XmpData::iterator pos = xmpKeys_.find(from);
         if (pos == xmpData_->end()) return;
         if (!prepareExifTarget(to)) return;
         std::string value;
@@ -796,13 +929,13 @@ namespace Exiv2 {
         if (0 == ed.setValue(value)) {
             exifData_->add(ed);
         }
-        if (erase_) xmpData_->erase(pos);
+        if (erase_) xmpKeys_.erase(pos);
     }
 
     void Converter::cnvXmpComment(const char* from, const char* to)
     {
         if (!prepareExifTarget(to)) return;
-        Exiv2::XmpData::iterator pos = xmpData_->findKey(XmpKey(from));
+        Exiv2::XmpData::iterator pos = xmpKeys_.find(from);
         if (pos == xmpData_->end()) return;
         std::string value;
         if (!getTextValue(value, pos)) {
@@ -813,13 +946,13 @@ namespace Exiv2 {
         }
         // Assumes the XMP value is encoded in UTF-8, as it should be
         (*exifData_)[to] = "charset=Unicode " + value;
-        if (erase_) xmpData_->erase(pos);
+        if (erase_) xmpKeys_.erase(pos);
     }
 
     void Converter::cnvXmpArray(const char* from, const char* to)
     {
         if (!prepareExifTarget(to)) return;
-        Exiv2::XmpData::iterator pos = xmpData_->findKey(XmpKey(from));
+        Exiv2::XmpData::iterator pos = xmpKeys_.find(from);
         if (pos == xmpData_->end()) return;
         std::ostringstream array;
         for (long i = 0; i < (long)pos->count(); ++i) {
@@ -835,12 +968,12 @@ namespace Exiv2 {
               array << " ";
         }
         (*exifData_)[to] = array.str();
-        if (erase_) xmpData_->erase(pos);
+        if (erase_) xmpKeys_.erase(pos);
     }
 
     void Converter::cnvXmpDate(const char* from, const char* to)
     {
-        Exiv2::XmpData::iterator pos = xmpData_->findKey(XmpKey(from));
+        Exiv2::XmpData::iterator pos = xmpKeys_.find(from);
         if (pos == xmpData_->end()) return;
         if (!prepareExifTarget(to)) return;
 #ifdef EXV_HAVE_XMP_TOOLKIT
@@ -928,7 +1061,7 @@ namespace Exiv2 {
             (*exifData_)["Exif.GPSInfo.GPSDateStamp"] = buf;
         }
 
-        if (erase_) xmpData_->erase(pos);
+        if (erase_) xmpKeys_.erase(pos);
 #else
 # ifndef SUPPRESS_WARNINGS
         EXV_WARNING << "Failed to convert " << from << " to " << to << "\n";
@@ -938,7 +1071,7 @@ namespace Exiv2 {
 
     void Converter::cnvXmpVersion(const char* from, const char* to)
     {
-        Exiv2::XmpData::iterator pos = xmpData_->findKey(XmpKey(from));
+        Exiv2::XmpData::iterator pos = xmpKeys_.find(from);
         if (pos == xmpData_->end()) return;
         if (!prepareExifTarget(to)) return;
         std::string value = pos->toString();
@@ -956,12 +1089,12 @@ namespace Exiv2 {
               << static_cast<int>(value[3]);
 
         (*exifData_)[to] = array.str();
-        if (erase_) xmpData_->erase(pos);
+        if (erase_) xmpKeys_.erase(pos);
     }
 
     void Converter::cnvXmpGPSVersion(const char* from, const char* to)
     {
-        Exiv2::XmpData::iterator pos = xmpData_->findKey(XmpKey(from));
+        Exiv2::XmpData::iterator pos = xmpKeys_.find(from);
         if (pos == xmpData_->end()) return;
         if (!prepareExifTarget(to)) return;
         std::string value = pos->toString();
@@ -976,13 +1109,13 @@ namespace Exiv2 {
             if (value[i] == '.') value[i] = ' ';
         }
         (*exifData_)[to] = value;
-        if (erase_) xmpData_->erase(pos);
+        if (erase_) xmpKeys_.erase(pos);
 
     }
 
     void Converter::cnvXmpFlash(const char* from, const char* to)
     {
-        Exiv2::XmpData::iterator pos = xmpData_->findKey(XmpKey(std::string(from) + "/exif:Fired"));
+        Exiv2::XmpData::iterator pos = xmpKeys_.find(std::string(from) + "/exif:Fired");
         if (pos == xmpData_->end()) return;
         if (!prepareExifTarget(to)) return;
         unsigned short value = 0;
@@ -996,7 +1129,7 @@ namespace Exiv2 {
                 EXV_WARNING << "Failed to convert " << std::string(from) + "/exif:Fired" << " to " << to << "\n";
 #endif
         }
-        pos = xmpData_->findKey(XmpKey(std::string(from) + "/exif:Return"));
+        pos = xmpKeys_.find(std::string(from) + "/exif:Return");
         if (pos != xmpData_->end() && pos->count() > 0) {
             int ret = pos->toLong();
             if (pos->value().ok())
@@ -1006,7 +1139,7 @@ namespace Exiv2 {
                 EXV_WARNING << "Failed to convert " << std::string(from) + "/exif:Return" << " to " << to << "\n";
 #endif
         }
-        pos = xmpData_->findKey(XmpKey(std::string(from) + "/exif:Mode"));
+        pos = xmpKeys_.find(std::string(from) + "/exif:Mode");
         if (pos != xmpData_->end() && pos->count() > 0) {
             int mode = pos->toLong();
             if (pos->value().ok())
@@ -1016,7 +1149,7 @@ namespace Exiv2 {
                 EXV_WARNING << "Failed to convert " << std::string(from) + "/exif:Mode" << " to " << to << "\n";
 #endif
         }
-        pos = xmpData_->findKey(XmpKey(std::string(from) + "/exif:Function"));
+        pos = xmpKeys_.find(std::string(from) + "/exif:Function");
         if (pos != xmpData_->end() && pos->count() > 0) {
             int function = pos->toLong();
             if (pos->value().ok())
@@ -1026,7 +1159,7 @@ namespace Exiv2 {
                 EXV_WARNING << "Failed to convert " << std::string(from) + "/exif:Function" << " to " << to << "\n";
 #endif
         }
-        pos = xmpData_->findKey(XmpKey(std::string(from) + "/exif:RedEyeMode"));
+        pos = xmpKeys_.find(std::string(from) + "/exif:RedEyeMode");
         if (pos != xmpData_->end() && pos->count() > 0) {
             int red = pos->toLong();
             if (pos->value().ok())
@@ -1038,12 +1171,12 @@ namespace Exiv2 {
         }
 
         (*exifData_)[to] = value;
-        if (erase_) xmpData_->erase(pos);
+        if (erase_) xmpKeys_.erase(pos);
     }
 
     void Converter::cnvXmpGPSCoord(const char* from, const char* to)
     {
-        Exiv2::XmpData::iterator pos = xmpData_->findKey(XmpKey(from));
+        Exiv2::XmpData::iterator pos = xmpKeys_.find(from);
         if (pos == xmpData_->end()) return;
         if (!prepareExifTarget(to)) return;
         std::string value = pos->toString();
@@ -1102,12 +1235,12 @@ namespace Exiv2 {
         char ref_str[2] = {ref, 0};
         (*exifData_)[std::string(to) + "Ref"] = ref_str;
 
-        if (erase_) xmpData_->erase(pos);
+        if (erase_) xmpKeys_.erase(pos);
     }
 
     void Converter::cnvIptcValue(const char* from, const char* to)
     {
-        Exiv2::IptcData::iterator pos = iptcData_->findKey(IptcKey(from));
+        Exiv2::IptcData::iterator pos = iptcKeys_.find(from);
         if (pos == iptcData_->end()) return;
         if (!prepareXmpTarget(to)) return;
         while (pos != iptcData_->end()) {
@@ -1123,7 +1256,7 @@ namespace Exiv2 {
                 if (iptcCharset_) convertStringCharset(value, iptcCharset_, "UTF-8");
                 (*xmpData_)[to] = value;
                 if (erase_) {
-                    pos = iptcData_->erase(pos);
+                    pos = iptcKeys_.erase(pos);
                     continue;
                 }
             }
@@ -1133,7 +1266,7 @@ namespace Exiv2 {
 
     void Converter::cnvXmpValueToIptc(const char* from, const char* to)
     {
-        XmpData::iterator pos = xmpData_->findKey(XmpKey(from));
+        XmpData::iterator pos = xmpKeys_.find(from);
         if (pos == xmpData_->end()) return;
         if (!prepareIptcTarget(to)) return;
 
@@ -1147,7 +1280,7 @@ namespace Exiv2 {
             }
             (*iptcData_)[to] = value;
             (*iptcData_)["Iptc.Envelope.CharacterSet"] = "\033%G"; // indicate UTF-8 encoding
-            if (erase_) xmpData_->erase(pos);
+            if (erase_) xmpKeys_.erase(pos);
             return;
         }
 
@@ -1167,7 +1300,7 @@ namespace Exiv2 {
             added = true;
         }
         if (added) (*iptcData_)["Iptc.Envelope.CharacterSet"] = "\033%G"; // indicate UTF-8 encoding
-        if (erase_) xmpData_->erase(pos);
+        if (erase_) xmpKeys_.erase(pos);
     }
 
 #ifdef EXV_HAVE_XMP_TOOLKIT
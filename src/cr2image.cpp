@@ -32,6 +32,7 @@
 #include "image.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 #include "i18n.h"                // NLS support.
 
 // + standard includes
@@ -89,6 +90,7 @@ namespace Exiv2 {
 
     void Cr2Image::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Reading CR2 file " << io_->path() << "\n";
 #endif
@@ -112,6 +114,7 @@ namespace Exiv2 {
 
     void Cr2Image::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Writing CR2 file " << io_->path() << "\n";
 #endif
@@ -31,6 +31,7 @@
 #include "crwimage_int.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 #include "value.hpp"
 #include "tags.hpp"
 #include "tags_int.hpp"
@@ -88,6 +89,7 @@ namespace Exiv2 {
 
     void CrwImage::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Reading CRW file " << io_->path() << "\n";
 #endif
@@ -110,6 +112,7 @@ namespace Exiv2 {
 
     void CrwImage::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Writing CRW file " << io_->path() << "\n";
 #endif
@@ -32,9 +32,11 @@
 #include "metadatum.hpp"
 #include "i18n.h"                // NLS support.
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <unordered_map>
 
 // *****************************************************************************
 // class member definitions
@@ -451,28 +453,67 @@ namespace Exiv2 {
         0
     };
 
+    namespace {
+        //! Number of IIM4 records with a dataset list, the record id is the index
+        const uint16_t recordCount = IptcDataSets::application2 + 1;
+
+        /*!
+          @brief Direct lookup tables for the dataset lists of the records: the
+                 index of each dataset by number and by name. If a number or name
+                 occurs more than once in a list, the first one is found, like
+                 with a search of the list.
+         */
+        class DataSetIndex {
+        public:
+            //! Constructor, builds the tables from the dataset lists
+            explicit DataSetIndex(const DataSet* const* records)
+            {
+                for (uint16_t recordId = 0; recordId < recordCount; ++recordId) {
+                    std::fill(numbers_[recordId], numbers_[recordId] + 256, static_cast<int16_t>(-1));
+                    const DataSet* dataSet = records[recordId];
+                    for (int idx = 0; dataSet != 0 && dataSet[idx].number_ != 0xffff; ++idx) {
+                        if (dataSet[idx].number_ < 256 && numbers_[recordId][dataSet[idx].number_] == -1) {
+                            numbers_[recordId][dataSet[idx].number_] = static_cast<int16_t>(idx);
+                        }
+                        names_[recordId].emplace(dataSet[idx].name_, idx);
+                    }
+                }
+            }
+            //! Return the index of dataset \em number in record \em recordId or -1
+            int find(uint16_t number, uint16_t recordId) const
+            {
+                if (recordId >= recordCount || number >= 256) return -1;
+                return numbers_[recordId][number];
+            }
+            //! Return the index of dataset \em dataSetName in record \em recordId or -1
+            int find(const std::string& dataSetName, uint16_t recordId) const
+            {
+                if (recordId >= recordCount) return -1;
+                auto pos = names_[recordId].find(dataSetName);
+                return pos == names_[recordId].end() ? -1 : pos->second;
+            }
+
+        private:
+            int16_t numbers_[recordCount][256];
+            std::unordered_map<std::string, int> names_[recordCount];
+        };
+
+        //! Return the lookup tables, they are built on first use
+        const DataSetIndex& dataSetIndex(const DataSet* const* records)
+        {
+            static const DataSetIndex index(records);
+            return index;
+        }
+    }
+
     int IptcDataSets::dataSetIdx(uint16_t number, uint16_t recordId)
     {
-        if( recordId != envelope && recordId != application2 ) return -1;
-        const DataSet* dataSet = records_[recordId];
-        if (dataSet == 0) return -1;
-        int idx;
-        for (idx = 0; dataSet[idx].number_ != number; ++idx) {
-            if (dataSet[idx].number_ == 0xffff) return -1;
-        }
-        return idx;
+        return dataSetIndex(records_).find(number, recordId);
     }
 
     int IptcDataSets::dataSetIdx(const std::string& dataSetName, uint16_t recordId)
     {
-        if( recordId != envelope && recordId != application2 ) return -1;
-        const DataSet* dataSet = records_[recordId];
-        if (dataSet == 0) return -1;
-        int idx;
-        for (idx = 0; dataSet[idx].name_ != dataSetName; ++idx) {
-            if (dataSet[idx].number_ == 0xffff) return -1;
-        }
-        return idx;
+        return dataSetIndex(records_).find(dataSetName, recordId);
     }
 
     TypeId IptcDataSets::dataSetType(uint16_t number, uint16_t recordId)
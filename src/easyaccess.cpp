@@ -24,132 +24,578 @@
 // included header files
 #include "easyaccess.hpp"
 
+// + standard includes
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
 // *****************************************************************************
 namespace {
 
     using namespace Exiv2;
 
+    // Candidate keys of each easy access value, in order of preference
+
+    const char* orientationKeys[] = {
+        "Exif.Image.Orientation",
+        "Exif.Panasonic.Rotation",
+        "Exif.MinoltaCs5D.Rotation",
+        "Exif.MinoltaCs5D.Rotation2",
+        "Exif.MinoltaCs7D.Rotation",
+        "Exif.Sony1MltCsA100.Rotation",
+        "Exif.Sony1Cs.Rotation",
+        "Exif.Sony2Cs.Rotation",
+        "Exif.Sony1Cs2.Rotation",
+        "Exif.Sony2Cs2.Rotation",
+        "Exif.Sony1MltCsA100.Rotation"
+    };
+
+    const char* isoSpeedKeys[] = {
+        "Exif.Photo.ISOSpeedRatings",
+        "Exif.Image.ISOSpeedRatings",
+        "Exif.CanonSi.ISOSpeed",
+        "Exif.CanonCs.ISOSpeed",
+        "Exif.Nikon1.ISOSpeed",
+        "Exif.Nikon2.ISOSpeed",
+        "Exif.Nikon3.ISOSpeed",
+        "Exif.NikonIi.ISO",
+        "Exif.NikonIi.ISO2",
+        "Exif.MinoltaCsNew.ISOSetting",
+        "Exif.MinoltaCsOld.ISOSetting",
+        "Exif.MinoltaCs5D.ISOSpeed",
+        "Exif.MinoltaCs7D.ISOSpeed",
+        "Exif.Sony1Cs.ISOSetting",
+        "Exif.Sony2Cs.ISOSetting",
+        "Exif.Sony1Cs2.ISOSetting",
+        "Exif.Sony2Cs2.ISOSetting",
+        "Exif.Sony1MltCsA100.ISOSetting",
+        "Exif.Pentax.ISO",
+        "Exif.PentaxDng.ISO",
+        "Exif.Olympus.ISOSpeed",
+        "Exif.Samsung2.ISO",
+        "Exif.Casio.ISO",
+        "Exif.Casio2.ISO",
+        "Exif.Casio2.ISOSpeed"
+    };
+
+    const char* flashBiasKeys[] = {
+        "Exif.CanonSi.FlashBias",
+        "Exif.Panasonic.FlashBias",
+        "Exif.Olympus.FlashBias",
+        "Exif.OlympusCs.FlashExposureComp",
+        "Exif.Minolta.FlashExposureComp",
+        "Exif.SonyMinolta.FlashExposureComp",
+        "Exif.Sony1.FlashExposureComp",
+        "Exif.Sony2.FlashExposureComp"
+    };
+
+    const char* exposureModeKeys[] = {
+        "Exif.Photo.ExposureProgram",
+        "Exif.Image.ExposureProgram",
+        "Exif.CanonCs.ExposureProgram",
+        "Exif.MinoltaCs7D.ExposureMode",
+        "Exif.MinoltaCs5D.ExposureMode",
+        "Exif.MinoltaCsNew.ExposureMode",
+        "Exif.MinoltaCsOld.ExposureMode",
+        "Exif.Sony1MltCsA100.ExposureMode",
+        "Exif.Sony1Cs.ExposureProgram",
+        "Exif.Sony2Cs.ExposureProgram",
+        "Exif.Sigma.ExposureMode"
+    };
+
+    const char* sceneModeKeys[] = {
+        "Exif.CanonCs.EasyMode",
+        "Exif.Fujifilm.PictureMode",
+        "Exif.MinoltaCsNew.SubjectProgram",
+        "Exif.MinoltaCsOld.SubjectProgram",
+        "Exif.Minolta.SceneMode",
+        "Exif.SonyMinolta.SceneMode",
+        "Exif.Sony1.SceneMode",
+        "Exif.Sony2.SceneMode",
+        "Exif.OlympusCs.SceneMode",
+        "Exif.Panasonic.ShootingMode",
+        "Exif.Panasonic.SceneMode",
+        "Exif.Pentax.PictureMode",
+        "Exif.PentaxDng.PictureMode",
+        "Exif.Photo.SceneCaptureType"
+    };
+
+    const char* macroModeKeys[] = {
+        "Exif.CanonCs.Macro",
+        "Exif.Fujifilm.Macro",
+        "Exif.Olympus.Macro",
+        "Exif.OlympusCs.MacroMode",
+        "Exif.Panasonic.Macro",
+        "Exif.MinoltaCsNew.MacroMode",
+        "Exif.MinoltaCsOld.MacroMode",
+        "Exif.Sony1.Macro",
+        "Exif.Sony2.Macro"
+    };
+
+    const char* imageQualityKeys[] = {
+        "Exif.CanonCs.Quality",
+        "Exif.Fujifilm.Quality",
+        "Exif.Sigma.Quality",
+        "Exif.Nikon1.Quality",
+        "Exif.Nikon2.Quality",
+        "Exif.Nikon3.Quality",
+        "Exif.Olympus.Quality",
+        "Exif.OlympusCs.Quality",
+        "Exif.Panasonic.Quality",
+        "Exif.Minolta.Quality",
+        "Exif.MinoltaCsNew.Quality",
+        "Exif.MinoltaCsOld.Quality",
+        "Exif.MinoltaCs5D.Quality",
+        "Exif.MinoltaCs7D.Quality",
+        "Exif.Sony1MltCsA100.Quality",
+        "Exif.Sony1.JPEGQuality",
+        "Exif.Sony1.Quality",
+        "Exif.Sony1Cs.Quality",
+        "Exif.Sony2.JPEGQuality",
+        "Exif.Sony2.Quality",
+        "Exif.Sony2Cs.Quality",
+        "Exif.Casio.Quality",
+        "Exif.Casio2.QualityMode",
+        "Exif.Casio2.Quality"
+    };
+
+    const char* whiteBalanceKeys[] = {
+        "Exif.CanonSi.WhiteBalance",
+        "Exif.Fujifilm.WhiteBalance",
+        "Exif.Sigma.WhiteBalance",
+        "Exif.Nikon1.WhiteBalance",
+        "Exif.Nikon2.WhiteBalance",
+        "Exif.Nikon3.WhiteBalance",
+        "Exif.Olympus.WhiteBalance",
+        "Exif.OlympusCs.WhiteBalance",
+        "Exif.Panasonic.WhiteBalance",
+        "Exif.MinoltaCs5D.WhiteBalance",
+        "Exif.MinoltaCs7D.WhiteBalance",
+        "Exif.MinoltaCsNew.WhiteBalance",
+        "Exif.MinoltaCsOld.WhiteBalance",
+        "Exif.Minolta.WhiteBalance",
+        "Exif.Sony1MltCsA100.WhiteBalance",
+        "Exif.SonyMinolta.WhiteBalance",
+        "Exif.Sony1.WhiteBalance",
+        "Exif.Sony2.WhiteBalance",
+        "Exif.Sony1.WhiteBalance2",
+        "Exif.Sony2.WhiteBalance2",
+        "Exif.Casio.WhiteBalance",
+        "Exif.Casio2.WhiteBalance",
+        "Exif.Casio2.WhiteBalance2",
+        "Exif.Photo.WhiteBalance"
+    };
+
+    const char* lensNameKeys[] = {
+        // Exif.Canon.LensModel only reports focal length.
+        // Try Exif.CanonCs.LensType first.
+        "Exif.CanonCs.LensType",
+        "Exif.Photo.LensModel",
+        "Exif.NikonLd1.LensIDNumber",
+        "Exif.NikonLd2.LensIDNumber",
+        "Exif.NikonLd3.LensIDNumber",
+        "Exif.Pentax.LensType",
+        "Exif.PentaxDng.LensType",
+        "Exif.Minolta.LensID",
+        "Exif.SonyMinolta.LensID",
+        "Exif.Sony1.LensID",
+        "Exif.Sony2.LensID",
+        "Exif.OlympusEq.LensType",
+        "Exif.Panasonic.LensType",
+        "Exif.Samsung2.LensType"
+    };
+
+    const char* saturationKeys[] = {
+        "Exif.Photo.Saturation",
+        "Exif.CanonCs.Saturation",
+        "Exif.MinoltaCsNew.Saturation",
+        "Exif.MinoltaCsOld.Saturation",
+        "Exif.MinoltaCs7D.Saturation",
+        "Exif.MinoltaCs5D.Saturation",
+        "Exif.Fujifilm.Color",
+        "Exif.Nikon3.Saturation",
+        "Exif.Panasonic.Saturation",
+        "Exif.Pentax.Saturation",
+        "Exif.PentaxDng.Saturation",
+        "Exif.Sigma.Saturation",
+        "Exif.Casio.Saturation",
+        "Exif.Casio2.Saturation",
+        "Exif.Casio2.Saturation2"
+    };
+
+    const char* sharpnessKeys[] = {
+        "Exif.Photo.Sharpness",
+        "Exif.CanonCs.Sharpness",
+        "Exif.Fujifilm.Sharpness",
+        "Exif.MinoltaCsNew.Sharpness",
+        "Exif.MinoltaCsOld.Sharpness",
+        "Exif.MinoltaCs7D.Sharpness",
+        "Exif.MinoltaCs5D.Sharpness",
+        "Exif.Olympus.SharpnessFactor",
+        "Exif.Panasonic.Sharpness",
+        "Exif.Pentax.Sharpness",
+        "Exif.PentaxDng.Sharpness",
+        "Exif.Sigma.Sharpness",
+        "Exif.Casio.Sharpness",
+        "Exif.Casio2.Sharpness",
+        "Exif.Casio2.Sharpness2"
+    };
+
+    const char* contrastKeys[] = {
+        "Exif.Photo.Contrast",
+        "Exif.CanonCs.Contrast",
+        "Exif.Fujifilm.Tone",
+        "Exif.MinoltaCsNew.Contrast",
+        "Exif.MinoltaCsOld.Contrast",
+        "Exif.MinoltaCs7D.Contrast",
+        "Exif.MinoltaCs5D.Contrast",
+        "Exif.Olympus.Contrast",
+        "Exif.Panasonic.Contrast",
+        "Exif.Pentax.Contrast",
+        "Exif.PentaxDng.Contrast",
+        "Exif.Sigma.Contrast",
+        "Exif.Casio.Contrast",
+        "Exif.Casio2.Contrast",
+        "Exif.Casio2.Contrast2"
+    };
+
+    const char* sceneCaptureTypeKeys[] = {
+        "Exif.Photo.SceneCaptureType",
+        "Exif.Olympus.SpecialMode"
+    };
+
+    const char* meteringModeKeys[] = {
+        "Exif.Photo.MeteringMode",
+        "Exif.Image.MeteringMode",
+        "Exif.CanonCs.MeteringMode",
+        "Exif.Sony1MltCsA100.MeteringMode"
+    };
+
+    const char* makeKeys[] = {
+        "Exif.Image.Make"
+    };
+
+    const char* modelKeys[] = {
+        "Exif.Image.Model"
+    };
+
+    const char* exposureTimeKeys[] = {
+        "Exif.Photo.ExposureTime",
+        "Exif.Image.ExposureTime",
+        "Exif.Samsung2.ExposureTime"
+    };
+
+    const char* fNumberKeys[] = {
+        "Exif.Photo.FNumber",
+        "Exif.Image.FNumber",
+        "Exif.Samsung2.FNumber"
+    };
+
+    const char* subjectDistanceKeys[] = {
+        "Exif.Photo.SubjectDistance",
+        "Exif.Image.SubjectDistance",
+        "Exif.CanonSi.SubjectDistance",
+        "Exif.CanonFi.FocusDistanceUpper",
+        "Exif.CanonFi.FocusDistanceLower",
+        "Exif.MinoltaCsNew.FocusDistance",
+        "Exif.Nikon1.FocusDistance",
+        "Exif.Nikon3.FocusDistance",
+        "Exif.NikonLd2.FocusDistance",
+        "Exif.NikonLd3.FocusDistance",
+        "Exif.Olympus.FocusDistance",
+        "Exif.OlympusFi.FocusDistance",
+        "Exif.Casio.ObjectDistance",
+        "Exif.Casio2.ObjectDistance"
+    };
+
+    const char* serialNumberKeys[] = {
+        "Exif.Image.CameraSerialNumber",
+        "Exif.Canon.SerialNumber",
+        "Exif.Nikon3.SerialNumber",
+        "Exif.Nikon3.SerialNO",
+        "Exif.Fujifilm.SerialNumber",
+        "Exif.Olympus.SerialNumber2",
+        "Exif.Sigma.SerialNumber"
+    };
+
+    const char* focalLengthKeys[] = {
+        "Exif.Photo.FocalLength",
+        "Exif.Image.FocalLength",
+        "Exif.Canon.FocalLength",
+        "Exif.NikonLd2.FocalLength",
+        "Exif.NikonLd3.FocalLength",
+        "Exif.MinoltaCsNew.FocalLength",
+        "Exif.Pentax.FocalLength",
+        "Exif.PentaxDng.FocalLength",
+        "Exif.Casio2.FocalLength"
+    };
+
+    const char* afPointKeys[] = {
+        "Exif.CanonPi.AFPointsUsed",
+        "Exif.CanonPi.AFPointsUsed20D",
+        "Exif.CanonSi.AFPointUsed",
+        "Exif.CanonCs.AFPoint",
+        "Exif.MinoltaCs7D.AFPoints",
+        "Exif.Nikon1.AFFocusPos",
+        "Exif.NikonAf.AFPoint",
+        "Exif.NikonAf.AFPointsInFocus",
+        "Exif.NikonAf2.AFPointsUsed",
+        "Exif.NikonAf2.PrimaryAFPoint",
+        "Exif.OlympusFi.AFPoint",
+        "Exif.Pentax.AFPoint",
+        "Exif.Pentax.AFPointInFocus",
+        "Exif.PentaxDng.AFPoint",
+        "Exif.PentaxDng.AFPointInFocus",
+        "Exif.Sony1Cs.LocalAFAreaPoint",
+        "Exif.Sony2Cs.LocalAFAreaPoint",
+        "Exif.Sony1Cs2.LocalAFAreaPoint",
+        "Exif.Sony2Cs2.LocalAFAreaPoint",
+        "Exif.Sony1MltCsA100.LocalAFAreaPoint",
+        "Exif.Casio.AFPoint",
+        "Exif.Casio2.AFPointPosition"
+    };
+
+    // Keys looked up by isoSpeed() when there is no usable legacy ISO tag
+    const char* sensitivityTypeKeys[] = {
+        "Exif.Photo.SensitivityType"
+    };
+
+    const char* sensitivityKeys[] = {
+        "Exif.Photo.StandardOutputSensitivity",
+        "Exif.Photo.RecommendedExposureIndex",
+        "Exif.Photo.ISOSpeed"
+    };
+
+    //! A list of candidate keys
+    struct KeyList {
+        const char** keys_;                     //!< Candidate keys, in order of preference
+        int count_;                             //!< Number of keys
+    };
+
+    //! Internal key lists, numbered after the public EasyAccessId values
+    const int listSensitivityType = eaAfPoint + 1;
+    const int listSensitivity     = eaAfPoint + 2;
+
+    //! Candidate key lists, indexed by EasyAccessId and the internal list numbers
+    const KeyList keyLists[] = {
+        { orientationKeys, EXV_COUNTOF(orientationKeys) },
+        { isoSpeedKeys, EXV_COUNTOF(isoSpeedKeys) },
+        { flashBiasKeys, EXV_COUNTOF(flashBiasKeys) },
+        { exposureModeKeys, EXV_COUNTOF(exposureModeKeys) },
+        { sceneModeKeys, EXV_COUNTOF(sceneModeKeys) },
+        { macroModeKeys, EXV_COUNTOF(macroModeKeys) },
+        { imageQualityKeys, EXV_COUNTOF(imageQualityKeys) },
+        { whiteBalanceKeys, EXV_COUNTOF(whiteBalanceKeys) },
+        { lensNameKeys, EXV_COUNTOF(lensNameKeys) },
+        { saturationKeys, EXV_COUNTOF(saturationKeys) },
+        { sharpnessKeys, EXV_COUNTOF(sharpnessKeys) },
+        { contrastKeys, EXV_COUNTOF(contrastKeys) },
+        { sceneCaptureTypeKeys, EXV_COUNTOF(sceneCaptureTypeKeys) },
+        { meteringModeKeys, EXV_COUNTOF(meteringModeKeys) },
+        { makeKeys, EXV_COUNTOF(makeKeys) },
+        { modelKeys, EXV_COUNTOF(modelKeys) },
+        { exposureTimeKeys, EXV_COUNTOF(exposureTimeKeys) },
+        { fNumberKeys, EXV_COUNTOF(fNumberKeys) },
+        { subjectDistanceKeys, EXV_COUNTOF(subjectDistanceKeys) },
+        { serialNumberKeys, EXV_COUNTOF(serialNumberKeys) },
+        { focalLengthKeys, EXV_COUNTOF(focalLengthKeys) },
+        { afPointKeys, EXV_COUNTOF(afPointKeys) },
+        { sensitivityTypeKeys, EXV_COUNTOF(sensitivityTypeKeys) },
+        { sensitivityKeys, EXV_COUNTOF(sensitivityKeys) }
+    };
+
     /*!
-      @brief Search \em ed for a Metadatum specified by the \em keys.
-             The \em keys are searched in the order of their appearance, the
-             first available Metadatum is returned.
+      @brief The candidate keys of all key lists, resolved once to IFD and tag
+             and sorted for lookup by IFD and tag.
+     */
+    class LookupPlan {
+    public:
+        //! A candidate key, resolved to IFD and tag
+        struct Candidate {
+            int      ifdId_;                    //!< IFD id of the key
+            uint16_t tag_;                      //!< Tag of the key
+            int      list_;                     //!< Key list the candidate belongs to
+            int      slot_;                     //!< Position over all key lists
+
+            //! Comparison by IFD and tag
+            bool operator<(const Candidate& rhs) const
+            {
+                return ifdId_ < rhs.ifdId_ || (ifdId_ == rhs.ifdId_ && tag_ < rhs.tag_);
+            }
+        };
+        //! Candidate container type
+        typedef std::vector<Candidate> Candidates;
+
+        //! Return the plan, which is built on first use
+        static const LookupPlan& instance()
+        {
+            static const LookupPlan plan;
+            return plan;
+        }
+        //! Return all candidates, sorted by IFD and tag
+        const Candidates& candidates() const { return candidates_; }
+        //! Return the slot of the first key of list \em list
+        int begin(int list) const { return begin_[list]; }
+        //! Return the total number of slots
+        int slots() const { return begin_.back(); }
+
+    private:
+        //! Constructor, resolves all keys
+        LookupPlan()
+        {
+            for (int list = 0; list < static_cast<int>(EXV_COUNTOF(keyLists)); ++list) {
+                begin_.push_back(static_cast<int>(candidates_.size()));
+                for (int i = 0; i < keyLists[list].count_; ++i) {
+                    const ExifKey key(keyLists[list].keys_[i]);
+                    Candidate c = { key.ifdId(), key.tag(), list, static_cast<int>(candidates_.size()) };
+                    candidates_.push_back(c);
+                }
+            }
+            begin_.push_back(static_cast<int>(candidates_.size()));
+            std::stable_sort(candidates_.begin(), candidates_.end());
+        }
 
-      @param ed The %Exif metadata container to search
-      @param keys Array of keys to look for
-      @param count Number of elements in the array
+        Candidates candidates_;
+        std::vector<int> begin_;
+    };
+
+    /*!
+      @brief Result of a single pass over an %ExifData container, which records
+             the first Metadatum for each candidate key of the requested key lists.
      */
-    ExifData::const_iterator findMetadatum(const ExifData& ed,
-                                           const char* keys[],
-                                           int count)
-    {
-        for (int i = 0; i < count; ++i) {
-            ExifData::const_iterator pos = ed.findKey(ExifKey(keys[i]));
-            if (pos != ed.end()) return pos;
+    class Lookup {
+    public:
+        /*!
+          @brief Scan \em ed once for the candidate keys of the key lists in \em lists.
+
+          @param ed The %Exif metadata container to search
+          @param lists Array of key list numbers
+          @param count Number of elements in the array
+         */
+        Lookup(const ExifData& ed, const int lists[], int count)
+            : ed_(ed), plan_(LookupPlan::instance()), found_(plan_.slots(), ed.end())
+        {
+            std::vector<bool> wanted(EXV_COUNTOF(keyLists), false);
+            for (int i = 0; i < count; ++i) wanted[lists[i]] = true;
+
+            const LookupPlan::Candidates& candidates = plan_.candidates();
+            for (ExifData::const_iterator pos = ed.begin(); pos != ed.end(); ++pos) {
+                LookupPlan::Candidate c = { pos->ifdId(), pos->tag(), 0, 0 };
+                LookupPlan::Candidates::const_iterator i = std::lower_bound(candidates.begin(), candidates.end(), c);
+                for (; i != candidates.end() && i->ifdId_ == c.ifdId_ && i->tag_ == c.tag_; ++i) {
+                    if (wanted[i->list_] && found_[i->slot_] == ed.end()) found_[i->slot_] = pos;
+                }
+            }
         }
-        return ed.end();
-    } // findMetadatum
 
-} // anonymous namespace
+        /*!
+          @brief Return the position in key list \em list of the first key
+                 from position \em first onwards which was found, or -1.
+         */
+        int rank(int list, int first = 0) const
+        {
+            const int begin = plan_.begin(list);
+            for (int i = first; i < keyLists[list].count_; ++i) {
+                if (found_[begin + i] != ed_.end()) return i;
+            }
+            return -1;
+        }
 
-// *****************************************************************************
-// class member definitions
-namespace Exiv2 {
+        //! Return the Metadatum found for the key at position \em rank in key list \em list
+        ExifData::const_iterator at(int list, int rank) const
+        {
+            return rank < 0 ? ed_.end() : found_[plan_.begin(list) + rank];
+        }
 
-    ExifData::const_iterator orientation(const ExifData& ed)
+        //! Return the first available Metadatum for the keys of key list \em list
+        ExifData::const_iterator find(int list) const
+        {
+            return at(list, rank(list));
+        }
+
+        //! Return the %Exif metadata container that was searched
+        const ExifData& exifData() const { return ed_; }
+
+    private:
+        const ExifData& ed_;
+        const LookupPlan& plan_;
+        std::vector<ExifData::const_iterator> found_;
+    };
+
+    //! Return the ISO speed from a lookup for eaIsoSpeed and the sensitivity key lists
+    ExifData::const_iterator findIsoSpeed(const Lookup& lookup);
+
+    //! Return the easy access value \em id from a lookup which includes it
+    ExifData::const_iterator findMetadatum(const Lookup& lookup, EasyAccessId id)
     {
-        static const char* keys[] = {
-            "Exif.Image.Orientation",
-            "Exif.Panasonic.Rotation",
-            "Exif.MinoltaCs5D.Rotation",
-            "Exif.MinoltaCs5D.Rotation2",
-            "Exif.MinoltaCs7D.Rotation",
-            "Exif.Sony1MltCsA100.Rotation",
-            "Exif.Sony1Cs.Rotation",
-            "Exif.Sony2Cs.Rotation",
-            "Exif.Sony1Cs2.Rotation",
-            "Exif.Sony2Cs2.Rotation",
-            "Exif.Sony1MltCsA100.Rotation"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        if (id == eaIsoSpeed) return findIsoSpeed(lookup);
+        return lookup.find(id);
     }
 
-    ExifData::const_iterator isoSpeed(const ExifData& ed)
+    /*!
+      @brief Search \em ed for the Metadatum of easy access value \em id.
+             The candidate keys are searched in the order of preference, the
+             first available Metadatum is returned.
+
+      @param ed The %Exif metadata container to search
+      @param id Easy access value to look for
+     */
+    ExifData::const_iterator findMetadatum(const ExifData& ed, EasyAccessId id)
     {
-        static const char* keys[] = {
-            "Exif.Photo.ISOSpeedRatings",
-            "Exif.Image.ISOSpeedRatings",
-            "Exif.CanonSi.ISOSpeed",
-            "Exif.CanonCs.ISOSpeed",
-            "Exif.Nikon1.ISOSpeed",
-            "Exif.Nikon2.ISOSpeed",
-            "Exif.Nikon3.ISOSpeed",
-            "Exif.NikonIi.ISO",
-            "Exif.NikonIi.ISO2",
-            "Exif.MinoltaCsNew.ISOSetting",
-            "Exif.MinoltaCsOld.ISOSetting",
-            "Exif.MinoltaCs5D.ISOSpeed",
-            "Exif.MinoltaCs7D.ISOSpeed",
-            "Exif.Sony1Cs.ISOSetting",
-            "Exif.Sony2Cs.ISOSetting",
-            "Exif.Sony1Cs2.ISOSetting",
-            "Exif.Sony2Cs2.ISOSetting",
-            "Exif.Sony1MltCsA100.ISOSetting",
-            "Exif.Pentax.ISO",
-            "Exif.PentaxDng.ISO",
-            "Exif.Olympus.ISOSpeed",
-            "Exif.Samsung2.ISO",
-            "Exif.Casio.ISO",
-            "Exif.Casio2.ISO",
-            "Exif.Casio2.ISOSpeed"
-        };
+        static const int isoLists[] = { eaIsoSpeed, listSensitivityType, listSensitivity };
+        const int list = id;
+        const Lookup lookup = id == eaIsoSpeed ? Lookup(ed, isoLists, EXV_COUNTOF(isoLists))
+                                               : Lookup(ed, &list, 1);
+        return findMetadatum(lookup, id);
+    } // findMetadatum
+
+    ExifData::const_iterator findIsoSpeed(const Lookup& lookup)
+    {
+        const ExifData& ed = lookup.exifData();
 
         struct SensKeyNameList {
             int count;
-            const char* keys[3];
+            int keys[3];
         };
 
         // covers Exif.Phot.SensitivityType values 1-7. Note that SOS, REI and
         // ISO do differ in their meaning. Values coming first in a list (and
         // existing as a tag) are picked up first and used as the "ISO" value.
+        // The numbers are positions in sensitivityKeys: 0 is SOS, 1 is REI and 2 is ISO.
         static const SensKeyNameList sensitivityKey[] = {
-            { 1, { "Exif.Photo.StandardOutputSensitivity" }},
-            { 1, { "Exif.Photo.RecommendedExposureIndex" }},
-            { 1, { "Exif.Photo.ISOSpeed" }},
-            { 2, { "Exif.Photo.RecommendedExposureIndex", "Exif.Photo.StandardOutputSensitivity" }},
-            { 2, { "Exif.Photo.ISOSpeed", "Exif.Photo.StandardOutputSensitivity" }},
-            { 2, { "Exif.Photo.ISOSpeed", "Exif.Photo.RecommendedExposureIndex" }},
-            { 3, { "Exif.Photo.ISOSpeed", "Exif.Photo.RecommendedExposureIndex", "Exif.Photo.StandardOutputSensitivity" }}
-        };
-
-        static const char* sensitivityType[] = {
-            "Exif.Photo.SensitivityType"
+            { 1, { 0 }},
+            { 1, { 1 }},
+            { 1, { 2 }},
+            { 2, { 1, 0 }},
+            { 2, { 2, 0 }},
+            { 2, { 2, 1 }},
+            { 3, { 2, 1, 0 }}
         };
 
         // Find the first ISO value which is not "0"
-        const int cnt = EXV_COUNTOF(keys);
         ExifData::const_iterator md = ed.end();
         long iso_val = -1;
-        for (int idx = 0; idx < cnt; ) {
-            md = findMetadatum(ed, keys + idx, cnt - idx);
+        for (int idx = 0; ; ) {
+            const int rank = lookup.rank(eaIsoSpeed, idx);
+            md = lookup.at(eaIsoSpeed, rank);
             if (md == ed.end()) break;
             std::ostringstream os;
             md->write(os, &ed);
             bool ok = false;
             iso_val = parseLong(os.str(), ok);
             if (ok && iso_val > 0) break;
-            while (strcmp(keys[idx++], md->key().c_str()) != 0 && idx < cnt) {}
+            idx = rank + 1;
             md = ed.end();
         }
 
         // there is either a possible ISO "overflow" or no legacy
         // ISO tag at all. Check for SensitivityType tag and the referenced
         // ISO value (see EXIF 2.3 Annex G)
-        long iso_tmp_val = -1;
-        while (iso_tmp_val == -1 && (iso_val == 65535 || md == ed.end())) {
-            ExifData::const_iterator md_st = findMetadatum(ed, sensitivityType, 1);
+        if (iso_val == 65535 || md == ed.end()) {
+            ExifData::const_iterator md_st = lookup.find(listSensitivityType);
             // no SensitivityType? exit with existing data
             if (md_st == ed.end())
-                break;
+                return md;
             // otherwise pick up actual value and grab value accordingly
             std::ostringstream os;
             md_st->write(os, &ed);
@@ -157,387 +603,160 @@ namespace Exiv2 {
             const long st_val = parseLong(os.str(), ok);
             // SensivityType out of range or cannot be parsed properly
             if (!ok || st_val < 1 || st_val > 7)
-                break;
+                return md;
             // pick up list of ISO tags, and check for at least one of
             // them available.
             const SensKeyNameList *sensKeys = &sensitivityKey[st_val - 1];
-            for (int idx = 0; idx < sensKeys->count; md_st = ed.end()) {
-                md_st = findMetadatum(ed, const_cast<const char**>(sensKeys->keys), sensKeys->count);
-                if (md_st == ed.end())
-                    break;
-                std::ostringstream os_iso;
-                md_st->write(os_iso, &ed);
-                ok = false;
-                iso_tmp_val = parseLong(os_iso.str(), ok);
-                // something wrong with the value
-                if (ok || iso_tmp_val > 0) {
-                    md = md_st;
-                    break;
-                }
-                while (strcmp(sensKeys->keys[idx++], md_st->key().c_str()) != 0 && idx < sensKeys->count) {}
+            md_st = ed.end();
+            for (int idx = 0; idx < sensKeys->count && md_st == ed.end(); ++idx) {
+                md_st = lookup.at(listSensitivity, sensKeys->keys[idx]);
+            }
+            if (md_st == ed.end())
+                return md;
+            std::ostringstream os_iso;
+            md_st->write(os_iso, &ed);
+            ok = false;
+            const long iso_tmp_val = parseLong(os_iso.str(), ok);
+            // something wrong with the value
+            if (ok || iso_tmp_val > 0) {
+                md = md_st;
             }
-            break;
         }
 
         return md;
+    } // findIsoSpeed
+
+} // anonymous namespace
+
+// *****************************************************************************
+// class member definitions
+namespace Exiv2 {
+
+    ExifData::const_iterator orientation(const ExifData& ed)
+    {
+        return findMetadatum(ed, eaOrientation);
+    }
+
+    ExifData::const_iterator isoSpeed(const ExifData& ed)
+    {
+        return findMetadatum(ed, eaIsoSpeed);
     }
 
     ExifData::const_iterator flashBias(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.CanonSi.FlashBias",
-            "Exif.Panasonic.FlashBias",
-            "Exif.Olympus.FlashBias",
-            "Exif.OlympusCs.FlashExposureComp",
-            "Exif.Minolta.FlashExposureComp",
-            "Exif.SonyMinolta.FlashExposureComp",
-            "Exif.Sony1.FlashExposureComp",
-            "Exif.Sony2.FlashExposureComp"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaFlashBias);
     }
 
     ExifData::const_iterator exposureMode(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.Photo.ExposureProgram",
-            "Exif.Image.ExposureProgram",
-            "Exif.CanonCs.ExposureProgram",
-            "Exif.MinoltaCs7D.ExposureMode",
-            "Exif.MinoltaCs5D.ExposureMode",
-            "Exif.MinoltaCsNew.ExposureMode",
-            "Exif.MinoltaCsOld.ExposureMode",
-            "Exif.Sony1MltCsA100.ExposureMode",
-            "Exif.Sony1Cs.ExposureProgram",
-            "Exif.Sony2Cs.ExposureProgram",
-            "Exif.Sigma.ExposureMode"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaExposureMode);
     }
 
     ExifData::const_iterator sceneMode(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.CanonCs.EasyMode",
-            "Exif.Fujifilm.PictureMode",
-            "Exif.MinoltaCsNew.SubjectProgram",
-            "Exif.MinoltaCsOld.SubjectProgram",
-            "Exif.Minolta.SceneMode",
-            "Exif.SonyMinolta.SceneMode",
-            "Exif.Sony1.SceneMode",
-            "Exif.Sony2.SceneMode",
-            "Exif.OlympusCs.SceneMode",
-            "Exif.Panasonic.ShootingMode",
-            "Exif.Panasonic.SceneMode",
-            "Exif.Pentax.PictureMode",
-            "Exif.PentaxDng.PictureMode",
-            "Exif.Photo.SceneCaptureType"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaSceneMode);
     }
 
     ExifData::const_iterator macroMode(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.CanonCs.Macro",
-            "Exif.Fujifilm.Macro",
-            "Exif.Olympus.Macro",
-            "Exif.OlympusCs.MacroMode",
-            "Exif.Panasonic.Macro",
-            "Exif.MinoltaCsNew.MacroMode",
-            "Exif.MinoltaCsOld.MacroMode",
-            "Exif.Sony1.Macro",
-            "Exif.Sony2.Macro"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaMacroMode);
     }
 
     ExifData::const_iterator imageQuality(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.CanonCs.Quality",
-            "Exif.Fujifilm.Quality",
-            "Exif.Sigma.Quality",
-            "Exif.Nikon1.Quality",
-            "Exif.Nikon2.Quality",
-            "Exif.Nikon3.Quality",
-            "Exif.Olympus.Quality",
-            "Exif.OlympusCs.Quality",
-            "Exif.Panasonic.Quality",
-            "Exif.Minolta.Quality",
-            "Exif.MinoltaCsNew.Quality",
-            "Exif.MinoltaCsOld.Quality",
-            "Exif.MinoltaCs5D.Quality",
-            "Exif.MinoltaCs7D.Quality",
-            "Exif.Sony1MltCsA100.Quality",
-            "Exif.Sony1.JPEGQuality",
-            "Exif.Sony1.Quality",
-            "Exif.Sony1Cs.Quality",
-            "Exif.Sony2.JPEGQuality",
-            "Exif.Sony2.Quality",
-            "Exif.Sony2Cs.Quality",
-            "Exif.Casio.Quality",
-            "Exif.Casio2.QualityMode",
-            "Exif.Casio2.Quality"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaImageQuality);
     }
 
     ExifData::const_iterator whiteBalance(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.CanonSi.WhiteBalance",
-            "Exif.Fujifilm.WhiteBalance",
-            "Exif.Sigma.WhiteBalance",
-            "Exif.Nikon1.WhiteBalance",
-            "Exif.Nikon2.WhiteBalance",
-            "Exif.Nikon3.WhiteBalance",
-            "Exif.Olympus.WhiteBalance",
-            "Exif.OlympusCs.WhiteBalance",
-            "Exif.Panasonic.WhiteBalance",
-            "Exif.MinoltaCs5D.WhiteBalance",
-            "Exif.MinoltaCs7D.WhiteBalance",
-            "Exif.MinoltaCsNew.WhiteBalance",
-            "Exif.MinoltaCsOld.WhiteBalance",
-            "Exif.Minolta.WhiteBalance",
-            "Exif.Sony1MltCsA100.WhiteBalance",
-            "Exif.SonyMinolta.WhiteBalance",
-            "Exif.Sony1.WhiteBalance",
-            "Exif.Sony2.WhiteBalance",
-            "Exif.Sony1.WhiteBalance2",
-            "Exif.Sony2.WhiteBalance2",
-            "Exif.Casio.WhiteBalance",
-            "Exif.Casio2.WhiteBalance",
-            "Exif.Casio2.WhiteBalance2",
-            "Exif.Photo.WhiteBalance"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaWhiteBalance);
     }
 
     ExifData::const_iterator lensName(const ExifData& ed)
     {
-        static const char* keys[] = {
-            // Exif.Canon.LensModel only reports focal length.
-            // Try Exif.CanonCs.LensType first.
-            "Exif.CanonCs.LensType",
-            "Exif.Photo.LensModel",
-            "Exif.NikonLd1.LensIDNumber",
-            "Exif.NikonLd2.LensIDNumber",
-            "Exif.NikonLd3.LensIDNumber",
-            "Exif.Pentax.LensType",
-            "Exif.PentaxDng.LensType",
-            "Exif.Minolta.LensID",
-            "Exif.SonyMinolta.LensID",
-            "Exif.Sony1.LensID",
-            "Exif.Sony2.LensID",
-            "Exif.OlympusEq.LensType",
-            "Exif.Panasonic.LensType",
-            "Exif.Samsung2.LensType"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaLensName);
     }
 
     ExifData::const_iterator saturation(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.Photo.Saturation",
-            "Exif.CanonCs.Saturation",
-            "Exif.MinoltaCsNew.Saturation",
-            "Exif.MinoltaCsOld.Saturation",
-            "Exif.MinoltaCs7D.Saturation",
-            "Exif.MinoltaCs5D.Saturation",
-            "Exif.Fujifilm.Color",
-            "Exif.Nikon3.Saturation",
-            "Exif.Panasonic.Saturation",
-            "Exif.Pentax.Saturation",
-            "Exif.PentaxDng.Saturation",
-            "Exif.Sigma.Saturation",
-            "Exif.Casio.Saturation",
-            "Exif.Casio2.Saturation",
-            "Exif.Casio2.Saturation2"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaSaturation);
     }
 
     ExifData::const_iterator sharpness(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.Photo.Sharpness",
-            "Exif.CanonCs.Sharpness",
-            "Exif.Fujifilm.Sharpness",
-            "Exif.MinoltaCsNew.Sharpness",
-            "Exif.MinoltaCsOld.Sharpness",
-            "Exif.MinoltaCs7D.Sharpness",
-            "Exif.MinoltaCs5D.Sharpness",
-            "Exif.Olympus.SharpnessFactor",
-            "Exif.Panasonic.Sharpness",
-            "Exif.Pentax.Sharpness",
-            "Exif.PentaxDng.Sharpness",
-            "Exif.Sigma.Sharpness",
-            "Exif.Casio.Sharpness",
-            "Exif.Casio2.Sharpness",
-            "Exif.Casio2.Sharpness2"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaSharpness);
     }
 
     ExifData::const_iterator contrast(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.Photo.Contrast",
-            "Exif.CanonCs.Contrast",
-            "Exif.Fujifilm.Tone",
-            "Exif.MinoltaCsNew.Contrast",
-            "Exif.MinoltaCsOld.Contrast",
-            "Exif.MinoltaCs7D.Contrast",
-            "Exif.MinoltaCs5D.Contrast",
-            "Exif.Olympus.Contrast",
-            "Exif.Panasonic.Contrast",
-            "Exif.Pentax.Contrast",
-            "Exif.PentaxDng.Contrast",
-            "Exif.Sigma.Contrast",
-            "Exif.Casio.Contrast",
-            "Exif.Casio2.Contrast",
-            "Exif.Casio2.Contrast2"
-
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaContrast);
     }
 
     ExifData::const_iterator sceneCaptureType(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.Photo.SceneCaptureType",
-            "Exif.Olympus.SpecialMode"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaSceneCaptureType);
     }
 
     ExifData::const_iterator meteringMode(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.Photo.MeteringMode",
-            "Exif.Image.MeteringMode",
-            "Exif.CanonCs.MeteringMode",
-            "Exif.Sony1MltCsA100.MeteringMode"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaMeteringMode);
     }
 
     ExifData::const_iterator make(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.Image.Make"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaMake);
     }
 
     ExifData::const_iterator model(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.Image.Model"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaModel);
     }
 
     ExifData::const_iterator exposureTime(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.Photo.ExposureTime",
-            "Exif.Image.ExposureTime",
-            "Exif.Samsung2.ExposureTime"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaExposureTime);
     }
 
     ExifData::const_iterator fNumber(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.Photo.FNumber",
-            "Exif.Image.FNumber",
-            "Exif.Samsung2.FNumber"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaFNumber);
     }
 
     ExifData::const_iterator subjectDistance(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.Photo.SubjectDistance",
-            "Exif.Image.SubjectDistance",
-            "Exif.CanonSi.SubjectDistance",
-            "Exif.CanonFi.FocusDistanceUpper",
-            "Exif.CanonFi.FocusDistanceLower",
-            "Exif.MinoltaCsNew.FocusDistance",
-            "Exif.Nikon1.FocusDistance",
-            "Exif.Nikon3.FocusDistance",
-            "Exif.NikonLd2.FocusDistance",
-            "Exif.NikonLd3.FocusDistance",
-            "Exif.Olympus.FocusDistance",
-            "Exif.OlympusFi.FocusDistance",
-            "Exif.Casio.ObjectDistance",
-            "Exif.Casio2.ObjectDistance"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaSubjectDistance);
     }
 
     ExifData::const_iterator serialNumber(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.Image.CameraSerialNumber",
-            "Exif.Canon.SerialNumber",
-            "Exif.Nikon3.SerialNumber",
-            "Exif.Nikon3.SerialNO",
-            "Exif.Fujifilm.SerialNumber",
-            "Exif.Olympus.SerialNumber2",
-            "Exif.Sigma.SerialNumber"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaSerialNumber);
     }
 
     ExifData::const_iterator focalLength(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.Photo.FocalLength",
-            "Exif.Image.FocalLength",
-            "Exif.Canon.FocalLength",
-            "Exif.NikonLd2.FocalLength",
-            "Exif.NikonLd3.FocalLength",
-            "Exif.MinoltaCsNew.FocalLength",
-            "Exif.Pentax.FocalLength",
-            "Exif.PentaxDng.FocalLength",
-            "Exif.Casio2.FocalLength"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaFocalLength);
     }
 
     ExifData::const_iterator afPoint(const ExifData& ed)
     {
-        static const char* keys[] = {
-            "Exif.CanonPi.AFPointsUsed",
-            "Exif.CanonPi.AFPointsUsed20D",
-            "Exif.CanonSi.AFPointUsed",
-            "Exif.CanonCs.AFPoint",
-            "Exif.MinoltaCs7D.AFPoints",
-            "Exif.Nikon1.AFFocusPos",
-            "Exif.NikonAf.AFPoint",
-            "Exif.NikonAf.AFPointsInFocus",
-            "Exif.NikonAf2.AFPointsUsed",
-            "Exif.NikonAf2.PrimaryAFPoint",
-            "Exif.OlympusFi.AFPoint",
-            "Exif.Pentax.AFPoint",
-            "Exif.Pentax.AFPointInFocus",
-            "Exif.PentaxDng.AFPoint",
-            "Exif.PentaxDng.AFPointInFocus",
-            "Exif.Sony1Cs.LocalAFAreaPoint",
-            "Exif.Sony2Cs.LocalAFAreaPoint",
-            "Exif.Sony1Cs2.LocalAFAreaPoint",
-            "Exif.Sony2Cs2.LocalAFAreaPoint",
-            "Exif.Sony1MltCsA100.LocalAFAreaPoint",
-            "Exif.Casio.AFPoint",
-            "Exif.Casio2.AFPointPosition"
-        };
-        return findMetadatum(ed, keys, EXV_COUNTOF(keys));
+        return findMetadatum(ed, eaAfPoint);
+    }
+
+    std::vector<ExifData::const_iterator> easyAccess(const ExifData& ed, const std::vector<EasyAccessId>& ids)
+    {
+        std::vector<int> lists(ids.begin(), ids.end());
+        if (std::find(ids.begin(), ids.end(), eaIsoSpeed) != ids.end()) {
+            lists.push_back(listSensitivityType);
+            lists.push_back(listSensitivity);
+        }
+        const Lookup lookup(ed, lists.data(), static_cast<int>(lists.size()));
+
+        std::vector<ExifData::const_iterator> result;
+        result.reserve(ids.size());
+        for (std::vector<EasyAccessId>::const_iterator id = ids.begin(); id != ids.end(); ++id) {
+            result.push_back(findMetadatum(lookup, *id));
+        }
+        return result;
     }
 
 }                                       // namespace Exiv2
@@ -168,6 +168,9 @@ namespace {
           N_("Memory allocation failed")}
     };
 
+    //! The log message handler of the thread, see LogMsg::setThreadHandler()
+    thread_local Exiv2::LogMsg::Handler threadLogHandler = 0;
+
 }
 
 // *****************************************************************************
@@ -183,7 +186,7 @@ namespace Exiv2 {
     LogMsg::~LogMsg()
     {
         if (msgType_ >= level_ && handler_)
-            handler_(msgType_, os_.str().c_str());
+            (threadLogHandler ? threadLogHandler : handler_)(msgType_, os_.str().c_str());
     }
 
     std::ostringstream &LogMsg::os() { return os_; }
@@ -192,10 +195,14 @@ namespace Exiv2 {
 
     void LogMsg::setHandler(LogMsg::Handler handler) { handler_ = handler; }
 
+    void LogMsg::setThreadHandler(LogMsg::Handler handler) { threadLogHandler = handler; }
+
     LogMsg::Level LogMsg::level() { return level_; }
 
     LogMsg::Handler LogMsg::handler() { return handler_; }
 
+    LogMsg::Handler LogMsg::threadHandler() { return threadLogHandler; }
+
     void LogMsg::defaultHandler(int level, const char* s)
     {
         switch (static_cast<LogMsg::Level>(level)) {
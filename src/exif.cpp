@@ -29,6 +29,7 @@
 
 #include "exif.hpp"
 #include "metadatum.hpp"
+#include "metadatum_int.hpp"
 #include "tags.hpp"
 #include "tags_int.hpp"
 #include "value.hpp"
@@ -39,7 +40,12 @@
 #include "tiffimage_int.hpp"
 #include "tiffcomposite_int.hpp" // for Tag::root
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 // *****************************************************************************
 namespace {
@@ -173,6 +179,37 @@ namespace {
 // *****************************************************************************
 // class member definitions
 namespace Exiv2 {
+    namespace Internal {
+
+    //! Positions of the first %Exifdatum of each key of the Exif metadata
+    class ExifKeyIndex {
+    public:
+        //! Index the keys of \em metadata, each key is built once
+        explicit ExifKeyIndex(const ExifMetadata& metadata)
+        {
+            entries_.reserve(metadata.size());
+            for (auto i = metadata.begin(); i != metadata.end(); ++i) {
+                entries_.push_back(Entry{i->key(), i});
+            }
+            std::stable_sort(entries_.begin(), entries_.end());
+        }
+        //! Return the position of the first %Exifdatum with \em key, \em end if there is none
+        ExifMetadata::const_iterator find(const std::string& key, ExifMetadata::const_iterator end) const
+        {
+            auto pos = std::lower_bound(entries_.begin(), entries_.end(), key,
+                                        [](const Entry& e, const std::string& k) { return e.key_ < k; });
+            return pos == entries_.end() || pos->key_ != key ? end : pos->position_;
+        }
+
+    private:
+        //! A key and the position of its %Exifdatum
+        typedef KeyPosition<ExifMetadata::const_iterator> Entry;
+
+        // DATA
+        std::vector<Entry> entries_;            //!< Entries sorted by key
+    };
+
+    }                                   // namespace Internal
 
     using namespace Internal;
 
@@ -191,11 +228,12 @@ namespace Exiv2 {
             = std::unique_ptr<Exiv2::ValueType<T> >(new Exiv2::ValueType<T>);
         v->value_.push_back(value);
         exifDatum.value_ = std::move(v);
+        exifDatum.modified_ = true;
         return exifDatum;
     }
 
     Exifdatum::Exifdatum(const ExifKey& key, const Value* pValue)
-        : key_(key.clone())
+        : key_(key.clone()), modified_(true)
     {
         if (pValue) value_ = pValue->clone();
     }
@@ -205,7 +243,7 @@ namespace Exiv2 {
     }
 
     Exifdatum::Exifdatum(const Exifdatum& rhs)
-        : Metadatum(rhs)
+        : Metadatum(rhs), modified_(rhs.modified_)
     {
         if (rhs.key_.get() != 0) key_ = rhs.key_->clone(); // deep copy
         if (rhs.value_.get() != 0) value_ = rhs.value_->clone(); // deep copy
@@ -237,6 +275,7 @@ namespace Exiv2 {
         value_.reset();
         if (rhs.value_.get() != 0) value_ = rhs.value_->clone(); // deep copy
 
+        modified_ = true;
         return *this;
     } // Exifdatum::operator=
 
@@ -286,6 +325,7 @@ namespace Exiv2 {
     {
         value_.reset();
         if (pValue) value_ = pValue->clone();
+        modified_ = true;
     }
 
     int Exifdatum::setValue(const std::string& value)
@@ -294,12 +334,15 @@ namespace Exiv2 {
             TypeId type = key_->defaultTypeId();
             value_ = Value::create(type);
         }
+        modified_ = true;
         return value_->read(value);
     }
 
     int Exifdatum::setDataArea(const byte* buf, size_t len)
     {
-        return value_.get() == 0 ? -1 : value_->setDataArea(buf, len);
+        if (value_.get() == 0) return -1;
+        modified_ = true;
+        return value_->setDataArea(buf, len);
     }
 
     std::string Exifdatum::key() const
@@ -347,6 +390,11 @@ namespace Exiv2 {
         return key_.get() == 0 ? 0 : key_->idx();
     }
 
+    bool Exifdatum::modified() const
+    {
+        return modified_;
+    }
+
     long Exifdatum::copy(byte* buf, ByteOrder byteOrder) const
     {
         return value_.get() == 0 ? 0 : value_->copy(buf, byteOrder);
@@ -539,6 +587,59 @@ namespace Exiv2 {
         eraseIfd(exifData_, ifd1Id);
     }
 
+    struct ExifData::Impl {
+        Impl() : origin_(0) {}
+
+        const void* origin_;  //!< Where the metadata was read from, see setOrigin()
+        //! Positions of the keys, created on demand by findIndexedKey()
+        std::shared_ptr<const ExifKeyIndex> keyIndex_;
+    };
+
+    ExifData::ExifData()
+        : p_(new Impl)
+    {
+    }
+
+    ExifData::ExifData(const ExifData& rhs)
+        : exifMetadata_(rhs.exifMetadata_), p_(new Impl)
+    {
+        p_->origin_ = rhs.p_->origin_;
+    }
+
+    ExifData::ExifData(ExifData&& rhs)
+        : exifMetadata_(std::move(rhs.exifMetadata_)), p_(new Impl)
+    {
+        p_->origin_ = rhs.p_->origin_;
+        rhs.exifMetadata_.clear();
+        rhs.p_->origin_ = 0;
+        rhs.p_->keyIndex_.reset();
+    }
+
+    ExifData::~ExifData()
+    {
+    }
+
+    ExifData& ExifData::operator=(const ExifData& rhs)
+    {
+        if (this == &rhs) return *this;
+        exifMetadata_ = rhs.exifMetadata_;
+        p_->origin_ = 0;
+        p_->keyIndex_.reset();
+        return *this;
+    }
+
+    ExifData& ExifData::operator=(ExifData&& rhs)
+    {
+        if (this == &rhs) return *this;
+        exifMetadata_ = std::move(rhs.exifMetadata_);
+        p_->origin_ = 0;
+        p_->keyIndex_.reset();
+        rhs.exifMetadata_.clear();
+        rhs.p_->origin_ = 0;
+        rhs.p_->keyIndex_.reset();
+        return *this;
+    }
+
     Exifdatum& ExifData::operator[](const std::string& key)
     {
         ExifKey exifKey(key);
@@ -559,6 +660,20 @@ namespace Exiv2 {
     {
         // allow duplicates
         exifMetadata_.push_back(exifdatum);
+        exifMetadata_.back().modified_ = true;
+        p_->keyIndex_.reset();
+    }
+
+    void ExifData::append(ExifData& exifData)
+    {
+        if (this == &exifData || exifData.empty()) return;
+        for (auto&& exifdatum : exifData.exifMetadata_) {
+            exifdatum.modified_ = true;
+        }
+        exifMetadata_.splice(exifMetadata_.end(), exifData.exifMetadata_);
+        p_->keyIndex_.reset();
+        exifData.p_->origin_ = 0;
+        exifData.p_->keyIndex_.reset();
     }
 
     ExifData::const_iterator ExifData::findKey(const ExifKey& key) const
@@ -567,10 +682,25 @@ namespace Exiv2 {
                             FindExifdatumByKey(key.key()));
     }
 
+    ExifData::const_iterator ExifData::findIndexedKey(const std::string& key) const
+    {
+        std::shared_ptr<const Internal::ExifKeyIndex> index = std::atomic_load(&p_->keyIndex_);
+        if (!index) {
+            index = std::make_shared<const Internal::ExifKeyIndex>(exifMetadata_);
+            std::atomic_store(&p_->keyIndex_, index);
+        }
+        const const_iterator pos = index->find(key, exifMetadata_.end());
+        if (pos == exifMetadata_.end() || pos->key() == key) return pos;
+        // The key was changed through an iterator
+        return std::find_if(exifMetadata_.begin(), exifMetadata_.end(), FindExifdatumByKey(key));
+    }
+
     bool ExifData::empty() const { return count() == 0; }
 
     long ExifData::count() const { return static_cast<long>(exifMetadata_.size()); }
 
+    const void* ExifData::origin() const { return p_->origin_; }
+
     ExifData::iterator ExifData::findKey(const ExifKey& key)
     {
         return std::find_if(exifMetadata_.begin(), exifMetadata_.end(),
@@ -580,25 +710,43 @@ namespace Exiv2 {
     void ExifData::clear()
     {
         exifMetadata_.clear();
+        p_->origin_ = 0;
+        p_->keyIndex_.reset();
     }
 
     void ExifData::sortByKey()
     {
-        exifMetadata_.sort(cmpMetadataByKey);
+        Internal::sortByKey(exifMetadata_);
+        p_->keyIndex_.reset();
     }
 
     void ExifData::sortByTag()
     {
         exifMetadata_.sort(cmpMetadataByTag);
+        p_->keyIndex_.reset();
+    }
+
+    void ExifData::setOrigin(const void* origin)
+    {
+        for (auto&& exifdatum : exifMetadata_) {
+            exifdatum.modified_ = false;
+        }
+        p_->origin_ = origin;
     }
 
     ExifData::iterator ExifData::erase(ExifData::iterator beg, ExifData::iterator end)
     {
+        if (beg != end) {
+            p_->origin_ = 0;
+            p_->keyIndex_.reset();
+        }
         return exifMetadata_.erase(beg, end);
     }
 
     ExifData::iterator ExifData::erase(ExifData::iterator pos)
     {
+        p_->origin_ = 0;
+        p_->keyIndex_.reset();
         return exifMetadata_.erase(pos);
     }
 
@@ -31,7 +31,381 @@
 #include "params.hpp"
 #include "i18n.h"  // NLS support.
 
+#include <exiv2/error.hpp>
 #include <exiv2/futils.hpp>
+#include <exiv2/stats.hpp>
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    //! True if \em action writes the image read from stdin to stdout, see Action::pipeToStdout()
+    bool pipesToStdout(int action)
+    {
+        return action == Action::modify || action == Action::erase || action == Action::adjust ||
+               action == Action::fixiso || action == Action::fixcom;
+    }
+
+    //! Send the output of std::cout to std::cerr while it exists
+    class CoutToCerr {
+    public:
+        CoutToCerr() : out_(std::cout.rdbuf(std::cerr.rdbuf()))
+        {
+        }
+        ~CoutToCerr()
+        {
+            std::cout.rdbuf(out_);
+        }
+        CoutToCerr(const CoutToCerr&) = delete;
+        CoutToCerr& operator=(const CoutToCerr&) = delete;
+
+    private:
+        std::streambuf* out_;
+    };
+
+    //! Run the action of the parsed command line on all its files
+    int processFiles(Params& params)
+    {
+        int rc = EXIT_SUCCESS;
+        if (params.stats_) {
+            Exiv2::Stats::reset();
+        }
+
+        try {
+            // Create the required action class
+            Action::TaskFactory& taskFactory = Action::TaskFactory::instance();
+            auto task = taskFactory.create(Action::TaskType(params.action_));
+            assert(task);
+
+            // Process all files
+            int n = 1;
+            int s = static_cast<int>(params.files_.size());
+            int w = s > 9 ? s > 99 ? 3 : 2 : 1;
+            for (Params::Files::const_iterator i = params.files_.begin(); i != params.files_.end(); ++i) {
+                // Stdout carries the image, so the messages go to stderr
+                std::unique_ptr<CoutToCerr> coutToCerr;
+                if (*i == "-" && pipesToStdout(params.action_)) {
+                    coutToCerr.reset(new CoutToCerr);
+                }
+                if (params.verbose_) {
+                    std::cout << _("File") << " " << std::setw(w) << std::right << n++ << "/" << s << ": " << *i
+                              << std::endl;
+                }
+                int ret = task->run(*i);
+                if (rc == EXIT_SUCCESS)
+                    rc = ret;
+            }
+
+        } catch (const std::exception& exc) {
+            std::cerr << "Uncaught exception: " << exc.what() << std::endl;
+            rc = EXIT_FAILURE;
+        }
+
+        if (params.stats_) {
+            if (Exiv2::Stats::enabled()) {
+                Exiv2::Stats::print(std::cerr, Exiv2::Stats::snapshot());
+            } else {
+                std::cerr << params.progname() << ": "
+                          << _("The library was built without counters (EXIV2_ENABLE_STATS)\n");
+            }
+        }
+        return rc;
+    }
+
+    /*!
+      @brief Split a command line of the stay-open mode into its arguments.
+             Arguments are separated by blanks, which can be quoted with
+             single or double quotes or escaped with a backslash.
+
+      @return false if a quote is not closed.
+     */
+    bool splitCommandLine(const std::string& line, std::vector<std::string>& args)
+    {
+        std::string arg;
+        bool inArg = false;
+        char quote = 0;
+        for (size_t i = 0; i < line.size(); ++i) {
+            const char c = line[i];
+            if (quote) {
+                if (c == quote) {
+                    quote = 0;
+                } else if (c == '\\' && quote == '"' && i + 1 < line.size() &&
+                           (line[i + 1] == '"' || line[i + 1] == '\\')) {
+                    arg += line[++i];
+                } else {
+                    arg += c;
+                }
+            } else if (c == '\'' || c == '"') {
+                quote = c;
+                inArg = true;
+            } else if (c == '\\' && i + 1 < line.size()) {
+                arg += line[++i];
+                inArg = true;
+            } else if (c == ' ' || c == '\t' || c == '\r') {
+                if (inArg) {
+                    args.push_back(arg);
+                    arg.clear();
+                    inArg = false;
+                }
+            } else {
+                arg += c;
+                inArg = true;
+            }
+        }
+        if (inArg) {
+            args.push_back(arg);
+        }
+        return quote == 0;
+    }
+
+    //! Parse and run one command line of the stay-open mode
+    int runCommandLine(const std::string& progname, const std::string& line)
+    {
+        std::vector<std::string> args(1, progname);
+        if (!splitCommandLine(line, args)) {
+            std::cerr << progname << ": " << _("Unbalanced quotes in the command line\n");
+            return EXIT_FAILURE;
+        }
+        std::vector<char*> argv;
+        for (auto&& arg : args) {
+            argv.push_back(&arg[0]);
+        }
+        argv.push_back(nullptr);
+
+        Params& params = Params::instance();
+        params.reset();
+        if (params.getopt(static_cast<int>(args.size()), &argv[0])) {
+            params.usage();
+            return EXIT_FAILURE;
+        }
+        if (params.help_) {
+            params.help();
+            return EXIT_SUCCESS;
+        }
+        if (params.version_) {
+            params.version(params.verbose_);
+            return EXIT_SUCCESS;
+        }
+        if (!params.stayOpen_.empty()) {
+            std::cerr << progname << ": " << _("-s option cannot be used in stay-open mode\n");
+            return EXIT_FAILURE;
+        }
+        // The standard input and output carry the commands and their results
+        bool stdInOut = (params.target_ & Params::ctStdInOut) != 0;
+        for (auto&& file : params.files_) {
+            stdInOut = stdInOut || file == "-";
+        }
+        if (stdInOut) {
+            std::cerr << progname << ": " << _("Standard input and output cannot be used in stay-open mode\n");
+            return EXIT_FAILURE;
+        }
+        return processFiles(params);
+    }
+
+    /*!
+      @brief Run the command lines read from \em in one after the other, each
+             followed by a line {ready <rc>} on the standard output. The log
+             level of each command line starts at \em level.
+
+      @return true if the line 'exit' was read, false at the end of the input.
+     */
+    bool serve(std::istream& in, const std::string& progname, Exiv2::LogMsg::Level level)
+    {
+        std::string line;
+        while (std::getline(in, line)) {
+            const std::string::size_type end = line.find_last_not_of(" \t\r");
+            if (end == std::string::npos) {
+                continue;
+            }
+            if (line.compare(0, end + 1, "exit") == 0) {
+                return true;
+            }
+            Exiv2::LogMsg::setLevel(level);
+            const int rc = runCommandLine(progname, line);
+            std::cout << "{ready " << static_cast<unsigned int>(rc) % 256 << "}" << std::endl;
+        }
+        return false;
+    }
+
+#ifndef _WIN32
+    //! Stream buffer on a connected socket
+    class SocketBuf : public std::streambuf
+    {
+    public:
+        explicit SocketBuf(int fd) : fd_(fd)
+        {
+            setg(in_, in_, in_);
+            setp(out_, out_ + sizeof(out_));
+        }
+
+        ~SocketBuf() override
+        {
+            sync();
+        }
+
+    protected:
+        int_type underflow() override
+        {
+            ssize_t n;
+            do {
+                n = ::read(fd_, in_, sizeof(in_));
+            } while (n < 0 && errno == EINTR);
+            if (n <= 0) {
+                return traits_type::eof();
+            }
+            setg(in_, in_, in_ + n);
+            return traits_type::to_int_type(*gptr());
+        }
+
+        int_type overflow(int_type c) override
+        {
+            if (sync() != 0) {
+                return traits_type::eof();
+            }
+            if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(c);
+                pbump(1);
+            }
+            return traits_type::not_eof(c);
+        }
+
+        int sync() override
+        {
+            const char* p = pbase();
+            while (p < pptr()) {
+                const ssize_t n = ::write(fd_, p, pptr() - p);
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n <= 0) {
+                    // The client went away, drop the output
+                    setp(out_, out_ + sizeof(out_));
+                    return -1;
+                }
+                p += n;
+            }
+            setp(out_, out_ + sizeof(out_));
+            return 0;
+        }
+
+    private:
+        int fd_;
+        char in_[4096];
+        char out_[4096];
+    };
+
+    /*!
+      @brief Listen on a Unix socket at \em path and serve the clients one
+             after the other. The output of the command lines, including
+             error messages, is sent to the client.
+     */
+    int serveSocket(const std::string& path, const std::string& progname, Exiv2::LogMsg::Level level)
+    {
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) {
+            std::cerr << progname << ": " << _("Socket path is too long") << ": " << path << "\n";
+            return EXIT_FAILURE;
+        }
+        path.copy(addr.sun_path, path.size());
+
+        // Remove the socket of a server which did not clean up, but neither
+        // other files nor the socket of a server which is still running
+        struct stat st;
+        if (::lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+            const int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (probe >= 0) {
+                if (::connect(probe, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 &&
+                    errno == ECONNREFUSED) {
+                    ::unlink(path.c_str());
+                }
+                ::close(probe);
+            }
+        }
+
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        // Only the user may connect, the umask closes the window until the chmod
+        const mode_t mask = ::umask(0177);
+        const bool bound = fd >= 0 && ::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+        ::umask(mask);
+        if (!bound || ::chmod(path.c_str(), 0600) != 0 || ::listen(fd, 1) != 0) {
+            std::cerr << progname << ": " << _("Failed to listen on") << " " << path << ": " << Exiv2::strError()
+                      << "\n";
+            if (bound) {
+                ::unlink(path.c_str());
+            }
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            return EXIT_FAILURE;
+        }
+        // Write errors are handled by SocketBuf
+        ::signal(SIGPIPE, SIG_IGN);
+
+        int rc = EXIT_SUCCESS;
+        bool exit = false;
+        while (!exit) {
+            const int conn = ::accept(fd, nullptr, nullptr);
+            if (conn < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::cerr << progname << ": " << _("Failed to accept a connection on") << " " << path << ": "
+                          << Exiv2::strError() << "\n";
+                rc = EXIT_FAILURE;
+                break;
+            }
+            {
+                SocketBuf buf(conn);
+                std::istream in(&buf);
+                std::streambuf* out = std::cout.rdbuf(&buf);
+                std::streambuf* err = std::cerr.rdbuf(&buf);
+                exit = serve(in, progname, level);
+                std::cout.rdbuf(out);
+                std::cerr.rdbuf(err);
+            }
+            ::close(conn);
+        }
+        ::close(fd);
+        ::unlink(path.c_str());
+        return rc;
+    }
+#endif
+
+    /*!
+      @brief Run the stay-open mode with the command lines from \em source.
+             The arguments are copies, Params is reset for each command line.
+     */
+    int stayOpen(std::string source, std::string progname)
+    {
+        // The log level set with the -s option is the default of all command lines
+        const Exiv2::LogMsg::Level level = Exiv2::LogMsg::level();
+        if (source == "-") {
+            serve(std::cin, progname, level);
+            return EXIT_SUCCESS;
+        }
+#ifndef _WIN32
+        return serveSocket(source, progname, level);
+#else
+        std::cerr << progname << ": " << _("Unix sockets are not supported on this platform\n");
+        return EXIT_FAILURE;
+#endif
+    }
+}  // namespace
 
 int main(int argc, char* const argv[])
 {
@@ -61,34 +435,14 @@ int main(int argc, char* const argv[])
     }
 
     int rc = EXIT_SUCCESS;
-
-    try {
-        // Create the required action class
-        Action::TaskFactory& taskFactory = Action::TaskFactory::instance();
-        auto task = taskFactory.create(Action::TaskType(params.action_));
-        assert(task);
-
-        // Process all files
-        int n = 1;
-        int s = static_cast<int>(params.files_.size());
-        int w = s > 9 ? s > 99 ? 3 : 2 : 1;
-        for (Params::Files::const_iterator i = params.files_.begin(); i != params.files_.end(); ++i) {
-            if (params.verbose_) {
-                std::cout << _("File") << " " << std::setw(w) << std::right << n++ << "/" << s << ": " << *i
-                          << std::endl;
-            }
-            int ret = task->run(*i);
-            if (rc == EXIT_SUCCESS)
-                rc = ret;
-        }
-
-        Exiv2::XmpParser::terminate();
-
-    } catch (const std::exception& exc) {
-        std::cerr << "Uncaught exception: " << exc.what() << std::endl;
-        rc = EXIT_FAILURE;
+    if (!params.stayOpen_.empty()) {
+        rc = stayOpen(params.stayOpen_, params.progname());
+    } else {
+        rc = processFiles(params);
     }
 
+    Exiv2::XmpParser::terminate();
+
     // Return a positive one byte code for better consistency across platforms
     return static_cast<unsigned int>(rc) % 256;
 } // main
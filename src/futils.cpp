@@ -23,6 +23,7 @@
 
 #include "futils.hpp"
 #include "enforce.hpp"
+#include "makernote_int.hpp"
 
 // + standard includes
 #include <sys/types.h>
@@ -506,6 +507,11 @@ namespace Exiv2 {
         return ret.substr(0, idxLastSeparator);
     }
 
+    void reloadExiv2Config()
+    {
+        Internal::reloadExiv2Config();
+    }
+
     static bool pushPath(std::string& path,std::vector<std::string>& libs,std::set<std::string> & paths)
     {
         bool result = Exiv2::fileExists(path,true) && paths.find(path) == paths.end() && path != "/" ;
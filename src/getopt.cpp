@@ -101,6 +101,7 @@ namespace Util {
     int Getopt::getopt(int argc, char* const argv[], const std::string& optstring)
     {
         progname_ = Util::basename(argv[0]);
+        errcnt_ = 0;
         Util::optind = 0; // reset the Util::Getopt scanner
 
         for (;!errcnt_;) {
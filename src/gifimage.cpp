@@ -31,6 +31,7 @@
 #include "basicio.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 
 // + standard includes
 #include <string>
@@ -71,6 +72,7 @@ namespace Exiv2 {
 
     void GifImage::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Exiv2::GifImage::readMetadata: Reading GIF file " << io_->path() << "\n";
 #endif
@@ -97,6 +99,7 @@ namespace Exiv2 {
 
     void GifImage::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
         // Todo: implement me!
         throw(Error(kerWritingImageFormatUnsupported, "GIF"));
     } // GifImage::writeMetadata
@@ -28,6 +28,7 @@
 #include "image_int.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 #include "safe_op.hpp"
 #include "slice.hpp"
 #include "unused.h"
@@ -131,12 +132,104 @@ namespace {
         { ImageType::none, 0,               0,          amNone,      amNone,      amNone,      amNone      }
     };
 
+    //! Number of leading bytes which are read once to detect the image type
+    const size_t headSize = 64;
+
+    //! Struct for the first byte of an image type, to skip type checks which cannot match.
+    struct MagicNumber {
+        //! Comparison operator to compare a MagicNumber structure with an image type
+        bool operator==(const ImageType& imageType) const
+        { return imageType == imageType_; }
+
+        // DATA
+        ImageType   imageType_;
+        const char* firstBytes_;  //!< Possible values of the first byte
+        size_t      count_;       //!< Number of possible values
+        bool        headOnly_;    //!< The type check reads only the first headSize bytes
+    };
+
+    //! Image types without an entry are checked with their type check only
+    const MagicNumber magicNumbers[] = {
+        //image type          first bytes  count  head only
+        //------------------  -----------  -----  ---------
+        { ImageType::jpeg,    "\xff",      1,     true  },
+        { ImageType::exv,     "\xff",      1,     true  },
+        { ImageType::cr2,     "IM",        2,     true  },
+        { ImageType::crw,     "IM",        2,     true  },
+        { ImageType::mrw,     "\0",        1,     true  },
+        { ImageType::tiff,    "IM",        2,     true  },
+        { ImageType::bigtiff, "IM",        2,     false },
+        { ImageType::webp,    "R",         1,     true  },
+        { ImageType::rw2,     "IM",        2,     true  },
+        { ImageType::orf,     "IM",        2,     true  },
+        { ImageType::png,     "\x89",      1,     true  },
+        { ImageType::pgf,     "P",         1,     true  },
+        { ImageType::raf,     "F",         1,     true  },
+        { ImageType::xmp,     "<\xef",     2,     false },
+        { ImageType::gif,     "G",         1,     true  },
+        { ImageType::psd,     "8",         1,     true  },
+        { ImageType::bmp,     "B",         1,     true  },
+        { ImageType::jp2,     "\0",        1,     true  },
+    };
+
+    /*!
+      @brief Return the registry entry for the type of the image in \em io or
+             the end of list marker if the type is not recognized. The result
+             is the same as that of calling the type checks in registry order.
+
+      The first bytes of the image are read once. Types whose magic number
+      cannot match the first byte and types with the same type check as an
+      earlier entry are skipped, the remaining checks which need only the
+      first bytes run on them in memory. The other checks, and all checks
+      for images which are not longer than the head, run on \em io.
+
+      @param io BasicIo instance to read from, must be open. The position
+             is restored.
+     */
+    const Registry* findRegistry(BasicIo& io)
+    {
+        byte head[headSize + 1];
+        const int64 pos = io.tell();
+        const size_t count = io.read(head, sizeof(head));
+        io.seek(pos, BasicIo::beg);
+
+        const Registry* r = registry;
+        if (count != sizeof(head)) {
+            // How the end of the data is reported depends on the BasicIo
+            while (r->imageType_ != ImageType::none && !r->isThisType_(io, false)) ++r;
+            return r;
+        }
+        MemIo headIo(head, headSize);
+        for (; r->imageType_ != ImageType::none; ++r) {
+            const Registry* p = registry;
+            while (p != r && p->isThisType_ != r->isThisType_) ++p;
+            if (p != r) continue;
+            const MagicNumber* m = find(magicNumbers, r->imageType_);
+            if (m == 0) {
+                if (r->isThisType_(io, false)) break;
+                continue;
+            }
+            if (std::memchr(m->firstBytes_, head[0], m->count_) == 0) continue;
+            if (!m->headOnly_) {
+                if (r->isThisType_(io, false)) break;
+                continue;
+            }
+            headIo.seek(0, BasicIo::beg);
+            if (r->isThisType_(headIo, false)) break;
+        }
+        return r;
+    }
+
 }
 
 // *****************************************************************************
 // class member definitions
 namespace Exiv2 {
 
+    struct Image::Impl {
+        Internal::SegmentIndex segmentIndex_;  //!< Index of the segments of the image
+    };
+
     Image::Image(ImageType type, uint16_t supportedMetadata, BasicIo::UniquePtr io)
         : io_(std::move(io)),
           pixelWidth_(0),
@@ -149,8 +242,7 @@ namespace Exiv2 {
           writeXmpFromPacket_(true),
 #endif
           byteOrder_(invalidByteOrder),
-          tags_(),
-          init_(true)
+          p_(new Impl)
     {
     }
 
@@ -158,6 +250,11 @@ namespace Exiv2 {
     {
     }
 
+    Internal::SegmentIndex& Image::segmentIndex()
+    {
+        return p_->segmentIndex_;
+    }
+
     void Image::printStructure(std::ostream&, PrintStructureOption,int /*depth*/)
     {
         throw Error(kerUnsupportedImageType, io_->path());
@@ -293,225 +390,18 @@ namespace Exiv2 {
 
     const char* Image::typeName(uint16_t tag) const
     {
-        //! List of TIFF image tags
-        const char* result = nullptr;
-        switch (tag ) {
-            case Exiv2::unsignedByte     : result = "BYTE"      ; break;
-            case Exiv2::asciiString      : result = "ASCII"     ; break;
-            case Exiv2::unsignedShort    : result = "SHORT"     ; break;
-            case Exiv2::unsignedLong     : result = "LONG"      ; break;
-            case Exiv2::unsignedRational : result = "RATIONAL"  ; break;
-            case Exiv2::signedByte       : result = "SBYTE"     ; break;
-            case Exiv2::undefined        : result = "UNDEFINED" ; break;
-            case Exiv2::signedShort      : result = "SSHORT"    ; break;
-            case Exiv2::signedLong       : result = "SLONG"     ; break;
-            case Exiv2::signedRational   : result = "SRATIONAL" ; break;
-            case Exiv2::tiffFloat        : result = "FLOAT"     ; break;
-            case Exiv2::tiffDouble       : result = "DOUBLE"    ; break;
-            case Exiv2::tiffIfd          : result = "IFD"       ; break;
-            default                      : result = "unknown"   ; break;
-        }
-        return result;
-    }
-
-    static bool typeValid(uint16_t type)
-    {
-        return type >= 1 && type <= 13 ;
+        return Internal::tiffTypeName(tag);
     }
 
     void Image::printIFDStructure(BasicIo& io, std::ostream& out, Exiv2::PrintStructureOption option,uint32_t start,bool bSwap,char c,int depth)
     {
-        depth++;
-        bool bFirst  = true  ;
-
-        // buffer
-        const size_t dirSize = 32;
-        DataBuf  dir(dirSize);
-        bool bPrint = option == kpsBasic || option == kpsRecursive;
-
-        do {
-            // Read top of directory
-            const int seekSuccess = !io.seek(start,BasicIo::beg);
-            const size_t bytesRead = io.read(dir.pData_, 2);
-            if (!seekSuccess || bytesRead == 0) {
-                throw Error(kerCorruptedMetadata);
-            }
-            uint16_t   dirLength = byteSwap2(dir,0,bSwap);
-
-            bool tooBig = dirLength > 500;
-            if ( tooBig ) {
-                out << Internal::indent(depth) << "dirLength = " << dirLength << std::endl;
-                throw Error(kerTiffDirectoryTooLarge);
-            }
-
-            if ( bFirst && bPrint ) {
-                out << Internal::indent(depth) << Internal::stringFormat("STRUCTURE OF TIFF FILE (%c%c): ",c,c) << io.path() << std::endl;
-            }
-
-            // Read the dictionary
-            for ( int i = 0 ; i < dirLength ; i ++ ) {
-                if ( bFirst && bPrint ) {
-                    out << Internal::indent(depth)
-                        << " address |    tag                              |     "
-                        << " type |    count |    offset | value\n";
-                }
-                bFirst = false;
-
-                io.read(dir.pData_, 12);
-                uint16_t tag    = byteSwap2(dir,0,bSwap);
-                uint16_t type   = byteSwap2(dir,2,bSwap);
-                uint32_t count  = byteSwap4(dir,4,bSwap);
-                uint32_t offset = byteSwap4(dir,8,bSwap);
-
-                // Break for unknown tag types else we may segfault.
-                if ( !typeValid(type) ) {
-                    std::cerr << "invalid type in tiff structure" << type << std::endl;
-                    start = 0; // break from do loop
-                    throw Error(kerInvalidTypeValue);
-                }
-
-                std::string sp  = "" ; // output spacer
-
-                //prepare to print the value
-                uint32_t kount  = isPrintXMP(tag,option) ? count // haul in all the data
-                                : isPrintICC(tag,option) ? count // ditto
-                                : isStringType(type)     ? (count > 32 ? 32 : count) // restrict long arrays
-                                : count > 5              ? 5
-                                : count
-                                ;
-                uint32_t pad    = isStringType(type) ? 1 : 0;
-                uint32_t size   = isStringType(type) ? 1
-                                : is2ByteType(type)  ? 2
-                                : is4ByteType(type)  ? 4
-                                : is8ByteType(type)  ? 8
-                                : 1
-                                ;
-
-                // if ( offset > io.size() ) offset = 0; // Denial of service?
-
-                // #55 and #56 memory allocation crash test/data/POC8
-                long long allocate = (long long) size*count + pad+20;
-                if ( allocate > (long long) io.size() ) {
-                    throw Error(kerInvalidMalloc);
-                }
-                DataBuf  buf((long)allocate);  // allocate a buffer
-                std::memset(buf.pData_, 0, buf.size_);
-                std::memcpy(buf.pData_,dir.pData_+8,4);  // copy dir[8:11] into buffer (short strings)
-                const bool bOffsetIsPointer = count*size > 4;
-
-                if ( bOffsetIsPointer ) {         // read into buffer
-                    size_t   restore = io.tell();  // save
-                    io.seek(offset,BasicIo::beg);  // position
-                    io.read(buf.pData_,count*size);// read
-                    io.seek(restore,BasicIo::beg); // restore
-                }
-
-                if ( bPrint ) {
-                    const uint32_t address = start + 2 + i*12 ;
-                    const std::string offsetString = bOffsetIsPointer?
-                        Internal::stringFormat("%10u", offset):
-                        "";
-
-                    out << Internal::indent(depth)
-                    << Internal::stringFormat("%8u | %#06x %-28s |%10s |%9u |%10s | "
-                                              ,address,tag,tagName(tag).c_str(),typeName(type),count,offsetString.c_str());
-                    if ( isShortType(type) ){
-                        for ( size_t k = 0 ; k < kount ; k++ ) {
-                            out << sp << byteSwap2(buf,k*size,bSwap);
-                            sp = " ";
-                        }
-                    } else if ( isLongType(type) ){
-                        for ( size_t k = 0 ; k < kount ; k++ ) {
-                            out << sp << byteSwap4(buf,k*size,bSwap);
-                            sp = " ";
-                        }
-
-                    } else if ( isRationalType(type) ){
-                        for ( size_t k = 0 ; k < kount ; k++ ) {
-                            uint32_t a = byteSwap4(buf,k*size+0,bSwap);
-                            uint32_t b = byteSwap4(buf,k*size+4,bSwap);
-                            out << sp << a << "/" << b;
-                            sp = " ";
-                        }
-                    } else if ( isStringType(type) ) {
-                        out << sp << Internal::binaryToString(makeSlice(buf, 0, kount));
-                    }
-
-                    sp = kount == count ? "" : " ...";
-                    out << sp << std::endl;
-
-                    if ( option == kpsRecursive && (tag == 0x8769 /* ExifTag */ || tag == 0x014a/*SubIFDs*/  || type == tiffIfd) ) {
-                        for ( size_t k = 0 ; k < count ; k++ ) {
-                            size_t   restore = io.tell();
-                            uint32_t offset2 = byteSwap4(buf,k*size,bSwap);
-                            printIFDStructure(io,out,option,offset2,bSwap,c,depth);
-                            io.seek(restore,BasicIo::beg);
-                        }
-                    } else if ( option == kpsRecursive && tag == 0x83bb /* IPTCNAA */ ) {
-
-                        if (static_cast<size_t>(Safe::add(count, offset)) > io.size()) {
-                            throw Error(kerCorruptedMetadata);
-                        }
-
-                        const size_t restore = io.tell();
-                        io.seek(offset, BasicIo::beg);  // position
-                        std::vector<byte> bytes(count) ;  // allocate memory
-                        // TODO: once we have C++11 use bytes.data()
-                        const size_t read_bytes = io.read(&bytes[0], count);
-                        io.seek(restore, BasicIo::beg);
-                        // TODO: once we have C++11 use bytes.data()
-                        IptcData::printStructure(out, makeSliceUntil(&bytes[0], read_bytes), depth);
-
-                    }  else if ( option == kpsRecursive && tag == 0x927c /* MakerNote */ && count > 10) {
-                        size_t   restore = io.tell();  // save
-
-                        uint32_t jump= 10           ;
-                        byte     bytes[20]          ;
-                        const char* chars = (const char*) &bytes[0] ;
-                        io.seek(offset,BasicIo::beg);  // position
-                        io.read(bytes,jump    )     ;  // read
-                        bytes[jump]=0               ;
-                        if ( ::strcmp("Nikon",chars) == 0 ) {
-                            // tag is an embedded tiff
-                            byte* bytes2=new byte[count-jump] ;  // allocate memory
-                            io.read(bytes2,count-jump)        ;  // read
-                            MemIo memIo(bytes2,count-jump)    ;  // create a file
-                            printTiffStructure(memIo,out,option,depth);
-                            delete[] bytes2                   ;  // free
-                        } else {
-                            // tag is an IFD
-                            io.seek(0,BasicIo::beg);  // position
-                            printIFDStructure(io,out,option,offset,bSwap,c,depth);
-                        }
-
-                        io.seek(restore,BasicIo::beg); // restore
-                    }
-                }
-
-                if ( isPrintXMP(tag,option) ) {
-                    buf.pData_[count]=0;
-                    out << (char*) buf.pData_;
-                }
-                if ( isPrintICC(tag,option) ) {
-                    out.write((const char*)buf.pData_,count);
-                }
-            }
-            if ( start ) {
-                io.read(dir.pData_, 4);
-                start = tooBig ? 0 : byteSwap4(dir,0,bSwap);
-            }
-        } while (start) ;
-
-        if ( bPrint ) {
-            out << Internal::indent(depth) << "END " << io.path() << std::endl;
-        }
-        out.flush();
-        depth--;
+        Internal::IoView view(io);
+        Internal::printIFDStructure(*this, view, out, option, start, bSwap, c, depth);
     }
 
     void Image::printTiffStructure(BasicIo& io, std::ostream& out, Exiv2::PrintStructureOption option,int depth,size_t offset /*=0*/)
     {
-        if ( option == kpsBasic || option == kpsXMP || option == kpsRecursive || option == kpsIccProfile ) {
+        if ( option == kpsBasic || option == kpsXMP || option == kpsRecursive || option == kpsIccProfile || option == kpsJson ) {
             // buffer
             const size_t dirSize = 32;
             DataBuf  dir(dirSize);
@@ -523,7 +413,8 @@ namespace Exiv2 {
                         || ( c == 'I' && isBigEndianPlatform()    )
                         ;
             uint32_t start = byteSwap4(dir,4,bSwap);
-            printIFDStructure(io,out,option,start+(uint32_t)offset,bSwap,c,depth);
+            Internal::IoView view(io);
+            Internal::printIFDStructure(*this,view,out,option,start+(uint32_t)offset,bSwap,c,depth);
         }
     }
 
@@ -743,21 +634,7 @@ namespace Exiv2 {
 
     const std::string& Image::tagName(uint16_t tag)
     {
-        if ( init_ ) {
-            int idx;
-            const TagInfo* ti ;
-            for (ti = Internal::  mnTagList(), idx = 0; ti[idx].tag_ != 0xffff; ++idx) tags_[ti[idx].tag_] = ti[idx].name_;
-            for (ti = Internal:: iopTagList(), idx = 0; ti[idx].tag_ != 0xffff; ++idx) tags_[ti[idx].tag_] = ti[idx].name_;
-            for (ti = Internal:: gpsTagList(), idx = 0; ti[idx].tag_ != 0xffff; ++idx) tags_[ti[idx].tag_] = ti[idx].name_;
-            for (ti = Internal:: ifdTagList(), idx = 0; ti[idx].tag_ != 0xffff; ++idx) tags_[ti[idx].tag_] = ti[idx].name_;
-            for (ti = Internal::exifTagList(), idx = 0; ti[idx].tag_ != 0xffff; ++idx) tags_[ti[idx].tag_] = ti[idx].name_;
-            for (ti = Internal:: mpfTagList(), idx = 0; ti[idx].tag_ != 0xffff; ++idx) tags_[ti[idx].tag_] = ti[idx].name_;
-            for (ti = Internal::Nikon1MakerNote::tagList(), idx = 0
-                                                    ; ti[idx].tag_ != 0xffff; ++idx) tags_[ti[idx].tag_] = ti[idx].name_;
-        }
-        init_ = false;
-
-        return tags_[tag] ;
+        return Internal::tiffTagName(tag);
     }
 
     AccessMode ImageFactory::checkMode(ImageType type, MetadataId metadataId)
@@ -822,12 +699,7 @@ namespace Exiv2 {
         if (io.open() != 0)
             return ImageType::none;
         IoCloser closer(io);
-        for (unsigned int i = 0; registry[i].imageType_ != ImageType::none; ++i) {
-            if (registry[i].isThisType_(io, false)) {
-                return registry[i].imageType_;
-            }
-        }
-        return ImageType::none;
+        return findRegistry(io)->imageType_;
     }
 
     BasicIo::UniquePtr ImageFactory::createIo(const std::string& path, bool useCurl)
@@ -844,7 +716,9 @@ namespace Exiv2 {
             return BasicIo::UniquePtr(new HttpIo(path)); // may throw
         if (fProt == pFileUri)
             return BasicIo::UniquePtr(new FileIo(pathOfFileUrl(path)));
-        if (fProt == pStdin || fProt == pDataUri)
+        if (fProt == pStdin)
+            return BasicIo::UniquePtr(new StdinIo()); // may throw
+        if (fProt == pDataUri)
             return BasicIo::UniquePtr(new XPathIo(path)); // may throw
 
         return BasicIo::UniquePtr(new FileIo(path));
@@ -868,7 +742,9 @@ namespace Exiv2 {
             return BasicIo::UniquePtr(new HttpIo(wpath));
         if (fProt == pFileUri)
             return BasicIo::UniquePtr(new FileIo(pathOfFileUrl(wpath)));
-        if (fProt == pStdin || fProt == pDataUri)
+        if (fProt == pStdin)
+            return BasicIo::UniquePtr(new StdinIo()); // may throw
+        if (fProt == pDataUri)
             return BasicIo::UniquePtr(new XPathIo(wpath)); // may throw
         return BasicIo::UniquePtr(new FileIo(wpath));
     }
@@ -900,13 +776,13 @@ namespace Exiv2 {
 
     Image::UniquePtr ImageFactory::open(BasicIo::UniquePtr io)
     {
+        EXV_STATS_TIMER(imageFactoryOpen, 0);
         if (io->open() != 0) {
             throw Error(kerDataSourceOpenFailed, io->path(), strError());
         }
-        for (unsigned int i = 0; registry[i].imageType_ != ImageType::none; ++i) {
-            if (registry[i].isThisType_(*io, false)) {
-                return registry[i].newInstance_(std::move(io), false);
-            }
+        const Registry* r = findRegistry(*io);
+        if (r->imageType_ != ImageType::none) {
+            return r->newInstance_(std::move(io), false);
         }
         return Image::UniquePtr();
     }
@@ -18,10 +18,20 @@
  */
 
 #include "image_int.hpp"
+#include "basicio.hpp"
+#include "error.hpp"
+#include "iptc.hpp"
+#include "nikonmn_int.hpp"
+#include "safe_op.hpp"
+#include "slice.hpp"
+#include "tags_int.hpp"
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstddef>
 #include <cstring>
+#include <iostream>
+#include <sstream>
 #include <vector>
 #include <cstdio>
 
@@ -114,6 +124,370 @@ namespace Exiv2
             return result;
         }
 
+        const std::string& tiffTagName(uint16_t tag)
+        {
+            // built once, the lists are constant
+            static const std::map<uint16_t, std::string> tags = [] {
+                std::map<uint16_t, std::string> result;
+                const TagInfo* const lists[] = {
+                    mnTagList(), iopTagList(), gpsTagList(), ifdTagList(),
+                    exifTagList(), mpfTagList(), Nikon1MakerNote::tagList()
+                };
+                for (const TagInfo* ti : lists)
+                    for (int idx = 0; ti[idx].tag_ != 0xffff; ++idx)
+                        result[ti[idx].tag_] = ti[idx].name_;
+                return result;
+            }();
+            static const std::string unknown;
+            auto i = tags.find(tag);
+            return i == tags.end() ? unknown : i->second;
+        }
+
+        const char* tiffTypeName(uint16_t tag)
+        {
+            //! List of TIFF image tags
+            const char* result = nullptr;
+            switch (tag ) {
+                case Exiv2::unsignedByte     : result = "BYTE"      ; break;
+                case Exiv2::asciiString      : result = "ASCII"     ; break;
+                case Exiv2::unsignedShort    : result = "SHORT"     ; break;
+                case Exiv2::unsignedLong     : result = "LONG"      ; break;
+                case Exiv2::unsignedRational : result = "RATIONAL"  ; break;
+                case Exiv2::signedByte       : result = "SBYTE"     ; break;
+                case Exiv2::undefined        : result = "UNDEFINED" ; break;
+                case Exiv2::signedShort      : result = "SSHORT"    ; break;
+                case Exiv2::signedLong       : result = "SLONG"     ; break;
+                case Exiv2::signedRational   : result = "SRATIONAL" ; break;
+                case Exiv2::tiffFloat        : result = "FLOAT"     ; break;
+                case Exiv2::tiffDouble       : result = "DOUBLE"    ; break;
+                case Exiv2::tiffIfd          : result = "IFD"       ; break;
+                default                      : result = "unknown"   ; break;
+            }
+            return result;
+        }
+
+        static bool typeValid(uint16_t type)
+        {
+            return type >= 1 && type <= 13 ;
+        }
+
+        void printIFDStructure(Image& image, IoView& view, std::ostream& out, PrintStructureOption option, uint32_t start, bool bSwap, char c, int depth)
+        {
+            depth++;
+            bool bFirst  = true  ;
+
+            // buffer
+            const size_t dirSize = 32;
+            DataBuf  dir(dirSize);
+            bool bPrint = option == kpsBasic || option == kpsRecursive;
+            bool bJson  = option == kpsJson;
+            bool bRecurse = option == kpsRecursive || bJson;
+            const std::string& path = view.io().path();
+            // output for one line, written in one go
+            std::string line;
+            // lines are not flushed one by one, so flush before errors are reported
+            struct Flush {
+                ~Flush() { out_.flush(); }
+                std::ostream& out_;
+            } flush = { out };
+
+            do {
+                // Read top of directory
+                uint64_t position = start;
+                const size_t bytesRead = view.read(dir.pData_, position, 2);
+                if (bytesRead == 0) {
+                    throw Error(kerCorruptedMetadata);
+                }
+                position += 2;
+                uint16_t   dirLength = image.byteSwap2(dir,0,bSwap);
+
+                bool tooBig = dirLength > 500;
+                if ( tooBig ) {
+                    out << indent(depth) << "dirLength = " << dirLength << std::endl;
+                    throw Error(kerTiffDirectoryTooLarge);
+                }
+
+                if ( bFirst && bPrint ) {
+                    line = indent(depth) + stringFormat("STRUCTURE OF TIFF FILE (%c%c): ",c,c) + path + '\n';
+                    out.write(line.data(), line.size());
+                }
+                if ( bJson ) {
+                    JsonRecord record("TIFF", bFirst ? "structure" : "ifd", depth);
+                    if ( bFirst ) record.add("path", path).add("byteOrder", std::string(2, c));
+                    record.add("offset", start).add("entries", dirLength).write(out);
+                }
+
+                // Read the dictionary
+                for ( int i = 0 ; i < dirLength ; i ++ ) {
+                    if ( bFirst && bPrint ) {
+                        line = indent(depth)
+                             + " address |    tag                              |     "
+                             + " type |    count |    offset | value\n";
+                        out.write(line.data(), line.size());
+                    }
+                    bFirst = false;
+
+                    position += view.read(dir.pData_, position, 12);
+                    uint16_t tag    = image.byteSwap2(dir,0,bSwap);
+                    uint16_t type   = image.byteSwap2(dir,2,bSwap);
+                    uint32_t count  = image.byteSwap4(dir,4,bSwap);
+                    uint32_t offset = image.byteSwap4(dir,8,bSwap);
+
+                    // Break for unknown tag types else we may segfault.
+                    if ( !typeValid(type) ) {
+                        out.flush();
+                        std::cerr << "invalid type in tiff structure" << type << std::endl;
+                        start = 0; // break from do loop
+                        throw Error(kerInvalidTypeValue);
+                    }
+
+                    //prepare to print the value
+                    uint32_t kount  = image.isPrintXMP(tag,option) ? count // haul in all the data
+                                    : image.isPrintICC(tag,option) ? count // ditto
+                                    : image.isStringType(type)     ? (count > 32 ? 32 : count) // restrict long arrays
+                                    : count > 5              ? 5
+                                    : count
+                                    ;
+                    uint32_t pad    = image.isStringType(type) ? 1 : 0;
+                    uint32_t size   = image.isStringType(type) ? 1
+                                    : image.is2ByteType(type)  ? 2
+                                    : image.is4ByteType(type)  ? 4
+                                    : image.is8ByteType(type)  ? 8
+                                    : 1
+                                    ;
+
+                    // #55 and #56 memory allocation crash test/data/POC8
+                    long long allocate = (long long) size*count + pad+20;
+                    if ( allocate > (long long) view.size() ) {
+                        throw Error(kerInvalidMalloc);
+                    }
+                    DataBuf  buf((long)allocate);  // allocate a buffer
+                    std::memset(buf.pData_, 0, buf.size_);
+                    std::memcpy(buf.pData_,dir.pData_+8,4);  // copy dir[8:11] into buffer (short strings)
+                    const bool bOffsetIsPointer = count*size > 4;
+
+                    if ( bOffsetIsPointer ) {         // read into buffer
+                        view.read(buf.pData_, offset, count*size);
+                    }
+
+                    if ( bPrint || bJson ) {
+                        const uint32_t address = start + 2 + i*12 ;
+                        std::string value;
+                        const char* sp = ""; // output spacer
+                        if ( image.isShortType(type) ){
+                            for ( size_t k = 0 ; k < kount ; k++ ) {
+                                value += sp + std::to_string(image.byteSwap2(buf,k*size,bSwap));
+                                sp = " ";
+                            }
+                        } else if ( image.isLongType(type) ){
+                            for ( size_t k = 0 ; k < kount ; k++ ) {
+                                value += sp + std::to_string(image.byteSwap4(buf,k*size,bSwap));
+                                sp = " ";
+                            }
+                        } else if ( image.isRationalType(type) ){
+                            for ( size_t k = 0 ; k < kount ; k++ ) {
+                                uint32_t a = image.byteSwap4(buf,k*size+0,bSwap);
+                                uint32_t b = image.byteSwap4(buf,k*size+4,bSwap);
+                                value += sp + std::to_string(a) + "/" + std::to_string(b);
+                                sp = " ";
+                            }
+                        } else if ( image.isStringType(type) ) {
+                            if ( kount ) {
+                                std::ostringstream os;
+                                os << binaryToString(makeSlice(buf.pData_, 0, kount));
+                                value = os.str();
+                            }
+                        }
+                        if ( kount != count ) value += " ...";
+
+                        if ( bPrint ) {
+                            const std::string offsetString = bOffsetIsPointer?
+                                stringFormat("%10u", offset):
+                                "";
+                            line = indent(depth)
+                                 + stringFormat("%8u | %#06x %-28s |%10s |%9u |%10s | "
+                                                          ,address,tag,tiffTagName(tag).c_str(),tiffTypeName(type),count,offsetString.c_str())
+                                 + value + '\n';
+                            out.write(line.data(), line.size());
+                        } else {
+                            JsonRecord record("TIFF", "entry", depth);
+                            record.add("address", address).add("tag", tag).add("name", tiffTagName(tag))
+                                  .add("type", tiffTypeName(type)).add("count", count);
+                            if ( bOffsetIsPointer ) record.add("offset", offset);
+                            record.add("value", value).write(out);
+                        }
+
+                        if ( bRecurse && (tag == 0x8769 /* ExifTag */ || tag == 0x014a/*SubIFDs*/  || type == tiffIfd) ) {
+                            for ( size_t k = 0 ; k < count ; k++ ) {
+                                uint32_t offset2 = image.byteSwap4(buf,k*size,bSwap);
+                                printIFDStructure(image,view,out,option,offset2,bSwap,c,depth);
+                            }
+                        } else if ( option == kpsRecursive && tag == 0x83bb /* IPTCNAA */ ) {
+
+                            if (static_cast<size_t>(Safe::add(count, offset)) > view.size()) {
+                                throw Error(kerCorruptedMetadata);
+                            }
+
+                            std::vector<byte> bytes(count) ;  // allocate memory
+                            const size_t read_bytes = view.read(bytes.data(), offset, count);
+                            IptcData::printStructure(out, makeSliceUntil(bytes.data(), read_bytes), depth);
+
+                        }  else if ( option == kpsRecursive && tag == 0x927c /* MakerNote */ && count > 10) {
+                            uint32_t jump= 10           ;
+                            byte     bytes[20]          ;
+                            const char* chars = (const char*) &bytes[0] ;
+                            std::memset(bytes, 0, sizeof(bytes));
+                            view.read(bytes, offset, jump);
+                            bytes[jump]=0               ;
+                            if ( ::strcmp("Nikon",chars) == 0 ) {
+                                // tag is an embedded tiff
+                                std::vector<byte> bytes2(count-jump);  // allocate memory
+                                view.read(bytes2.data(), offset + jump, bytes2.size());
+                                MemIo memIo(bytes2.data(), bytes2.size());  // create a file
+                                image.printTiffStructure(memIo,out,option,depth);
+                            } else {
+                                // tag is an IFD
+                                printIFDStructure(image,view,out,option,offset,bSwap,c,depth);
+                            }
+                        }
+                    }
+
+                    if ( image.isPrintXMP(tag,option) ) {
+                        buf.pData_[count]=0;
+                        out << (char*) buf.pData_;
+                    }
+                    if ( image.isPrintICC(tag,option) ) {
+                        out.write((const char*)buf.pData_,count);
+                    }
+                }
+                if ( start ) {
+                    view.read(dir.pData_, position, 4);
+                    start = tooBig ? 0 : image.byteSwap4(dir,0,bSwap);
+                }
+                out.flush();
+            } while (start) ;
+
+            if ( bPrint ) {
+                line = indent(depth) + "END " + path + '\n';
+                out.write(line.data(), line.size());
+            }
+            depth--;
+        }
+
+        const size_t IoView::blockSize;
+
+        IoView::IoView(BasicIo& io) : io_(io), size_(io.size())
+        {
+        }
+
+        const std::vector<byte>& IoView::block(uint64_t start)
+        {
+            std::vector<byte>& data = blocks_[start];
+            if (data.empty()) {
+                const size_t size = static_cast<size_t>(std::min<uint64_t>(blockSize, size_ - start));
+                data.resize(size);
+                if (io_.seek(static_cast<int64>(start), BasicIo::beg) != 0 || io_.read(&data[0], size) != size) {
+                    blocks_.erase(start);
+                    throw Error(kerFailedToReadImageData);
+                }
+            }
+            return data;
+        }
+
+        size_t IoView::read(byte* buf, uint64_t offset, size_t count)
+        {
+            if (offset >= size_)
+                return 0;
+            count = static_cast<size_t>(std::min<uint64_t>(count, size_ - offset));
+            if (count > blockSize) {
+                if (io_.seek(static_cast<int64>(offset), BasicIo::beg) != 0)
+                    throw Error(kerFailedToReadImageData);
+                return io_.read(buf, count);
+            }
+            size_t done = 0;
+            while (done < count) {
+                const uint64_t start = (offset + done) / blockSize * blockSize;
+                const std::vector<byte>& data = block(start);
+                const size_t from = static_cast<size_t>(offset + done - start);
+                const size_t n = std::min(count - done, data.size() - from);
+                std::memcpy(buf + done, &data[from], n);
+                done += n;
+            }
+            return done;
+        }
+
+        SegmentIndex::SegmentIndex() : io_(0), size_(0)
+        {
+        }
+
+        void SegmentIndex::clear()
+        {
+            segments_.clear();
+            io_ = 0;
+            size_ = 0;
+        }
+
+        void SegmentIndex::add(uint32_t type, uint32_t id, uint64_t offset, uint64_t size)
+        {
+            Segment segment = {type, id, offset, size};
+            segments_.push_back(segment);
+        }
+
+        void SegmentIndex::complete(const BasicIo& io)
+        {
+            io_ = &io;
+            // The size of stdin is only known after all of it was read
+            size_ = dynamic_cast<const StdinIo*>(&io) ? 0 : io.size();
+        }
+
+        bool SegmentIndex::valid(const BasicIo& io) const
+        {
+            return io_ == &io && (dynamic_cast<const StdinIo*>(&io) || size_ == io.size());
+        }
+
+        JsonRecord::JsonRecord(const char* format, const char* kind, int depth)
+        {
+            add("format", format);
+            add("kind", kind);
+            add("depth", static_cast<uint64_t>(depth > 0 ? depth : 0));
+        }
+
+        JsonRecord& JsonRecord::add(const char* name, const std::string& value)
+        {
+            line_ += line_.empty() ? "{\"" : ",\"";
+            line_ += name;
+            line_ += "\":\"";
+            for (auto&& c : value) {
+                const unsigned char u = static_cast<unsigned char>(c);
+                if (c == '"' || c == '\\') {
+                    line_ += '\\';
+                    line_ += c;
+                } else if (u < 0x20 || u >= 0x7f) {
+                    // Binary data, not necessarily UTF-8
+                    line_ += stringFormat("\\u%04x", u);
+                } else {
+                    line_ += c;
+                }
+            }
+            line_ += '"';
+            return *this;
+        }
+
+        JsonRecord& JsonRecord::add(const char* name, uint64_t value)
+        {
+            line_ += line_.empty() ? "{\"" : ",\"";
+            line_ += name;
+            line_ += "\":";
+            line_ += std::to_string(value);
+            return *this;
+        }
+
+        void JsonRecord::write(std::ostream& out)
+        {
+            line_ += "}\n";
+            out.write(line_.data(), static_cast<std::streamsize>(line_.size()));
+        }
+
     }  // namespace Internal
 
 }  // namespace Exiv2
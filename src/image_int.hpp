@@ -28,10 +28,14 @@
 
 // *****************************************************************************
 // included header files
+#include "image.hpp"
 #include "types.hpp"
 
 // + standard includes
+#include <map>
+#include <ostream>
 #include <string>
+#include <vector>
 
 #if (defined(__GNUG__) || defined(__GNUC__)) || defined(__clang__)
 #define ATTRIBUTE_FORMAT_PRINTF __attribute__((format(printf, 1, 0)))
@@ -42,6 +46,8 @@
 // *****************************************************************************
 // namespace extensions
 namespace Exiv2 {
+    class BasicIo;
+
     namespace Internal {
 
 // *****************************************************************************
@@ -136,4 +142,124 @@ namespace Exiv2 {
      */
     std::string indent(int32_t depth);
 
+    /*!
+      @brief Read-ahead view of the data of a BasicIo for \em printStructure().
+
+      The data is read in aligned blocks which are kept, so the entries and
+      most values of a directory are served from memory instead of with a
+      seek and a read each. Requests larger than a block are read directly.
+      The position of the BasicIo is undefined after a read.
+     */
+    class IoView {
+    public:
+        //! Constructor, \em io must be open and must outlive the view
+        explicit IoView(BasicIo& io);
+
+        /*!
+          @brief Copy up to \em count bytes at \em offset to \em buf.
+          @return The number of bytes copied, less than \em count only at the
+                  end of the data.
+         */
+        size_t read(byte* buf, uint64_t offset, size_t count);
+        //! Return the size of the data
+        uint64_t size() const { return size_; }
+        //! Return the BasicIo
+        BasicIo& io() const { return io_; }
+
+    private:
+        //! Size of the blocks which are read and kept
+        static const size_t blockSize = 64 * 1024;
+
+        //! Return the block which starts at \em start, read it if necessary
+        const std::vector<byte>& block(uint64_t start);
+
+        // DATA
+        BasicIo& io_;
+        uint64_t size_;
+        std::map<uint64_t, std::vector<byte> > blocks_;
+    };
+
+    //! Return the name of the TIFF tag \em tag for \em printStructure(), or an empty string
+    const std::string& tiffTagName(uint16_t tag);
+
+    //! Return the name of the TIFF type \em tag for \em printStructure()
+    const char* tiffTypeName(uint16_t tag);
+
+    /*!
+      @brief Print out the structure of the TIFF IFD at \em start and the IFDs
+             linked from it, for Image::printIFDStructure(). The data is read
+             through \em view, which is shared by the nested IFDs.
+     */
+    void printIFDStructure(Image& image, IoView& view, std::ostream& out, PrintStructureOption option,
+                           uint32_t start, bool bSwap, char c, int depth);
+
+    /*!
+      @brief Index of the segments, chunks or boxes of an image. It is filled
+             when the metadata is read and reused when the metadata is written,
+             to scan the image only once.
+
+      The index is valid for the BasicIo and the size of the data it was
+      completed for. It assumes that the data is changed only through the
+      image, which clears the index when it writes. The size of a StdinIo
+      is not checked, because it would read the rest of the input.
+     */
+    class SegmentIndex {
+    public:
+        //! A segment, chunk or box of an image
+        struct Segment {
+            uint32_t type_;    //!< Marker, chunk or box type
+            uint32_t id_;      //!< Format specific identification of the contents
+            uint64_t offset_;  //!< Offset of the segment data, after the marker or type
+            uint64_t size_;    //!< Size of the segment as recorded in the image
+        };
+        //! Container type for the segments
+        typedef std::vector<Segment> Segments;
+
+        //! Default constructor, the index is invalid
+        SegmentIndex();
+
+        //! Remove all segments, the index becomes invalid
+        void clear();
+        //! Append a segment
+        void add(uint32_t type, uint32_t id, uint64_t offset, uint64_t size);
+        //! Mark the index as complete for the current data of \em io
+        void complete(const BasicIo& io);
+
+        //! True if the index is complete and the data of \em io appears unchanged
+        bool valid(const BasicIo& io) const;
+        //! Return the segments in the order of the image
+        const Segments& segments() const { return segments_; }
+
+    private:
+        Segments segments_;
+        const BasicIo* io_;  //!< The BasicIo the index is complete for, or 0
+        uint64_t size_;      //!< Size of the data of io_, 0 for a StdinIo
+    };
+
+    /*!
+      @brief One line of the JSON output of \em printStructure() with option
+             kpsJson: an object with the members "format", "kind" and "depth",
+             followed by the members added in turn.
+     */
+    class JsonRecord {
+    public:
+        /*!
+          @brief Start a record.
+          @param format Image format, e.g., "TIFF" or "JPEG".
+          @param kind   What the record describes, e.g., "ifd" or "segment".
+          @param depth  Nesting depth of the structure the record belongs to.
+         */
+        JsonRecord(const char* format, const char* kind, int depth);
+
+        //! Add a string member, the value is escaped
+        JsonRecord& add(const char* name, const std::string& value);
+        //! Add a number member
+        JsonRecord& add(const char* name, uint64_t value);
+        //! Write the record as one line to \em out
+        void write(std::ostream& out);
+
+    private:
+        std::string line_;
+    };
+
 }}                                      // namespace Internal, Exiv2
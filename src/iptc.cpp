@@ -31,6 +31,8 @@
 #include "datasets.hpp"
 #include "jpgimage.hpp"
 #include "image_int.hpp"
+#include "metadatum_int.hpp"
+#include "stats_int.hpp"
 
 // + standard includes
 #include <iostream>
@@ -335,7 +337,7 @@ namespace Exiv2 {
 
     void IptcData::sortByKey()
     {
-        std::sort(iptcMetadata_.begin(), iptcMetadata_.end(), cmpMetadataByKey);
+        Internal::sortByKey(iptcMetadata_);
     }
 
     void IptcData::sortByTag()
@@ -431,6 +433,7 @@ namespace Exiv2 {
 
     int IptcParser::decode(IptcData& iptcData, const byte* pData, size_t size)
     {
+        EXV_STATS_TIMER(iptcDecode, size);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "IptcParser::decode, size = " << size << "\n";
 #endif
@@ -491,37 +494,39 @@ namespace Exiv2 {
         return 0;
     } // IptcParser::decode
 
-    /*!
-      @brief Compare two iptc items by record. Return true if the record of
-             lhs is less than that of rhs.
-
-      This is a helper function for IptcParser::encode().
-     */
-    bool cmpIptcdataByRecord(const Iptcdatum& lhs, const Iptcdatum& rhs)
+    DataBuf IptcParser::encode(const IptcData& iptcData)
     {
-        return lhs.record() < rhs.record();
-    }
+        Blob blob;
+        encode(blob, iptcData);
+        return DataBuf(blob.data(), blob.size());
+    } // IptcParser::encode
 
-    DataBuf IptcParser::encode(const IptcData& iptcData)
+    void IptcParser::encode(Blob& blob, const IptcData& iptcData)
     {
-        DataBuf buf(iptcData.size());
-        byte *pWrite = buf.pData_;
+        EXV_STATS_TIMER(iptcEncode, 0);
+        // Sort pointers to the iptc data sets by record but preserve the order of datasets
+        std::vector<const Iptcdatum*> sorted;
+        sorted.reserve(iptcData.count());
+        for (auto&& datum : iptcData) {
+            sorted.push_back(&datum);
+        }
+        std::stable_sort(sorted.begin(), sorted.end(), [](const Iptcdatum* lhs, const Iptcdatum* rhs) {
+            return lhs->record() < rhs->record();
+        });
 
-        // Copy the iptc data sets and sort them by record but preserve the order of datasets
-        IptcMetadata sortedIptcData;
-        std::copy(iptcData.begin(), iptcData.end(), std::back_inserter(sortedIptcData));
-        std::stable_sort(sortedIptcData.begin(), sortedIptcData.end(), cmpIptcdataByRecord);
+        for (auto&& datum : sorted) {
+            // extended or standard dataset?
+            const size_t dataSize = datum->size();
+            const size_t sizeHeader = dataSize > 32767 ? 9 : 5;
+            const size_t pos = blob.size();
+            blob.resize(pos + sizeHeader + dataSize);
+            byte* pWrite = &blob[pos];
 
-        IptcData::const_iterator iter = sortedIptcData.begin();
-        IptcData::const_iterator end = sortedIptcData.end();
-        for ( ; iter != end; ++iter) {
             // marker, record Id, dataset num
             *pWrite++ = marker_;
-            *pWrite++ = static_cast<byte>(iter->record());
-            *pWrite++ = static_cast<byte>(iter->tag());
+            *pWrite++ = static_cast<byte>(datum->record());
+            *pWrite++ = static_cast<byte>(datum->tag());
 
-            // extended or standard dataset?
-            size_t dataSize = iter->size();
             if (dataSize > 32767) {
                 // always use 4 bytes for extended length
                 uint16_t sizeOfSize = 4 | 0x8000;
@@ -534,10 +539,8 @@ namespace Exiv2 {
                 us2Data(pWrite, static_cast<uint16_t>(dataSize), bigEndian);
                 pWrite += 2;
             }
-            pWrite += iter->value().copy(pWrite, bigEndian);
+            datum->value().copy(pWrite, bigEndian);
         }
-
-        return buf;
     } // IptcParser::encode
 
 }                                       // namespace Exiv2
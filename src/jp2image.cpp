@@ -30,6 +30,7 @@
 #include "basicio.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 #include "types.hpp"
 #include "safe_op.hpp"
 
@@ -127,6 +128,22 @@ struct Jp2UuidBox
 };
 //! @endcond
 
+// *****************************************************************************
+// local declarations
+namespace
+{
+    //! Write a UUID box with \em uuid and the \em size bytes of \em data to \em out with one call
+    void writeUuidBox(Exiv2::BasicIo& out, const unsigned char* uuid, const Exiv2::byte* data, size_t size)
+    {
+        Exiv2::byte head[8 + 16];
+        Exiv2::ul2Data(head,     static_cast<uint32_t>(sizeof(head) + size), Exiv2::bigEndian);
+        Exiv2::ul2Data(head + 4, kJp2BoxTypeUuid,                             Exiv2::bigEndian);
+        memcpy(head + 8, uuid, 16);
+        const Exiv2::IoBlock blocks[] = {{head, sizeof(head)}, {data, size}};
+        if (out.writev(blocks, 2) != sizeof(head) + size) throw Exiv2::Error(Exiv2::kerImageWriteFailed);
+    }
+}
+
 // *****************************************************************************
 // class member definitions
 namespace Exiv2
@@ -206,6 +223,7 @@ static void boxes_check(size_t b,size_t m)
 
     void Jp2Image::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Exiv2::Jp2Image::readMetadata: Reading JPEG-2000 file " << io_->path() << std::endl;
 #endif
@@ -446,11 +464,6 @@ static void boxes_check(size_t b,size_t m)
                     }
                     break;
                 }
-
-                default:
-                {
-                    break;
-                }
             }
 
             // Move to the next box.
@@ -477,13 +490,17 @@ static void boxes_check(size_t b,size_t m)
         bool bICC = option == kpsIccProfile;
         bool bXMP = option == kpsXMP;
         bool bIPTCErase = option == kpsIptcErase;
+        bool bJson = option == kpsJson;
 
         if (bPrint) {
             out << "STRUCTURE OF JPEG2000 FILE: " << io_->path() << std::endl;
             out << " address |   length | box       | data" << std::endl;
         }
+        if (bJson) {
+            Internal::JsonRecord("JP2", "structure", depth).add("path", io_->path()).write(out);
+        }
 
-        if (bPrint || bXMP || bICC || bIPTCErase) {
+        if (bPrint || bXMP || bICC || bIPTCErase || bJson) {
             Jp2BoxHeader box = {1, 1};
             Jp2BoxHeader subBox = {1, 1};
             Jp2UuidBox uuid = {{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
@@ -502,6 +519,13 @@ static void boxes_check(size_t b,size_t m)
                     if (box.type == kJp2BoxTypeClose)
                         lf(out, bLF);
                 }
+                if (bJson && box.type != kJp2BoxTypeUuid) {
+                    Internal::JsonRecord("JP2", "box", depth)
+                        .add("address", static_cast<uint64_t>(position - sizeof(box)))
+                        .add("length", box.length)
+                        .add("type", toAscii(box.type))
+                        .write(out);
+                }
                 if (box.type == kJp2BoxTypeClose)
                     break;
 
@@ -529,6 +553,13 @@ static void boxes_check(size_t b,size_t m)
                                     << Internal::binaryToString(makeSlice(data, 0, std::min(30_z, data.size_)));
                                 bLF = true;
                             }
+                            if (bJson) {
+                                Internal::JsonRecord("JP2", "box", depth + 1)
+                                    .add("address", static_cast<uint64_t>(address))
+                                    .add("length", subBox.length)
+                                    .add("type", toAscii(subBox.type))
+                                    .write(out);
+                            }
 
                             if (subBox.type == kJp2BoxTypeColorHeader) {
                                 long pad = 3;  // don't know why there are 3 padding bytes
@@ -567,6 +598,14 @@ static void boxes_check(size_t b,size_t m)
                                 if (bUnknown)
                                     out << "????: ";
                             }
+                            if (bJson) {
+                                Internal::JsonRecord("JP2", "box", depth)
+                                    .add("address", static_cast<uint64_t>(position - sizeof(box)))
+                                    .add("length", box.length)
+                                    .add("type", toAscii(box.type))
+                                    .add("uuid", bIsExif ? "Exif" : bIsIPTC ? "IPTC" : bIsXMP ? "XMP" : "unknown")
+                                    .write(out);
+                            }
 
                             DataBuf rawData;
                             rawData.alloc(box.length - sizeof(uuid) - sizeof(box));
@@ -582,7 +621,7 @@ static void boxes_check(size_t b,size_t m)
                             }
                             lf(out, bLF);
 
-                            if (bIsExif && bRecursive && rawData.size_ > 0) {
+                            if (bIsExif && (bRecursive || bJson) && rawData.size_ > 0) {
                                 if ((rawData.pData_[0] == rawData.pData_[1]) &&
                                     (rawData.pData_[0] == 'I' || rawData.pData_[0] == 'M')) {
                                     BasicIo::UniquePtr p = BasicIo::UniquePtr(new MemIo(rawData.pData_, rawData.size_));
@@ -616,6 +655,7 @@ static void boxes_check(size_t b,size_t m)
 
     void Jp2Image::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
         if (io_->open() != 0)
         {
             throw Error(kerDataSourceOpenFailed, io_->path(), strError());
@@ -731,8 +771,6 @@ static void boxes_check(size_t b,size_t m)
 
         Jp2BoxHeader box = {0,0};
 
-        byte    boxDataSize[4];
-        byte    boxUUIDtype[4];
         DataBuf bheaderBuf(8);     // Box header : 4 bytes (data size) + 4 bytes (box type).
 
         // FIXME: Andreas, why the loop do not stop when EOF is taken from _io. The loop go out by an exception
@@ -774,6 +812,23 @@ static void boxes_check(size_t b,size_t m)
                 // FIXME. Special case. the real box size is given in another place.
             }
 
+            if (box.type != kJp2BoxTypeJp2Header && box.type != kJp2BoxTypeUuid)
+            {
+                // Copy all other boxes, like the codestream, without reading them into a buffer.
+#ifdef EXIV2_DEBUG_MESSAGES
+                std::cout << "Exiv2::Jp2Image::doWriteMetadata: write box (length: " << box.length << ")" << std::endl;
+#endif
+                if (box.length < 8) throw Error(kerInputDataReadFailed);
+                io_->seek(-8, BasicIo::cur);
+                if (outIo.copyRange(*io_, box.length) != box.length)
+                {
+                    if (io_->error()) throw Error(kerFailedToReadImageData);
+                    if (io_->eof()) throw Error(kerInputDataReadFailed);
+                    throw Error(kerImageWriteFailed);
+                }
+                continue;
+            }
+
             // Read whole box : Box header + Box data (not fixed size - can be null).
 
             DataBuf boxBuf(box.length);                             // Box header (8 bytes) + box data.
@@ -817,22 +872,11 @@ static void boxes_check(size_t b,size_t m)
                         ExifParser::encode(blob, littleEndian, exifData_);
                         if (blob.size())
                         {
-                            DataBuf rawExif(static_cast<long>(blob.size()));
-                            memcpy(rawExif.pData_, &blob[0], blob.size());
-
-                            DataBuf boxData(8 + 16 + rawExif.size_);
-                            ul2Data(boxDataSize, static_cast<uint32_t>(boxData.size_), Exiv2::bigEndian);
-                            ul2Data(boxUUIDtype, kJp2BoxTypeUuid, Exiv2::bigEndian);
-                            memcpy(boxData.pData_,          boxDataSize,    4);
-                            memcpy(boxData.pData_ + 4,      boxUUIDtype,    4);
-                            memcpy(boxData.pData_ + 8,      kJp2UuidExif,   16);
-                            memcpy(boxData.pData_ + 8 + 16, rawExif.pData_, rawExif.size_);
-
 #ifdef EXIV2_DEBUG_MESSAGES
                             std::cout << "Exiv2::Jp2Image::doWriteMetadata: Write box with Exif metadata (length: "
-                                      << boxData.size_ << std::endl;
+                                      << 8 + 16 + blob.size() << std::endl;
 #endif
-                            if (outIo.write(boxData.pData_, boxData.size_) != boxData.size_) throw Error(kerImageWriteFailed);
+                            writeUuidBox(outIo, kJp2UuidExif, &blob[0], blob.size());
                         }
                     }
 
@@ -843,19 +887,11 @@ static void boxes_check(size_t b,size_t m)
                         DataBuf rawIptc = IptcParser::encode(iptcData_);
                         if (rawIptc.size_ > 0)
                         {
-                            DataBuf boxData(8 + 16 + rawIptc.size_);
-                            ul2Data(boxDataSize, (uint32_t)boxData.size_, Exiv2::bigEndian);
-                            ul2Data(boxUUIDtype, kJp2BoxTypeUuid, Exiv2::bigEndian);
-                            memcpy(boxData.pData_,          boxDataSize,    4);
-                            memcpy(boxData.pData_ + 4,      boxUUIDtype,    4);
-                            memcpy(boxData.pData_ + 8,      kJp2UuidIptc,   16);
-                            memcpy(boxData.pData_ + 8 + 16, rawIptc.pData_, rawIptc.size_);
-
 #ifdef EXIV2_DEBUG_MESSAGES
                             std::cout << "Exiv2::Jp2Image::doWriteMetadata: Write box with Iptc metadata (length: "
-                                      << boxData.size_ << std::endl;
+                                      << 8 + 16 + rawIptc.size_ << std::endl;
 #endif
-                            if (outIo.write(boxData.pData_, boxData.size_) != boxData.size_) throw Error(kerImageWriteFailed);
+                            writeUuidBox(outIo, kJp2UuidIptc, rawIptc.pData_, rawIptc.size_);
                         }
                     }
 
@@ -872,20 +908,12 @@ static void boxes_check(size_t b,size_t m)
                     {
                         // Update Xmp data to a new UUID box
 
-                        DataBuf xmp(reinterpret_cast<const byte*>(xmpPacket_.data()), static_cast<long>(xmpPacket_.size()));
-                        DataBuf boxData(8 + 16 + xmp.size_);
-                        ul2Data(boxDataSize, (uint32_t)boxData.size_, Exiv2::bigEndian);
-                        ul2Data(boxUUIDtype, kJp2BoxTypeUuid, Exiv2::bigEndian);
-                        memcpy(boxData.pData_,          boxDataSize,  4);
-                        memcpy(boxData.pData_ + 4,      boxUUIDtype,  4);
-                        memcpy(boxData.pData_ + 8,      kJp2UuidXmp,  16);
-                        memcpy(boxData.pData_ + 8 + 16, xmp.pData_,   xmp.size_);
-
 #ifdef EXIV2_DEBUG_MESSAGES
                         std::cout << "Exiv2::Jp2Image::doWriteMetadata: Write box with XMP metadata (length: "
-                                  << boxData.size_ << ")" << std::endl;
+                                  << 8 + 16 + xmpPacket_.size() << ")" << std::endl;
 #endif
-                        if (outIo.write(boxData.pData_, boxData.size_) != boxData.size_) throw Error(kerImageWriteFailed);
+                        writeUuidBox(outIo, kJp2UuidXmp, reinterpret_cast<const byte*>(xmpPacket_.data()),
+                                     xmpPacket_.size());
                     }
 
                     break;
@@ -923,11 +951,6 @@ static void boxes_check(size_t b,size_t m)
 
                 default:
                 {
-#ifdef EXIV2_DEBUG_MESSAGES
-                    std::cout << "Exiv2::Jp2Image::doWriteMetadata: write box (length: " << box.length << ")" << std::endl;
-#endif
-                    if (outIo.write(boxBuf.pData_, boxBuf.size_) != boxBuf.size_) throw Error(kerImageWriteFailed);
-
                     break;
                 }
             }
@@ -29,6 +29,7 @@
 #include "image_int.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 #include "helper_functions.hpp"
 #include "enforce.hpp"
 #include "safe_op.hpp"
@@ -50,6 +51,13 @@
 #include <stdexcept>
 #include <iostream>
 
+// *****************************************************************************
+// local declarations
+namespace {
+    //! Kinds of APPn segments in the segment index, see JpegBase::segmentId()
+    enum SegmentId { sidOther, sidExif, sidXmp, sidIcc, sidPs3 };
+}
+
 // *****************************************************************************
 // class member definitions
 
@@ -257,18 +265,24 @@ namespace Exiv2 {
             append(psBlob, pPsData, sizeFront);
         }
         // Write new iptc record if we have it
-        DataBuf rawIptc = IptcParser::encode(iptcData);
-        if (rawIptc.size_ > 0) {
-            byte tmpBuf[12];
-            std::memcpy(tmpBuf, Photoshop::irbId_[0], 4);
-            us2Data(tmpBuf + 4, iptc_, bigEndian);
-            tmpBuf[6] = 0;
-            tmpBuf[7] = 0;
-            ul2Data(tmpBuf + 8, (uint32_t)rawIptc.size_, bigEndian);
-            append(psBlob, tmpBuf, 12);
-            append(psBlob, rawIptc.pData_, (uint32_t)rawIptc.size_);
+        // The IPTC data is encoded directly after the header, the size is filled in afterwards
+        const size_t sizeHead = psBlob.size();
+        byte tmpBuf[12];
+        std::memcpy(tmpBuf, Photoshop::irbId_[0], 4);
+        us2Data(tmpBuf + 4, iptc_, bigEndian);
+        tmpBuf[6] = 0;
+        tmpBuf[7] = 0;
+        ul2Data(tmpBuf + 8, 0, bigEndian);
+        append(psBlob, tmpBuf, 12);
+        IptcParser::encode(psBlob, iptcData);
+        const size_t sizeRawIptc = psBlob.size() - sizeHead - 12;
+        if (sizeRawIptc > 0) {
+            ul2Data(&psBlob[sizeHead + 8], static_cast<uint32_t>(sizeRawIptc), bigEndian);
             // Data is padded to be even (but not included in size)
-            if (rawIptc.size_ & 1) psBlob.push_back(0x00);
+            if (sizeRawIptc & 1) psBlob.push_back(0x00);
+        }
+        else {
+            psBlob.resize(sizeHead);
         }
         // Write existing stuff after record,
         // skip the current and all remaining IPTC blocks
@@ -335,8 +349,18 @@ namespace Exiv2 {
         return c;
     }
 
+    uint32_t JpegBase::segmentId(int marker, const byte* buf)
+    {
+        if (marker == app1_ && memcmp(buf + 2, exifId_, 6) == 0) return sidExif;
+        if (marker == app1_ && memcmp(buf + 2, xmpId_, 29) == 0) return sidXmp;
+        if (marker == app2_ && memcmp(buf + 2, iccId_, 11) == 0) return sidIcc;
+        if (marker == app13_ && memcmp(buf + 2, Photoshop::ps3Id_, 14) == 0) return sidPs3;
+        return sidOther;
+    }
+
     void JpegBase::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
         int rc = 0; // Todo: this should be the return value
 
         if (io_->open() != 0) throw Error(kerDataSourceOpenFailed, io_->path(), strError());
@@ -347,6 +371,8 @@ namespace Exiv2 {
             throw Error(kerNotAJpeg);
         }
         clearMetadata();
+        Internal::SegmentIndex& index = segmentIndex();
+        index.clear();
         int search = 6 ; // Exif, ICC, XMP, Comment, IPTC, SOF
         const long bufMinSize = 36;
         DataBuf buf(bufMinSize);
@@ -362,6 +388,7 @@ namespace Exiv2 {
 
         while (marker != sos_ && marker != eoi_ && search > 0) {
             // Read size and signature (ok if this hits EOF)
+            const uint64_t offset = io_->tell();
             std::memset(buf.pData_, 0x0, buf.size_);
             size_t bufRead = io_->read(buf.pData_, bufMinSize);
             if (io_->error())
@@ -369,9 +396,10 @@ namespace Exiv2 {
             if (bufRead < 2)
                 throw Error(kerNotAJpeg);
             uint16_t size = getUShort(buf.pData_, bigEndian);
+            const uint32_t id = segmentId(marker, buf.pData_);
+            index.add(marker, id, offset, size);
 
-            if (   !foundExifData
-                && marker == app1_ && memcmp(buf.pData_ + 2, exifId_, 6) == 0) {
+            if (!foundExifData && id == sidExif) {
                 if (size < 8) {
                     rc = 1;
                     break;
@@ -392,8 +420,7 @@ namespace Exiv2 {
                 --search;
                 foundExifData = true;
             }
-            else if (   !foundXmpData
-                     && marker == app1_ && memcmp(buf.pData_ + 2, xmpId_, 29) == 0) {
+            else if (!foundXmpData && id == sidXmp) {
                 if (size < 31) {
                     rc = 6;
                     break;
@@ -412,8 +439,7 @@ namespace Exiv2 {
                 --search;
                 foundXmpData = true;
             }
-            else if (   !foundCompletePsData
-                     && marker == app13_ && memcmp(buf.pData_ + 2, Photoshop::ps3Id_, 14) == 0) {
+            else if (!foundCompletePsData && id == sidPs3) {
                 if (size < 16) {
                     rc = 2;
                     break;
@@ -455,7 +481,7 @@ namespace Exiv2 {
                 }
                 --search;
             }
-            else if ( marker == app2_ && memcmp(buf.pData_ + 2, iccId_,11)==0) {
+            else if (id == sidIcc) {
                 if (size < 2+14) {
                     rc = 8;
                     break;
@@ -529,6 +555,26 @@ namespace Exiv2 {
             }
         } // while there are segments to process
 
+        // Index the remaining segments up to the image data for writeMetadata().
+        // Unlike the metadata segments, they are not required to be well-formed.
+        bool indexed = rc == 0;
+        while (indexed && marker != sos_ && marker != eoi_) {
+            const uint64_t offset = io_->tell();
+            std::memset(buf.pData_, 0x0, buf.size_);
+            const size_t bufRead = io_->read(buf.pData_, bufMinSize);
+            const uint16_t size = getUShort(buf.pData_, bigEndian);
+            index.add(marker, segmentId(marker, buf.pData_), offset, size);
+            indexed = !io_->error() && bufRead >= 2 && size >= 2 && io_->seek(size - bufRead, BasicIo::cur) == 0;
+            if (indexed) {
+                marker = advanceToMarker();
+                indexed = marker >= 0;
+            }
+        }
+        if (indexed) {
+            index.add(marker, sidOther, io_->tell(), 0);
+            index.complete(*io_);
+        }
+
         if (psBlob.size() > 0) {
             // Find actual IPTC data within the psBlob
             Blob iptcBlob;
@@ -582,9 +628,10 @@ namespace Exiv2 {
         }
 
         bool bPrint = option == kpsBasic || option == kpsRecursive;
+        bool bJson = option == kpsJson;
         Exiv2::Uint32Vector iptcDataSegs;
 
-        if (bPrint || option == kpsXMP || option == kpsIccProfile || option == kpsIptcErase) {
+        if (bPrint || option == kpsXMP || option == kpsIccProfile || option == kpsIptcErase || bJson) {
             // nmonic for markers
             std::string nm[256];
             nm[0xd8] = "SOI";
@@ -622,6 +669,7 @@ namespace Exiv2 {
             int marker = advanceToMarker();
             if (marker < 0)
                 throw Error(kerNotAJpeg);
+            int64 address = io_->tell() - 2;
 
             bool done = false;
             bool first = true;
@@ -632,6 +680,9 @@ namespace Exiv2 {
                     out << " address | marker       |  length | data" << std::endl;
                     REPORT_MARKER;
                 }
+                if (first && bJson) {
+                    Internal::JsonRecord("JPEG", "structure", depth).add("path", io_->path()).write(out);
+                }
                 first = false;
                 bool bLF = bPrint;
 
@@ -645,6 +696,18 @@ namespace Exiv2 {
                 const uint16_t size = mHasLength[marker] ? getUShort(buf.pData_, bigEndian) : 0;
                 if (bPrint && mHasLength[marker])
                     out << Internal::stringFormat(" | %7d ", size);
+                if (bJson) {
+                    Internal::JsonRecord record("JPEG", "segment", depth);
+                    record.add("address", address)
+                        .add("marker", Internal::stringFormat("0xff%02x", marker))
+                        .add("name", nm[marker]);
+                    if (mHasLength[marker])
+                        record.add("length", size);
+                    if (marker >= app0_ && marker <= (app0_ | 0x0F))
+                        record.add("signature", string_from_unterminated(reinterpret_cast<const char*>(buf.pData_ + 2),
+                                                                         buf.size_ - 2));
+                    record.write(out);
+                }
 
                 // print signature for APPn
                 if (marker >= app0_ && marker <= (app0_ | 0x0F)) {
@@ -737,13 +800,14 @@ namespace Exiv2 {
                     // for MPF: http://www.sno.phy.queensu.ca/~phil/exiftool/TagNames/MPF.html
                     // for FLIR: http://owl.phy.queensu.ca/~phil/exiftool/TagNames/FLIR.html
                     bool bFlir = option == kpsRecursive && marker == (app0_ + 1) && signature.compare("FLIR") == 0;
-                    bool bExif = option == kpsRecursive && marker == (app0_ + 1) && signature.compare("Exif") == 0;
-                    bool bMPF = option == kpsRecursive && marker == (app0_ + 2) && signature.compare("MPF") == 0;
+                    bool bExif = (option == kpsRecursive || bJson) && marker == (app0_ + 1) && signature.compare("Exif") == 0;
+                    bool bMPF = (option == kpsRecursive || bJson) && marker == (app0_ + 2) && signature.compare("MPF") == 0;
                     bool bPS = option == kpsRecursive && signature.compare("Photoshop 3.0") == 0;
                     if (bFlir || bExif || bMPF || bPS) {
                         // extract Exif data block which is tiff formatted
                         if (size > 0) {
-                            out << std::endl;
+                            if (bPrint)
+                                out << std::endl;
 
                             // allocate storage and current file position
                             byte* exif = new byte[size];
@@ -822,11 +886,19 @@ namespace Exiv2 {
                     // Read the beginning of the next segment
                     marker = advanceToMarker();
                     enforce(marker>=0, kerNoImageInInputData);
+                    address = io_->tell() - 2;
                     REPORT_MARKER;
                 }
                 done |= marker == eoi_ || marker == sos_;
                 if (done && bPrint)
                     out << std::endl;
+                if (done && bJson) {
+                    Internal::JsonRecord("JPEG", "segment", depth)
+                        .add("address", address)
+                        .add("marker", Internal::stringFormat("0xff%02x", marker))
+                        .add("name", nm[marker])
+                        .write(out);
+                }
             }
         }
         if (option == kpsIptcErase && iptcDataSegs.size()) {
@@ -895,6 +967,7 @@ namespace Exiv2 {
 
     void JpegBase::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
         if (io_->open() != 0) {
             throw Error(kerDataSourceOpenFailed, io_->path(), strError());
         }
@@ -904,6 +977,7 @@ namespace Exiv2 {
 
         doWriteMetadata(*tempIo); // may throw
         io_->close();
+        segmentIndex().clear();
         io_->transfer(*tempIo); // may throw
     } // JpegBase::writeMetadata
 
@@ -944,46 +1018,31 @@ namespace Exiv2 {
         if (writeHeader(outIo))
             throw Error(kerImageWriteFailed);
 
-        // Read section marker
-        int marker = advanceToMarker();
-        if (marker < 0)
-            throw Error(kerNoImageInInputData);
-
         // First find segments of interest. Normally app0 is first and we want
         // to insert after it. But if app0 comes after com, app1 and app13 then
         // don't bother.
-        while (marker != sos_ && marker != eoi_ && search < 6) {
-            // Read size and signature (ok if this hits EOF)
-            bufRead = io_->read(buf.pData_, bufMinSize);
-            if (io_->error())
-                throw Error(kerInputDataReadFailed);
-            uint16_t size = getUShort(buf.pData_, bigEndian);
-
+        auto findSegment = [&](int marker, uint32_t id, uint64_t offset, uint16_t size) {
             if (marker == app0_) {
                 if (size < 2)
                     throw Error(kerNoImageInInputData);
                 insertPos = count + 1;
-                if (io_->seek(size - bufRead, BasicIo::cur))
-                    throw Error(kerNoImageInInputData);
-            } else if (skipApp1Exif == -1 && marker == app1_ && memcmp(buf.pData_ + 2, exifId_, 6) == 0) {
+            } else if (skipApp1Exif == -1 && id == sidExif) {
                 if (size < 8)
                     throw Error(kerNoImageInInputData);
                 skipApp1Exif = count;
                 ++search;
-                // Seek to beginning and read the current Exif data
-                io_->seek(8 - bufRead, BasicIo::cur);
+                // Read the current Exif data
+                io_->seek(static_cast<int64>(offset + 8), BasicIo::beg);
                 rawExif.alloc(size - 8);
                 io_->read(rawExif.pData_, rawExif.size_);
                 if (io_->error() || io_->eof())
                     throw Error(kerNoImageInInputData);
-            } else if (skipApp1Xmp == -1 && marker == app1_ && memcmp(buf.pData_ + 2, xmpId_, 29) == 0) {
+            } else if (skipApp1Xmp == -1 && id == sidXmp) {
                 if (size < 31)
                     throw Error(kerNoImageInInputData);
                 skipApp1Xmp = count;
                 ++search;
-                if (io_->seek(size - bufRead, BasicIo::cur))
-                    throw Error(kerNoImageInInputData);
-            } else if (marker == app2_ && memcmp(buf.pData_ + 2, iccId_, 11) == 0) {
+            } else if (id == sidIcc) {
                 if (size < 31)
                     throw Error(kerNoImageInInputData);
                 skipApp2Icc.push_back(count);
@@ -991,16 +1050,14 @@ namespace Exiv2 {
                     ++search;
                     foundIccData = true;
                 }
-                if (io_->seek(size - bufRead, BasicIo::cur))
-                    throw Error(kerNoImageInInputData);
-            } else if (!foundCompletePsData && marker == app13_ && memcmp(buf.pData_ + 2, Photoshop::ps3Id_, 14) == 0) {
+            } else if (!foundCompletePsData && id == sidPs3) {
 #ifdef EXIV2_DEBUG_MESSAGES
                 std::cerr << "Found APP13 Photoshop PS3 segment\n";
 #endif
                 if (size < 16)
                     throw Error(kerNoImageInInputData);
                 skipApp13Ps3.push_back(count);
-                io_->seek(16 - bufRead, BasicIo::cur);
+                io_->seek(static_cast<int64>(offset + 16), BasicIo::beg);
                 // Load PS data now to allow reinsertion at any point
                 DataBuf psData(size - 16);
                 io_->read(psData.pData_, size - 16);
@@ -1019,13 +1076,9 @@ namespace Exiv2 {
                 // the first one (most jpegs only have one anyway).
                 skipCom = count;
                 ++search;
-                if (io_->seek(size - bufRead, BasicIo::cur))
-                    throw Error(kerNoImageInInputData);
             } else {
                 if (size < 2)
                     throw Error(kerNoImageInInputData);
-                if (io_->seek(size - bufRead, BasicIo::cur))
-                    throw Error(kerNoImageInInputData);
             }
             // As in jpeg-6b/wrjpgcom.c:
             // We will insert the new comment marker just before SOFn.
@@ -1036,10 +1089,36 @@ namespace Exiv2 {
                 comPos = count;
                 ++search;
             }
+            ++count;
+        };
+
+        int marker = -1;
+        if (segmentIndex().valid(*io_)) {
+            // The segments were indexed when the metadata was read
+            for (auto&& segment : segmentIndex().segments()) {
+                marker = static_cast<int>(segment.type_);
+                if (marker == sos_ || marker == eoi_ || search >= 6)
+                    break;
+                findSegment(marker, segment.id_, segment.offset_, static_cast<uint16_t>(segment.size_));
+            }
+        } else {
             marker = advanceToMarker();
             if (marker < 0)
                 throw Error(kerNoImageInInputData);
-            ++count;
+            while (marker != sos_ && marker != eoi_ && search < 6) {
+                // Read size and signature (ok if this hits EOF)
+                const uint64_t offset = io_->tell();
+                bufRead = io_->read(buf.pData_, bufMinSize);
+                if (io_->error())
+                    throw Error(kerInputDataReadFailed);
+                uint16_t size = getUShort(buf.pData_, bigEndian);
+                findSegment(marker, segmentId(marker, buf.pData_), offset, size);
+                if (io_->seek(static_cast<int64>(offset + size), BasicIo::beg))
+                    throw Error(kerNoImageInInputData);
+                marker = advanceToMarker();
+                if (marker < 0)
+                    throw Error(kerNoImageInInputData);
+            }
         }
 
         if (!foundCompletePsData && psBlob.size() > 0)
@@ -1110,11 +1189,10 @@ namespace Exiv2 {
                             throw Error(kerTooLargeJpegSegment, "Exif");
                         us2Data(tmpBuf + 2, static_cast<uint16_t>(exifSize + 8), bigEndian);
                         std::memcpy(tmpBuf + 4, exifId_, 6);
-                        if (outIo.write(tmpBuf, 10) != 10)
-                            throw Error(kerImageWriteFailed);
 
-                        // Write new Exif data buffer
-                        if (outIo.write(pExifData, exifSize) != exifSize)
+                        // Write the header and the new Exif data buffer
+                        const IoBlock blocks[] = {{tmpBuf, 10}, {pExifData, exifSize}};
+                        if (outIo.writev(blocks, 2) != 10 + exifSize)
                             throw Error(kerImageWriteFailed);
                         if (outIo.error())
                             throw Error(kerImageWriteFailed);
@@ -1138,12 +1216,11 @@ namespace Exiv2 {
                         throw Error(kerTooLargeJpegSegment, "XMP");
                     us2Data(tmpBuf + 2, static_cast<uint16_t>(xmpPacket_.size() + 31), bigEndian);
                     std::memcpy(tmpBuf + 4, xmpId_, 29);
-                    if (outIo.write(tmpBuf, 33) != 33)
-                        throw Error(kerImageWriteFailed);
 
-                    // Write new XMP packet
-                    if (outIo.write(reinterpret_cast<const byte*>(xmpPacket_.data()),
-                                    xmpPacket_.size()) != xmpPacket_.size())
+                    // Write the header and the new XMP packet
+                    const IoBlock blocks[] = {
+                        {tmpBuf, 33}, {reinterpret_cast<const byte*>(xmpPacket_.data()), xmpPacket_.size()}};
+                    if (outIo.writev(blocks, 2) != 33 + xmpPacket_.size())
                         throw Error(kerImageWriteFailed);
                     if (outIo.error())
                         throw Error(kerImageWriteFailed);
@@ -1165,21 +1242,16 @@ namespace Exiv2 {
                         size_t bytes = profileSize > chunk_size ? chunk_size : profileSize;  // bytes to write
                         profileSize -= bytes;
 
-                        // write JPEG marker (2 bytes)
-                        if (outIo.write(tmpBuf, 2) != 2)
-                            throw Error(kerImageWriteFailed);  // JPEG Marker
-                        // write length (2 bytes).  length includes the 2 bytes for the length
+                        // JPEG marker (2 bytes) and length (2 bytes), the
+                        // length includes the 2 bytes for the length
                         us2Data(tmpBuf + 2, (uint16_t)(2 + 14 + bytes), bigEndian);
-                        if (outIo.write(tmpBuf + 2, 2) != 2)
-                            throw Error(kerImageWriteFailed);  // JPEG Length
-
-                        // write the ICC_PROFILE header (14 bytes)
-                        char pad[2];
-                        pad[0] = static_cast<char>(chunk + 1);
-                        pad[1] = static_cast<char>(chunks);
-                        outIo.write((const byte*)iccId_, 12);
-                        outIo.write((const byte*)pad, 2);
-                        if (outIo.write(iccProfile_.pData_ + (chunk * chunk_size), bytes) != bytes)
+                        // ICC_PROFILE header (14 bytes)
+                        std::memcpy(tmpBuf + 4, iccId_, 12);
+                        tmpBuf[16] = static_cast<byte>(chunk + 1);
+                        tmpBuf[17] = static_cast<byte>(chunks);
+
+                        const IoBlock blocks[] = {{tmpBuf, 18}, {iccProfile_.pData_ + (chunk * chunk_size), bytes}};
+                        if (outIo.writev(blocks, 2) != 18 + bytes)
                             throw Error(kerImageWriteFailed);
                         if (outIo.error())
                             throw Error(kerImageWriteFailed);
@@ -1214,13 +1286,10 @@ namespace Exiv2 {
                         tmpBuf[1] = app13_;
                         us2Data(tmpBuf + 2, static_cast<uint16_t>(chunkSize + 16), bigEndian);
                         std::memcpy(tmpBuf + 4, Photoshop::ps3Id_, 14);
-                        if (outIo.write(tmpBuf, 18) != 18)
-                            throw Error(kerImageWriteFailed);
-                        if (outIo.error())
-                            throw Error(kerImageWriteFailed);
 
-                        // Write next chunk of the Photoshop IRB data buffer
-                        if (outIo.write(chunkStart, chunkSize) != chunkSize)
+                        // Write the header and the next chunk of the Photoshop IRB data buffer
+                        const IoBlock blocks[] = {{tmpBuf, 18}, {chunkStart, chunkSize}};
+                        if (outIo.writev(blocks, 2) != 18 + chunkSize)
                             throw Error(kerImageWriteFailed);
                         if (outIo.error())
                             throw Error(kerImageWriteFailed);
@@ -1241,11 +1310,10 @@ namespace Exiv2 {
                         throw Error(kerTooLargeJpegSegment, "JPEG comment");
                     us2Data(tmpBuf + 2, static_cast<uint16_t>(comment_.length() + 3), bigEndian);
 
-                    if (outIo.write(tmpBuf, 4) != 4)
-                        throw Error(kerImageWriteFailed);
-                    if (outIo.write((byte*)comment_.data(), (long)comment_.length()) != comment_.length())
-                        throw Error(kerImageWriteFailed);
-                    if (outIo.putb(0) == EOF)
+                    const byte terminator = 0;
+                    const IoBlock blocks[] = {
+                        {tmpBuf, 4}, {reinterpret_cast<const byte*>(comment_.data()), comment_.length()}, {&terminator, 1}};
+                    if (outIo.writev(blocks, 3) != 4 + comment_.length() + 1)
                         throw Error(kerImageWriteFailed);
                     if (outIo.error())
                         throw Error(kerImageWriteFailed);
@@ -1264,13 +1332,12 @@ namespace Exiv2 {
             } else {
                 if (size < 2)
                     throw Error(kerNoImageInInputData);
-                buf.alloc(size + 2);
                 io_->seek(-(int64_t)bufRead - 2, BasicIo::cur);
-                io_->read(buf.pData_, size + 2);
-                if (io_->error() || io_->eof())
-                    throw Error(kerInputDataReadFailed);
-                if (outIo.write(buf.pData_, size + 2) != static_cast<size_t>(size) + 2)
+                if (outIo.copyRange(*io_, size + 2) != static_cast<size_t>(size) + 2) {
+                    if (io_->error() || io_->eof())
+                        throw Error(kerInputDataReadFailed);
                     throw Error(kerImageWriteFailed);
+                }
                 if (outIo.error())
                     throw Error(kerImageWriteFailed);
             }
@@ -1288,12 +1355,9 @@ namespace Exiv2 {
 
         // Copy rest of the Io
         io_->seek(-2, BasicIo::cur);
-        buf.alloc(4096);
-        size_t readSize = 0;
-        while ((readSize = io_->read(buf.pData_, buf.size_))) {
-            if (outIo.write(buf.pData_, readSize) != readSize)
-                throw Error(kerImageWriteFailed);
-        }
+        const size_t rest = io_->size() - static_cast<size_t>(io_->tell());
+        if (outIo.copyRange(*io_, rest) != rest)
+            throw Error(kerImageWriteFailed);
         if (outIo.error())
             throw Error(kerImageWriteFailed);
 
@@ -0,0 +1,62 @@
+// ***************************************************************** -*- C++ -*-
+/*
+ * Copyright (C) 2004-2018 Exiv2 authors
+ * This program is part of the Exiv2 distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, 5th Floor, Boston, MA 02110-1301 USA.
+ */
+// *****************************************************************************
+// included header files
+#include "lensdb_int.hpp"
+#include "value.hpp"
+#include "i18n.h"                // NLS support.
+
+// + standard includes
+#include <cstring>
+
+// *****************************************************************************
+// class member definitions
+namespace Exiv2 {
+    namespace Internal {
+
+    const TagDetails* findLens(const TagDetailsIndex& index,
+                               int64_t id,
+                               const std::string& focalLength,
+                               const std::string& maxAperture)
+    {
+        const TagDetailsIndex::Range r = index.lenses(id);
+        for (auto i = r.first; i != r.second; ++i) {
+            const char* label = i->lens_->label_;
+            if (   std::strstr(label, focalLength.c_str()) != nullptr
+                && std::strstr(label, maxAperture.c_str()) != nullptr) {
+                return i->lens_;
+            }
+        }
+        return nullptr;
+    }
+
+    std::ostream& printLens(std::ostream& os, const TagDetailsIndex& index, const Value& value)
+    {
+        const TagDetails* td = index.find(value.toLong());
+        if (td) {
+            os << exvGettext(td->label_);
+        }
+        else {
+            os << "(" << value << ")";
+        }
+        return os;
+    }
+
+}}                                      // namespace Internal, Exiv2
@@ -0,0 +1,141 @@
+// ***************************************************************** -*- C++ -*-
+/*
+ * Copyright (C) 2004-2018 Exiv2 authors
+ * This program is part of the Exiv2 distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, 5th Floor, Boston, MA 02110-1301 USA.
+ */
+/*!
+  @file    lensdb_int.hpp
+  @brief   Indexes of the lens tables of the makernotes
+ */
+#pragma once
+
+// *****************************************************************************
+// included header files
+#include "tags_int.hpp"
+
+// + standard includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// *****************************************************************************
+// namespace extensions
+namespace Exiv2 {
+    class Value;
+
+    namespace Internal {
+
+// *****************************************************************************
+// class definitions
+
+    /*!
+      @brief Index of a table of lenses by lens id. Lenses with the same id
+             keep the order of the table, so the first lens of an id is the
+             one a linear search of the table finds. The index refers to the
+             table, which must outlive it.
+     */
+    template <typename Lens>
+    class LensIndex {
+    public:
+        //! An entry of the index
+        struct Entry {
+            //! Comparison operator to sort by id
+            bool operator<(const Entry& rhs) const { return id_ < rhs.id_; }
+
+            // DATA
+            int64_t     id_;                    //!< Lens id
+            const Lens* lens_;                  //!< Lens in the table
+        };
+        //! Const iterator over the entries
+        typedef typename std::vector<Entry>::const_iterator const_iterator;
+        //! A range of entries
+        typedef std::pair<const_iterator, const_iterator> Range;
+
+        //! @name Creators
+        //@{
+        /*!
+          @brief Index the \em size lenses of \em table. \em id is a function
+                 which returns the id of a lens.
+         */
+        template <typename IdFct>
+        LensIndex(const Lens* table, size_t size, IdFct id)
+        {
+            entries_.reserve(size);
+            for (size_t i = 0; i < size; ++i) {
+                entries_.push_back(Entry{static_cast<int64_t>(id(table[i])), table + i});
+            }
+            std::stable_sort(entries_.begin(), entries_.end());
+        }
+        //@}
+
+        //! @name Accessors
+        //@{
+        //! The lenses with \em id, in the order of the table
+        Range lenses(int64_t id) const
+        {
+            const Entry key = {id, nullptr};
+            return std::equal_range(entries_.begin(), entries_.end(), key);
+        }
+        //! The first lens with \em id, 0 if there is none
+        const Lens* find(int64_t id) const
+        {
+            const Range r = lenses(id);
+            return r.first == r.second ? nullptr : r.first->lens_;
+        }
+        //! The number of lenses in the index
+        size_t size() const { return entries_.size(); }
+        //@}
+
+    private:
+        // DATA
+        std::vector<Entry> entries_;            //!< Entries sorted by id
+    };
+
+    //! Index of a lens table with lens names, like canonCsLensType
+    typedef LensIndex<TagDetails> TagDetailsIndex;
+
+// *****************************************************************************
+// template, inline and free functions
+
+    //! Index a lens table with lens names by the value of the entries
+    template <int N>
+    TagDetailsIndex makeLensIndex(const TagDetails (&table)[N])
+    {
+        return TagDetailsIndex(table, N, [](const TagDetails& td) { return td.val_; });
+    }
+
+    /*!
+      @brief Return the first lens with \em id whose name contains \em focalLength
+             and \em maxAperture, 0 if there is none. An empty string matches
+             any name.
+     */
+    const TagDetails* findLens(const TagDetailsIndex& index,
+                               int64_t id,
+                               const std::string& focalLength,
+                               const std::string& maxAperture);
+
+    /*!
+      @brief Print the name of the first lens with the id in \em value,
+             like printTag() prints it from the table of the index.
+     */
+    std::ostream& printLens(std::ostream& os, const TagDetailsIndex& index, const Value& value);
+
+}}                                      // namespace Internal, Exiv2
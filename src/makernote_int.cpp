@@ -36,6 +36,8 @@
 // + standard includes
 #include <string>
 #include <cstring>
+#include <sys/stat.h>
+#include <sys/types.h>
 
 #if defined(__MINGW32__) || defined(__MINGW64__)
 #ifndef __MINGW__
@@ -110,15 +112,74 @@ namespace Exiv2 {
         }
 
 
+        //! The Exiv2 configuration file, its path is determined once unless it is set
+        ConfigFile& exiv2Config()
+        {
+            static ConfigFile config(getExiv2ConfigPath());
+            return config;
+        }
+
         std::string readExiv2Config(const std::string& section,const std::string& value,const std::string& def)
         {
-            std::string result = def;
-            Exiv2::INIReader reader(Exiv2::Internal::getExiv2ConfigPath());
+            return exiv2Config().get(section, value, def);
+        }
+
+        void reloadExiv2Config()
+        {
+            exiv2Config().reload();
+        }
+
+        void setExiv2ConfigPath(const std::string& path)
+        {
+            exiv2Config().setPath(path);
+        }
+
+        ExifData::const_iterator findIndexedKey(const ExifData& exifData, const std::string& key)
+        {
+            return exifData.findIndexedKey(key);
+        }
+
+        ConfigFile::ConfigFile(const std::string& path)
+            : path_(path), parsed_(false), exists_(false), size_(0), mtime_(0)
+        {
+        }
+
+        std::string ConfigFile::get(const std::string& section, const std::string& name, const std::string& def)
+        {
+            std::lock_guard<std::mutex> scoped_lock(mutex_);
+            refresh();
+            if (!reader_ || reader_->ParseError() != 0) {
+                return def;
+            }
+            return reader_->Get(section, name, def);
+        }
+
+        void ConfigFile::reload()
+        {
+            std::lock_guard<std::mutex> scoped_lock(mutex_);
+            parsed_ = false;
+        }
 
-            if (reader.ParseError() == 0) {
-                result = reader.Get(section,value,def);
+        void ConfigFile::setPath(const std::string& path)
+        {
+            std::lock_guard<std::mutex> scoped_lock(mutex_);
+            path_ = path;
+            parsed_ = false;
+        }
+
+        void ConfigFile::refresh()
+        {
+            struct stat buf;
+            const bool exists = ::stat(path_.c_str(), &buf) == 0;
+            if (parsed_ && exists == exists_ &&
+                (!exists || (static_cast<uint64_t>(buf.st_size) == size_ && buf.st_mtime == mtime_))) {
+                return;
             }
-            return result;
+            parsed_ = true;
+            exists_ = exists;
+            size_ = exists ? static_cast<uint64_t>(buf.st_size) : 0;
+            mtime_ = exists ? buf.st_mtime : 0;
+            reader_.reset(exists ? new INIReader(path_) : 0);
         }
 
 
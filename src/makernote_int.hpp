@@ -32,11 +32,15 @@
 // *****************************************************************************
 // included header files
 #include "tifffwd_int.hpp"
+#include "exif.hpp"
 #include "tags_int.hpp"
 #include "ini.hpp"
 #include "types.hpp"
 
 // + standard includes
+#include <ctime>
+#include <memory>
+#include <mutex>
 #include <string>
 
 // *****************************************************************************
@@ -51,10 +55,70 @@ namespace Exiv2 {
         std::string getExiv2ConfigPath();
 
         /*!
-          @brief Read value from Exiv2 configuration file
+          @brief Read value from Exiv2 configuration file. The file is parsed
+                 once and again only when it changes, see ConfigFile.
          */
         std::string readExiv2Config(const std::string& section,const std::string& value,const std::string& def);
 
+        /*!
+          @brief Find the first %Exifdatum with \em key in \em exifData, like
+                 ExifData::findKey(), for the makernote print functions. The
+                 positions of all keys are indexed on the first call, so that
+                 the lookups of the print functions don't search the metadata.
+
+          Adding, erasing or sorting metadata drops the index. Assigning
+          another %Exifdatum through an iterator changes its key without
+          ExifData noticing it, the index may then miss the new key. The print
+          functions don't change the metadata.
+         */
+        ExifData::const_iterator findIndexedKey(const ExifData& exifData, const std::string& key);
+
+        /*!
+          @brief Parse the Exiv2 configuration file again on the next lookup
+         */
+        void reloadExiv2Config();
+
+        /*!
+          @brief Read the Exiv2 configuration from \em path instead of the file
+                 in the home directory, e.g., in benchmarks
+         */
+        void setExiv2ConfigPath(const std::string& path);
+
+// *****************************************************************************
+// class definitions
+
+        /*!
+          @brief A configuration file which is parsed on the first lookup and
+                 again when its size or modification time changes, or after
+                 reload(). Lookups are thread safe.
+         */
+        class ConfigFile {
+        public:
+            //! Constructor, the file is not read yet
+            explicit ConfigFile(const std::string& path);
+            /*!
+              @brief Return the value of \em name in \em section, or \em def
+                     if it is not set or the file can't be parsed.
+             */
+            std::string get(const std::string& section, const std::string& name, const std::string& def);
+            //! Parse the file again on the next lookup
+            void reload();
+            //! Read the file at \em path from the next lookup on
+            void setPath(const std::string& path);
+
+        private:
+            //! Parse the file if it is new or has changed. The caller holds mutex_.
+            void refresh();
+
+            std::string path_;
+            std::mutex mutex_;
+            bool parsed_;                        //!< The file was parsed at least once
+            bool exists_;                        //!< The file existed when it was checked last
+            uint64_t size_;                      //!< Size of the file when it was parsed
+            time_t mtime_;                       //!< Modification time of the file when it was parsed
+            std::unique_ptr<INIReader> reader_;  //!< The parsed file
+        };
+
 
 // *****************************************************************************
 // class definitions
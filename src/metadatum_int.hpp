@@ -0,0 +1,105 @@
+// ***************************************************************** -*- C++ -*-
+/*
+ * Copyright (C) 2004-2018 Exiv2 authors
+ * This program is part of the Exiv2 distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, 5th Floor, Boston, MA 02110-1301 USA.
+ */
+/*!
+  @file    metadatum_int.hpp
+  @brief   Internal helpers for the metadata containers
+ */
+#pragma once
+
+// *****************************************************************************
+// standard includes
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+// *****************************************************************************
+// namespace extensions
+namespace Exiv2 {
+    namespace Internal {
+
+// *****************************************************************************
+// type definitions
+
+    //! A key and the position of its metadatum
+    template <typename Position>
+    struct KeyPosition {
+        //! Comparison operator to sort by key
+        bool operator<(const KeyPosition& rhs) const { return key_ < rhs.key_; }
+
+        // DATA
+        std::string key_;      //!< Key of the metadatum
+        Position    position_; //!< Position of the metadatum
+    };
+
+// *****************************************************************************
+// free functions
+
+    /*!
+      @brief Sort \em metadata by key. Unlike sorting with cmpMetadataByKey,
+             each key is built only once. Metadata with the same key keep
+             their order. The entries are moved by relinking the list nodes.
+     */
+    template <typename T>
+    void sortByKey(std::list<T>& metadata)
+    {
+        typedef KeyPosition<typename std::list<T>::iterator> Entry;
+        std::vector<Entry> entries;
+        entries.reserve(metadata.size());
+        for (auto i = metadata.begin(); i != metadata.end(); ++i) {
+            entries.push_back(Entry{i->key(), i});
+        }
+        std::stable_sort(entries.begin(), entries.end());
+        for (auto&& e : entries) {
+            metadata.splice(metadata.end(), metadata, e.position_);
+        }
+    }
+
+    /*!
+      @brief Sort \em metadata by key. Unlike sorting with cmpMetadataByKey,
+             each key is built only once and each metadatum is copied at most
+             once. Metadata with the same key keep their order. If a copy
+             throws, \em metadata is not modified.
+     */
+    template <typename T>
+    void sortByKey(std::vector<T>& metadata)
+    {
+        typedef KeyPosition<size_t> Entry;
+        std::vector<Entry> entries;
+        entries.reserve(metadata.size());
+        for (size_t i = 0; i < metadata.size(); ++i) {
+            entries.push_back(Entry{metadata[i].key(), i});
+        }
+        std::stable_sort(entries.begin(), entries.end());
+        size_t unmoved = 0;
+        while (unmoved < entries.size() && entries[unmoved].position_ == unmoved) ++unmoved;
+        if (unmoved == entries.size()) return;
+
+        std::vector<T> sorted;
+        sorted.reserve(metadata.size());
+        for (auto&& e : entries) {
+            sorted.push_back(metadata[e.position_]);
+        }
+        metadata.swap(sorted);
+    }
+
+}}                                      // namespace Internal, Exiv2
@@ -28,6 +28,7 @@
 // *****************************************************************************
 // included header files
 #include "minoltamn_int.hpp"
+#include "lensdb_int.hpp"
 #include "tags_int.hpp"
 #include "makernote_int.hpp"
 #include "value.hpp"
@@ -1610,7 +1611,7 @@ namespace Exiv2 {
        25720/25721, 25790/25791, 25960/25961, 25980/25981, 26150/26151
        - No need to i18n these string.
     */
-    extern TagDetails const minoltaSonyLensID[] = {
+    extern constexpr TagDetails minoltaSonyLensID[] = {
         { 0,     "Minolta AF 28-85mm F3.5-4.5 New" },
         { 1,     "Minolta AF 80-200mm F2.8 HS-APO G" },
         { 2,     "Minolta AF 28-70mm F2.8 G" },
@@ -1935,6 +1936,14 @@ namespace Exiv2 {
                  "E PZ 16-50mm F3.5-5.6 OSS"             // 3
         }
     };
+    static_assert(isSorted(minoltaSonyLensID, EXV_COUNTOF(minoltaSonyLensID)), "minoltaSonyLensID must be sorted by value");
+
+    //! Index of minoltaSonyLensID
+    static const TagDetailsIndex& minoltaSonyLensIndex()
+    {
+        static const TagDetailsIndex index = makeLensIndex(minoltaSonyLensID);
+        return index;
+    }
 
     // ----------------------------------------------------------------------
     // #1145 begin - respect lenses with shared LensID
@@ -1966,15 +1975,16 @@ namespace Exiv2 {
             return os << buffer;
         }
 #endif
-        return EXV_PRINT_TAG(minoltaSonyLensID)(os, value, metadata);
+        return printLens(os, minoltaSonyLensIndex(), value);
     }
 #endif
 
     static std::string getKeyString(const std::string& key,const ExifData* metadata)
     {
         std::string result;
-        if ( metadata->findKey(ExifKey(key)) != metadata->end() ) {
-            result = metadata->findKey(ExifKey(key))->toString();
+        const ExifData::const_iterator pos = findIndexedKey(*metadata, key);
+        if ( pos != metadata->end() ) {
+            result = pos->toString();
         }
         return result;
     }
@@ -1983,8 +1993,9 @@ namespace Exiv2 {
     static long getKeyLong(const std::string& key,const ExifData* metadata,int which)
     {
         long result = -1;
-        if ( metadata->findKey(ExifKey(key)) != metadata->end() ) {
-            result = (long) metadata->findKey(ExifKey(key))->toFloat(which);
+        const ExifData::const_iterator pos = findIndexedKey(*metadata, key);
+        if ( pos != metadata->end() ) {
+            result = (long) pos->toFloat(which);
         }
         return result;
     }
@@ -2035,7 +2046,7 @@ namespace Exiv2 {
 
     static std::ostream& resolvedLens(std::ostream& os,long lensID,long index)
     {
-        const TagDetails* td = find(minoltaSonyLensID, lensID);
+        const TagDetails* td = minoltaSonyLensIndex().find(lensID);
         std::vector<std::string> tokens = split(td[0].label_,"|");
         return os << exvGettext(trim(tokens[index-1]).c_str());
     }
@@ -2059,7 +2070,7 @@ namespace Exiv2 {
             }
         } catch (...) {
         }
-        return EXV_PRINT_TAG(minoltaSonyLensID)(os, value, metadata);
+        return printLens(os, minoltaSonyLensIndex(), value);
     }
 
     static std::ostream& resolveLens0x29(std::ostream& os, const Value& value,
@@ -2082,7 +2093,7 @@ namespace Exiv2 {
         } catch (...) {
 
         }
-        return EXV_PRINT_TAG(minoltaSonyLensID)(os, value, metadata);
+        return printLens(os, minoltaSonyLensIndex(), value);
     }
 
     static std::ostream& resolveLens0x34(std::ostream& os, const Value& value,
@@ -2109,7 +2120,7 @@ namespace Exiv2 {
             }
         } catch (...) {
         }
-        return EXV_PRINT_TAG(minoltaSonyLensID)(os, value, metadata);
+        return printLens(os, minoltaSonyLensIndex(), value);
     }
 
     static std::ostream& resolveLens0x80(std::ostream& os, const Value& value,
@@ -2132,7 +2143,7 @@ namespace Exiv2 {
                 return resolvedLens(os,lensID,index);
             }
         } catch (...) {}
-        return EXV_PRINT_TAG(minoltaSonyLensID)(os, value, metadata);
+        return printLens(os, minoltaSonyLensIndex(), value);
     }
 
     static std::ostream& resolveLens0xff(std::ostream& os, const Value& value,
@@ -2156,7 +2167,7 @@ namespace Exiv2 {
             }
         } catch (...) {
         }
-        return EXV_PRINT_TAG(minoltaSonyLensID)(os, value, metadata);
+        return printLens(os, minoltaSonyLensIndex(), value);
     }
 
     static std::ostream& resolveLens0xffff(std::ostream& os, const Value& value,
@@ -2197,7 +2208,7 @@ namespace Exiv2 {
             }
         } catch (...) {}
 
-        return EXV_PRINT_TAG(minoltaSonyLensID)(os, value, metadata);
+        return printLens(os, minoltaSonyLensIndex(), value);
     }
 
     struct LensIdFct {
@@ -2226,11 +2237,13 @@ namespace Exiv2 {
         const std::string undefined("undefined") ;
         const std::string minolta  ("minolta");
         const std::string sony     ("sony");
-        if ( Internal::readExiv2Config(minolta,value.toString(),undefined) != undefined ) {
-            return os << Internal::readExiv2Config(minolta,value.toString(),undefined);
+        const std::string lensID   (value.toString());
+        std::string       lens     (Internal::readExiv2Config(minolta,lensID,undefined));
+        if ( lens == undefined ) {
+            lens = Internal::readExiv2Config(sony,lensID,undefined);
         }
-        if ( Internal::readExiv2Config(sony,value.toString(),undefined) != undefined ) {
-            return os << Internal::readExiv2Config(sony,value.toString(),undefined);
+        if ( lens != undefined ) {
+            return os << lens;
         }
 
         // #1145 - respect lenses with shared LensID
@@ -2241,7 +2254,7 @@ namespace Exiv2 {
                 return lif->fct_(os, value, metadata);
         }
 
-        return EXV_PRINT_TAG(minoltaSonyLensID)(os, value, metadata);
+        return printLens(os, minoltaSonyLensIndex(), value);
     }
 
     // ----------------------------------------------------------------------------------------------------
@@ -34,6 +34,7 @@
 #include "error.hpp"
 #include "enforce.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 
 // + standard includes
 #include <string>
@@ -93,6 +94,7 @@ namespace Exiv2 {
 
     void MrwImage::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Reading MRW file " << io_->path() << "\n";
 #endif
@@ -153,6 +155,7 @@ namespace Exiv2 {
 
     void MrwImage::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
         // Todo: implement me!
         throw(Error(kerWritingImageFormatUnsupported, "MRW"));
     } // MrwImage::writeMetadata
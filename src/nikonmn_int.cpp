@@ -32,6 +32,7 @@
 // included header files
 #include "types.hpp"
 #include "nikonmn_int.hpp"
+#include "lensdb_int.hpp"
 #include "value.hpp"
 #include "image.hpp"
 #include "tags_int.hpp"
@@ -282,8 +283,9 @@ namespace Exiv2 {
     static std::string getKeyString(const std::string& key,const ExifData* metadata)
     {
         std::string result;
-        if ( metadata->findKey(ExifKey(key)) != metadata->end() ) {
-            result = metadata->findKey(ExifKey(key))->toString();
+        const ExifData::const_iterator pos = findIndexedKey(*metadata, key);
+        if ( pos != metadata->end() ) {
+            result = pos->toString();
         }
         return result;
     }
@@ -1690,7 +1692,7 @@ namespace Exiv2 {
 
         bool dModel = false;
         if (metadata) {
-            ExifData::const_iterator pos = metadata->findKey(ExifKey("Exif.Image.Model"));
+            ExifData::const_iterator pos = findIndexedKey(*metadata, "Exif.Image.Model");
             if (pos != metadata->end() && pos->count() != 0) {
                 std::string model = pos->toString();
                 if (model.find("NIKON D") != std::string::npos) {
@@ -1721,8 +1723,7 @@ namespace Exiv2 {
         if (!(l & 0x87)) os << _("Single-frame") << ", ";
         bool d70 = false;
         if (metadata) {
-            ExifKey key("Exif.Image.Model");
-            ExifData::const_iterator pos = metadata->findKey(key);
+            ExifData::const_iterator pos = findIndexedKey(*metadata, "Exif.Image.Model");
             if (pos != metadata->end() && pos->count() != 0) {
                 std::string model = pos->toString();
                 if (model.find("D70") != std::string::npos) {
@@ -2554,30 +2555,31 @@ fmountlens[] = {
 #endif
 // 8< - - - 8< do not remove this line >8 - - - >8
 
+    /* the 'FMntLens' name is added to the annonymous struct for
+     * fmountlens[]
+     *
+     * remember to name the struct when importing/updating the lens info
+     * from:
+     *
+     * www.rottmerhusen.com/objektives/lensid/files/c-header/fmountlens4.h
+     */
+        // Index of the lenses by LensIDNumber, without the terminating entry
+        static const LensIndex<FMntLens> fmountIndex(fmountlens, EXV_COUNTOF(fmountlens) - 1,
+                                                     [](const FMntLens& lens) { return lens.lid; });
+        // The lookup by lens id alone stops at the first lens without an id
+        static const FMntLens* const noLid = fmountIndex.find(0);
+
     /* if no meta obj is provided, try to use the value param that *may*
      * be the pre-parsed lensid
      */
         if (metadata == 0)
         {
             const unsigned char  vid = (unsigned)value.toLong(0);
-
-        /* the 'FMntLens' name is added to the annonymous struct for
-         * fmountlens[]
-         *
-         * remember to name the struct when importing/updating the lens info
-         * from:
-         *
-         * www.rottmerhusen.com/objektives/lensid/files/c-header/fmountlens4.h
-         */
-            const struct FMntLens*  pf = fmountlens;
-            while (pf->lid && pf->lensname) {
-                if (pf->lid == vid) {
-                    break;
-                }
-                ++pf;
+            const FMntLens*      pf  = fmountIndex.find(vid);
+            if (noLid != nullptr && (pf == nullptr || pf > noLid)) {
+                pf = noLid;
             }
-
-            if (pf->lensname == nullptr) {
+            if (pf == nullptr) {
                 return os << value;
             }
             else {
@@ -2600,43 +2602,43 @@ fmountlens[] = {
 
         const std::string pre = std::string("Exif.") + group + std::string(".");
         for (unsigned int i = 0; i < 7; ++i) {
-            ExifKey key(pre + std::string(tags[i]));
-            ExifData::const_iterator md = metadata->findKey(key);
+            ExifData::const_iterator md = findIndexedKey(*metadata, pre + tags[i]);
             if (md == metadata->end() || md->typeId() != unsignedByte || md->count() == 0) {
                 return os << value;
             }
             raw[i] = static_cast<byte>(md->toLong());
         }
 
-        ExifData::const_iterator md = metadata->findKey(ExifKey("Exif.Nikon3.LensType"));
+        ExifData::const_iterator md = findIndexedKey(*metadata, "Exif.Nikon3.LensType");
         if (md == metadata->end() || md->typeId() != unsignedByte || md->count() == 0) {
             return os << value;
         }
         raw[7] = static_cast<byte>(md->toLong());
 
-        for (int i = 0; fmountlens[i].lensname != nullptr; ++i) {
-            if (   raw[0] == fmountlens[i].lid ) {
-                // #1034
-                const std::string  undefined("undefined") ;
-                const std::string  section  ("nikon");
-                std::ostringstream lensIDStream;
-                lensIDStream  << (int) raw[7];
-                if ( Internal::readExiv2Config(section,lensIDStream.str(),undefined) != undefined ) {
-                    return os << Internal::readExiv2Config(section,lensIDStream.str(),undefined);
-                }
+        const LensIndex<FMntLens>::Range lenses = fmountIndex.lenses(raw[0]);
+        if (lenses.first != lenses.second) {
+            // #1034
+            const std::string  undefined("undefined") ;
+            const std::string  section  ("nikon");
+            std::ostringstream lensIDStream;
+            lensIDStream  << (int) raw[7];
+            const std::string  lens(Internal::readExiv2Config(section,lensIDStream.str(),undefined));
+            if ( lens != undefined ) {
+                return os << lens;
             }
-
-            if (   raw[0] == fmountlens[i].lid
-                // stps varies with focal length for some Sigma zoom lenses.
-                &&(raw[1] == fmountlens[i].stps || strcmp(fmountlens[i].manuf, "Sigma") == 0)
-                && raw[2] == fmountlens[i].focs
-                && raw[3] == fmountlens[i].focl
-                && raw[4] == fmountlens[i].aps
-                && raw[5] == fmountlens[i].apl
-                && raw[6] == fmountlens[i].lfw
-                && raw[7] == fmountlens[i].ltype) {
+        }
+        for (auto i = lenses.first; i != lenses.second; ++i) {
+            const FMntLens& pf = *i->lens_;
+            if (   // stps varies with focal length for some Sigma zoom lenses.
+                   (raw[1] == pf.stps || strcmp(pf.manuf, "Sigma") == 0)
+                && raw[2] == pf.focs
+                && raw[3] == pf.focl
+                && raw[4] == pf.aps
+                && raw[5] == pf.apl
+                && raw[6] == pf.lfw
+                && raw[7] == pf.ltype) {
                 // Lens found in database
-                return os << fmountlens[i].manuf << " " << fmountlens[i].lensname;
+                return os << pf.manuf << " " << pf.lensname;
             }
         }
         // Lens not found in database
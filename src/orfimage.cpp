@@ -36,6 +36,7 @@
 #include "basicio.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 
 // + standard includes
 #include <string>
@@ -101,6 +102,7 @@ namespace Exiv2 {
 
     void OrfImage::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Reading ORF file " << io_->path() << "\n";
 #endif
@@ -124,6 +126,7 @@ namespace Exiv2 {
 
     void OrfImage::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Writing ORF file " << io_->path() << "\n";
 #endif
@@ -103,32 +103,9 @@ namespace
     };
 }  // namespace
 
-Params::Params()
-    : optstring_(":hVvqfbuktTFa:Y:O:D:r:p:P:d:e:i:c:m:M:l:S:g:K:n:Q:"),
-      first_(true),
-      help_(false),
-      version_(false),
-      verbose_(false),
-      force_(false),
-      binary_(true),
-      unknown_(true),
-      preserve_(false),
-      timestamp_(false),
-      timestampOnly_(false),
-      fileExistsPolicy_(askPolicy),
-      adjust_(false),
-      printMode_(pmSummary),
-      printItems_(0),
-      printTags_(Exiv2::mdNone),
-      action_(0),
-      target_(ctExif | ctIptc | ctComment | ctXmp),
-      adjustment_(0),
-      format_("%Y%m%d_%H%M%S"),
-      formatSet_(false)
+Params::Params() : optstring_(":hVvqfbuktTFZa:Y:O:D:r:p:P:d:e:i:c:m:M:l:S:g:K:n:Q:s:")
 {
-    yodAdjust_[yodYear] = {false, "-Y", 0};
-    yodAdjust_[yodMonth] = {false, "-O", 0};
-    yodAdjust_[yodDay] = {false, "-D", 0};
+    reset();
 }
 
 Params& Params::instance()
@@ -230,6 +207,9 @@ void Params::help(std::ostream& os) const
        << _("             C : print ICC profile embedded in image\n")
        << _("             R : recursive print structure of image\n")
        << _("             S : print structure of image\n")
+       << _("             J : print structure of image as JSON lines\n")
+       << _("             j : print Exif, IPTC and XMP metadata as JSON lines\n")
+       << _("             b : print Exif, IPTC and XMP metadata as binary records\n")
        << _("             X : extract XMP from image\n")
        << _("   -P flgs Print flags for fine control of tag lists ('print' action):\n")
        << _("             E : include Exif tags in the list\n")
@@ -276,7 +256,14 @@ void Params::help(std::ostream& os) const
        << _("   -M cmd  Command line for the modify action. The format for the\n"
             "           commands is the same as that of the lines of a command file.\n")
        << _("   -l dir  Location (directory) for files to be inserted from or extracted to.\n")
-       << _("   -S .suf Use suffix .suf for source files for insert command.\n\n");
+       << _("   -S .suf Use suffix .suf for source files for insert command.\n")
+       << _("   -Z      Print the counters and timers of the library for the run to the\n"
+            "           standard error (--stats). They are only collected by a library\n"
+            "           built with EXIV2_ENABLE_STATS.\n")
+       << _("   -s src  Stay open and run the command lines read from src, '-' for the\n"
+            "           standard input or the path of a Unix socket to listen on. Each\n"
+            "           line has the options, action and files of one run and its output\n"
+            "           ends with a line {ready <rc>}. The line 'exit' stops the program.\n\n");
     // clang-format on
 }  // Params::help
 
@@ -321,7 +308,9 @@ int Params::option(int opt, const std::string& optarg, int optopt)
             break;
         case 'K':
             rc = evalKey(optarg);
-            printMode_ = pmList;
+            if (printMode_ != pmListJson && printMode_ != pmListBinary) {
+                printMode_ = pmList;
+            }
             break;
         case 'n':
             charset_ = optarg;
@@ -380,6 +369,12 @@ int Params::option(int opt, const std::string& optarg, int optopt)
         case 'S':
             suffix_ = optarg;
             break;
+        case 's':
+            stayOpen_ = optarg;
+            break;
+        case 'Z':
+            stats_ = true;
+            break;
         case ':':
             std::cerr << progname() << ": " << _("Option") << " -" << static_cast<char>(optopt) << " "
                       << _("requires an argument\n");
@@ -604,6 +599,18 @@ int Params::evalPrint(const std::string& optarg)
                     action_ = Action::print;
                     printMode_ = pmStructure;
                     break;
+                case 'J':
+                    action_ = Action::print;
+                    printMode_ = pmStructureJson;
+                    break;
+                case 'j':
+                    action_ = Action::print;
+                    printMode_ = pmListJson;
+                    break;
+                case 'b':
+                    action_ = Action::print;
+                    printMode_ = pmListBinary;
+                    break;
                 case 'X':
                     action_ = Action::print;
                     printMode_ = pmXMP;
@@ -890,6 +897,47 @@ int Params::nonoption(const std::string& argv)
     return rc;
 }  // Params::nonoption
 
+void Params::reset()
+{
+    first_ = true;
+    help_ = false;
+    version_ = false;
+    verbose_ = false;
+    force_ = false;
+    binary_ = true;
+    unknown_ = true;
+    preserve_ = false;
+    timestamp_ = false;
+    timestampOnly_ = false;
+    fileExistsPolicy_ = askPolicy;
+    adjust_ = false;
+    printMode_ = pmSummary;
+    printItems_ = 0;
+    printTags_ = Exiv2::mdNone;
+    action_ = 0;
+    target_ = ctExif | ctIptc | ctComment | ctXmp;
+    adjustment_ = 0;
+    yodAdjust_[yodYear] = {false, "-Y", 0};
+    yodAdjust_[yodMonth] = {false, "-O", 0};
+    yodAdjust_[yodDay] = {false, "-D", 0};
+    format_ = "%Y%m%d_%H%M%S";
+    formatSet_ = false;
+    cmdFiles_.clear();
+    cmdLines_.clear();
+    modifyCmds_.clear();
+    jpegComment_.clear();
+    directory_.clear();
+    suffix_.clear();
+    files_.clear();
+    previewNumbers_.clear();
+    greps_.clear();
+    keys_.clear();
+    charset_.clear();
+    stayOpen_.clear();
+    stats_ = false;
+    stdinBuf.free();
+}  // Params::reset
+
 void Params::getStdin(Exiv2::DataBuf& buf)
 {
     // copy stdin to stdinBuf
@@ -973,6 +1021,8 @@ int Params::getopt(int argc, char* const Argv[])
     longs["--log"] = "-Q";
     longs["--rename"] = "-r";
     longs["--suffix"] = "-S";
+    longs["--stay-open"] = "-s";
+    longs["--stats"] = "-Z";
     longs["--timestamp"] = "-t";
     longs["--Timestamp"] = "-T";
     longs["--unknown"] = "-u";
@@ -996,6 +1046,14 @@ int Params::getopt(int argc, char* const Argv[])
     if (help_ || version_) {
         goto cleanup;
     }
+    if (!stayOpen_.empty()) {
+        // Actions and files are given with each command line
+        if (!first_) {
+            std::cerr << progname() << ": " << _("-s option cannot be used with an action or files\n");
+            rc = 1;
+        }
+        goto cleanup;
+    }
     if (action_ == Action::none) {
         // This shouldn't happen since print is taken as default action
         std::cerr << progname() << ": " << _("An action must be specified\n");
@@ -165,7 +165,10 @@ public:
         pmStructure,
         pmXMP,
         pmIccProfile,
-        pmRecursive
+        pmRecursive,
+        pmStructureJson,
+        pmListJson,
+        pmListBinary
     };
 
     //! Individual items to print, bitmap
@@ -259,6 +262,13 @@ public:
     */
     void getStdin(Exiv2::DataBuf& buf);
 
+    /*!
+      @brief Restore the initial state, to parse another command line. Used
+             by the constructor and by the stay-open mode, which runs many
+             command lines.
+     */
+    void reset();
+
 private:
     /*!
       @brief Default constructor. Note that optstring_ is initialized here.
@@ -322,6 +332,8 @@ public:
     Greps greps_;                        //!< List of keys to 'grep' from the metadata
     Keys keys_;                          //!< List of keys to match from the metadata
     std::string charset_;                //!< Charset to use for UNICODE Exif user comment
+    std::string stayOpen_;               //!< Source of the command lines in stay-open mode (-s option arg)
+    bool stats_;                         //!< Print the counters of the library (-Z option)
 
     Exiv2::DataBuf stdinBuf;             //!< DataBuf with the binary bytes from stdin
 };                            // class Params
@@ -24,6 +24,7 @@
 // included header files
 #include "types.hpp"
 #include "pentaxmn_int.hpp"
+#include "lensdb_int.hpp"
 #include "makernote_int.hpp"
 #include "value.hpp"
 #include "exif.hpp"
@@ -47,7 +48,7 @@ namespace Exiv2 {
     };
 
     //! CameraModel, tag 0x0005
-    extern const TagDetails pentaxModel[] = {
+    extern constexpr TagDetails pentaxModel[] = {
         {    0x0000d, "Optio 330/430" },
         {    0x12926, "Optio 230" },
         {    0x12958, "Optio 330GS" },
@@ -186,6 +187,7 @@ namespace Exiv2 {
         {    0x13222, "K-70" },
         {    0x1322c, "KP" },
     };
+    static_assert(isSorted(pentaxModel, EXV_COUNTOF(pentaxModel)), "pentaxModel must be sorted by value");
 
     //! Quality, tag 0x0008
     extern const TagDetails pentaxQuality[] = {
@@ -692,7 +694,7 @@ namespace Exiv2 {
     };
 
     //! LensType, combi-tag 0x003f (2 unsigned long)
-    extern const TagDetails pentaxLensType[] = {
+    extern constexpr TagDetails pentaxLensType[] = {
         { 0x0000, N_("M-42 or No Lens") },
         { 0x0100, N_("K or M Lens") },
         { 0x0200, N_("A Series Lens") },
@@ -974,14 +976,15 @@ namespace Exiv2 {
         { 0x1500, "Pentax Q Manual Lens" },
         { 0x1501, "01 Standard Prime 8.5mm F1.9" },
         { 0x1502, "02 Standard Zoom 5-15mm F2.8-4.5" },
-        { 0x1603, "03 Fish-eye 3.2mm F5.6" },
-        { 0x1604, "04 Toy Lens Wide 6.3mm F7.1" },
-        { 0x1605, "05 Toy Lens Telephoto 18mm F8" },
         { 0x1506, "06 Telephoto Zoom 15-45mm F2.8" },
         { 0x1507, "07 Mount Shield 11.5mm F9" },
         { 0x1508, "08 Wide Zoom 3.8-5.9mm F3.7-4" },
         { 0x15e9, "Adapter Q for K-mount Lens" },
+        { 0x1603, "03 Fish-eye 3.2mm F5.6" },
+        { 0x1604, "04 Toy Lens Wide 6.3mm F7.1" },
+        { 0x1605, "05 Toy Lens Telephoto 18mm F8" },
     };
+    static_assert(isSorted(pentaxLensType, EXV_COUNTOF(pentaxLensType)), "pentaxLensType must be sorted by value");
 
     //! ImageTone, tag 0x004f
     extern const TagDetails pentaxImageTone[] = {
@@ -1161,15 +1164,13 @@ namespace Exiv2 {
     {
         if ( ! metadata ) return os << "undefined" ;
 
-        ExifData::const_iterator dateIt = metadata->findKey(
-                ExifKey("Exif.PentaxDng.Date"));
+        ExifData::const_iterator dateIt = findIndexedKey(*metadata, "Exif.PentaxDng.Date");
         if (dateIt == metadata->end()) {
-            dateIt = metadata->findKey(ExifKey("Exif.Pentax.Date"));
+            dateIt = findIndexedKey(*metadata, "Exif.Pentax.Date");
         }
-        ExifData::const_iterator timeIt = metadata->findKey(
-                ExifKey("Exif.PentaxDng.Time"));
+        ExifData::const_iterator timeIt = findIndexedKey(*metadata, "Exif.PentaxDng.Time");
         if (timeIt == metadata->end()) {
-            timeIt = metadata->findKey(ExifKey("Exif.Pentax.Time"));
+            timeIt = findIndexedKey(*metadata, "Exif.Pentax.Time");
         }
         if (    dateIt == metadata->end() || dateIt->size() != 4 ||
                 timeIt == metadata->end() || timeIt->size() != 3 ||
@@ -1195,12 +1196,28 @@ namespace Exiv2 {
         return os;
     }
 
+    //! Index of pentaxLensType
+    static const TagDetailsIndex& pentaxLensIndex()
+    {
+        static const TagDetailsIndex index = makeLensIndex(pentaxLensType);
+        return index;
+    }
+
+    //! resolveLensType print lens in human format
+    std::ostream& resolveLensType(std::ostream& os, const Value& value,
+                                                 const ExifData* metadata)
+    {
+        return printCombiValue(os, value, metadata, 2, 1, 2,
+                               [](unsigned long l) { return pentaxLensIndex().find(l); });
+    }
+
     // #1144 begin
     static std::string getKeyString(const std::string& key,const ExifData* metadata)
     {
         std::string result;
-        if ( metadata->findKey(ExifKey(key)) != metadata->end() ) {
-            result = metadata->findKey(ExifKey(key))->toString();
+        const ExifData::const_iterator pos = findIndexedKey(*metadata, key);
+        if ( pos != metadata->end() ) {
+            result = pos->toString();
         }
         return result;
     }
@@ -1208,8 +1225,9 @@ namespace Exiv2 {
     static long getKeyLong(const std::string& key,const ExifData* metadata)
     {
         long result = -1;
-        if ( metadata->findKey(ExifKey(key)) != metadata->end() ) {
-            result = (long) metadata->findKey(ExifKey(key))->toFloat(0);
+        const ExifData::const_iterator pos = findIndexedKey(*metadata, key);
+        if ( pos != metadata->end() ) {
+            result = (long) pos->toFloat(0);
         }
         return result;
     }
@@ -1231,12 +1249,12 @@ namespace Exiv2 {
 
             if ( index > 0 )  {
                 const unsigned long lensID    = 0x32c;
-                const TagDetails* td = find(pentaxLensType, lensID);
+                const TagDetails* td = pentaxLensIndex().find(lensID);
                 os << exvGettext(td[index].label_);
                 return os;
             }
         } catch (...) {}
-        return EXV_PRINT_COMBITAG_MULTI(pentaxLensType, 2, 1, 2)(os, value, metadata);
+        return resolveLensType(os, value, metadata);
     }
     // #1144 end
 
@@ -1250,12 +1268,12 @@ namespace Exiv2 {
             unsigned long index  = 0;
 
             // http://www.sno.phy.queensu.ca/~phil/exiftool/TagNames/Pentax.html#LensData
-            const ExifData::const_iterator lensInfo = metadata->findKey(ExifKey("Exif.PentaxDng.LensInfo")) != metadata->end()
-                                                    ? metadata->findKey(ExifKey("Exif.PentaxDng.LensInfo"))
-                                                    : metadata->findKey(ExifKey("Exif.Pentax.LensInfo"))
+            const ExifData::const_iterator lensInfo = findIndexedKey(*metadata, "Exif.PentaxDng.LensInfo") != metadata->end()
+                                                    ? findIndexedKey(*metadata, "Exif.PentaxDng.LensInfo")
+                                                    : findIndexedKey(*metadata, "Exif.Pentax.LensInfo")
                                                     ;
-            if ( lensInfo == metadata->end() ) return EXV_PRINT_COMBITAG_MULTI(pentaxLensType, 2, 1, 2)(os, value, metadata);
-            if ( lensInfo->count() < 5       ) return EXV_PRINT_COMBITAG_MULTI(pentaxLensType, 2, 1, 2)(os, value, metadata);
+            if ( lensInfo == metadata->end() ) return resolveLensType(os, value, metadata);
+            if ( lensInfo->count() < 5       ) return resolveLensType(os, value, metadata);
 
             if ( value.count() == 2 ) {
                 // http://dev.exiv2.org/attachments/download/326/IMGP4432.PEF
@@ -1291,12 +1309,12 @@ namespace Exiv2 {
 
             if ( index > 0 )  {
                 const unsigned long lensID = 0x3ff;
-                const TagDetails* td = find(pentaxLensType, lensID);
+                const TagDetails* td = pentaxLensIndex().find(lensID);
                 os << exvGettext(td[index].label_);
                 return os;
             }
         } catch (...) {}
-        return EXV_PRINT_COMBITAG_MULTI(pentaxLensType, 2, 1, 2)(os, value, metadata);
+        return resolveLensType(os, value, metadata);
     }
 
     // #1155
@@ -1308,9 +1326,9 @@ namespace Exiv2 {
         try {
             unsigned long index  = 0;
 
-            const ExifData::const_iterator lensInfo = metadata->findKey(ExifKey("Exif.PentaxDng.LensInfo")) != metadata->end()
-                                                    ? metadata->findKey(ExifKey("Exif.PentaxDng.LensInfo"))
-                                                    : metadata->findKey(ExifKey("Exif.Pentax.LensInfo"))
+            const ExifData::const_iterator lensInfo = findIndexedKey(*metadata, "Exif.PentaxDng.LensInfo") != metadata->end()
+                                                    ? findIndexedKey(*metadata, "Exif.PentaxDng.LensInfo")
+                                                    : findIndexedKey(*metadata, "Exif.Pentax.LensInfo")
                                                     ;
             if ( value.count() == 4 ) {
                 std::string model       = getKeyString("Exif.Image.Model"      ,metadata);
@@ -1319,12 +1337,12 @@ namespace Exiv2 {
 
             if ( index > 0 )  {
                 const unsigned long lensID = 0x8ff;
-                const TagDetails* td = find(pentaxLensType, lensID);
+                const TagDetails* td = pentaxLensIndex().find(lensID);
                 os << exvGettext(td[index].label_);
                 return os;
             }
         } catch (...) {}
-        return EXV_PRINT_COMBITAG_MULTI(pentaxLensType, 2, 1, 2)(os, value, metadata);
+        return resolveLensType(os, value, metadata);
     }
 
     // #1155
@@ -1336,9 +1354,9 @@ namespace Exiv2 {
         try {
             unsigned long index  = 0;
 
-            const ExifData::const_iterator lensInfo = metadata->findKey(ExifKey("Exif.PentaxDng.LensInfo")) != metadata->end()
-                                                    ? metadata->findKey(ExifKey("Exif.PentaxDng.LensInfo"))
-                                                    : metadata->findKey(ExifKey("Exif.Pentax.LensInfo"))
+            const ExifData::const_iterator lensInfo = findIndexedKey(*metadata, "Exif.PentaxDng.LensInfo") != metadata->end()
+                                                    ? findIndexedKey(*metadata, "Exif.PentaxDng.LensInfo")
+                                                    : findIndexedKey(*metadata, "Exif.Pentax.LensInfo")
                                                     ;
             if ( value.count() == 4 ) {
                 std::string model       = getKeyString("Exif.Image.Model"      ,metadata);
@@ -1355,19 +1373,12 @@ namespace Exiv2 {
 
             if ( index > 0 )  {
                 const unsigned long lensID = 0x319;
-                const TagDetails* td = find(pentaxLensType, lensID);
+                const TagDetails* td = pentaxLensIndex().find(lensID);
                 os << exvGettext(td[index].label_);
                 return os;
             }
         } catch (...) {}
-        return EXV_PRINT_COMBITAG_MULTI(pentaxLensType, 2, 1, 2)(os, value, metadata);
-    }
-
-    //! resolveLensType print lens in human format
-    std::ostream& resolveLensType(std::ostream& os, const Value& value,
-                                                 const ExifData* metadata)
-    {
-        return EXV_PRINT_COMBITAG_MULTI(pentaxLensType, 2, 1, 2)(os, value, metadata);
+        return resolveLensType(os, value, metadata);
     }
 
     struct LensIdFct {
@@ -1402,8 +1413,9 @@ namespace Exiv2 {
         // #1034
         const std::string  undefined("undefined") ;
         const std::string  section  ("pentax");
-        if ( Internal::readExiv2Config(section,value.toString(),undefined) != undefined ) {
-            return os << Internal::readExiv2Config(section,value.toString(),undefined);
+        const std::string  lens(Internal::readExiv2Config(section,value.toString(),undefined));
+        if ( lens != undefined ) {
+            return os << lens;
         }
 
         unsigned long index = value.toLong(0)*256+value.toLong(1);
@@ -1411,7 +1423,7 @@ namespace Exiv2 {
         // std::cout << std::endl << "printLensType value =" << value.toLong() << " index = " << index << std::endl;
         const LensIdFct* lif = find(lensIdFct, index);
         if (!lif) {
-           return EXV_PRINT_COMBITAG_MULTI(pentaxLensType, 2, 1, 2)(os, value, metadata);
+           return resolveLensType(os, value, metadata);
         }
         if (metadata && lif->fct_) {
             return lif->fct_(os, value, metadata);
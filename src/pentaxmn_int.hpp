@@ -82,10 +82,11 @@ namespace Exiv2 {
 
     /*!
       @brief Print function to translate Pentax "combi-values" to a description
-             by looking up a reference table.
+             which \em lookup finds for the combined value.
      */
-    template <int N, const TagDetails (&array)[N], int count, int ignoredcount, int ignoredcountmax>
-    std::ostream& printCombiTag(std::ostream& os, const Value& value, const ExifData* metadata)
+    template <typename Lookup>
+    std::ostream& printCombiValue(std::ostream& os, const Value& value, const ExifData* metadata,
+                                  int count, int ignoredcount, int ignoredcountmax, Lookup lookup)
     {
         std::ios::fmtflags f( os.flags() );
         if ((value.count() != count && (value.count() < (count + ignoredcount) || value.count() > (count + ignoredcountmax))) || count > 4) {
@@ -98,7 +99,7 @@ namespace Exiv2 {
             }
             l += (value.toLong(c) << ((count - c - 1) * 8));
         }
-        const TagDetails* td = find(array, l);
+        const TagDetails* td = lookup(l);
         if (td) {
             os << exvGettext(td->label_);
         }
@@ -112,6 +113,17 @@ namespace Exiv2 {
         return os;
     }
 
+    /*!
+      @brief Print function to translate Pentax "combi-values" to a description
+             by looking up a reference table.
+     */
+    template <int N, const TagDetails (&array)[N], int count, int ignoredcount, int ignoredcountmax>
+    std::ostream& printCombiTag(std::ostream& os, const Value& value, const ExifData* metadata)
+    {
+        return printCombiValue(os, value, metadata, count, ignoredcount, ignoredcountmax,
+                               [](unsigned long l) { return find(array, l); });
+    }
+
 //! Shortcut for the printCombiTag template which requires typing the array name only once.
 #define EXV_PRINT_COMBITAG(array, count, ignoredcount) printCombiTag<EXV_COUNTOF(array), array, count, ignoredcount, ignoredcount>
 //! Shortcut for the printCombiTag template which requires typing the array name only once.
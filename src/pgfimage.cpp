@@ -34,6 +34,7 @@
 #include "enforce.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 
 // + standard includes
 #include <cstdio>                               // for EOF
@@ -106,6 +107,7 @@ namespace Exiv2 {
 
     void PgfImage::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Exiv2::PgfImage::readMetadata: Reading PGF file " << io_->path() << "\n";
 #endif
@@ -159,6 +161,7 @@ namespace Exiv2 {
 
     void PgfImage::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
         if (io_->open() != 0)
         {
             throw Error(kerDataSourceOpenFailed, io_->path(), strError());
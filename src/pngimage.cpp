@@ -28,6 +28,7 @@
 #include "error.hpp"
 #include "enforce.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 #include "image.hpp"
 #include "image_int.hpp"
 #include "jpgimage.hpp"
@@ -223,7 +224,8 @@ namespace Exiv2
         chType[0] = 0;
         chType[4] = 0;
 
-        if (option == kpsBasic || option == kpsXMP || option == kpsIccProfile || option == kpsRecursive) {
+        if (option == kpsBasic || option == kpsXMP || option == kpsIccProfile || option == kpsRecursive ||
+            option == kpsJson) {
             const std::string xmpKey = "XML:com.adobe.xmp";
             const std::string exifKey = "Raw profile type exif";
             const std::string app1Key = "Raw profile type APP1";
@@ -234,10 +236,14 @@ namespace Exiv2
             const std::string descKey = "Description";
 
             bool bPrint = option == kpsBasic || option == kpsRecursive;
+            bool bJson = option == kpsJson;
             if (bPrint) {
                 out << "STRUCTURE OF PNG FILE: " << io_->path() << std::endl;
                 out << " address | chunk |  length | data                           | checksum" << std::endl;
             }
+            if (bJson) {
+                Internal::JsonRecord("PNG", "structure", depth).add("path", io_->path()).write(out);
+            }
 
             const long imgSize = (long)io_->size();
             DataBuf cheaderBuf(8);
@@ -284,18 +290,27 @@ namespace Exiv2
                     dataString += ' ';
                 dataString = dataString.substr(0, iMax);
 
-                if (bPrint) {
+                if (bPrint || bJson) {
                     io_->seek(dataOffset, BasicIo::cur);  // jump to checksum
                     byte checksum[4];
                     bufRead = io_->read(checksum,4);
                     enforce(bufRead == 4, kerFailedToReadImageData);
                     io_->seek(restore, BasicIo::beg)   ;// restore file pointer
 
-                    out << Internal::stringFormat("%8d | %-5s |%8d | ", (uint32_t)address, chType, dataOffset)
-                        << dataString
-                        << Internal::stringFormat(" | 0x%02x%02x%02x%02x", checksum[0], checksum[1], checksum[2],
-                                                  checksum[3])
-                        << std::endl;
+                    if (bPrint) {
+                        out << Internal::stringFormat("%8d | %-5s |%8d | ", (uint32_t)address, chType, dataOffset)
+                            << dataString
+                            << Internal::stringFormat(" | 0x%02x%02x%02x%02x", checksum[0], checksum[1],
+                                                      checksum[2], checksum[3])
+                            << std::endl;
+                    } else {
+                        Internal::JsonRecord("PNG", "chunk", depth)
+                            .add("address", address)
+                            .add("type", chType)
+                            .add("length", dataOffset)
+                            .add("checksum", getULong(checksum, bigEndian))
+                            .write(out);
+                    }
                 }
 
                 // chunk type
@@ -307,8 +322,8 @@ namespace Exiv2
                 // for XMP, ICC etc: read and format data
                 bool bXMP = option == kpsXMP && findi(dataString, xmpKey) == 0;
                 bool bICC = option == kpsIccProfile && findi(dataString, iccKey) == 0;
-                bool bExif =
-                    option == kpsRecursive && (findi(dataString, exifKey) == 0 || findi(dataString, app1Key) == 0);
+                bool bExif = (option == kpsRecursive || bJson) &&
+                             (findi(dataString, exifKey) == 0 || findi(dataString, app1Key) == 0);
                 bool bIptc = option == kpsRecursive && findi(dataString, iptcKey) == 0;
                 bool bSoft = option == kpsRecursive && findi(dataString, softKey) == 0;
                 bool bComm = option == kpsRecursive && findi(dataString, commKey) == 0;
@@ -417,6 +432,7 @@ namespace Exiv2
 
     void PngImage::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Exiv2::PngImage::readMetadata: Reading PNG file " << io_->path() << std::endl;
 #endif
@@ -507,6 +523,7 @@ namespace Exiv2
 
     void PngImage::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
         if (io_->open() != 0) {
             throw Error(kerDataSourceOpenFailed, io_->path(), strError());
         }
@@ -558,6 +575,29 @@ namespace Exiv2
             if (dataOffset > 0x7FFFFFFF)
                 throw Exiv2::Error(kerFailedToReadImageData);
 
+            char szChunk[5];
+            memcpy(szChunk, cheaderBuf.pData_ + 4, 4);
+            szChunk[4] = 0;
+
+            if (strcmp(szChunk, "IEND") != 0 && strcmp(szChunk, "IHDR") != 0 && strcmp(szChunk, "tEXt") != 0 &&
+                strcmp(szChunk, "zTXt") != 0 && strcmp(szChunk, "iTXt") != 0 && strcmp(szChunk, "iCCP") != 0) {
+                // Copy all other chunks, like the image data, without reading them into a buffer.
+#ifdef EXIV2_DEBUG_MESSAGES
+                std::cout << "Exiv2::PngImage::doWriteMetadata:  copy " << szChunk << " chunk (length: " << dataOffset
+                          << ")" << std::endl;
+#endif
+                const size_t chunkSize = 8 + static_cast<size_t>(dataOffset) + 4;
+                io_->seek(-8, BasicIo::cur);
+                if (outIo.copyRange(*io_, chunkSize) != chunkSize) {
+                    if (io_->error())
+                        throw Error(kerFailedToReadImageData);
+                    if (io_->eof())
+                        throw Error(kerInputDataReadFailed);
+                    throw Error(kerImageWriteFailed);
+                }
+                continue;
+            }
+
             // Read whole chunk : Chunk header + Chunk data (not fixed size - can be null) + CRC (4 bytes).
 
             DataBuf chunkBuf(8 + dataOffset + 4);           // Chunk header (8 bytes) + Chunk data + CRC (4 bytes).
@@ -568,10 +608,6 @@ namespace Exiv2
             if (bufRead != static_cast<size_t>(dataOffset) + 4)
                 throw Error(kerInputDataReadFailed);
 
-            char szChunk[5];
-            memcpy(szChunk, cheaderBuf.pData_ + 4, 4);
-            szChunk[4] = 0;
-
             if (!memcmp(cheaderBuf.pData_ + 4, "IEND", 4)) {
                 // Last chunk found: we write it and done.
 #ifdef EXIV2_DEBUG_MESSAGES
@@ -641,11 +677,13 @@ namespace Exiv2
                         byte crc[4];
                         ul2Data(crc, tmp, bigEndian);
 
-                        if (outIo.write(length, 4) != 4 || outIo.write(type, 4) != 4 ||
-                            outIo.write(reinterpret_cast<const byte*>(profileName_.data()), nameLength) != nameLength ||
-                            outIo.write(nullComp, 2) != 2 ||
-                            outIo.write(compressed.pData_, compressed.size_) != compressed.size_ ||
-                            outIo.write(crc, 4) != 4) {
+                        const IoBlock blocks[] = {{length, 4},
+                                                  {type, 4},
+                                                  {reinterpret_cast<const byte*>(profileName_.data()), nameLength},
+                                                  {nullComp, 2},
+                                                  {compressed.pData_, compressed.size_},
+                                                  {crc, 4}};
+                        if (outIo.writev(blocks, 6) != 12 + static_cast<size_t>(chunkLength)) {
                             throw Error(kerImageWriteFailed);
                         }
 #ifdef EXIV2_DEBUG_MESSAGES
@@ -688,14 +726,6 @@ namespace Exiv2
                     if (outIo.write(chunkBuf.pData_, chunkBuf.size_) != chunkBuf.size_)
                         throw Error(kerImageWriteFailed);
                 }
-            } else {
-                // Write all others chunk as well.
-#ifdef EXIV2_DEBUG_MESSAGES
-                std::cout << "Exiv2::PngImage::doWriteMetadata:  copy " << szChunk << " chunk (length: " << dataOffset
-                          << ")" << std::endl;
-#endif
-                if (outIo.write(chunkBuf.pData_, chunkBuf.size_) != chunkBuf.size_)
-                    throw Error(kerImageWriteFailed);
             }
         }
 
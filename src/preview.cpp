@@ -26,6 +26,7 @@
 // included header files
 #include "config.h"
 
+#include <algorithm>
 #include <climits>
 #include <string>
 
@@ -83,6 +84,45 @@ namespace {
      */
     DataBuf makePnm(uint32_t width, uint32_t height, const DataBuf &rgb);
 
+    /*!
+      @brief Write \em count zero bytes to \em dest, return the number of bytes written.
+     */
+    size_t writeZeros(BasicIo& dest, size_t count);
+
+    /*!
+      @brief Return the first value of the short or long entry \em tag in IFD0
+             of the little endian TIFF structure \em pData, \em size, or 0 if
+             there is no such entry.
+     */
+    uint32_t firstIfd0Value(const byte* pData, size_t size, uint16_t tag);
+
+    /*!
+      @brief Strip or tile offsets with a data area which has a size, but no
+             data. The TIFF encoder lays out the image data of such offsets and
+             writes the alignment byte after it, but not the data itself.
+     */
+    template<typename T>
+    class LayoutValue : public ValueType<T> {
+    public:
+        //! Constructor, copies the values of \em offsets
+        LayoutValue(const Value& offsets, size_t sizeDataArea)
+            : sizeDataArea_(sizeDataArea)
+        {
+            for (long i = 0; i < offsets.count(); ++i) {
+                this->value_.push_back(static_cast<T>(offsets.toLong(i)));
+            }
+        }
+
+        size_t sizeDataArea() const override { return sizeDataArea_; }
+        DataBuf dataArea() const override { return DataBuf(); }
+
+    private:
+        LayoutValue<T>* clone_() const override { return new LayoutValue<T>(*this); }
+
+        // DATA
+        size_t sizeDataArea_;                   //!< Size of the image data
+    };
+
     /*!
       Base class for image loaders. Provides virtual methods for reading properties
       and DataBuf.
@@ -107,6 +147,9 @@ namespace {
         //! Get a buffer that contains the preview image
         virtual DataBuf getData() const = 0;
 
+        //! Write the preview image to \em dest, return the number of bytes written
+        virtual size_t writeData(BasicIo& dest) const;
+
         //! Read preview image dimensions when they are not available directly
         virtual bool readDimensions() { return true; }
 
@@ -161,6 +204,9 @@ namespace {
         //! Get a buffer that contains the preview image
         DataBuf getData() const override;
 
+        //! Write the preview image to \em dest, straight from the source image if possible
+        size_t writeData(BasicIo& dest) const override;
+
         //! Read preview image dimensions
         bool readDimensions() override;
 
@@ -185,6 +231,9 @@ namespace {
         //! Get a buffer that contains the preview image
         DataBuf getData() const override;
 
+        //! Write the preview image to \em dest straight from the source image
+        size_t writeData(BasicIo& dest) const override;
+
         //! Read preview image dimensions
         bool readDimensions() override;
 
@@ -251,7 +300,23 @@ namespace {
         //! Get a buffer that contains the preview image
         DataBuf getData() const override;
 
+        //! Write the encoded preview image to \em dest without an intermediate buffer
+        size_t writeData(BasicIo& dest) const override;
+
     protected:
+        //! Copy the TIFF image tags of the preview image to \em preview
+        void copyTags(ExifData& preview) const;
+
+        //! Encode the preview image as a TIFF image into \em mio
+        void encode(MemIo& mio) const;
+
+        /*!
+          @brief Encode the tags in \em preview without the image data and write
+                 them to \em dest, followed by the strips or tiles, which are
+                 copied one by one from the open image \em io.
+         */
+        size_t writeStrips(BasicIo& dest, ExifData& preview, BasicIo& io) const;
+
         //! Name of the group that contains the preview image
         const char *group_;
 
@@ -410,6 +475,13 @@ namespace {
         return prop;
     }
 
+    size_t Loader::writeData(BasicIo& dest) const
+    {
+        const DataBuf buf = getData();
+        if (buf.size_ == 0) return 0;
+        return dest.write(buf.pData_, buf.size_);
+    }
+
     PreviewId Loader::getNumLoaders()
     {
         return (PreviewId)EXV_COUNTOF(loaderList_);
@@ -498,6 +570,26 @@ namespace {
         }
     }
 
+    size_t LoaderNative::writeData(BasicIo& dest) const
+    {
+        if (!valid()) return 0;
+        if (nativePreview_.filter_ != "") return Loader::writeData(dest);
+
+        BasicIo &io = image_.io();
+        if (io.open() != 0) {
+            throw Error(kerDataSourceOpenFailed, io.path(), strError());
+        }
+        IoCloser closer(io);
+        if ((long)io.size() < nativePreview_.position_ + static_cast<long>(nativePreview_.size_)) {
+#ifndef SUPPRESS_WARNINGS
+            EXV_WARNING << "Invalid native preview position or size.\n";
+#endif
+            return 0;
+        }
+        if (io.seek(nativePreview_.position_, BasicIo::beg) != 0) return 0;
+        return dest.copyRange(io, nativePreview_.size_);
+    }
+
     bool LoaderNative::readDimensions()
     {
         if (!valid()) return false;
@@ -583,6 +675,20 @@ namespace {
         return DataBuf(base + offset_, size_);
     }
 
+    size_t LoaderExifJpeg::writeData(BasicIo& dest) const
+    {
+        if (!valid()) return 0;
+        BasicIo &io = image_.io();
+
+        if (io.open() != 0) {
+            throw Error(kerDataSourceOpenFailed, io.path(), strError());
+        }
+        IoCloser closer(io);
+
+        if (io.seek(offset_, BasicIo::beg) != 0) return 0;
+        return dest.copyRange(io, size_);
+    }
+
     bool LoaderExifJpeg::readDimensions()
     {
         if (!valid()) return false;
@@ -760,11 +866,54 @@ namespace {
 
     DataBuf LoaderTiff::getData() const
     {
-        const ExifData &exifData = image_.exifData();
+        MemIo mio;
+        encode(mio);
+        return DataBuf(mio.mmap(), (long) mio.size());
+    }
 
+    size_t LoaderTiff::writeData(BasicIo& dest) const
+    {
         ExifData preview;
+        copyTags(preview);
+
+        Exifdatum& offsets = preview["Exif.Image." + offsetTag_];
+        const Value& sizes = preview["Exif.Image." + sizeTag_].value();
+
+        if (   offsets.sizeDataArea() == 0
+            && static_cast<size_t>(sizes.count()) == offsets.count()
+            && (offsets.typeId() == unsignedShort || offsets.typeId() == unsignedLong)) {
+            // image data are not available via exifData, stream them from image_.io()
+            BasicIo &io = image_.io();
+
+            if (io.open() != 0) {
+                throw Error(kerDataSourceOpenFailed, io.path(), strError());
+            }
+            IoCloser closer(io);
+
+            bool contiguous = true;
+            for (int i = 1; contiguous && i < sizes.count(); i++) {
+                contiguous = Safe::add(static_cast<uint32_t>(offsets.toLong(i - 1)),
+                                       static_cast<uint32_t>(sizes.toLong(i - 1)))
+                          == static_cast<uint32_t>(offsets.toLong(i));
+            }
+            if (!contiguous) {
+                enforce(size_ <= io.size(), kerCorruptedMetadata);
+            }
+            if (   !contiguous
+                || static_cast<uint64_t>(static_cast<uint32_t>(offsets.toLong(0))) + size_ <= io.size()) {
+                return writeStrips(dest, preview, io);
+            }
+        }
+
+        MemIo mio;
+        encode(mio);
+        return dest.write(mio.mmap(), mio.size());
+    }
+
+    void LoaderTiff::copyTags(ExifData& preview) const
+    {
+        const ExifData &exifData = image_.exifData();
 
-        // copy tags
         for (ExifData::const_iterator pos = exifData.begin(); pos != exifData.end(); ++pos) {
             if (pos->groupName() == group_) {
                 /*
@@ -781,6 +930,17 @@ namespace {
             }
         }
 
+        // Fix compression value in the CR2 IFD2 image
+        if (0 == strcmp(group_, "Image2") && image_.mimeType() == "image/x-canon-cr2") {
+            preview["Exif.Image.Compression"] = uint16_t(1);
+        }
+    }
+
+    void LoaderTiff::encode(MemIo& mio) const
+    {
+        ExifData preview;
+        copyTags(preview);
+
         Value &dataValue = const_cast<Value&>(preview["Exif.Image." + offsetTag_].value());
 
         if (dataValue.sizeDataArea() == 0) {
@@ -797,22 +957,26 @@ namespace {
             const Value &sizes = preview["Exif.Image." + sizeTag_].value();
 
             if (sizes.count() == dataValue.count()) {
-                if (sizes.count() == 1) {
-                    // this saves one copying of the buffer
+                // strips which follow each other in the file are copied in one go
+                bool contiguous = true;
+                for (int i = 1; contiguous && i < sizes.count(); i++) {
+                    contiguous = Safe::add(static_cast<uint32_t>(dataValue.toLong(i - 1)),
+                                           static_cast<uint32_t>(sizes.toLong(i - 1)))
+                              == static_cast<uint32_t>(dataValue.toLong(i));
+                }
+                if (contiguous) {
                     uint32_t offset = dataValue.toLong(0);
-                    uint32_t size = sizes.toLong(0);
-                    if (Safe::add(offset, size) <= static_cast<uint32_t>(io.size()))
-                        dataValue.setDataArea(base + offset, size);
+                    if (Safe::add(offset, static_cast<uint32_t>(size_)) <= static_cast<uint32_t>(io.size()))
+                        dataValue.setDataArea(base + offset, size_);
                 }
                 else {
-                    // FIXME: the buffer is probably copied twice, it should be optimized
                     enforce(size_ <= static_cast<uint32_t>(io.size()), kerCorruptedMetadata);
                     DataBuf buf(size_);
                     uint32_t idxBuf = 0;
                     for (int i = 0; i < sizes.count(); i++) {
                         uint32_t offset = dataValue.toLong(i);
                         uint32_t size = sizes.toLong(i);
-                        enforce(Safe::add(idxBuf, size) < size_, kerCorruptedMetadata);
+                        enforce(Safe::add(idxBuf, size) <= size_, kerCorruptedMetadata);
                         if (size!=0 && Safe::add(offset, size) <= static_cast<uint32_t>(io.size()))
                             memcpy(&buf.pData_[idxBuf], base + offset, size);
                         idxBuf += size;
@@ -822,17 +986,60 @@ namespace {
             }
         }
 
-        // Fix compression value in the CR2 IFD2 image
-        if (0 == strcmp(group_, "Image2") && image_.mimeType() == "image/x-canon-cr2") {
-            preview["Exif.Image.Compression"] = uint16_t(1);
+        // write new image
+        IptcData emptyIptc;
+        XmpData  emptyXmp;
+        TiffParser::encode(mio, 0, 0, Exiv2::littleEndian, preview, emptyIptc, emptyXmp);
+    }
+
+    size_t LoaderTiff::writeStrips(BasicIo& dest, ExifData& preview, BasicIo& io) const
+    {
+        Exifdatum& offsetDatum = preview["Exif.Image." + offsetTag_];
+        const Value::UniquePtr offsets = offsetDatum.getValue();
+        const Value::UniquePtr sizes = preview["Exif.Image." + sizeTag_].getValue();
+
+        // let the encoder lay out the image data without copying it
+        if (offsets->typeId() == unsignedShort) {
+            const LayoutValue<uint16_t> layout(*offsets, size_);
+            offsetDatum.setValue(&layout);
+        }
+        else {
+            const LayoutValue<uint32_t> layout(*offsets, size_);
+            offsetDatum.setValue(&layout);
         }
 
-        // write new image
         MemIo mio;
         IptcData emptyIptc;
         XmpData  emptyXmp;
         TiffParser::encode(mio, 0, 0, Exiv2::littleEndian, preview, emptyIptc, emptyXmp);
-        return DataBuf(mio.mmap(), (long) mio.size());
+
+        // the encoder lays out the image data last, writes none of it and
+        // aligns it to a word boundary, see TiffImageEntry::doWriteImage()
+        const size_t align = size_ & 1;
+        enforce(mio.size() >= align, kerImageWriteFailed);
+        const size_t sizeHeader = mio.size() - align;
+        // the offsets of the image data are relative to the TIFF header at
+        // the start of mio, the first strip must start where the tags end
+        const uint32_t firstOffset = firstIfd0Value(mio.mmap(), mio.size(), offsetDatum.tag());
+        enforce(firstOffset == sizeHeader, kerImageWriteFailed);
+        size_t written = dest.write(mio.mmap(), sizeHeader);
+
+        uint32_t idxBuf = 0;
+        for (int i = 0; i < sizes->count(); i++) {
+            uint32_t offset = offsets->toLong(i);
+            uint32_t size = sizes->toLong(i);
+            enforce(Safe::add(idxBuf, size) <= size_, kerCorruptedMetadata);
+            if (   size != 0 && static_cast<uint64_t>(offset) + size <= io.size()
+                && io.seek(offset, BasicIo::beg) == 0) {
+                written += dest.copyRange(io, size);
+            }
+            else {
+                written += writeZeros(dest, size);
+            }
+            idxBuf += size;
+        }
+        if (align) written += writeZeros(dest, align);
+        return written;
     }
 
     LoaderXmpJpeg::LoaderXmpJpeg(PreviewId id, const Image &image, int parIdx)
@@ -1011,6 +1218,43 @@ namespace {
         return DataBuf(reinterpret_cast<const byte*>(dest.data()), static_cast<long>(dest.size()));
     }
 
+    size_t writeZeros(BasicIo& dest, size_t count)
+    {
+        const byte zeros[4096] = {};
+        size_t written = 0;
+        while (written < count) {
+            const size_t n = std::min(count - written, sizeof(zeros));
+            const size_t w = dest.write(zeros, n);
+            written += w;
+            if (w != n) break;
+        }
+        return written;
+    }
+
+    uint32_t firstIfd0Value(const byte* pData, size_t size, uint16_t tag)
+    {
+        if (size < 8) return 0;
+        const size_t ifd = getULong(pData + 4, littleEndian);
+        if (ifd > size - 2) return 0;
+        const uint16_t count = getUShort(pData + ifd, littleEndian);
+        for (uint16_t i = 0; i < count; ++i) {
+            const size_t entry = ifd + 2 + 12 * static_cast<size_t>(i);
+            if (entry > size - 12) return 0;
+            if (getUShort(pData + entry, littleEndian) != tag) continue;
+            const uint16_t type = getUShort(pData + entry + 2, littleEndian);
+            const uint64_t n = getULong(pData + entry + 4, littleEndian);
+            if (n == 0 || (type != unsignedShort && type != unsignedLong)) return 0;
+            const size_t valueSize = type == unsignedShort ? 2 : 4;
+            size_t pos = entry + 8;
+            if (n * valueSize > 4) {
+                pos = getULong(pData + entry + 8, littleEndian);
+                if (pos > size - valueSize) return 0;
+            }
+            return type == unsignedShort ? getUShort(pData + pos, littleEndian) : getULong(pData + pos, littleEndian);
+        }
+        return 0;
+    }
+
     DataBuf makePnm(uint32_t width, uint32_t height, const DataBuf &rgb)
     {
         const size_t expectedSize = static_cast<size_t>(width * height * 3);
@@ -1074,18 +1318,22 @@ namespace Exiv2 {
     size_t PreviewImage::writeFile(const std::string& path) const
     {
         std::string name = path + extension();
-        // Todo: Creating a DataBuf here unnecessarily copies the memory
-        DataBuf buf(pData_, size_);
-        return Exiv2::writeFile(buf, name);
+        FileIo file(name);
+        if (file.open("wb") != 0) {
+            throw Error(kerFileOpenFailed, name, "wb", strError());
+        }
+        return file.write(pData_, size_);
     }
 
 #ifdef EXV_UNICODE_PATH
     size_t PreviewImage::writeFile(const std::wstring& wpath) const
     {
         std::wstring name = wpath + wextension();
-        // Todo: Creating a DataBuf here unnecessarily copies the memory
-        DataBuf buf(pData_, size_);
-        return Exiv2::writeFile(buf, name);
+        FileIo file(name);
+        if (file.open("wb") != 0) {
+            throw WError(kerFileOpenFailed, name, "wb", strError().c_str());
+        }
+        return file.write(pData_, size_);
     }
 
 #endif
@@ -1168,4 +1416,24 @@ namespace Exiv2 {
 
         return PreviewImage(properties, buf);
     }
+
+    size_t PreviewManager::writePreviewImage(const PreviewProperties& properties, BasicIo& dest) const
+    {
+        Loader::UniquePtr loader = Loader::create(properties.id_, image_);
+        if (!loader.get()) return 0;
+        return loader->writeData(dest);
+    }
+
+    size_t PreviewManager::writePreviewImage(const PreviewProperties& properties, const std::string& path) const
+    {
+        Loader::UniquePtr loader = Loader::create(properties.id_, image_);
+        if (!loader.get()) return 0;
+
+        std::string name = path + properties.extension_;
+        FileIo file(name);
+        if (file.open("wb") != 0) {
+            throw Error(kerFileOpenFailed, name, "wb", strError());
+        }
+        return loader->writeData(file);
+    }
 }                                       // namespace Exiv2
@@ -33,6 +33,7 @@
 #include "basicio.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 
 #include "safe_op.hpp"
 #include "enforce.hpp"
@@ -119,6 +120,41 @@ enum {
     kPhotoshopResourceID_MorePrintFlags            = 0x2710  // [Photoshop 6.0 and later] Print flags information. 2 bytes version (=1), 1 byte center crop  marks, 1 byte (=0), 4 bytes bleed width value, 2 bytes bleed width  scale.
 };
 
+// *****************************************************************************
+// local declarations
+namespace {
+    /*!
+      @brief Write a resource block with \em resourceId, an empty name and
+             the \em size bytes of \em data, padded to an even size, to
+             \em out with one call. Return the size of the block.
+     */
+    size_t writeResourceBlock(Exiv2::BasicIo& out, uint16_t resourceId, const Exiv2::byte* data, size_t size)
+    {
+        Exiv2::byte head[12];
+        std::memcpy(head, Exiv2::Photoshop::irbId_[0], 4);
+        Exiv2::us2Data(head + 4, resourceId, Exiv2::bigEndian);
+        Exiv2::us2Data(head + 6, 0, Exiv2::bigEndian);  // NULL resource name
+        Exiv2::ul2Data(head + 8, static_cast<uint32_t>(size), Exiv2::bigEndian);
+        static const Exiv2::byte pad = 0;  // even padding
+        const Exiv2::IoBlock blocks[] = {{head, 12}, {data, size}, {&pad, 1}};
+        const size_t count = size & 1 ? 3 : 2;
+        const size_t resLength = 12 + size + (size & 1);
+        if (out.writev(blocks, count) != resLength || out.error())
+            throw Exiv2::Error(Exiv2::kerImageWriteFailed);
+        return resLength;
+    }
+
+    //! Copy \em size bytes from \em in to \em out, throw if \em in is too short
+    void copyData(Exiv2::BasicIo& out, Exiv2::BasicIo& in, size_t size)
+    {
+        if (out.copyRange(in, size) != size) {
+            if (in.error() || in.eof())
+                throw Exiv2::Error(Exiv2::kerNotAnImage, "Photoshop");
+            throw Exiv2::Error(Exiv2::kerImageWriteFailed);
+        }
+    }
+}
+
 // *****************************************************************************
 // class member definitions
 namespace Exiv2 {
@@ -141,6 +177,7 @@ namespace Exiv2 {
 
     void PsdImage::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Exiv2::PsdImage::readMetadata: Reading Photoshop file " << io_->path() << "\n";
 #endif
@@ -342,6 +379,7 @@ namespace Exiv2 {
 
     void PsdImage::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
         if (io_->open() != 0) {
             throw Error(kerDataSourceOpenFailed, io_->path(), strError());
         }
@@ -376,7 +414,6 @@ namespace Exiv2 {
 
         io_->seek(0, BasicIo::beg);  // rewind
 
-        DataBuf lbuf(4096);
         byte buf[8];
 
         // Get Photoshop header from original file
@@ -384,36 +421,22 @@ namespace Exiv2 {
         if (io_->read(psd_head, 26) != 26)
             throw Error(kerNotAnImage, "Photoshop");
 
-        // Write Photoshop header data out to new PSD file
-        if (outIo.write(psd_head, 26) != 26)
-            throw Error(kerImageWriteFailed);
-
         // Read colorDataLength from original PSD
         if (io_->read(buf, 4) != 4)
             throw Error(kerNotAnImage, "Photoshop");
 
         uint32_t colorDataLength = getULong(buf, bigEndian);
 
-        // Write colorDataLength
+        // Write Photoshop header data and colorDataLength out to new PSD file
         ul2Data(buf, colorDataLength, bigEndian);
-        if (outIo.write(buf, 4) != 4)
+        const IoBlock headBlocks[] = {{psd_head, 26}, {buf, 4}};
+        if (outIo.writev(headBlocks, 2) != 30)
             throw Error(kerImageWriteFailed);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << std::dec << "colorDataLength: " << colorDataLength << "\n";
 #endif
         // Copy colorData
-        size_t readTotal = 0;
-        size_t toRead = 0;
-        while (readTotal < colorDataLength) {
-            toRead = static_cast<size_t>(colorDataLength - readTotal) < lbuf.size_
-                         ? static_cast<size_t>(colorDataLength - readTotal)
-                         : lbuf.size_;
-            if (io_->read(lbuf.pData_, toRead) != toRead)
-                throw Error(kerNotAnImage, "Photoshop");
-            readTotal += toRead;
-            if (outIo.write(lbuf.pData_, toRead) != toRead)
-                throw Error(kerImageWriteFailed);
-        }
+        copyData(outIo, *io_, colorDataLength);
         if (outIo.error())
             throw Error(kerImageWriteFailed);
 
@@ -499,37 +522,19 @@ namespace Exiv2 {
                 std::cerr << std::hex << "copy : resourceId: " << resourceId << "\n";
                 std::cerr << std::dec;
 #endif
-                // Copy resource block to new PSD file
-                ul2Data(buf, resourceType, bigEndian);
-                if (outIo.write(buf, 4) != 4)
-                    throw Error(kerImageWriteFailed);
-                us2Data(buf, resourceId, bigEndian);
-                if (outIo.write(buf, 2) != 2)
-                    throw Error(kerImageWriteFailed);
-                // Write resource name as Pascal string
-                buf[0] = resourceNameLength & 0x00ff;
-                if (outIo.write(buf, 1) != 1)
-                    throw Error(kerImageWriteFailed);
-                buf[0] = resourceNameFirstChar;
-                if (outIo.write(buf, 1) != 1)
-                    throw Error(kerImageWriteFailed);
-                if (outIo.write(resName.pData_, adjResourceNameLen) != static_cast<size_t>(adjResourceNameLen))
-                    throw Error(kerImageWriteFailed);
+                // Copy resource block to new PSD file: type, id, the
+                // resource name as Pascal string and the size
+                byte head[8];
+                ul2Data(head, resourceType, bigEndian);
+                us2Data(head + 4, resourceId, bigEndian);
+                head[6] = resourceNameLength & 0x00ff;
+                head[7] = resourceNameFirstChar;
                 ul2Data(buf, resourceSize, bigEndian);
-                if (outIo.write(buf, 4) != 4)
+                const IoBlock blocks[] = {{head, 8}, {resName.pData_, adjResourceNameLen}, {buf, 4}};
+                if (outIo.writev(blocks, 3) != 12 + static_cast<size_t>(adjResourceNameLen))
                     throw Error(kerImageWriteFailed);
 
-                readTotal = 0;
-                toRead = 0;
-                while (readTotal < pResourceSize) {
-                    toRead = (pResourceSize - readTotal) < lbuf.size_ ? (pResourceSize - readTotal) : lbuf.size_;
-                    if (io_->read(lbuf.pData_, toRead) != toRead) {
-                        throw Error(kerNotAnImage, "Photoshop");
-                    }
-                    readTotal += toRead;
-                    if (outIo.write(lbuf.pData_, toRead) != toRead)
-                        throw Error(kerImageWriteFailed);
-                }
+                copyData(outIo, *io_, pResourceSize);
                 if (outIo.error())
                     throw Error(kerImageWriteFailed);
                 newResLength += pResourceSize + adjResourceNameLen + 12;
@@ -559,11 +564,11 @@ namespace Exiv2 {
         io_->populateFakeData();
 
         // Copy remaining data
-        size_t readSize = 0;
-        while ((readSize = io_->read(lbuf.pData_, lbuf.size_))) {
-            if (outIo.write(lbuf.pData_, readSize) != readSize)
-                throw Error(kerImageWriteFailed);
-        }
+        const size_t size = io_->size();
+        const size_t pos = static_cast<size_t>(io_->tell());
+        const size_t rest = pos < size ? size - pos : 0;
+        if (outIo.copyRange(*io_, rest) != rest)
+            throw Error(kerImageWriteFailed);
         if (outIo.error())
             throw Error(kerImageWriteFailed);
 
@@ -589,29 +594,8 @@ namespace Exiv2 {
                 std::cerr << std::hex << "write: resourceId: " << kPhotoshopResourceID_IPTC_NAA << "\n";
                 std::cerr << std::dec << "Writing IPTC_NAA: size: " << rawIptc.size_ << "\n";
 #endif
-                byte buf[8];
-                if (out.write(reinterpret_cast<const byte*>(Photoshop::irbId_[0]), 4) != 4)
-                    throw Error(kerImageWriteFailed);
-                us2Data(buf, kPhotoshopResourceID_IPTC_NAA, bigEndian);
-                if (out.write(buf, 2) != 2)
-                    throw Error(kerImageWriteFailed);
-                us2Data(buf, 0, bigEndian);                      // nullptr resource name
-                if (out.write(buf, 2) != 2)
-                    throw Error(kerImageWriteFailed);
-                ul2Data(buf, (uint32_t)rawIptc.size_, bigEndian);
-                if (out.write(buf, 4) != 4)
-                    throw Error(kerImageWriteFailed);
                 // Write encoded Iptc data
-                if (out.write(rawIptc.pData_, rawIptc.size_) != rawIptc.size_)
-                    throw Error(kerImageWriteFailed);
-                resLength += rawIptc.size_ + 12;
-                if (rawIptc.size_ & 1)  // even padding
-                {
-                    buf[0] = 0;
-                    if (out.write(buf, 1) != 1)
-                        throw Error(kerImageWriteFailed);
-                    resLength++;
-                }
+                resLength += writeResourceBlock(out, kPhotoshopResourceID_IPTC_NAA, rawIptc.pData_, rawIptc.size_);
             }
         }
         return resLength;
@@ -635,29 +619,8 @@ namespace Exiv2 {
                 std::cerr << std::hex << "write: resourceId: " << kPhotoshopResourceID_ExifInfo << "\n";
                 std::cerr << std::dec << "Writing ExifInfo: size: " << blob.size() << "\n";
 #endif
-                byte buf[8];
-                if (out.write(reinterpret_cast<const byte*>(Photoshop::irbId_[0]), 4) != 4)
-                    throw Error(kerImageWriteFailed);
-                us2Data(buf, kPhotoshopResourceID_ExifInfo, bigEndian);
-                if (out.write(buf, 2) != 2)
-                    throw Error(kerImageWriteFailed);
-                us2Data(buf, 0, bigEndian);  // NULL resource name
-                if (out.write(buf, 2) != 2)
-                    throw Error(kerImageWriteFailed);
-                ul2Data(buf, static_cast<uint32_t>(blob.size()), bigEndian);
-                if (out.write(buf, 4) != 4)
-                    throw Error(kerImageWriteFailed);
                 // Write encoded Exif data
-                if (out.write(&blob[0], blob.size()) != blob.size())
-                    throw Error(kerImageWriteFailed);
-                resLength += blob.size() + 12;
-                if (blob.size() & 1)  // even padding
-                {
-                    buf[0] = 0;
-                    if (out.write(buf, 1) != 1)
-                        throw Error(kerImageWriteFailed);
-                    resLength++;
-                }
+                resLength += writeResourceBlock(out, kPhotoshopResourceID_ExifInfo, &blob[0], blob.size());
             }
         }
         return resLength;
@@ -685,31 +648,9 @@ namespace Exiv2 {
             std::cerr << std::hex << "write: resourceId: " << kPhotoshopResourceID_XMPPacket << "\n";
             std::cerr << std::dec << "Writing XMPPacket: size: " << xmpPacket.size() << "\n";
 #endif
-            byte buf[8];
-            if (out.write(reinterpret_cast<const byte*>(Photoshop::irbId_[0]), 4) != 4)
-                throw Error(kerImageWriteFailed);
-            us2Data(buf, kPhotoshopResourceID_XMPPacket, bigEndian);
-            if (out.write(buf, 2) != 2)
-                throw Error(kerImageWriteFailed);
-            us2Data(buf, 0, bigEndian);  // NULL resource name
-            if (out.write(buf, 2) != 2)
-                throw Error(kerImageWriteFailed);
-            ul2Data(buf, static_cast<uint32_t>(xmpPacket.size()), bigEndian);
-            if (out.write(buf, 4) != 4)
-                throw Error(kerImageWriteFailed);
             // Write XMPPacket
-            if (out.write(reinterpret_cast<const byte*>(xmpPacket.data()), xmpPacket.size()) != xmpPacket.size())
-                throw Error(kerImageWriteFailed);
-            if (out.error())
-                throw Error(kerImageWriteFailed);
-            resLength += xmpPacket.size() + 12;
-            if (xmpPacket.size() & 1)  // even padding
-            {
-                buf[0] = 0;
-                if (out.write(buf, 1) != 1)
-                    throw Error(kerImageWriteFailed);
-                resLength++;
-            }
+            resLength += writeResourceBlock(out, kPhotoshopResourceID_XMPPacket,
+                                            reinterpret_cast<const byte*>(xmpPacket.data()), xmpPacket.size());
         }
         return resLength;
     }
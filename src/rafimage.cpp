@@ -34,6 +34,7 @@
 #include "basicio.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 #include "enforce.hpp"
 #include "safe_op.hpp"
 
@@ -274,6 +275,7 @@ namespace Exiv2 {
 
     void RafImage::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Reading RAF file " << io_->path() << "\n";
 #endif
@@ -386,6 +388,7 @@ namespace Exiv2 {
 
     void RafImage::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
         //! Todo: implement me!
         throw(Error(kerWritingImageFormatUnsupported, "RAF"));
     } // RafImage::writeMetadata
@@ -0,0 +1,778 @@
+// ***************************************************************** -*- C++ -*-
+/*
+ * Copyright (C) 2004-2018 Exiv2 authors
+ * This program is part of the Exiv2 distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, 5th Floor, Boston, MA 02110-1301 USA.
+ */
+/*
+  File:    rdfreader_int.cpp
+ */
+// *****************************************************************************
+// included header files
+#include "config.h"
+
+#include "rdfreader_int.hpp"
+#include "properties.hpp"
+#include "types.hpp"
+#include "value.hpp"
+#include "xmp_exiv2.hpp"
+
+// + standard includes
+#include <cctype>
+#include <cstring>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <expat.h>
+
+// *****************************************************************************
+// local declarations
+namespace {
+
+    using namespace Exiv2;
+
+    //! Separator between namespace URI and local name in the names Expat reports
+    const char nsSeparator = '@';
+
+    // Expanded names of the RDF/XML syntax elements and attributes
+    const char metaXmpmeta[]    = "adobe:ns:meta/@xmpmeta";
+    const char metaXapmeta[]    = "adobe:ns:meta/@xapmeta";
+    const char rdfRDF[]         = "http://www.w3.org/1999/02/22-rdf-syntax-ns#@RDF";
+    const char rdfDescription[] = "http://www.w3.org/1999/02/22-rdf-syntax-ns#@Description";
+    const char rdfAbout[]       = "http://www.w3.org/1999/02/22-rdf-syntax-ns#@about";
+    const char rdfParseType[]   = "http://www.w3.org/1999/02/22-rdf-syntax-ns#@parseType";
+    const char rdfBag[]         = "http://www.w3.org/1999/02/22-rdf-syntax-ns#@Bag";
+    const char rdfSeq[]         = "http://www.w3.org/1999/02/22-rdf-syntax-ns#@Seq";
+    const char rdfAlt[]         = "http://www.w3.org/1999/02/22-rdf-syntax-ns#@Alt";
+    const char rdfLi[]          = "http://www.w3.org/1999/02/22-rdf-syntax-ns#@li";
+    const char xmlLang[]        = "http://www.w3.org/XML/1998/namespace@lang";
+
+    // Namespaces which never hold plain properties
+    const char nsRdf[] = "http://www.w3.org/1999/02/22-rdf-syntax-ns#";
+    const char nsXml[] = "http://www.w3.org/XML/1998/namespace";
+    const char nsIx[]  = "http://ns.adobe.com/iX/1.0/";
+
+    //! Forms of a property, used as a bitmask in the touch-up table
+    enum Form {
+        fmSimple  = 1,
+        fmBag     = 2,
+        fmSeq     = 4,
+        fmAlt     = 8,
+        fmLangAlt = 16,
+        fmStruct  = 32
+    };
+
+    //! Anything but a simple property
+    const int fmComposite = fmBag | fmSeq | fmAlt | fmLangAlt | fmStruct;
+
+    //! Property which the XMP toolkit touches up after parsing unless it has one of the forms_
+    struct TouchUp {
+        const char* ns_;                //!< Namespace URI
+        const char* name_;              //!< Property name
+        int         forms_;             //!< Forms which the toolkit leaves alone
+    };
+
+    //! Top-level properties changed by NormalizeDCArrays() and TouchUpDataModel() in the XMP toolkit
+    const TouchUp touchUps[] = {
+        { "http://purl.org/dc/elements/1.1/",           "contributor", fmComposite },
+        { "http://purl.org/dc/elements/1.1/",           "creator",     fmComposite },
+        { "http://purl.org/dc/elements/1.1/",           "date",        fmComposite },
+        { "http://purl.org/dc/elements/1.1/",           "description", fmLangAlt   },
+        { "http://purl.org/dc/elements/1.1/",           "language",    fmComposite },
+        { "http://purl.org/dc/elements/1.1/",           "publisher",   fmComposite },
+        { "http://purl.org/dc/elements/1.1/",           "relation",    fmComposite },
+        { "http://purl.org/dc/elements/1.1/",           "rights",      fmLangAlt   },
+        { "http://purl.org/dc/elements/1.1/",           "subject",     fmBag       },
+        { "http://purl.org/dc/elements/1.1/",           "title",       fmLangAlt   },
+        { "http://purl.org/dc/elements/1.1/",           "type",        fmComposite },
+        { "http://ns.adobe.com/exif/1.0/",              "GPSTimeStamp", 0          },
+        { "http://ns.adobe.com/exif/1.0/",              "UserComment", fmLangAlt   },
+        { "http://ns.adobe.com/xmp/1.0/DynamicMedia/",  "copyright",   0           },
+        { "http://ns.adobe.com/xap/1.0/rights/",        "UsageTerms",  fmSimple | fmLangAlt }
+    };
+
+    //! Properties of one schema, in document order
+    struct Schema {
+        std::string           ns_;      //!< Namespace URI
+        std::string           prefix_;  //!< Exiv2 prefix of the namespace
+        bool                  touchUp_; //!< True if some properties of the schema are touched up
+        std::vector<Xmpdatum> data_;    //!< Decoded properties
+    };
+
+    //! Simple array item
+    struct Item {
+        std::string lang_;              //!< Normalized xml:lang qualifier
+        bool        hasLang_;           //!< True if the item has an xml:lang qualifier
+        std::string text_;              //!< Item value
+    };
+
+    //! Property element which is being read: a top-level property, a struct field or an array item
+    struct Node {
+        //! What the element turned out to be so far
+        enum Kind {
+            nkSimple,                   //!< Text only, or empty
+            nkAttrStruct,               //!< Struct with the fields as attributes, must be empty
+            nkResource,                 //!< Struct with rdf:parseType="Resource"
+            nkStruct,                   //!< Struct in a nested rdf:Description
+            nkArray                     //!< Bag, Seq or Alt
+        };
+
+        Kind                     kind_;
+        bool                     isItem_;       //!< True for an rdf:li element
+        bool                     hasLang_;      //!< True if the item has an xml:lang qualifier
+        std::string              lang_;         //!< Normalized xml:lang qualifier
+        std::string              path_;         //!< Property path as used in Exiv2 keys
+        std::string              text_;         //!< Character data
+        size_t                   slot_;         //!< Position of the struct or array datum in the schema
+        Form                     arrayForm_;    //!< fmBag, fmSeq or fmAlt
+        size_t                   itemCount_;    //!< Number of array items
+        size_t                   nestedItems_;  //!< Number of array items which are structs or arrays
+        std::vector<Item>        items_;        //!< Simple array items
+        std::vector<std::string> fields_;       //!< Expanded names of the struct fields
+    };
+
+    /*!
+      @brief Expat based reader for the RDF/XML subset described at
+             Internal::decodeRdf(). It follows the element nesting with a
+             stack of levels and gives up as soon as it sees anything else.
+
+      Struct and array properties are added when they start, as an
+      XmpTextValue which only marks the struct or array type, and followed by
+      their fields and items. Arrays of simple items are turned into a single
+      XmpArrayValue or LangAltValue when they end, like XmpParser::decode does.
+     */
+    class RdfReader {
+    public:
+        //! Constructor
+        RdfReader(Internal::RdfPrefixFct prefix, Internal::RdfPropertyCheckFct check);
+        //! Destructor
+        ~RdfReader();
+        //! Decode \em xmpPacket, see Internal::decodeRdf()
+        bool read(XmpData& xmpData, const std::string& xmpPacket);
+
+    private:
+        //! Element nesting levels
+        enum Level {
+            lvDocument, lvMeta, lvRdf, lvDescription, lvProperty, lvStruct, lvArray
+        };
+
+        // Expat callbacks
+        static void XMLCALL startElement(void* userData, const XML_Char* name, const XML_Char** atts);
+        static void XMLCALL endElement(void* userData, const XML_Char* name);
+        static void XMLCALL characterData(void* userData, const XML_Char* s, int len);
+        static void XMLCALL processingInstruction(void* userData, const XML_Char* target, const XML_Char* data);
+        static void XMLCALL startDoctypeDecl(void* userData, const XML_Char* doctypeName,
+                                             const XML_Char* sysid, const XML_Char* pubid, int hasInternalSubset);
+
+        void onStartElement(const char* name, const char** atts);
+        void onEndElement();
+        void onCharacterData(const char* s, int len);
+        //! Handle the attributes of a top-level rdf:Description element
+        void descriptionAttributes(const char** atts);
+        //! Set \em path to the path of top-level property \em name, an expanded name from Expat
+        bool topLevelPath(const char* name, std::string& path);
+        //! Set \em path to the path of field \em name of struct \em parent
+        bool fieldPath(Node& parent, const char* name, std::string& path);
+        //! Start a property element with expanded name \em name, attributes \em atts
+        void startNode(const char* name, const char** atts);
+        //! Finish the current property element
+        void finishNode();
+        //! Finish array \em node and return its form
+        Form finishArray(Node& node);
+        //! Give up if the toolkit touches up the current top-level property with form \em form
+        void checkForm(Form form);
+        //! Add a struct or array datum for \em node and remember its position
+        void addSlot(Node& node);
+        //! Add a simple property
+        void addSimple(const std::string& path, const std::string& text);
+        //! Stop parsing, the packet must be decoded by the XMP toolkit
+        void giveUp();
+
+        // DATA
+        XML_Parser                     parser_;
+        Internal::RdfPrefixFct         prefix_;
+        Internal::RdfPropertyCheckFct  check_;
+        bool                           failed_;
+        bool                           seenRdf_;
+        std::vector<Level>             levels_;
+        std::string                    about_;      //!< Top level rdf:about value
+        std::vector<Schema>            schemas_;    //!< Schemas in order of appearance
+        std::set<std::string>          names_;      //!< Expanded names of all top-level properties
+        std::vector<std::pair<std::string, std::string> > prefixes_; //!< Toolkit prefixes of field namespaces
+        size_t                         schema_;     //!< Schema of the current top-level property
+        std::string                    name_;       //!< Name of the current top-level property
+        std::vector<Node>              nodes_;      //!< Open property elements, reused
+        size_t                         depth_;      //!< Number of open property elements
+    };
+
+    //! Return true if \em s contains only XML whitespace
+    bool isWhitespace(const char* s, size_t len)
+    {
+        for (size_t i = 0; i < len; ++i) {
+            if (s[i] != ' ' && s[i] != '\t' && s[i] != '\n' && s[i] != '\r') return false;
+        }
+        return true;
+    }
+
+    /*!
+      @brief Return true if the XMP toolkit feeds \em xmpPacket to Expat
+             unchanged, i.e., it is UTF-8 without ASCII controls, bytes
+             which are not UTF-8 and numeric escapes for characters other
+             than tab, LF and CR (see ProcessUTF8Portion() in the toolkit).
+     */
+    bool isPlainUtf8(const std::string& xmpPacket)
+    {
+        const unsigned char* p   = reinterpret_cast<const unsigned char*>(xmpPacket.data());
+        const unsigned char* end = p + xmpPacket.size();
+        while (p < end) {
+            const unsigned char c = *p;
+            if (0x20 <= c && c < 0x7f && c != '&') {
+                ++p;
+            }
+            else if (c >= 0x80) {
+                if ((c & 0xc0) != 0xc0) return false;
+                size_t len = 2;
+                for (unsigned char lead = static_cast<unsigned char>(c << 2); lead & 0x80; lead <<= 1) ++len;
+                if (static_cast<size_t>(end - p) < len) return false;
+                for (size_t i = 1; i < len; ++i) {
+                    if ((p[i] & 0xc0) != 0x80) return false;
+                }
+                p += len;
+            }
+            else if (c == '\t' || c == '\n' || c == '\r') {
+                ++p;
+            }
+            else if (c == '&') {
+                // Hex escape with one or two digits, e.g. "&#x0A;"
+                if (end - p >= 5 && std::strncmp(reinterpret_cast<const char*>(p), "&#x", 3) == 0) {
+                    const unsigned char* q = p + 3;
+                    unsigned value = 0;
+                    for (int i = 0; i < 2 && q < end && std::isxdigit(*q); ++i, ++q) {
+                        value = value * 16 + (std::isdigit(*q) ? *q - '0' : (*q | 0x20) - 'a' + 10);
+                    }
+                    if (q > p + 3 && q < end && *q == ';' && value != '\t' && value != '\n' && value != '\r') {
+                        return false;
+                    }
+                }
+                ++p;
+            }
+            else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //! Return true if \em about looks like a UUID, which the XMP toolkit moves to xmpMM:InstanceID
+    bool isUuid(const std::string& about)
+    {
+        if (about.compare(0, 5, "uuid:") == 0) return true;
+        if (about.size() != 36) return false;
+        for (size_t i = 0; i < 36; ++i) {
+            const char c = about[i];
+            if (c == '-') {
+                if (i != 8 && i != 13 && i != 18 && i != 23) return false;
+            }
+            else if (!(('0' <= c && c <= '9') || ('a' <= c && c <= 'z'))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    RdfReader::RdfReader(Internal::RdfPrefixFct prefix, Internal::RdfPropertyCheckFct check)
+        : parser_(XML_ParserCreateNS(0, nsSeparator)), prefix_(prefix), check_(check), failed_(false),
+          seenRdf_(false), schema_(0), depth_(0)
+    {
+        levels_.reserve(16);
+        levels_.push_back(lvDocument);
+        if (parser_ == 0) {
+            failed_ = true;
+            return;
+        }
+        XML_SetUserData(parser_, this);
+        XML_SetElementHandler(parser_, startElement, endElement);
+        XML_SetCharacterDataHandler(parser_, characterData);
+        XML_SetProcessingInstructionHandler(parser_, processingInstruction);
+        XML_SetStartDoctypeDeclHandler(parser_, startDoctypeDecl);
+    }
+
+    RdfReader::~RdfReader()
+    {
+        if (parser_ != 0) XML_ParserFree(parser_);
+    }
+
+    bool RdfReader::read(XmpData& xmpData, const std::string& xmpPacket)
+    {
+        if (failed_ || !isPlainUtf8(xmpPacket)) return false;
+
+        const XML_Status status = XML_Parse(parser_, xmpPacket.data(), static_cast<int>(xmpPacket.size()), 1);
+        if (failed_ || status != XML_STATUS_OK || isUuid(about_)) return false;
+
+        for (auto&& schema : schemas_) {
+            for (auto&& xmpdatum : schema.data_) {
+                xmpData.add(xmpdatum);
+            }
+        }
+        return true;
+    }
+
+    void XMLCALL RdfReader::startElement(void* userData, const XML_Char* name, const XML_Char** atts)
+    {
+        RdfReader* reader = static_cast<RdfReader*>(userData);
+        // Exceptions must not propagate through Expat
+        try {
+            reader->onStartElement(name, atts);
+        }
+        catch (...) {
+            reader->giveUp();
+        }
+    }
+
+    void XMLCALL RdfReader::endElement(void* userData, const XML_Char* /*name*/)
+    {
+        RdfReader* reader = static_cast<RdfReader*>(userData);
+        try {
+            reader->onEndElement();
+        }
+        catch (...) {
+            reader->giveUp();
+        }
+    }
+
+    void XMLCALL RdfReader::characterData(void* userData, const XML_Char* s, int len)
+    {
+        RdfReader* reader = static_cast<RdfReader*>(userData);
+        try {
+            reader->onCharacterData(s, len);
+        }
+        catch (...) {
+            reader->giveUp();
+        }
+    }
+
+    void XMLCALL RdfReader::processingInstruction(void* userData, const XML_Char* /*target*/,
+                                                  const XML_Char* /*data*/)
+    {
+        // The toolkit keeps xpacket instructions as nodes, they are only harmless outside of the root
+        RdfReader* reader = static_cast<RdfReader*>(userData);
+        if (reader->levels_.back() != lvDocument) reader->giveUp();
+    }
+
+    void XMLCALL RdfReader::startDoctypeDecl(void* userData, const XML_Char* /*doctypeName*/,
+                                             const XML_Char* /*sysid*/, const XML_Char* /*pubid*/,
+                                             int /*hasInternalSubset*/)
+    {
+        static_cast<RdfReader*>(userData)->giveUp();
+    }
+
+    void RdfReader::onStartElement(const char* name, const char** atts)
+    {
+        switch (levels_.back()) {
+        case lvDocument:
+            if (std::strcmp(name, metaXmpmeta) == 0 || std::strcmp(name, metaXapmeta) == 0) {
+                levels_.push_back(lvMeta);
+                return;
+            }
+            // fallthrough
+        case lvMeta:
+            if (std::strcmp(name, rdfRDF) != 0 || atts[0] != 0 || seenRdf_) break;
+            seenRdf_ = true;
+            levels_.push_back(lvRdf);
+            return;
+        case lvRdf:
+            if (std::strcmp(name, rdfDescription) != 0) break;
+            descriptionAttributes(atts);
+            levels_.push_back(lvDescription);
+            return;
+        case lvDescription:
+        case lvStruct:
+            startNode(name, atts);
+            return;
+        case lvProperty: {
+            Node& node = nodes_[depth_ - 1];
+            if (node.kind_ == Node::nkResource) {
+                startNode(name, atts);
+                return;
+            }
+            // A struct or array element may only be surrounded by whitespace
+            if (node.kind_ != Node::nkSimple || !isWhitespace(node.text_.data(), node.text_.size())) break;
+            if (std::strcmp(name, rdfDescription) == 0) {
+                node.kind_ = Node::nkStruct;
+                addSlot(node);
+                for (const char** att = atts; *att != 0 && !failed_; att += 2) {
+                    // The toolkit ignores rdf:about of nested descriptions
+                    if (std::strcmp(att[0], rdfAbout) == 0) continue;
+                    std::string path;
+                    if (fieldPath(node, att[0], path)) addSimple(path, att[1]);
+                }
+                levels_.push_back(lvStruct);
+                return;
+            }
+            if (atts[0] != 0) break;
+            if      (std::strcmp(name, rdfBag) == 0) node.arrayForm_ = fmBag;
+            else if (std::strcmp(name, rdfSeq) == 0) node.arrayForm_ = fmSeq;
+            else if (std::strcmp(name, rdfAlt) == 0) node.arrayForm_ = fmAlt;
+            else break;
+            node.kind_ = Node::nkArray;
+            addSlot(node);
+            levels_.push_back(lvArray);
+            return;
+        }
+        case lvArray:
+            if (std::strcmp(name, rdfLi) != 0) break;
+            startNode(name, atts);
+            return;
+        }
+        giveUp();
+    }
+
+    void RdfReader::onEndElement()
+    {
+        const Level level = levels_.back();
+        levels_.pop_back();
+        if (level == lvProperty) finishNode();
+    }
+
+    void RdfReader::onCharacterData(const char* s, int len)
+    {
+        switch (levels_.back()) {
+        case lvDocument:
+            break;
+        case lvProperty: {
+            Node& node = nodes_[depth_ - 1];
+            if (node.kind_ == Node::nkSimple) {
+                node.text_.append(s, len);
+                break;
+            }
+            // The fields of an attribute struct require an empty element
+            if (node.kind_ == Node::nkAttrStruct) giveUp();
+        }
+            // fallthrough
+        default:
+            if (!isWhitespace(s, len)) giveUp();
+            break;
+        }
+    }
+
+    void RdfReader::descriptionAttributes(const char** atts)
+    {
+        for (const char** att = atts; *att != 0 && !failed_; att += 2) {
+            if (std::strcmp(att[0], rdfAbout) == 0) {
+                const std::string about(att[1]);
+                if (about_.empty()) {
+                    about_ = about;
+                }
+                else if (!about.empty() && about != about_) {
+                    giveUp();
+                }
+                continue;
+            }
+            std::string path;
+            if (!topLevelPath(att[0], path)) return;
+            addSimple(path, att[1]);
+            checkForm(fmSimple);
+        }
+    }
+
+    bool RdfReader::topLevelPath(const char* name, std::string& path)
+    {
+        const char* sep = std::strrchr(name, nsSeparator);
+        if (sep == 0 || !names_.insert(name).second) {
+            giveUp();
+            return false;
+        }
+        const std::string ns(name, sep);
+        name_.assign(sep + 1);
+
+        if (schemas_.empty() || schemas_[schema_].ns_ != ns) {
+            schema_ = 0;
+            while (schema_ < schemas_.size() && schemas_[schema_].ns_ != ns) ++schema_;
+        }
+        if (schema_ == schemas_.size()) {
+            std::string prefix;
+            if (ns == nsRdf || ns == nsXml || ns == nsIx || !prefix_(ns, prefix)) {
+                giveUp();
+                return false;
+            }
+            Schema schema;
+            schema.ns_ = ns;
+            schema.prefix_ = XmpProperties::prefix(ns);
+            if (schema.prefix_.empty()) {
+                // Unknown namespaces are registered with Exiv2 by XmpParser::decode()
+                giveUp();
+                return false;
+            }
+            schema.touchUp_ = false;
+            for (auto&& touchUp : touchUps) {
+                if (ns == touchUp.ns_) schema.touchUp_ = true;
+            }
+            schemas_.push_back(schema);
+        }
+        if (!check_(ns, name_)) {
+            giveUp();
+            return false;
+        }
+        path = name_;
+        return true;
+    }
+
+    bool RdfReader::fieldPath(Node& parent, const char* name, std::string& path)
+    {
+        const char* sep = std::strrchr(name, nsSeparator);
+        if (sep == 0) {
+            giveUp();
+            return false;
+        }
+        for (auto&& field : parent.fields_) {
+            if (field == name) {
+                giveUp();
+                return false;
+            }
+        }
+        parent.fields_.push_back(name);
+
+        const std::string ns(name, sep);
+        if (ns == nsRdf || ns == nsXml) {
+            giveUp();
+            return false;
+        }
+        // Field paths use the prefix registered with the toolkit, like the keys from XmpParser::decode()
+        size_t i = 0;
+        while (i < prefixes_.size() && prefixes_[i].first != ns) ++i;
+        if (i == prefixes_.size()) {
+            std::string prefix;
+            if (!prefix_(ns, prefix)) {
+                giveUp();
+                return false;
+            }
+            prefixes_.push_back(std::make_pair(ns, prefix));
+        }
+        path = parent.path_ + '/' + prefixes_[i].second + ':' + (sep + 1);
+        return true;
+    }
+
+    void RdfReader::startNode(const char* name, const char** atts)
+    {
+        std::string path;
+        bool isItem = false;
+        if (depth_ == 0) {
+            if (!topLevelPath(name, path)) return;
+        }
+        else if (nodes_[depth_ - 1].kind_ == Node::nkArray) {
+            Node& parent = nodes_[depth_ - 1];
+            path = parent.path_ + '[' + toString(++parent.itemCount_) + ']';
+            isItem = true;
+        }
+        else if (!fieldPath(nodes_[depth_ - 1], name, path)) {
+            return;
+        }
+
+        if (nodes_.size() == depth_) nodes_.push_back(Node());
+        Node& node = nodes_[depth_++];
+        node.kind_ = Node::nkSimple;
+        node.isItem_ = isItem;
+        node.hasLang_ = false;
+        node.path_.swap(path);
+        node.text_.clear();
+        node.itemCount_ = 0;
+        node.nestedItems_ = 0;
+        node.items_.clear();
+        node.fields_.clear();
+        levels_.push_back(lvProperty);
+
+        bool resource = false;
+        size_t fields = 0;
+        for (const char** att = atts; *att != 0; att += 2) {
+            if (std::strcmp(att[0], xmlLang) == 0 && isItem && !node.hasLang_) {
+                node.hasLang_ = true;
+                node.lang_ = att[1];
+                Internal::normalizeLang(node.lang_);
+            }
+            else if (std::strcmp(att[0], rdfParseType) == 0 && std::strcmp(att[1], "Resource") == 0 && !resource) {
+                resource = true;
+            }
+            else {
+                ++fields;
+            }
+        }
+        if (fields > 0 && (resource || node.hasLang_)) {
+            giveUp();
+            return;
+        }
+        if (resource) {
+            node.kind_ = Node::nkResource;
+            addSlot(node);
+        }
+        else if (fields > 0) {
+            node.kind_ = Node::nkAttrStruct;
+            addSlot(node);
+            for (const char** att = atts; *att != 0 && !failed_; att += 2) {
+                std::string path;
+                if (fieldPath(node, att[0], path)) addSimple(path, att[1]);
+            }
+        }
+    }
+
+    void RdfReader::finishNode()
+    {
+        Node& node = nodes_[depth_ - 1];
+        Node* parent = depth_ > 1 ? &nodes_[depth_ - 2] : 0;
+        Form form = fmStruct;
+        switch (node.kind_) {
+        case Node::nkSimple:
+            if (node.isItem_) {
+                // Simple items are only added when the array ends
+                parent->items_.push_back(Item());
+                Item& item = parent->items_.back();
+                item.hasLang_ = node.hasLang_;
+                item.lang_.swap(node.lang_);
+                item.text_.swap(node.text_);
+                --depth_;
+                return;
+            }
+            addSimple(node.path_, node.text_);
+            form = fmSimple;
+            break;
+        case Node::nkArray:
+            form = finishArray(node);
+            break;
+        default:
+            break;
+        }
+        // Qualified struct or array item
+        if (node.hasLang_) giveUp();
+        if (node.isItem_) ++parent->nestedItems_;
+        if (parent == 0) checkForm(form);
+        --depth_;
+    }
+
+    Form RdfReader::finishArray(Node& node)
+    {
+        if (node.nestedItems_ > 0) {
+            // Arrays of structs and arrays keep the datum which marks the array type
+            if (!node.items_.empty()) giveUp();
+            return node.arrayForm_;
+        }
+        Xmpdatum& xmpdatum = schemas_[schema_].data_[node.slot_];
+        size_t langs = 0;
+        for (auto&& item : node.items_) {
+            if (item.hasLang_) ++langs;
+        }
+        if (node.arrayForm_ == fmAlt && !node.items_.empty() && langs == node.items_.size()) {
+            LangAltValue value;
+            for (auto&& item : node.items_) {
+                if (item.lang_.empty() || !value.value_.insert(std::make_pair(item.lang_, item.text_)).second) {
+                    // The toolkit reorders duplicate languages
+                    giveUp();
+                    return fmLangAlt;
+                }
+            }
+            xmpdatum.setValue(&value);
+            return fmLangAlt;
+        }
+        if (langs > 0) {
+            // Qualified array items
+            giveUp();
+            return node.arrayForm_;
+        }
+        XmpArrayValue value(node.arrayForm_ == fmBag ? xmpBag : node.arrayForm_ == fmSeq ? xmpSeq : xmpAlt);
+        for (auto&& item : node.items_) {
+            value.read(item.text_);
+        }
+        xmpdatum.setValue(&value);
+        return node.arrayForm_;
+    }
+
+    void RdfReader::checkForm(Form form)
+    {
+        const Schema& schema = schemas_[schema_];
+        if (!schema.touchUp_) return;
+        for (auto&& touchUp : touchUps) {
+            if (name_ == touchUp.name_ && schema.ns_ == touchUp.ns_ && (touchUp.forms_ & form) == 0) {
+                giveUp();
+                return;
+            }
+        }
+    }
+
+    void RdfReader::addSlot(Node& node)
+    {
+        XmpTextValue value;
+        if (node.kind_ == Node::nkArray) {
+            value.setXmpArrayType(node.arrayForm_ == fmBag ? XmpValue::xaBag
+                                  : node.arrayForm_ == fmSeq ? XmpValue::xaSeq : XmpValue::xaAlt);
+        }
+        else {
+            value.setXmpStruct();
+        }
+        Schema& schema = schemas_[schema_];
+        node.slot_ = schema.data_.size();
+        schema.data_.push_back(Xmpdatum(XmpKey(schema.prefix_, node.path_), &value));
+    }
+
+    void RdfReader::addSimple(const std::string& path, const std::string& text)
+    {
+        XmpTextValue value;
+        value.read(text);
+        Schema& schema = schemas_[schema_];
+        schema.data_.push_back(Xmpdatum(XmpKey(schema.prefix_, path), &value));
+    }
+
+    void RdfReader::giveUp()
+    {
+        if (failed_) return;
+        failed_ = true;
+        XML_StopParser(parser_, XML_FALSE);
+    }
+
+}
+
+// *****************************************************************************
+// class member definitions
+namespace Exiv2 {
+    namespace Internal {
+
+    bool decodeRdf(XmpData& xmpData, const std::string& xmpPacket, RdfPrefixFct prefix, RdfPropertyCheckFct check)
+    {
+        RdfReader reader(prefix, check);
+        return reader.read(xmpData, xmpPacket);
+    }
+
+    void normalizeLang(std::string& lang)
+    {
+        // Primary subtag lowercase, 2 letter secondary subtag uppercase, all others lowercase
+        size_t tag = 0;
+        size_t start = 0;
+        for (size_t i = 0; i <= lang.size(); ++i) {
+            if (i == lang.size() || lang[i] == '-') {
+                if (tag == 1 && i - start == 2) {
+                    for (size_t j = start; j < i; ++j) {
+                        if ('a' <= lang[j] && lang[j] <= 'z') lang[j] -= 0x20;
+                    }
+                }
+                ++tag;
+                start = i + 1;
+            }
+            else if ('A' <= lang[i] && lang[i] <= 'Z') {
+                lang[i] += 0x20;
+            }
+        }
+    }
+
+}}                                      // namespace Internal, Exiv2
@@ -0,0 +1,97 @@
+// ***************************************************************** -*- C++ -*-
+/*
+ * Copyright (C) 2004-2018 Exiv2 authors
+ * This program is part of the Exiv2 distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, 5th Floor, Boston, MA 02110-1301 USA.
+ */
+/*!
+  @file    rdfreader_int.hpp
+  @brief   Streaming reader for the common RDF/XML forms of XMP packets
+ */
+#pragma once
+
+// *****************************************************************************
+// included header files
+#include "exiv2lib_export.h"
+
+// + standard includes
+#include <string>
+
+// *****************************************************************************
+// namespace extensions
+namespace Exiv2 {
+    class XmpData;
+
+    namespace Internal {
+
+// *****************************************************************************
+// type definitions
+
+    /*!
+      @brief Type for a function which sets \em prefix to the prefix the XMP
+             toolkit has registered for namespace \em ns, without the colon.
+             Returns false if the namespace is not registered.
+     */
+    typedef bool (*RdfPrefixFct)(const std::string& ns, std::string& prefix);
+
+    /*!
+      @brief Type for a function which decides if a top-level property can
+             be decoded without the XMP toolkit, i.e., it is not an alias.
+     */
+    typedef bool (*RdfPropertyCheckFct)(const std::string& ns, const std::string& name);
+
+// *****************************************************************************
+// free functions
+
+    /*!
+      @brief Decode an XMP packet with a streaming reader which creates the
+             Xmpdatum entries directly from the Expat callbacks, without
+             building the XML and XMP trees of the XMP toolkit.
+
+      Only the forms commonly written by applications are handled:
+      rdf:Description elements with property attributes, simple property
+      elements, structs (rdf:parseType="Resource", a nested rdf:Description
+      or field attributes) and Bag, Seq and Alt arrays. Alt arrays with an
+      xml:lang qualifier on every item are decoded to a LangAltValue. The
+      properties are added grouped by schema, with the same keys and values
+      and in the same order as XmpParser::decode adds them.
+
+      The reader gives up on anything else: qualifiers, rdf:resource,
+      rdf:value and other rdf:parseType values, unknown namespaces,
+      aliases, properties the toolkit touches up after parsing, DOCTYPE
+      declarations and input which the toolkit repairs before parsing
+      (ASCII controls, Latin-1 characters).
+
+      @param xmpData   XMP properties container, the properties are added to it.
+      @param xmpPacket The XMP packet to decode.
+      @param prefix    Function which returns the toolkit prefix of a namespace.
+      @param check     Function which accepts or rejects each top-level property.
+      @return true if the packet was decoded; false if it must be decoded
+              with the XMP toolkit, in which case \em xmpData is not modified.
+     */
+    bool decodeRdf(XmpData& xmpData, const std::string& xmpPacket, RdfPrefixFct prefix, RdfPropertyCheckFct check);
+
+    //! Normalize an xml:lang value like NormalizeLangValue() in the XMP toolkit
+    void normalizeLang(std::string& lang);
+
+    /*!
+      @brief Decode an XMP packet with the XMP toolkit only, bypassing
+             decodeRdf(). Returns the same codes as XmpParser::decode().
+             Exported to verify the streaming reader against the toolkit.
+     */
+    EXIV2API int decodeXmpToolkit(XmpData& xmpData, const std::string& xmpPacket);
+
+}}                                      // namespace Internal, Exiv2
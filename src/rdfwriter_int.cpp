@@ -0,0 +1,881 @@
+// ***************************************************************** -*- C++ -*-
+/*
+ * Copyright (C) 2004-2018 Exiv2 authors
+ * This program is part of the Exiv2 distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, 5th Floor, Boston, MA 02110-1301 USA.
+ */
+/*
+  File:    rdfwriter_int.cpp
+ */
+// *****************************************************************************
+// included header files
+#include "config.h"
+
+#include "rdfwriter_int.hpp"
+#include "properties.hpp"
+#include "value.hpp"
+#include "xmp_exiv2.hpp"
+
+// + standard includes
+#include <string>
+#include <utility>
+#include <vector>
+
+// *****************************************************************************
+// local declarations
+namespace {
+
+    using namespace Exiv2;
+
+    //! Node options, these are the option bits of the XMP toolkit
+    enum Option {
+        opHasQualifiers = 0x00000010,
+        opHasLang       = 0x00000040,
+        opStruct        = 0x00000100,
+        opArray         = 0x00000200,
+        opOrdered       = 0x00000400,
+        opAlternate     = 0x00000800,
+        opAltText       = 0x00001000,
+        opSchema        = 0x80000000
+    };
+
+    //! Struct and array form options, kXMP_PropCompositeMask in the XMP toolkit
+    const uint32_t opComposite = opStruct | opArray | opOrdered | opAlternate | opAltText;
+
+    //! Namespace and property of the thumbnails checked for XmpParser::includeThumbnailPad
+    const char xmpNs[] = "http://ns.adobe.com/xap/1.0/";
+    const char xmpThumbnails[] = "Thumbnails";
+
+    //! No node
+    const size_t npos = static_cast<size_t>(-1);
+
+    const char packetHeader[]  = "<?xpacket begin=\"\xEF\xBB\xBF\" id=\"W5M0MpCehiHzreSzNTczkc9d\"?>";
+    const char packetTrailer[] = "<?xpacket end=\"w\"?>";
+
+    //! Property node, like XMP_Node in the XMP toolkit
+    struct Node {
+        //! Constructor
+        Node(const std::string& name, uint32_t options) : name_(name), options_(options) {}
+
+        std::string         name_;      //!< Qualified name, "[]" for array items, namespace URI for schemas
+        std::string         value_;     //!< Property value, toolkit prefix with colon for schemas
+        uint32_t            options_;   //!< Node options
+        std::string         lang_;      //!< Value of the xml:lang qualifier if options_ has opHasLang
+        std::vector<size_t> children_;  //!< Positions of the properties, fields or items in the node pool
+    };
+
+    //! Step of a property path after the top-level property
+    struct Step {
+        std::string name_;              //!< Qualified struct field name, empty for an array index
+        size_t      index_;             //!< One-based array index
+    };
+
+    /*!
+      @brief Writer for Internal::encodeRdf(). It builds a light copy of the
+             property tree SXMPMeta would end up with, following the same
+             rules for creating and changing nodes, and serializes it the way
+             SXMPMeta::SerializeToBuffer() does. Anything the toolkit would
+             reject or treat specially makes it give up.
+     */
+    class RdfWriter {
+    public:
+        //! Constructor
+        explicit RdfWriter(const Internal::RdfRegistry& registry);
+        //! Add all properties like XmpParser::encode adds them to an SXMPMeta object
+        bool build(const XmpData& xmpData);
+        //! Serialize the properties to \em xmpPacket with toolkit format options \em options
+        bool write(std::string& xmpPacket, uint32_t options, uint32_t padding);
+
+    private:
+        //! Set the top-level name and the steps from an Exiv2 property path, like ExpandXPath()
+        bool parsePath(const std::string& path);
+        //! Find or create the node of the parsed path, like FindNode()
+        size_t findNode(const std::string& ns, bool create, uint32_t leafOptions);
+        //! Add a child node to \em parent
+        size_t addNode(size_t parent, const std::string& name, uint32_t options);
+        //! Like SXMPMeta::SetProperty(), sets node_ to the property
+        bool setProperty(const std::string& ns, const std::string& path, const std::string* value, uint32_t options);
+        //! Like SetNode() in the XMP toolkit
+        bool setNode(size_t node, const std::string* value, uint32_t options);
+        //! Add a language alternative like SXMPMeta::AppendArrayItem() and SXMPMeta::SetQualifier()
+        bool addLangAlt(const std::string& ns, const std::string& path, const LangAltValue& value);
+        //! Return the toolkit prefix of \em ns, with the colon, or 0
+        const std::string* schemaPrefix(const std::string& ns);
+        //! Return the namespace of toolkit prefix \em prefix, without the colon, or 0
+        const std::string* prefixNamespace(const std::string& prefix);
+        //! Return the position of the child of \em parent called \em name, or npos
+        size_t findChild(size_t parent, const std::string& name) const;
+        //! True if xmp:Thumbnails exists
+        bool hasThumbnails();
+
+        // Serialization, like the functions in XMPMeta-Serialize.cpp
+        void writeIndent(int level);
+        void writeValue(const std::string& value, bool forAttribute);
+        void writeArrayTag(uint32_t form, int indent, size_t size, bool isStartTag);
+        void declareNamespace(const std::string& prefix, const std::string& ns, std::string& usedNs, int indent);
+        void declareElemNamespace(const std::string& name, std::string& usedNs, int indent);
+        void declareUsedNamespaces(const Node& node, std::string& usedNs, int indent);
+        void writePrettyProperty(const Node& node, int indent);
+        void writePrettySchema(const Node& schema);
+        bool writeCompactAttrProps(const Node& parent, int indent);
+        void writeCompactElemProps(const Node& parent, int indent);
+        void writeCompactSchemas();
+
+        //! Return true if \em node can be written as an attribute in the compact format
+        static bool canBeAttrProp(const Node& node);
+
+        // DATA
+        const Internal::RdfRegistry& registry_;
+        bool                         failed_;
+        std::vector<Node>            nodes_;    //!< Node pool, the tree root is the first node
+        size_t                       node_;     //!< Node of the last setProperty()
+        std::string                  root_;     //!< Parsed top-level property name, without prefix
+        std::vector<Step>            steps_;    //!< Parsed remaining steps
+        std::vector<std::pair<std::string, std::string> > prefixes_;   //!< Toolkit prefixes of schemas
+        std::vector<std::pair<std::string, std::string> > namespaces_; //!< Namespaces of field prefixes
+        std::string                  out_;      //!< Serialized packet
+        const char*                  newline_;
+        const char*                  indent_;
+    };
+
+    //! Return true if \em name is an XML name with ASCII characters only
+    bool isAsciiXmlName(const std::string& name, size_t begin, size_t end)
+    {
+        if (begin >= end) return false;
+        for (size_t i = begin; i < end; ++i) {
+            const char c = name[i];
+            if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '_') continue;
+            if (i > begin && (('0' <= c && c <= '9') || c == '-' || c == '.')) continue;
+            return false;
+        }
+        return true;
+    }
+
+    //! Option bits of Xmpdatum \em value, see xmpArrayOptionBits() in xmp.cpp
+    uint32_t xmpOptions(const XmpValue& value)
+    {
+        uint32_t options = 0;
+        switch (value.xmpArrayType()) {
+            case XmpValue::xaAlt: options = opArray | opOrdered | opAlternate; break;
+            case XmpValue::xaSeq: options = opArray | opOrdered; break;
+            case XmpValue::xaBag: options = opArray; break;
+            case XmpValue::xaNone: break;
+        }
+        if (value.xmpStruct() == XmpValue::xsStruct) options |= opStruct;
+        return options;
+    }
+
+    //! Normalize and check set options like VerifySetOptions() in the XMP toolkit
+    bool verifySetOptions(uint32_t& options, bool hasValue)
+    {
+        if (options & opAltText)   options |= opAlternate;
+        if (options & opAlternate) options |= opOrdered;
+        if (options & opOrdered)   options |= opArray;
+        if ((options & opStruct) && (options & opArray)) return false;
+        return !(hasValue && (options & opComposite));
+    }
+
+    /*!
+      @brief Set \em target to \em value like SetNodeValue() in the XMP toolkit:
+             the value ends at the first NUL character and ASCII controls
+             other than tab, LF and CR become spaces. Returns false for
+             invalid UTF-8, which the toolkit rejects.
+     */
+    bool setNodeValue(std::string& target, const std::string& value)
+    {
+        target.assign(value, 0, value.find('\0'));
+        for (size_t i = 0; i < target.size(); ++i) {
+            const unsigned char c = static_cast<unsigned char>(target[i]);
+            if (c < 0x80) {
+                if ((c < 0x20 && c != 0x09 && c != 0x0A && c != 0x0D) || c == 0x7F) target[i] = ' ';
+                continue;
+            }
+            size_t count = 0;
+            for (unsigned char t = c; t & 0x80; t = static_cast<unsigned char>(t << 1)) ++count;
+            if (count < 2 || count > 4 || target.size() - i < count) return false;
+            uint32_t cp = c & ((1 << (7 - count)) - 1);
+            for (size_t j = 1; j < count; ++j) {
+                const unsigned char u = static_cast<unsigned char>(target[i + j]);
+                if ((u & 0xC0) != 0x80) return false;
+                cp = (cp << 6) | (u & 0x3F);
+            }
+            if ((0xD800 <= cp && cp <= 0xDFFF) || cp > 0x10FFFF) return false;
+            i += count - 1;
+        }
+        return true;
+    }
+
+    RdfWriter::RdfWriter(const Internal::RdfRegistry& registry)
+        : registry_(registry), failed_(false), node_(npos), newline_("\n"), indent_(" ")
+    {
+        nodes_.push_back(Node("", 0));
+    }
+
+    bool RdfWriter::build(const XmpData& xmpData)
+    {
+        std::string prefix;
+        std::string ns;
+        for (XmpData::const_iterator i = xmpData.begin(); i != xmpData.end(); ++i) {
+            const std::string group = i->groupName();
+            if (group != prefix) {
+                ns = XmpProperties::ns(group);
+                prefix = group;
+            }
+            if (i->typeId() == langAlt) {
+                const LangAltValue* la = dynamic_cast<const LangAltValue*>(&i->value());
+                if (la == 0 || !addLangAlt(ns, i->tagName(), *la)) return false;
+                continue;
+            }
+            const XmpValue* val = dynamic_cast<const XmpValue*>(&i->value());
+            if (val == 0) return false;
+            const uint32_t options = xmpOptions(*val);
+            if (i->typeId() == xmpBag || i->typeId() == xmpSeq || i->typeId() == xmpAlt) {
+                if (!setProperty(ns, i->tagName(), 0, options)) return false;
+                // Items [1], [2], ... of the array which was just emptied, SetProperty() appends them
+                for (long idx = 0; idx < static_cast<long>(i->count()); ++idx) {
+                    if (!(nodes_[node_].options_ & opArray)) return false;
+                    const std::string item = i->toString(idx);
+                    if (!setNode(addNode(node_, "[]", 0), &item, 0)) return false;
+                }
+                continue;
+            }
+            if (i->typeId() == xmpText) {
+                if (i->count() == 0) {
+                    if (!setProperty(ns, i->tagName(), 0, options)) return false;
+                }
+                else {
+                    const std::string text = i->toString(0);
+                    if (!setProperty(ns, i->tagName(), &text, options)) return false;
+                }
+                continue;
+            }
+            return false;
+        }
+        return true;
+    }
+
+    bool RdfWriter::parsePath(const std::string& path)
+    {
+        steps_.clear();
+        size_t pos = path.find_first_of("/[*");
+        if (pos == std::string::npos) pos = path.size();
+        root_.assign(path, 0, pos);
+        if (!isAsciiXmlName(root_, 0, root_.size())) return false;
+
+        while (pos < path.size()) {
+            if (path[pos] == '/') ++pos;
+            Step step;
+            step.index_ = 0;
+            if (pos < path.size() && path[pos] == '[') {
+                size_t end = ++pos;
+                while (end < path.size() && '0' <= path[end] && path[end] <= '9' && end - pos < 9) {
+                    step.index_ = step.index_ * 10 + (path[end] - '0');
+                    ++end;
+                }
+                if (end == pos || end == path.size() || path[end] != ']' || step.index_ == 0) return false;
+                pos = end + 1;
+            }
+            else {
+                size_t end = path.find_first_of("/[*", pos);
+                if (end == std::string::npos) end = path.size();
+                const size_t colon = path.find(':', pos);
+                if (colon >= end) return false;
+                if (!isAsciiXmlName(path, pos, colon) || !isAsciiXmlName(path, colon + 1, end)) return false;
+                if (prefixNamespace(path.substr(pos, colon - pos)) == 0) return false;
+                step.name_.assign(path, pos, end - pos);
+                pos = end;
+            }
+            steps_.push_back(step);
+        }
+        return true;
+    }
+
+    size_t RdfWriter::findNode(const std::string& ns, bool create, uint32_t leafOptions)
+    {
+        const std::string* prefix = schemaPrefix(ns);
+        if (prefix == 0) {
+            failed_ = true;
+            return npos;
+        }
+        const std::string name = *prefix + root_;
+        bool leafIsNew = false;
+
+        size_t schema = npos;
+        for (size_t i = 0; i < nodes_[0].children_.size(); ++i) {
+            if (nodes_[nodes_[0].children_[i]].name_ == ns) {
+                schema = nodes_[0].children_[i];
+                break;
+            }
+        }
+        size_t node = schema == npos ? npos : findChild(schema, name);
+        if (node == npos) {
+            // Aliases are redirected to their actual property by the toolkit
+            if (!registry_.check_(ns, root_)) {
+                failed_ = true;
+                return npos;
+            }
+            if (!create) return npos;
+            if (schema == npos) {
+                schema = addNode(0, ns, opSchema);
+                nodes_[schema].value_ = *prefix;
+            }
+            node = addNode(schema, name, 0);
+            leafIsNew = true;
+            if (!steps_.empty() && steps_[0].index_ == 0) nodes_[node].options_ |= opStruct;
+        }
+
+        for (size_t s = 0; s < steps_.size(); ++s) {
+            const Step& step = steps_[s];
+            size_t next = npos;
+            if (step.index_ == 0) {
+                if (!(nodes_[node].options_ & opStruct)) {
+                    failed_ = true;
+                    return npos;
+                }
+                next = findChild(node, step.name_);
+                if (next == npos) {
+                    if (!create) return npos;
+                    next = addNode(node, step.name_, 0);
+                    leafIsNew = true;
+                }
+                else {
+                    node = next;
+                    continue;
+                }
+            }
+            else {
+                if (!(nodes_[node].options_ & opArray)) {
+                    failed_ = true;
+                    return npos;
+                }
+                const size_t count = nodes_[node].children_.size();
+                if (step.index_ <= count) {
+                    node = nodes_[node].children_[step.index_ - 1];
+                    continue;
+                }
+                if (!create || step.index_ != count + 1) return npos;
+                next = addNode(node, "[]", 0);
+                leafIsNew = true;
+            }
+            // A new node followed by a field step is an implicit struct
+            if (s + 1 < steps_.size() && steps_[s + 1].index_ == 0) nodes_[next].options_ |= opStruct;
+            node = next;
+        }
+        if (leafIsNew) nodes_[node].options_ |= leafOptions;
+        return node;
+    }
+
+    size_t RdfWriter::addNode(size_t parent, const std::string& name, uint32_t options)
+    {
+        const size_t node = nodes_.size();
+        nodes_.push_back(Node(name, options));
+        nodes_[parent].children_.push_back(node);
+        return node;
+    }
+
+    bool RdfWriter::setProperty(const std::string& ns, const std::string& path, const std::string* value, uint32_t options)
+    {
+        if (!verifySetOptions(options, value != 0)) return false;
+        if (!parsePath(path)) return false;
+        node_ = findNode(ns, true, options);
+        if (node_ == npos) return false;
+        return setNode(node_, value, options);
+    }
+
+    bool RdfWriter::setNode(size_t node, const std::string* value, uint32_t options)
+    {
+        Node& n = nodes_[node];
+        n.options_ |= options;
+        if (value != 0) {
+            if (n.options_ & opComposite) return false;
+            return setNodeValue(n.value_, *value);
+        }
+        if (!n.value_.empty()) return false;
+        if ((n.options_ & opComposite) && (options & opComposite) != (n.options_ & opComposite)) return false;
+        n.children_.clear();
+        return true;
+    }
+
+    bool RdfWriter::addLangAlt(const std::string& ns, const std::string& path, const LangAltValue& value)
+    {
+        size_t array = npos;
+        for (LangAltValue::ValueType::const_iterator k = value.value_.begin(); k != value.value_.end(); ++k) {
+            if (k->second.empty()) continue;
+            if (array == npos) {
+                // Items of an existing array would be numbered differently by SetQualifier()
+                if (!parsePath(path) || findNode(ns, false, 0) != npos || failed_) return false;
+                array = findNode(ns, true, opArray | opOrdered | opAlternate);
+                if (array == npos) return false;
+            }
+            const size_t item = addNode(array, "[]", 0);
+            if (!setNode(item, &k->second, 0)) return false;
+            Node& n = nodes_[item];
+            n.options_ |= opHasQualifiers | opHasLang;
+            if (!setNodeValue(n.lang_, k->first)) return false;
+            Internal::normalizeLang(n.lang_);
+        }
+        return true;
+    }
+
+    const std::string* RdfWriter::schemaPrefix(const std::string& ns)
+    {
+        for (size_t i = 0; i < prefixes_.size(); ++i) {
+            if (prefixes_[i].first == ns) return &prefixes_[i].second;
+        }
+        std::string prefix;
+        if (!registry_.prefix_(ns, prefix)) return 0;
+        prefixes_.push_back(std::make_pair(ns, prefix + ':'));
+        return &prefixes_.back().second;
+    }
+
+    const std::string* RdfWriter::prefixNamespace(const std::string& prefix)
+    {
+        for (size_t i = 0; i < namespaces_.size(); ++i) {
+            if (namespaces_[i].first == prefix) return &namespaces_[i].second;
+        }
+        std::string ns;
+        if (!registry_.namespace_(prefix, ns)) return 0;
+        namespaces_.push_back(std::make_pair(prefix, ns));
+        return &namespaces_.back().second;
+    }
+
+    size_t RdfWriter::findChild(size_t parent, const std::string& name) const
+    {
+        const std::vector<size_t>& children = nodes_[parent].children_;
+        for (size_t i = 0; i < children.size(); ++i) {
+            if (nodes_[children[i]].name_ == name) return children[i];
+        }
+        return npos;
+    }
+
+    bool RdfWriter::hasThumbnails()
+    {
+        const std::string* prefix = schemaPrefix(xmpNs);
+        if (prefix == 0) return false;
+        for (size_t i = 0; i < nodes_[0].children_.size(); ++i) {
+            const size_t schema = nodes_[0].children_[i];
+            if (nodes_[schema].name_ == xmpNs) return findChild(schema, *prefix + xmpThumbnails) != npos;
+        }
+        return false;
+    }
+
+    bool RdfWriter::write(std::string& xmpPacket, uint32_t options, uint32_t padding)
+    {
+        const bool omitWrapper = (options & XmpParser::omitPacketWrapper) != 0;
+        const bool thumbnailPad = (options & XmpParser::includeThumbnailPad) != 0;
+        if (options & XmpParser::omitAllFormatting) {
+            newline_ = " ";
+            indent_ = "";
+        }
+        else {
+            newline_ = "\n";
+            indent_ = (options & XmpParser::useCompactFormat) ? " " : "   ";
+        }
+        if (options & XmpParser::exactPacketLength) {
+            if (omitWrapper || thumbnailPad) return false;
+        }
+        else if ((options & XmpParser::readOnlyPacket) || omitWrapper) {
+            if (thumbnailPad) return false;
+            padding = 0;
+        }
+        else {
+            if (padding == 0) padding = 2048;
+            if (thumbnailPad && !hasThumbnails()) padding += 10000;
+        }
+
+        size_t size = 512;
+        for (size_t i = 0; i < nodes_.size(); ++i) {
+            size += 2 * nodes_[i].name_.size() + nodes_[i].value_.size() + nodes_[i].lang_.size() + 32;
+        }
+        out_.reserve(size + padding + (padding >> 6));
+
+        if (!omitWrapper) {
+            out_ += packetHeader;
+            out_ += newline_;
+        }
+        out_ += "<x:xmpmeta xmlns:x=\"adobe:ns:meta/\" x:xmptk=\"";
+        out_ += registry_.xmptk_;
+        out_ += "\">";
+        out_ += newline_;
+        writeIndent(1);
+        out_ += "<rdf:RDF xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\">";
+        out_ += newline_;
+
+        const Node& tree = nodes_[0];
+        if (options & XmpParser::useCompactFormat) {
+            writeCompactSchemas();
+        }
+        else if (!tree.children_.empty()) {
+            for (size_t i = 0; i < tree.children_.size(); ++i) {
+                writePrettySchema(nodes_[tree.children_[i]]);
+            }
+        }
+        else {
+            writeIndent(2);
+            out_ += "<rdf:Description rdf:about=\"\"/>";
+            out_ += newline_;
+        }
+
+        writeIndent(1);
+        out_ += "</rdf:RDF>";
+        out_ += newline_;
+        out_ += "</x:xmpmeta>";
+        out_ += newline_;
+        if (failed_) return false;
+
+        std::string tail;
+        if (!omitWrapper) {
+            tail = packetTrailer;
+            if (options & XmpParser::readOnlyPacket) tail[tail.size() - 4] = 'r';
+        }
+        if (options & XmpParser::exactPacketLength) {
+            const size_t minSize = out_.size() + tail.size();
+            if (minSize > padding) return false;
+            padding -= static_cast<uint32_t>(minSize);
+        }
+
+        const size_t newlineLen = std::char_traits<char>::length(newline_);
+        if (padding < newlineLen) {
+            out_.append(padding, ' ');
+        }
+        else {
+            padding -= static_cast<uint32_t>(newlineLen);
+            while (padding >= 100 + newlineLen) {
+                out_.append(100, ' ');
+                out_ += newline_;
+                padding -= static_cast<uint32_t>(100 + newlineLen);
+            }
+            out_.append(padding, ' ');
+            out_ += newline_;
+        }
+        out_ += tail;
+
+        xmpPacket.swap(out_);
+        return true;
+    }
+
+    void RdfWriter::writeIndent(int level)
+    {
+        for (; level > 0; --level) out_ += indent_;
+    }
+
+    void RdfWriter::writeValue(const std::string& value, bool forAttribute)
+    {
+        size_t start = 0;
+        for (size_t i = 0; i < value.size(); ++i) {
+            const unsigned char c = static_cast<unsigned char>(value[i]);
+            const char* entity = 0;
+            char hex[] = "&#x0;";
+            if (c < 0x20) {
+                hex[3] = "0123456789ABCDEF"[c & 0xF];
+                entity = hex;
+            }
+            else if (c == '&') entity = "&amp;";
+            else if (c == '<') entity = "&lt;";
+            else if (c == '>') entity = "&gt;";
+            else if (c == '"' && forAttribute) entity = "&quot;";
+            if (entity == 0) continue;
+            out_.append(value, start, i - start);
+            out_ += entity;
+            start = i + 1;
+        }
+        out_.append(value, start, std::string::npos);
+    }
+
+    void RdfWriter::writeArrayTag(uint32_t form, int indent, size_t size, bool isStartTag)
+    {
+        if (!isStartTag && size == 0) return;
+        writeIndent(indent);
+        out_ += isStartTag ? "<rdf:" : "</rdf:";
+        if (form & opAlternate) out_ += "Alt";
+        else if (form & opOrdered) out_ += "Seq";
+        else out_ += "Bag";
+        if (isStartTag && size == 0) out_ += '/';
+        out_ += '>';
+        out_ += newline_;
+    }
+
+    void RdfWriter::declareNamespace(const std::string& prefix, const std::string& ns, std::string& usedNs, int indent)
+    {
+        // Like the toolkit, look for the prefix anywhere in the list of used prefixes
+        if (usedNs.find(prefix) != std::string::npos) return;
+        out_ += newline_;
+        writeIndent(indent);
+        out_ += "xmlns:";
+        out_.append(prefix, 0, prefix.size() - 1);
+        out_ += "=\"";
+        out_ += ns;
+        out_ += '"';
+        usedNs += prefix;
+    }
+
+    void RdfWriter::declareElemNamespace(const std::string& name, std::string& usedNs, int indent)
+    {
+        const size_t colon = name.find(':');
+        if (colon == std::string::npos) return;
+        const std::string* ns = prefixNamespace(name.substr(0, colon));
+        if (ns == 0) {
+            failed_ = true;
+            return;
+        }
+        declareNamespace(name.substr(0, colon + 1), *ns, usedNs, indent);
+    }
+
+    void RdfWriter::declareUsedNamespaces(const Node& node, std::string& usedNs, int indent)
+    {
+        if (node.options_ & opSchema) {
+            declareNamespace(node.value_, node.name_, usedNs, indent);
+        }
+        else if (node.options_ & opStruct) {
+            for (size_t i = 0; i < node.children_.size(); ++i) {
+                declareElemNamespace(nodes_[node.children_[i]].name_, usedNs, indent);
+            }
+        }
+        for (size_t i = 0; i < node.children_.size(); ++i) {
+            declareUsedNamespaces(nodes_[node.children_[i]], usedNs, indent);
+        }
+        // The only qualifier is xml:lang, which needs no declaration
+    }
+
+    void RdfWriter::writePrettyProperty(const Node& node, int indent)
+    {
+        bool emitEndTag = true;
+        bool indentEndTag = true;
+        const uint32_t form = node.options_ & opComposite;
+        const char* elemName = node.name_[0] == '[' ? "rdf:li" : node.name_.c_str();
+
+        writeIndent(indent);
+        out_ += '<';
+        out_ += elemName;
+        if (node.options_ & opHasLang) {
+            out_ += " xml:lang=\"";
+            writeValue(node.lang_, true);
+            out_ += '"';
+        }
+
+        if (form == 0) {
+            if (node.value_.empty()) {
+                out_ += "/>";
+                out_ += newline_;
+                emitEndTag = false;
+            }
+            else {
+                out_ += '>';
+                writeValue(node.value_, false);
+                indentEndTag = false;
+            }
+        }
+        else if (form & opArray) {
+            out_ += '>';
+            out_ += newline_;
+            writeArrayTag(form, indent + 1, node.children_.size(), true);
+            for (size_t i = 0; i < node.children_.size(); ++i) {
+                writePrettyProperty(nodes_[node.children_[i]], indent + 2);
+            }
+            writeArrayTag(form, indent + 1, node.children_.size(), false);
+        }
+        else if (node.children_.empty()) {
+            out_ += " rdf:parseType=\"Resource\"/>";
+            out_ += newline_;
+            emitEndTag = false;
+        }
+        else {
+            out_ += " rdf:parseType=\"Resource\">";
+            out_ += newline_;
+            for (size_t i = 0; i < node.children_.size(); ++i) {
+                writePrettyProperty(nodes_[node.children_[i]], indent + 1);
+            }
+        }
+
+        if (emitEndTag) {
+            if (indentEndTag) writeIndent(indent);
+            out_ += "</";
+            out_ += elemName;
+            out_ += '>';
+            out_ += newline_;
+        }
+    }
+
+    void RdfWriter::writePrettySchema(const Node& schema)
+    {
+        writeIndent(2);
+        out_ += "<rdf:Description rdf:about=\"\"";
+        std::string usedNs("xml:rdf:");
+        declareUsedNamespaces(schema, usedNs, 4);
+        out_ += ">";
+        out_ += newline_;
+        for (size_t i = 0; i < schema.children_.size(); ++i) {
+            writePrettyProperty(nodes_[schema.children_[i]], 3);
+        }
+        writeIndent(2);
+        out_ += "</rdf:Description>";
+        out_ += newline_;
+    }
+
+    bool RdfWriter::writeCompactAttrProps(const Node& parent, int indent)
+    {
+        bool allAreAttrs = true;
+        for (size_t i = 0; i < parent.children_.size(); ++i) {
+            const Node& node = nodes_[parent.children_[i]];
+            if (!canBeAttrProp(node)) {
+                allAreAttrs = false;
+                continue;
+            }
+            out_ += newline_;
+            writeIndent(indent);
+            out_ += node.name_;
+            out_ += "=\"";
+            writeValue(node.value_, true);
+            out_ += '"';
+        }
+        return allAreAttrs;
+    }
+
+    void RdfWriter::writeCompactElemProps(const Node& parent, int indent)
+    {
+        for (size_t i = 0; i < parent.children_.size(); ++i) {
+            const Node& node = nodes_[parent.children_[i]];
+            if (canBeAttrProp(node)) continue;
+
+            bool emitEndTag = true;
+            bool indentEndTag = true;
+            const uint32_t form = node.options_ & opComposite;
+            const char* elemName = node.name_[0] == '[' ? "rdf:li" : node.name_.c_str();
+
+            writeIndent(indent);
+            out_ += '<';
+            out_ += elemName;
+            if (node.options_ & opHasLang) {
+                out_ += " xml:lang=\"";
+                writeValue(node.lang_, true);
+                out_ += '"';
+            }
+
+            if (form == 0) {
+                if (node.value_.empty()) {
+                    out_ += "/>";
+                    out_ += newline_;
+                    emitEndTag = false;
+                }
+                else {
+                    out_ += '>';
+                    writeValue(node.value_, false);
+                    indentEndTag = false;
+                }
+            }
+            else if (form & opArray) {
+                out_ += '>';
+                out_ += newline_;
+                writeArrayTag(form, indent + 1, node.children_.size(), true);
+                writeCompactElemProps(node, indent + 2);
+                writeArrayTag(form, indent + 1, node.children_.size(), false);
+            }
+            else {
+                bool hasAttrFields = false;
+                bool hasElemFields = false;
+                for (size_t j = 0; j < node.children_.size(); ++j) {
+                    if (canBeAttrProp(nodes_[node.children_[j]])) hasAttrFields = true;
+                    else hasElemFields = true;
+                }
+                if (node.children_.empty()) {
+                    out_ += " rdf:parseType=\"Resource\"/>";
+                    out_ += newline_;
+                    emitEndTag = false;
+                }
+                else if (!hasElemFields) {
+                    writeCompactAttrProps(node, indent + 1);
+                    out_ += "/>";
+                    out_ += newline_;
+                    emitEndTag = false;
+                }
+                else if (!hasAttrFields) {
+                    out_ += " rdf:parseType=\"Resource\">";
+                    out_ += newline_;
+                    writeCompactElemProps(node, indent + 1);
+                }
+                else {
+                    out_ += '>';
+                    out_ += newline_;
+                    writeIndent(indent + 1);
+                    out_ += "<rdf:Description";
+                    writeCompactAttrProps(node, indent + 2);
+                    out_ += ">";
+                    out_ += newline_;
+                    writeCompactElemProps(node, indent + 1);
+                    writeIndent(indent + 1);
+                    out_ += "</rdf:Description>";
+                    out_ += newline_;
+                }
+            }
+
+            if (emitEndTag) {
+                if (indentEndTag) writeIndent(indent);
+                out_ += "</";
+                out_ += elemName;
+                out_ += '>';
+                out_ += newline_;
+            }
+        }
+    }
+
+    void RdfWriter::writeCompactSchemas()
+    {
+        const Node& tree = nodes_[0];
+        writeIndent(2);
+        out_ += "<rdf:Description rdf:about=\"\"";
+        std::string usedNs("xml:rdf:");
+        for (size_t i = 0; i < tree.children_.size(); ++i) {
+            declareUsedNamespaces(nodes_[tree.children_[i]], usedNs, 4);
+        }
+        bool allAreAttrs = true;
+        for (size_t i = 0; i < tree.children_.size(); ++i) {
+            allAreAttrs &= writeCompactAttrProps(nodes_[tree.children_[i]], 3);
+        }
+        if (allAreAttrs) {
+            out_ += "/>";
+            out_ += newline_;
+            return;
+        }
+        out_ += ">";
+        out_ += newline_;
+        for (size_t i = 0; i < tree.children_.size(); ++i) {
+            writeCompactElemProps(nodes_[tree.children_[i]], 3);
+        }
+        writeIndent(2);
+        out_ += "</rdf:Description>";
+        out_ += newline_;
+    }
+
+    bool RdfWriter::canBeAttrProp(const Node& node)
+    {
+        return node.name_[0] != '[' && !(node.options_ & (opHasQualifiers | opComposite));
+    }
+
+}
+
+// *****************************************************************************
+// class member definitions
+namespace Exiv2 {
+    namespace Internal {
+
+    bool encodeRdf(std::string& xmpPacket, const XmpData& xmpData, uint16_t formatFlags, uint32_t padding,
+                   const RdfRegistry& registry)
+    {
+        RdfWriter writer(registry);
+        return writer.build(xmpData) && writer.write(xmpPacket, formatFlags, padding);
+    }
+
+}}                                      // namespace Internal, Exiv2
@@ -0,0 +1,95 @@
+// ***************************************************************** -*- C++ -*-
+/*
+ * Copyright (C) 2004-2018 Exiv2 authors
+ * This program is part of the Exiv2 distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, 5th Floor, Boston, MA 02110-1301 USA.
+ */
+/*!
+  @file    rdfwriter_int.hpp
+  @brief   Direct RDF/XML writer for XMP packets
+ */
+#pragma once
+
+// *****************************************************************************
+// included header files
+#include "exiv2lib_export.h"
+#include "rdfreader_int.hpp"
+#include "types.hpp"
+
+// + standard includes
+#include <string>
+
+// *****************************************************************************
+// namespace extensions
+namespace Exiv2 {
+    class XmpData;
+
+    namespace Internal {
+
+// *****************************************************************************
+// type definitions
+
+    /*!
+      @brief Type for a function which sets \em ns to the namespace the XMP
+             toolkit has registered for \em prefix (without the colon).
+             Returns false if the prefix is not registered.
+     */
+    typedef bool (*RdfNamespaceFct)(const std::string& prefix, std::string& ns);
+
+    //! Lookups in the registries of the XMP toolkit, used by encodeRdf()
+    struct RdfRegistry {
+        RdfPrefixFct        prefix_;    //!< Toolkit prefix of a namespace
+        RdfNamespaceFct     namespace_; //!< Namespace of a toolkit prefix
+        RdfPropertyCheckFct check_;     //!< Accepts top-level properties which are not aliases
+        std::string         xmptk_;     //!< Value of the x:xmptk attribute
+    };
+
+// *****************************************************************************
+// free functions
+
+    /*!
+      @brief Encode XMP properties to an RDF/XML packet in one pass, without
+             building the property tree of the XMP toolkit.
+
+      The writer follows what XmpParser::encode asks the toolkit to do for
+      each Xmpdatum and writes the packet exactly as SXMPMeta::SerializeToBuffer
+      would, in the pretty or compact format and with the same padding. It
+      gives up on anything the toolkit would reject or treat specially:
+      aliases, unregistered namespaces and prefixes, path syntax other than
+      struct fields and array indexes, names with non-ASCII characters,
+      invalid UTF-8, conflicting struct and array forms, inconsistent format
+      flags and packets which do not fit into the exact packet length.
+
+      @param xmpPacket   String to hold the encoded XMP packet.
+      @param xmpData     XMP properties to encode, must not be empty.
+      @param formatFlags Flags that control the format of the XMP packet,
+                         see XmpParser::XmpFormatFlags.
+      @param padding     Padding length.
+      @param registry    Namespace and alias lookups of the XMP toolkit.
+      @return true if the packet was encoded; false if it must be encoded
+              with the XMP toolkit, in which case \em xmpPacket is not modified.
+     */
+    bool encodeRdf(std::string& xmpPacket, const XmpData& xmpData, uint16_t formatFlags, uint32_t padding,
+                   const RdfRegistry& registry);
+
+    /*!
+      @brief Encode XMP properties with the XMP toolkit only, bypassing
+             encodeRdf(). Returns the same codes as XmpParser::encode().
+             Exported to verify the RDF writer against the toolkit.
+     */
+    EXIV2API int encodeXmpToolkit(std::string& xmpPacket, const XmpData& xmpData, uint16_t formatFlags, uint32_t padding);
+
+}}                                      // namespace Internal, Exiv2
@@ -35,6 +35,7 @@
 #include "preview.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 
 // + standard includes
 #ifdef EXIV2_DEBUG_MESSAGES
@@ -112,6 +113,7 @@ namespace Exiv2 {
 
     void Rw2Image::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Reading RW2 file " << io_->path() << "\n";
 #endif
@@ -219,6 +221,7 @@ namespace Exiv2 {
 
     void Rw2Image::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
         // Todo: implement me!
         throw(Error(kerWritingImageFormatUnsupported, "RW2"));
     } // Rw2Image::writeMetadata
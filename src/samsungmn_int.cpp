@@ -43,7 +43,7 @@ namespace Exiv2 {
     namespace Internal {
 
     //! LensType, tag 0xa003
-    extern const TagDetails samsung2LensType[] = {
+    extern constexpr TagDetails samsung2LensType[] = {
         {  0, N_("Built-in")                                      },
         {  1, "Samsung NX 30mm F2 Pancake"                    },
         {  2, "Samsung NX 18-55mm F3.5-5.6 OIS"               },
@@ -63,6 +63,7 @@ namespace Exiv2 {
         { 20, "Samsung NX 50-150mm F2.8 S ED OIS"             },
         { 21, "Samsung NX 300mm F2.8 ED OIS"                  }
     };
+    static_assert(isSorted(samsung2LensType, EXV_COUNTOF(samsung2LensType)), "samsung2LensType must be sorted by value");
 
     //! ColorSpace, tag 0xa011
     extern const TagDetails samsung2ColorSpace[] = {
@@ -58,7 +58,7 @@ namespace Exiv2 {
     };
 
     //! Lookup table to translate Sony model ID values to readable labels
-    extern const TagDetails sonyModelId[] = {
+    extern constexpr TagDetails sonyModelId[] = {
         { 2, "DSC-R1"                   },
         { 256, "DSLR-A100"              },
         { 257, "DSLR-A900"              },
@@ -128,6 +128,7 @@ namespace Exiv2 {
         { 357, "ILCE-6300"              },
         { 369, "DSC-RX100M5A"           }
     };
+    static_assert(isSorted(sonyModelId, EXV_COUNTOF(sonyModelId)), "sonyModelId must be sorted by value");
 
     //! Lookup table to translate Sony dynamic range optimizer values to readable labels
     extern const TagDetails print0xb025[] = {
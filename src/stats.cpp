@@ -0,0 +1,119 @@
+// ***************************************************************** -*- C++ -*-
+/*
+ * Copyright (C) 2004-2018 Exiv2 authors
+ * This program is part of the Exiv2 distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, 5th Floor, Boston, MA 02110-1301 USA.
+ */
+// *****************************************************************************
+// included header files
+#include "stats.hpp"
+#include "stats_int.hpp"
+
+// + standard includes
+#include <iomanip>
+#include <ios>
+
+// *****************************************************************************
+// local declarations
+namespace {
+    //! Names of the counters, indexed by Stats::Counter
+    const char* const counterNames[] = {
+        "ImageFactory::open",
+        "Image::readMetadata",
+        "Image::writeMetadata",
+        "TiffParser::decode",
+        "TiffParser::encode",
+        "XmpParser::decode",
+        "XmpParser::encode",
+        "IptcParser::decode",
+        "IptcParser::encode",
+        "BasicIo::read",
+        "BasicIo::write",
+        "BasicIo::seek",
+        "BasicIo::mmap"
+    };
+    static_assert(sizeof(counterNames) / sizeof(counterNames[0]) == Exiv2::Stats::lastCounter,
+                  "a counter has no name");
+}
+
+// *****************************************************************************
+// class member definitions
+namespace Exiv2 {
+
+#ifdef EXV_ENABLE_STATS
+    bool Stats::enabled()
+    {
+        return true;
+    }
+
+    Stats::Snapshot Stats::snapshot()
+    {
+        return Internal::statsSnapshot();
+    }
+
+    void Stats::reset()
+    {
+        Internal::resetStats();
+    }
+#else
+    bool Stats::enabled()
+    {
+        return false;
+    }
+
+    Stats::Snapshot Stats::snapshot()
+    {
+        return Snapshot(lastCounter, Entry());
+    }
+
+    void Stats::reset()
+    {
+    }
+#endif                                  // EXV_ENABLE_STATS
+
+    const char* Stats::name(Counter counter)
+    {
+        return counter >= 0 && counter < lastCounter ? counterNames[counter] : "";
+    }
+
+    std::ostream& Stats::print(std::ostream& os, const Snapshot& snapshot)
+    {
+        const std::ios::fmtflags flags = os.flags();
+        const std::streamsize precision = os.precision();
+        os << std::left << std::setw(22) << "Counter"
+           << std::right << std::setw(10) << "Calls"
+           << std::setw(14) << "Time [ms]"
+           << std::setw(14) << "Bytes" << "\n";
+        for (int i = 0; i < lastCounter && i < static_cast<int>(snapshot.size()); ++i) {
+            const Entry& entry = snapshot[i];
+            if (entry.calls_ == 0) continue;
+            os << std::left << std::setw(22) << counterNames[i]
+               << std::right << std::setw(10) << entry.calls_
+               << std::setw(14);
+            if (entry.nanoseconds_ > 0) {
+                os << std::fixed << std::setprecision(3) << entry.nanoseconds_ / 1e6;
+            }
+            else {
+                os << "-";
+            }
+            os << std::setw(14) << entry.bytes_ << "\n";
+        }
+        os.flags(flags);
+        os.precision(precision);
+        return os;
+    }
+
+}                                       // namespace Exiv2
@@ -0,0 +1,116 @@
+// ***************************************************************** -*- C++ -*-
+/*
+ * Copyright (C) 2004-2018 Exiv2 authors
+ * This program is part of the Exiv2 distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, 5th Floor, Boston, MA 02110-1301 USA.
+ */
+// *****************************************************************************
+// included header files
+#include "stats_int.hpp"
+
+#ifdef EXV_ENABLE_STATS
+// + standard includes
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+// *****************************************************************************
+// local declarations
+namespace {
+    //! The counters of the running threads and the counts of the ended ones
+    struct StatsRegistry {
+        StatsRegistry() : ended_(Exiv2::Stats::lastCounter, Exiv2::Stats::Entry()) {}
+
+        std::mutex mutex_;
+        std::vector<Exiv2::Internal::StatsBlock*> blocks_;
+        Exiv2::Stats::Snapshot ended_;
+    };
+
+    StatsRegistry& registry()
+    {
+        static StatsRegistry registry;
+        return registry;
+    }
+}
+
+// *****************************************************************************
+// class member definitions
+namespace Exiv2 {
+    namespace Internal {
+
+    StatsBlock::StatsBlock()
+    {
+        reset();
+        StatsRegistry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex_);
+        r.blocks_.push_back(this);
+    }
+
+    StatsBlock::~StatsBlock()
+    {
+        StatsRegistry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex_);
+        addTo(r.ended_);
+        r.blocks_.erase(std::find(r.blocks_.begin(), r.blocks_.end(), this));
+    }
+
+    void StatsBlock::addTo(Stats::Snapshot& snapshot) const
+    {
+        for (int i = 0; i < Stats::lastCounter; ++i) {
+            snapshot[i].calls_ += counts_[i].calls_.load(std::memory_order_relaxed);
+            snapshot[i].nanoseconds_ += counts_[i].nanoseconds_.load(std::memory_order_relaxed);
+            snapshot[i].bytes_ += counts_[i].bytes_.load(std::memory_order_relaxed);
+        }
+    }
+
+    void StatsBlock::reset()
+    {
+        for (auto&& counts : counts_) {
+            counts.calls_.store(0, std::memory_order_relaxed);
+            counts.nanoseconds_.store(0, std::memory_order_relaxed);
+            counts.bytes_.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    StatsBlock& statsBlock()
+    {
+        thread_local StatsBlock block;
+        return block;
+    }
+
+    Stats::Snapshot statsSnapshot()
+    {
+        StatsRegistry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex_);
+        Stats::Snapshot snapshot(r.ended_);
+        for (auto&& block : r.blocks_) {
+            block->addTo(snapshot);
+        }
+        return snapshot;
+    }
+
+    void resetStats()
+    {
+        StatsRegistry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex_);
+        std::fill(r.ended_.begin(), r.ended_.end(), Stats::Entry());
+        for (auto&& block : r.blocks_) {
+            block->reset();
+        }
+    }
+
+}}                                      // namespace Internal, Exiv2
+#endif                                  // EXV_ENABLE_STATS
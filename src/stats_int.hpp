@@ -0,0 +1,135 @@
+// ***************************************************************** -*- C++ -*-
+/*
+ * Copyright (C) 2004-2018 Exiv2 authors
+ * This program is part of the Exiv2 distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, 5th Floor, Boston, MA 02110-1301 USA.
+ */
+/*!
+  @file    stats_int.hpp
+  @brief   Per thread counters and scoped timers behind the Stats API. Use
+           the macros EXV_STATS_TIMER and EXV_STATS_COUNT, which compile to
+           nothing unless the library is built with EXIV2_ENABLE_STATS.
+ */
+#pragma once
+
+// *****************************************************************************
+// included header files
+#include "stats.hpp"
+
+#ifdef EXV_ENABLE_STATS
+// + standard includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// *****************************************************************************
+// namespace extensions
+namespace Exiv2 {
+    namespace Internal {
+
+// *****************************************************************************
+// class definitions
+
+    /*!
+      @brief The counters of one thread. Only the thread itself changes them,
+             other threads read them for a snapshot, so the updates don't
+             need atomic read-modify-write operations.
+     */
+    class StatsBlock {
+    public:
+        //! Register the counters of the thread
+        StatsBlock();
+        //! Keep the counts for snapshots and unregister the counters
+        ~StatsBlock();
+        StatsBlock(const StatsBlock& rhs) = delete;
+        StatsBlock& operator=(const StatsBlock& rhs) = delete;
+
+        //! Count a call of \em counter
+        void add(Stats::Counter counter, uint64_t nanoseconds, uint64_t bytes)
+        {
+            Counts& counts = counts_[counter];
+            increment(counts.calls_, 1);
+            increment(counts.nanoseconds_, nanoseconds);
+            increment(counts.bytes_, bytes);
+        }
+        //! Add the counts to \em snapshot
+        void addTo(Stats::Snapshot& snapshot) const;
+        //! Set the counts to 0
+        void reset();
+
+    private:
+        //! The counts of one counter
+        struct Counts {
+            std::atomic<uint64_t> calls_;
+            std::atomic<uint64_t> nanoseconds_;
+            std::atomic<uint64_t> bytes_;
+        };
+
+        static void increment(std::atomic<uint64_t>& count, uint64_t value)
+        {
+            count.store(count.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        // DATA
+        Counts counts_[Stats::lastCounter];
+    };
+
+    //! Return the counters of the calling thread
+    StatsBlock& statsBlock();
+
+    //! Return the counts of all threads
+    Stats::Snapshot statsSnapshot();
+
+    //! Set the counters of all threads to 0
+    void resetStats();
+
+    //! Time the scope and count it as a call of a counter
+    class StatsTimer {
+    public:
+        //! Start the timer of a call of \em counter, which processes \em bytes
+        StatsTimer(Stats::Counter counter, uint64_t bytes)
+            : counter_(counter), bytes_(bytes), start_(std::chrono::steady_clock::now())
+        {
+        }
+        //! Count the call
+        ~StatsTimer()
+        {
+            const auto elapsed = std::chrono::steady_clock::now() - start_;
+            statsBlock().add(counter_, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), bytes_);
+        }
+        StatsTimer(const StatsTimer& rhs) = delete;
+        StatsTimer& operator=(const StatsTimer& rhs) = delete;
+
+    private:
+        // DATA
+        const Stats::Counter counter_;
+        const uint64_t bytes_;
+        const std::chrono::steady_clock::time_point start_;
+    };
+
+}}                                      // namespace Internal, Exiv2
+
+//! Time the rest of the scope as a call of Stats::counter which processes bytes
+#define EXV_STATS_TIMER(counter, bytes) \
+    const Exiv2::Internal::StatsTimer exvStatsTimer(Exiv2::Stats::counter, bytes)
+//! Count a call of Stats::counter which processes bytes, without timing it
+#define EXV_STATS_COUNT(counter, bytes) \
+    Exiv2::Internal::statsBlock().add(Exiv2::Stats::counter, 0, bytes)
+
+#else
+#define EXV_STATS_TIMER(counter, bytes)
+#define EXV_STATS_COUNT(counter, bytes)
+#endif                                  // EXV_ENABLE_STATS
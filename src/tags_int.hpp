@@ -34,6 +34,7 @@
 #include "value.hpp"
 
 // + standard includes
+#include <cstddef>
 #include <string>
 #include <iostream>
 #include <memory>
@@ -219,6 +220,49 @@ namespace Exiv2 {
         bool operator==(const std::string& key) const;
     }; // struct TagDetails
 
+    /*!
+      @brief Return true if the \em n tag details starting at \em td are sorted
+             by value. It can be used in constant expressions to check a table
+             at compile time, e.g.,
+             <tt>static_assert(isSorted(table, EXV_COUNTOF(table)), "...")</tt>.
+     */
+    constexpr bool isSorted(const TagDetails* td, size_t n)
+    {
+        return n < 2 || (   isSorted(td, n / 2)
+                         && td[n / 2 - 1].val_ <= td[n / 2].val_
+                         && isSorted(td + n / 2, n - n / 2));
+    }
+
+    /*!
+      @brief Return the first entry of the \em n tag details starting at \em td,
+             which must be sorted by value, with value \em key; 0 if there is
+             none. The binary search has no data dependent branches.
+     */
+    inline const TagDetails* findSorted(const TagDetails* td, size_t n, int64_t key)
+    {
+        if (n == 0) return nullptr;
+        const TagDetails* const end = td + n;
+        while (n > 1) {
+            const size_t half = n / 2;
+            td = td[half].val_ < key ? td + half : td;
+            n -= half;
+        }
+        td += td->val_ < key;
+        return td == end || td->val_ != key ? nullptr : td;
+    }
+
+    /*!
+      @brief Return the first entry of \em array with value \em key, 0 if there
+             is none. Arrays sorted by value are searched with a binary search,
+             the others with a linear search.
+     */
+    template <int N, const TagDetails (&array)[N]>
+    const TagDetails* findTagDetails(long key)
+    {
+        static const bool sorted = isSorted(array, N);
+        return sorted ? findSorted(array, N, key) : find(array, key);
+    }
+
     /*!
       @brief Generic pretty-print function to translate a long value to a description
              by looking up a reference table.
@@ -226,7 +270,7 @@ namespace Exiv2 {
     template <int N, const TagDetails (&array)[N]>
     std::ostream& printTag(std::ostream& os, const Value& value, const ExifData*)
     {
-        const TagDetails* td = find(array, value.toLong());
+        const TagDetails* td = findTagDetails<N, array>(value.toLong());
         if (td) {
             os << exvGettext(td->label_);
         }
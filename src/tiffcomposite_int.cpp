@@ -435,10 +435,11 @@ namespace Exiv2 {
         for (int i = 0; i < pSize->count(); ++i) {
             size += static_cast<uint32_t>(pSize->toLong(i));
         }
-        uint32_t offset = static_cast<uint32_t>(pValue()->toLong(0));
+        // Offsets are 64-bit in BigTIFF images
+        const uint64_t offset = static_cast<uint64_t>(pValue()->toLong(0));
         // Todo: Remove limitation of JPEG writer: strips must be contiguous
         // Until then we check: last offset + last size - first offset == size?
-        if (  static_cast<uint32_t>(pValue()->toLong(pValue()->count()-1))
+        if (  static_cast<uint64_t>(pValue()->toLong(pValue()->count()-1))
             + static_cast<uint32_t>(pSize->toLong(pSize->count()-1))
             - offset != size) {
 #ifndef SUPPRESS_WARNINGS
@@ -490,7 +491,7 @@ namespace Exiv2 {
             return;
         }
         for (int i = 0; i < pValue()->count(); ++i) {
-            const uint32_t offset = static_cast<uint32_t>(pValue()->toLong(i));
+            const uint64_t offset = static_cast<uint64_t>(pValue()->toLong(i));
             const byte* pStrip = pData + baseOffset + offset;
             const uint32_t size = static_cast<uint32_t>(pSize->toLong(i));
 
@@ -927,13 +928,22 @@ namespace Exiv2 {
         visitor.visitSubIfd(this);
         for (Ifds::iterator i = ifds_.begin();
              visitor.go(TiffVisitor::geTraverse) && i != ifds_.end(); ++i) {
-            (*i)->accept(visitor);
+            if (visitor.go(TiffVisitor::geSubtrees)) {
+                (*i)->accept(visitor);
+            }
+            else {
+                visitor.visitSubtree(*i);
+            }
         }
     } // TiffSubIfd::doAccept
 
     void TiffMnEntry::doAccept(TiffVisitor& visitor)
     {
         visitor.visitMnEntry(this);
+        if (!visitor.go(TiffVisitor::geSubtrees)) {
+            if (mn_ && visitor.go(TiffVisitor::geTraverse)) visitor.visitSubtree(mn_);
+            return;
+        }
         if (mn_) mn_->accept(visitor);
         if (!visitor.go(TiffVisitor::geKnownMakernote)) {
             delete mn_;
@@ -1224,7 +1234,7 @@ namespace Exiv2 {
         ioWrapper.write(buf, 8);
         if (pDirEntry->size() > 4) {
             pDirEntry->setOffset(offset + static_cast<int32_t>(valueIdx));
-            l2Data(buf, pDirEntry->offset(), byteOrder);
+            l2Data(buf, static_cast<int32_t>(pDirEntry->offset()), byteOrder);
             ioWrapper.write(buf, 4);
         }
         else {
@@ -1620,6 +1630,9 @@ namespace Exiv2 {
                       << std::setfill('0') << std::hex << tag() << std::dec
                       << ": Writing data area, size = " << len;
 #endif
+            // A value with a data area size but no data area, as the one of
+            // LoaderTiff::writeStrips(), writes only the alignment byte. The
+            // caller then writes the image data in its place, at the end.
             DataBuf buf = pValue()->dataArea();
             ioWrapper.write(buf.pData_, buf.size_);
             uint32_t align = len & 1;       // Align image data to word boundary
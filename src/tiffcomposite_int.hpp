@@ -65,6 +65,9 @@ namespace Exiv2 {
     const TiffType ttTiffFloat        =11; //!< TIFF FLOAT type
     const TiffType ttTiffDouble       =12; //!< TIFF DOUBLE type
     const TiffType ttTiffIfd          =13; //!< TIFF IFD type
+    const TiffType ttUnsignedLongLong =16; //!< BigTIFF LONG8 type
+    const TiffType ttSignedLongLong   =17; //!< BigTIFF SLONG8 type
+    const TiffType ttTiffIfd8         =18; //!< BigTIFF IFD8 type
 
     //! Convert the \em tiffType of a \em tag and \em group to an Exiv2 \em typeId.
     TypeId toTypeId(TiffType tiffType, uint16_t tag, IfdId group);
@@ -434,7 +437,7 @@ namespace Exiv2 {
          */
         void encode(TiffEncoder& encoder, const Exifdatum* datum);
         //! Set the offset
-        void setOffset(int32_t offset) { offset_ = offset; }
+        void setOffset(int64_t offset) { offset_ = offset; }
         //! Set pointer and size of the entry's data (not taking ownership of the data).
         void setData(byte* pData, int32_t size);
         //! Set the entry's data buffer, taking ownership of the data buffer passed in.
@@ -461,7 +464,7 @@ namespace Exiv2 {
           @brief Return the offset to the data area relative to the base
                  for the component (usually the start of the TIFF header)
          */
-        int32_t offset()         const { return offset_; }
+        int64_t offset()         const { return offset_; }
 
         /// @brief Return the unique id of the entry in the image
         int idx() const override;
@@ -536,7 +539,7 @@ namespace Exiv2 {
         // DATA
         TiffType tiffType_;   //!< Field TIFF type
         uint32_t count_;      //!< The number of values of the indicated type
-        int32_t  offset_;     //!< Offset to the data area
+        int64_t  offset_;     //!< Offset to the data area, 64-bit for BigTIFF
         /*!
           Size of the data buffer holding the value in bytes, there is no
           minimum size.
@@ -843,6 +846,7 @@ namespace Exiv2 {
      */
     class TiffDirectory : public TiffComponent {
         friend class TiffEncoder;
+        friend class TiffDirEntryCollector;
     public:
         //! @name Creators
         //@{
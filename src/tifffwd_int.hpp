@@ -61,6 +61,7 @@ namespace Exiv2 {
 
     class TiffVisitor;
     class TiffFinder;
+    class TiffDirEntryCollector;
     class TiffDecoder;
     class TiffEncoder;
     class TiffReader;
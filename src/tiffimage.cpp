@@ -35,6 +35,7 @@
 #include "image_int.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 #include "types.hpp"
 #include "basicio.hpp"
 #include "i18n.h"                // NLS support.
@@ -43,6 +44,7 @@
 #include <string>
 #include <iostream>
 #include <iomanip>
+#include <atomic>
 #include <cassert>
 #include <cstdarg>
 
@@ -64,6 +66,13 @@
 
    -------------------------------------------------------------------------- */
 
+// *****************************************************************************
+// local declarations
+namespace {
+    //! Number of threads to decode one TIFF structure, see TiffParser::setDecodeThreads()
+    std::atomic<unsigned int> decodeThreads_(1);
+}
+
 // *****************************************************************************
 // class member definitions
 namespace Exiv2 {
@@ -168,6 +177,7 @@ namespace Exiv2 {
 
     void TiffImage::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Reading TIFF file " << io_->path() << "\n";
 #endif
@@ -202,11 +212,13 @@ namespace Exiv2 {
             iccProfile_.alloc(size);
             pos->copy(iccProfile_.pData_,bo);
         }
-
+        // Track changes to write back only the modified tags
+        exifData_.setOrigin(io_.get());
     }
 
     void TiffImage::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Writing TIFF file " << io_->path() << "\n";
 #endif
@@ -248,6 +260,7 @@ namespace Exiv2 {
         xmpData().usePacket(writeXmpFromPacket());
 
         TiffParser::encode(*io_, pData, size, bo, exifData_, iptcData_, xmpData_); // may throw
+        exifData_.setOrigin(io_.get());
     } // TiffImage::writeMetadata
 
     ByteOrder TiffParser::decode(ExifData& exifData,
@@ -266,6 +279,16 @@ namespace Exiv2 {
                                         TiffMapping::findDecoder);
     } // TiffParser::decode
 
+    void TiffParser::setDecodeThreads(unsigned int threads)
+    {
+        decodeThreads_ = threads;
+    }
+
+    unsigned int TiffParser::decodeThreads()
+    {
+        return decodeThreads_;
+    }
+
     WriteMethod TiffParser::encode(BasicIo&  io,
         const byte*     pData,
               size_t size,
@@ -3,6 +3,9 @@
 #include "error.hpp"
 #include "makernote_int.hpp"
 #include "sonymn_int.hpp"
+#include "stats_int.hpp"
+#include "tiffimage.hpp"
+#include "tifftasks_int.hpp"
 #include "tiffvisitor_int.hpp"
 #include "i18n.h"                // NLS support.
 
@@ -1606,14 +1609,41 @@ namespace Exiv2 {
               TiffHeaderBase*    pHeader
     )
     {
+        EXV_STATS_TIMER(tiffDecode, size);
         // Create standard TIFF header if necessary
         std::unique_ptr<TiffHeaderBase> ph;
         if (!pHeader) {
             ph = std::unique_ptr<TiffHeaderBase>(new TiffHeader);
             pHeader = ph.get();
         }
-        TiffComponent::UniquePtr rootDir = parse(pData, size, root, pHeader);
+        const unsigned int threads = TiffParser::decodeThreads();
+        TiffComponent::UniquePtr rootDir = parse(pData, size, root, pHeader, threads);
         if (0 != rootDir.get()) {
+            if (threads > 1) {
+                // Decode into containers of our own, which are left as they
+                // are if the tasks can't be merged
+                ExifData taskExifData;
+                IptcData taskIptcData;
+                XmpData  taskXmpData;
+                TiffDecoder decoder(taskExifData,
+                                    taskIptcData,
+                                    taskXmpData,
+                                    rootDir.get(),
+                                    findDecoderFct);
+                {
+                    TiffTaskQueue tasks(threads);
+                    decoder.setTasks(&tasks);
+                    decoder.run(rootDir.get());
+                }
+                if (decoder.mergeTasks()) {
+                    exifData.clear();
+                    exifData.append(taskExifData);
+                    std::swap(iptcData, taskIptcData);
+                    std::swap(xmpData, taskXmpData);
+                    return pHeader->byteOrder();
+                }
+                // Decode again in place
+            }
             TiffDecoder decoder(exifData,
                                 iptcData,
                                 xmpData,
@@ -1638,9 +1668,12 @@ namespace Exiv2 {
               OffsetWriter*      pOffsetWriter
     )
     {
+        EXV_STATS_TIMER(tiffEncode, size);
         /*
            1) parse the binary image, if one is provided, and
-           2) attempt updating the parsed tree in-place ("non-intrusive writing")
+           2) attempt updating the parsed tree in-place ("non-intrusive writing"),
+              only the entries of modified metadata if the Exif data was read
+              from the same image
            3) else, create a new tree and write a new TIFF structure ("intrusive
               writing"). If there is a parsed tree, it is only used to access the
               image data in this case.
@@ -1661,8 +1694,13 @@ namespace Exiv2 {
                                 &primaryGroups,
                                 pHeader,
                                 findEncoderFct);
-            parsedTree->accept(encoder);
-            if (!encoder.dirty()) writeMethod = wmNonIntrusive;
+            if (exifData.origin() == &io && encoder.encodeModified()) {
+                writeMethod = wmNonIntrusive;
+            }
+            else {
+                parsedTree->accept(encoder);
+                if (!encoder.dirty()) writeMethod = wmNonIntrusive;
+            }
         }
         if (writeMethod == wmIntrusive) {
             TiffComponent::UniquePtr createdTree = TiffCreator::create(root, ifdIdNotSet);
@@ -1711,18 +1749,35 @@ namespace Exiv2 {
         const byte*              pData,
               size_t             size,
               uint32_t           root,
-              TiffHeaderBase*    pHeader
+              TiffHeaderBase*    pHeader,
+              unsigned int       threads
     )
     {
         if (pData == 0 || size == 0)
             return nullptr;
-        if (!pHeader->read(pData, size) || pHeader->offset() >= size) {
+        if (!pHeader->read(pData, size) || pHeader->rootOffset() >= size) {
             throw Error(kerNotAnImage, "TIFF");
         }
+        const TiffRwState state(pHeader->byteOrder(), 0, pHeader->isBigTiff());
+        if (threads > 1) {
+            TiffComponent::UniquePtr rootDir = TiffCreator::create(root, ifdIdNotSet);
+            if (0 == rootDir.get()) return rootDir;
+            rootDir->setStart(pData + pHeader->rootOffset());
+            TiffReader reader(pData, size, rootDir.get(), state);
+            {
+                TiffTaskQueue tasks(threads);
+                reader.setTasks(&tasks);
+                reader.run(rootDir.get());
+            }
+            if (reader.mergeTasks()) {
+                reader.postProcess();
+                return rootDir;
+            }
+            // Read the composite again in place
+        }
         TiffComponent::UniquePtr rootDir = TiffCreator::create(root, ifdIdNotSet);
         if (0 != rootDir.get()) {
-            rootDir->setStart(pData + pHeader->offset());
-            TiffRwState state(pHeader->byteOrder(), 0);
+            rootDir->setStart(pData + pHeader->rootOffset());
             TiffReader reader(pData, size, rootDir.get(), state);
             rootDir->accept(reader);
             reader.postProcess();
@@ -1855,6 +1910,16 @@ namespace Exiv2 {
         offset_ = offset;
     }
 
+    uint64_t TiffHeaderBase::rootOffset() const
+    {
+        return offset();
+    }
+
+    bool TiffHeaderBase::isBigTiff() const
+    {
+        return false;
+    }
+
     uint32_t TiffHeaderBase::size() const
     {
         return size_;
@@ -1968,6 +2033,79 @@ namespace Exiv2 {
     {
     }
 
+    BigTiffHeader::BigTiffHeader(ByteOrder byteOrder)
+        : TiffHeaderBase(43, 16, byteOrder, 0),
+          rootOffset_(16)
+    {
+    }
+
+    BigTiffHeader::~BigTiffHeader()
+    {
+    }
+
+    bool BigTiffHeader::read(const byte* pData, size_t size)
+    {
+        if (!pData || size < 16) return false;
+
+        ByteOrder byteOrder = invalidByteOrder;
+        if (pData[0] == 'I' && pData[0] == pData[1]) {
+            byteOrder = littleEndian;
+        }
+        else if (pData[0] == 'M' && pData[0] == pData[1]) {
+            byteOrder = bigEndian;
+        }
+        else {
+            return false;
+        }
+        // Magic number, size of offsets (always 8) and a reserved zero
+        if (   tag() != getUShort(pData + 2, byteOrder)
+            || getUShort(pData + 4, byteOrder) != 8
+            || getUShort(pData + 6, byteOrder) != 0) return false;
+        setByteOrder(byteOrder);
+        rootOffset_ = getULongLong(pData + 8, byteOrder);
+
+        return true;
+    } // BigTiffHeader::read
+
+    DataBuf BigTiffHeader::write() const
+    {
+        DataBuf buf(16);
+        buf.pData_[0] = byteOrder() == bigEndian ? 'M' : 'I';
+        buf.pData_[1] = buf.pData_[0];
+        us2Data(buf.pData_ + 2, tag(), byteOrder());
+        us2Data(buf.pData_ + 4, 8, byteOrder());
+        us2Data(buf.pData_ + 6, 0, byteOrder());
+        ull2Data(buf.pData_ + 8, 16, byteOrder());
+        return buf;
+    }
+
+    void BigTiffHeader::print(std::ostream& os, const std::string& prefix) const
+    {
+        std::ios::fmtflags f( os.flags() );
+        os << prefix
+           << _("BigTIFF header, offset") << " = 0x"
+           << std::setw(16) << std::setfill('0') << std::hex << std::right
+           << rootOffset_;
+
+        switch (byteOrder()) {
+        case littleEndian:     os << ", " << _("little endian encoded"); break;
+        case bigEndian:        os << ", " << _("big endian encoded");    break;
+        case invalidByteOrder: break;
+        }
+        os << "\n";
+        os.flags(f);
+    } // BigTiffHeader::print
+
+    uint64_t BigTiffHeader::rootOffset() const
+    {
+        return rootOffset_;
+    }
+
+    bool BigTiffHeader::isBigTiff() const
+    {
+        return true;
+    }
+
     bool TiffHeader::isImageTag(      uint16_t       tag,
                                       IfdId          group,
                                 const PrimaryGroups* pPrimaryGroups) const
@@ -107,6 +107,14 @@ namespace Exiv2 {
         virtual ByteOrder byteOrder() const;
         //! Return the offset to the start of the root directory.
         virtual uint32_t offset() const;
+        /*!
+          @brief Return the offset to the start of the root directory for
+                 reading. The default implementation returns offset(), the
+                 BigTIFF header returns its 64-bit offset.
+         */
+        virtual uint64_t rootOffset() const;
+        //! Return true if the IFDs following the header use the BigTIFF layout.
+        virtual bool isBigTiff() const;
         //! Return the size (in bytes) of the image header.
         virtual uint32_t size() const;
         //! Return the tag value (magic number) which identifies the buffer as TIFF data.
@@ -166,6 +174,36 @@ namespace Exiv2 {
         bool           hasImageTags_;   //!< Indicates if image tags are supported
     }; // class TiffHeader
 
+    /*!
+      @brief BigTIFF header structure, with a 64-bit offset to the root
+             directory. Used to read the metadata of BigTIFF images.
+     */
+    class BigTiffHeader : public TiffHeaderBase {
+    public:
+        //! @name Creators
+        //@{
+        //! Default constructor
+        explicit BigTiffHeader(ByteOrder byteOrder =littleEndian);
+        //! Destructor
+        ~BigTiffHeader();
+        //@}
+        //! @name Manipulators
+        //@{
+        bool read(const byte* pData, size_t size) override;
+        //@}
+        //! @name Accessors
+        //@{
+        DataBuf write() const override;
+        void print(std::ostream& os, const std::string& prefix ="") const override;
+        uint64_t rootOffset() const override;
+        bool isBigTiff() const override;
+        //@}
+
+    private:
+        // DATA
+        uint64_t rootOffset_;           //!< 64-bit offset to the start of the root dir
+    }; // class BigTiffHeader
+
     /*!
       @brief Data structure used to list image tags for TIFF and TIFF-like images.
      */
@@ -341,6 +379,8 @@ namespace Exiv2 {
           @param size      Length of the data buffer.
           @param root      Root tag of the TIFF tree.
           @param pHeader   Pointer to a TIFF header.
+          @param threads   Number of threads to read the subtrees with, see
+                           TiffParser::setDecodeThreads().
           @return          An auto pointer with the root element of the TIFF
                            composite structure. If \em pData is 0 or \em size
                            is 0, the return value is a 0 pointer.
@@ -349,7 +389,8 @@ namespace Exiv2 {
             const byte*              pData,
                   size_t             size,
                   uint32_t           root,
-                  TiffHeaderBase*    pHeader
+                  TiffHeaderBase*    pHeader,
+                  unsigned int       threads =1
         );
         /*!
           @brief Find primary groups in the source tree provided and populate
@@ -0,0 +1,205 @@
+// ***************************************************************** -*- C++ -*-
+/*
+ * Copyright (C) 2004-2018 Exiv2 authors
+ * This program is part of the Exiv2 distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, 5th Floor, Boston, MA 02110-1301 USA.
+ */
+// *****************************************************************************
+// included header files
+#include "tifftasks_int.hpp"
+
+// + standard includes
+#include <algorithm>
+#include <system_error>
+#include <thread>
+
+// *****************************************************************************
+// local declarations
+namespace {
+    //! Messages collected by the LogCapture of the thread
+    thread_local Exiv2::Internal::LogMessages* capturedMessages = 0;
+
+    //! Thread log handler of LogCapture
+    void captureHandler(int level, const char* s)
+    {
+        capturedMessages->push_back(std::make_pair(level, std::string(s)));
+    }
+}
+
+// *****************************************************************************
+// class member definitions
+namespace Exiv2 {
+    namespace Internal {
+
+    LogCapture::LogCapture(LogMessages& messages)
+        : pPrevMessages_(capturedMessages), prevHandler_(LogMsg::threadHandler())
+    {
+        capturedMessages = &messages;
+        LogMsg::setThreadHandler(captureHandler);
+    }
+
+    LogCapture::~LogCapture()
+    {
+        capturedMessages = pPrevMessages_;
+        LogMsg::setThreadHandler(prevHandler_);
+    }
+
+    void logMessages(const LogMessages& messages, size_t first, size_t count)
+    {
+        LogMsg::Handler handler = LogMsg::threadHandler();
+        if (handler == 0) handler = LogMsg::handler();
+        if (handler == 0) return;
+        for (size_t i = first; i < first + count && i < messages.size(); ++i) {
+            handler(messages[i].first, messages[i].second.c_str());
+        }
+    }
+
+    /*!
+      @brief The worker threads of the process. Each task queued posts its
+             queue, a worker runs the next task of the queue posted first.
+             The workers wait for more tasks when there are none, they are
+             not stopped.
+     */
+    class TiffWorkers {
+    public:
+        //! Return the workers of the process
+        static TiffWorkers& instance();
+        //! Post \em queue for a task, start a worker if none is idle and there are less than \em maxWorkers
+        void post(TiffTaskQueue* queue, size_t maxWorkers);
+        //! Remove the posts of \em queue and wait for the workers which run one of its tasks
+        void cancel(TiffTaskQueue* queue);
+
+    private:
+        //! The loop of a worker thread
+        void work();
+
+        // DATA
+        std::mutex mutex_;
+        std::condition_variable posted_;       //!< Signals new posts
+        std::condition_variable done_;         //!< Signals that a worker has run a post
+        std::deque<TiffTaskQueue*> queues_;    //!< Posted queues
+        std::vector<TiffTaskQueue*> running_;  //!< Queues of which the workers run a task
+        size_t workers_{0};                    //!< Number of workers
+        size_t idle_{0};                       //!< Number of workers waiting for posts
+    };
+
+    TiffWorkers& TiffWorkers::instance()
+    {
+        // Never destroyed, the workers wait on it until the process ends
+        static TiffWorkers* workers = new TiffWorkers;
+        return *workers;
+    }
+
+    void TiffWorkers::post(TiffTaskQueue* queue, size_t maxWorkers)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queues_.push_back(queue);
+            if (idle_ == 0 && workers_ < maxWorkers) {
+                try {
+                    std::thread(&TiffWorkers::work, this).detach();
+                    ++workers_;
+                }
+                catch (const std::system_error&) {
+                    // Run the tasks with the threads we have
+                }
+            }
+        }
+        posted_.notify_one();
+    }
+
+    void TiffWorkers::cancel(TiffTaskQueue* queue)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        queues_.erase(std::remove(queues_.begin(), queues_.end(), queue), queues_.end());
+        while (std::find(running_.begin(), running_.end(), queue) != running_.end()) {
+            done_.wait(lock);
+        }
+    }
+
+    void TiffWorkers::work()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            if (queues_.empty()) {
+                ++idle_;
+                posted_.wait(lock);
+                --idle_;
+                continue;
+            }
+            TiffTaskQueue* const queue = queues_.front();
+            queues_.pop_front();
+            running_.push_back(queue);
+            lock.unlock();
+            queue->runQueued();
+            lock.lock();
+            running_.erase(std::find(running_.begin(), running_.end(), queue));
+            done_.notify_all();
+        }
+    }
+
+    TiffTaskQueue::TiffTaskQueue(unsigned int threads)
+        : pending_(0), maxWorkers_(threads > 1 ? threads - 1 : 0)
+    {
+    }
+
+    TiffTaskQueue::~TiffTaskQueue()
+    {
+        wait();
+        // Posts left are for tasks which the waiting thread ran
+        TiffWorkers::instance().cancel(this);
+    }
+
+    void TiffTaskQueue::push(Task task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+            ++pending_;
+        }
+        TiffWorkers::instance().post(this, maxWorkers_);
+    }
+
+    void TiffTaskQueue::wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (pending_ > 0) {
+            if (tasks_.empty()) {
+                cond_.wait(lock);
+            }
+            else {
+                runNext(lock);
+            }
+        }
+    }
+
+    void TiffTaskQueue::runNext(std::unique_lock<std::mutex>& lock)
+    {
+        Task task = std::move(tasks_.front());
+        tasks_.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+        if (--pending_ == 0) cond_.notify_all();
+    }
+
+    void TiffTaskQueue::runQueued()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!tasks_.empty()) runNext(lock);
+    }
+
+}}                                      // namespace Internal, Exiv2
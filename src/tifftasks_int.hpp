@@ -0,0 +1,128 @@
+// ***************************************************************** -*- C++ -*-
+/*
+ * Copyright (C) 2004-2018 Exiv2 authors
+ * This program is part of the Exiv2 distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, 5th Floor, Boston, MA 02110-1301 USA.
+ */
+/*!
+  @file    tifftasks_int.hpp
+  @brief   Internal task queue and log message buffers, to read and decode the
+           subtrees of a TIFF structure in parallel, see
+           TiffParser::setDecodeThreads().
+ */
+#pragma once
+
+// *****************************************************************************
+// included header files
+#include "error.hpp"
+
+// + standard includes
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// *****************************************************************************
+// namespace extensions
+namespace Exiv2 {
+    namespace Internal {
+
+// *****************************************************************************
+// class definitions
+
+    //! Log messages, their level and text, in the order they were logged
+    typedef std::vector<std::pair<int, std::string> > LogMessages;
+
+    /*!
+      @brief Collect the log messages of the calling thread instead of logging
+             them, as long as the object lives. A task uses this to log its
+             messages later, in the order of a sequential traversal.
+     */
+    class LogCapture {
+    public:
+        //! Collect the log messages of the calling thread in \em messages
+        explicit LogCapture(LogMessages& messages);
+        //! Log messages of the calling thread as before
+        ~LogCapture();
+        LogCapture(const LogCapture& rhs) = delete;
+        LogCapture& operator=(const LogCapture& rhs) = delete;
+
+    private:
+        // DATA
+        LogMessages* const pPrevMessages_; //!< Messages collected before
+        const LogMsg::Handler prevHandler_; //!< Thread log handler before
+    };
+
+    /*!
+      @brief Log the \em first \em count messages of \em messages with the log
+             message handler of the calling thread.
+     */
+    void logMessages(const LogMessages& messages, size_t first, size_t count);
+
+    class TiffWorkers;
+
+    /*!
+      @brief A queue of tasks, which are run by the worker threads of the
+             process and by the thread which waits for them. Workers are
+             started as tasks are queued, up to one less than the maximum
+             number of threads, and are shared by all queues, so that reading
+             the metadata of an image doesn't start threads of its own. Tasks
+             may queue more tasks.
+     */
+    class TiffTaskQueue {
+    public:
+        //! A task, it must not throw
+        typedef std::function<void()> Task;
+
+        //! @name Creators
+        //@{
+        //! Constructor, \em threads is the maximum number of threads, including the waiting one
+        explicit TiffTaskQueue(unsigned int threads);
+        //! Destructor, waits for the tasks
+        ~TiffTaskQueue();
+        TiffTaskQueue(const TiffTaskQueue& rhs) = delete;
+        TiffTaskQueue& operator=(const TiffTaskQueue& rhs) = delete;
+        //@}
+
+        //! @name Manipulators
+        //@{
+        //! Queue \em task
+        void push(Task task);
+        //! Run tasks in the calling thread until all tasks are done
+        void wait();
+        //@}
+
+    private:
+        friend class TiffWorkers;
+
+        //! Run the next task, called with \em lock held
+        void runNext(std::unique_lock<std::mutex>& lock);
+        //! Run the next task, if there is one left, called by a worker
+        void runQueued();
+
+        // DATA
+        std::mutex mutex_;
+        std::condition_variable cond_;  //!< Signals done tasks
+        std::deque<Task> tasks_;        //!< Queued tasks
+        size_t pending_;                //!< Number of queued and running tasks
+        const size_t maxWorkers_;       //!< Maximum number of workers
+    };
+
+}}                                      // namespace Internal, Exiv2
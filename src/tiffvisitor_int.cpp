@@ -43,6 +43,7 @@
 #include <string>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 #include <cassert>
 #include <limits>
 #include <ostream>
@@ -121,6 +122,10 @@ namespace Exiv2 {
     {
     }
 
+    void TiffVisitor::visitSubtree(TiffComponent* /*object*/)
+    {
+    }
+
     void TiffFinder::init(uint16_t tag, IfdId group)
     {
         tag_ = tag;
@@ -191,6 +196,70 @@ namespace Exiv2 {
         findObject(object);
     }
 
+    TiffDirEntryCollector::~TiffDirEntryCollector()
+    {
+    }
+
+    void TiffDirEntryCollector::visitEntry(TiffEntry* /*object*/)
+    {
+    }
+
+    void TiffDirEntryCollector::visitDataEntry(TiffDataEntry* /*object*/)
+    {
+    }
+
+    void TiffDirEntryCollector::visitImageEntry(TiffImageEntry* /*object*/)
+    {
+    }
+
+    void TiffDirEntryCollector::visitSizeEntry(TiffSizeEntry* /*object*/)
+    {
+    }
+
+    void TiffDirEntryCollector::visitDirectory(TiffDirectory* /*object*/)
+    {
+    }
+
+    void TiffDirEntryCollector::visitDirectoryNext(TiffDirectory* object)
+    {
+        // Same layout as assumed by TiffEncoder::visitDirectoryNext
+        byte* p = object->start() + 2;
+        for (TiffDirectory::Components::iterator i = object->components_.begin();
+             i != object->components_.end(); ++i, p += 12) {
+            if (!isExifIfd((*i)->group())) continue;
+            TiffEntryBase* pTiffEntry = dynamic_cast<TiffEntryBase*>(*i);
+            DirEntry dirEntry = { pTiffEntry, p };
+            auto rc = dirEntries_.insert(std::make_pair(std::make_pair((*i)->tag(), (*i)->group()), dirEntry));
+            if (!rc.second) rc.first->second.object_ = 0;
+        }
+    }
+
+    void TiffDirEntryCollector::visitSubIfd(TiffSubIfd* /*object*/)
+    {
+    }
+
+    void TiffDirEntryCollector::visitMnEntry(TiffMnEntry* /*object*/)
+    {
+    }
+
+    void TiffDirEntryCollector::visitIfdMakernote(TiffIfdMakernote* /*object*/)
+    {
+    }
+
+    void TiffDirEntryCollector::visitBinaryArray(TiffBinaryArray* /*object*/)
+    {
+    }
+
+    void TiffDirEntryCollector::visitBinaryElement(TiffBinaryElement* /*object*/)
+    {
+    }
+
+    const TiffDirEntryCollector::DirEntry* TiffDirEntryCollector::find(uint16_t tag, IfdId group) const
+    {
+        DirEntries::const_iterator pos = dirEntries_.find(std::make_pair(tag, group));
+        return pos == dirEntries_.end() ? 0 : &pos->second;
+    }
+
     TiffCopier::TiffCopier(      TiffComponent*  pRoot,
                                  uint32_t        root,
                            const TiffHeaderBase* pHeader,
@@ -288,7 +357,10 @@ namespace Exiv2 {
           xmpData_(xmpData),
           pRoot_(pRoot),
           findDecoderFct_(findDecoderFct),
-          decodedIptc_(false)
+          decodedIptc_(false),
+          pTasks_(0),
+          task_(false),
+          failed_(false)
     {
         assert(pRoot != 0);
 
@@ -305,10 +377,112 @@ namespace Exiv2 {
         }
     }
 
+    //! The metadata containers of a subtree and the metadata decoded before it
+    struct TiffDecoder::Task {
+        ExifData before_;                     //!< Exif metadata decoded before the subtree
+        size_t logPos_;                       //!< Number of log messages before the subtree
+        ExifData exifData_;                   //!< Exif metadata of the subtree
+        IptcData iptcData_;                   //!< IPTC metadata of the subtree, stays empty
+        XmpData xmpData_;                     //!< XMP metadata of the subtree, stays empty
+        std::unique_ptr<TiffDecoder> decoder_; //!< Decoder of the subtree
+    };
+
+    TiffDecoder::TiffDecoder(const TiffDecoder& parent,
+                             ExifData&          exifData,
+                             IptcData&          iptcData,
+                             XmpData&           xmpData)
+        : exifData_(exifData),
+          iptcData_(iptcData),
+          xmpData_(xmpData),
+          pRoot_(parent.pRoot_),
+          findDecoderFct_(parent.findDecoderFct_),
+          make_(parent.make_),
+          decodedIptc_(parent.decodedIptc_),
+          pTasks_(parent.pTasks_),
+          task_(true),
+          failed_(false)
+    {
+        setGo(geSubtrees, false);
+    }
+
     TiffDecoder::~TiffDecoder()
     {
     }
 
+    void TiffDecoder::setTasks(TiffTaskQueue* tasks)
+    {
+        pTasks_ = tasks;
+        setGo(geSubtrees, tasks == 0);
+    }
+
+    void TiffDecoder::run(TiffComponent* object)
+    {
+        LogCapture capture(messages_);
+        try {
+            object->accept(*this);
+        }
+        catch (...) {
+            // Decoding again in place reports the error
+            failed_ = true;
+        }
+    }
+
+    void TiffDecoder::visitSubtree(TiffComponent* object)
+    {
+        assert(object != 0);
+        assert(pTasks_ != 0);
+
+        std::unique_ptr<Task> task(new Task);
+        task->before_.append(exifData_);
+        task->logPos_ = messages_.size();
+        task->decoder_.reset(new TiffDecoder(*this, task->exifData_, task->iptcData_, task->xmpData_));
+        TiffDecoder* const decoder = task->decoder_.get();
+        tasks_.push_back(std::move(task));
+        pTasks_->push([decoder, object] { decoder->run(object); });
+    }
+
+    bool TiffDecoder::merge(ExifData& exifData, LogMessages& messages, std::vector<std::string>& keys)
+    {
+        if (failed_) return false;
+        size_t logPos = 0;
+        for (auto&& task : tasks_) {
+            exifData.append(task->before_);
+            messages.insert(messages.end(), messages_.begin() + logPos, messages_.begin() + task->logPos_);
+            logPos = task->logPos_;
+            if (!task->decoder_->merge(exifData, messages, keys)) return false;
+        }
+        exifData.append(exifData_);
+        messages.insert(messages.end(), messages_.begin() + logPos, messages_.end());
+        keys.insert(keys.end(), keys_.begin(), keys_.end());
+        return true;
+    }
+
+    bool TiffDecoder::mergeTasks()
+    {
+        ExifData exifData;
+        LogMessages messages;
+        std::vector<std::string> keys;
+        const bool merged = merge(exifData, messages, keys);
+        setTasks(0);
+        tasks_.clear();
+        if (!merged) return false;
+        // A task only finds the keys of its own metadata, decoding in place
+        // would have found those of the others
+        for (auto&& key : keys) {
+            const auto sameKey = [&key](const Exifdatum& md) { return md.key() == key; };
+            if (std::count_if(exifData.begin(), exifData.end(), sameKey) > 1) return false;
+        }
+        exifData_.append(exifData);
+        logMessages(messages, 0, messages.size());
+        return true;
+    }
+
+    Exifdatum& TiffDecoder::exifDatum(const std::string& key)
+    {
+        if (pTasks_) keys_.push_back(key);
+        return exifData_[key];
+    }
+
     void TiffDecoder::visitEntry(TiffEntry* object)
     {
         decodeTiffEntry(object);
@@ -349,13 +523,13 @@ namespace Exiv2 {
     {
         assert(object != 0);
 
-        exifData_["Exif.MakerNote.Offset"] = object->mnOffset();
+        exifDatum("Exif.MakerNote.Offset") = object->mnOffset();
         switch (object->byteOrder()) {
         case littleEndian:
-            exifData_["Exif.MakerNote.ByteOrder"] = "II";
+            exifDatum("Exif.MakerNote.ByteOrder") = "II";
             break;
         case bigEndian:
-            exifData_["Exif.MakerNote.ByteOrder"] = "MM";
+            exifDatum("Exif.MakerNote.ByteOrder") = "MM";
             break;
         case invalidByteOrder:
             assert(object->byteOrder() != invalidByteOrder);
@@ -386,6 +560,8 @@ namespace Exiv2 {
 
     void TiffDecoder::decodeXmp(const TiffEntryBase* object)
     {
+        // The XMP packet belongs to the metadata containers of the image
+        if (task_) failed_ = true;
         // add Exif tag anyway
         decodeStdTiffEntry(object);
 
@@ -413,6 +589,8 @@ namespace Exiv2 {
 
     void TiffDecoder::decodeIptc(const TiffEntryBase* object)
     {
+        // The IPTC data belongs to the metadata containers of the image
+        if (task_) failed_ = true;
         // add Exif tag anyway
         decodeStdTiffEntry(object);
 
@@ -530,7 +708,7 @@ namespace Exiv2 {
                 }
 
                 v->read(s.str());
-                exifData_[familyGroup + pTag->name_] = *v;
+                exifDatum(familyGroup + pTag->name_) = *v;
             }
         }
     }
@@ -1209,6 +1387,53 @@ namespace Exiv2 {
 
     } // TiffEncoder::add
 
+    bool TiffEncoder::encodeModified()
+    {
+        assert(!isNewImage_);
+
+        TiffDirEntryCollector collector;
+        pRoot_->accept(collector);
+
+        // IPTC and XMP tags which encodeIptc() and encodeXmp() removed need to be deleted
+        static const uint16_t packetTags[] = { 0x02bc, 0x83bb, 0x8649 };
+        for (auto&& tag : packetTags) {
+            if (   collector.find(tag, ifd0Id) != 0
+                && exifData_.findKey(ExifKey(tag, groupName(ifd0Id))) == exifData_.end()) {
+                return false;
+            }
+        }
+
+        std::map<std::pair<uint16_t, int>, int> keyCount;
+        for (auto&& datum : exifData_) {
+            ++keyCount[std::make_pair(datum.tag(), datum.ifdId())];
+        }
+        typedef std::pair<const Exifdatum*, const TiffDirEntryCollector::DirEntry*> Update;
+        std::vector<Update> updates;
+        for (auto&& datum : exifData_) {
+            if (!datum.modified()) continue;
+            const IfdId group = static_cast<IfdId>(datum.ifdId());
+            if (!isExifIfd(group)) return false;
+            if (keyCount[std::make_pair(datum.tag(), datum.ifdId())] != 1) return false;
+            const TiffDirEntryCollector::DirEntry* dirEntry = collector.find(datum.tag(), group);
+            if (dirEntry == 0 || dirEntry->object_ == 0) return false;
+            // Image tags of the existing image are not encoded
+            if (isImageTag(datum.tag(), group)) continue;
+            if (   dynamic_cast<TiffEntry*>(dirEntry->object_) == 0
+                || findEncoderFct_(make_, datum.tag(), group) != 0
+                || datum.size() > dirEntry->object_->size_) {
+                return false;
+            }
+            updates.push_back(Update(&datum, dirEntry));
+        }
+
+        for (auto&& update : updates) {
+            TiffEntryBase* object = update.second->object_;
+            object->updateValue(update.first->getValue(), byteOrder());
+            updateDirEntry(update.second->pDirEntry_, byteOrder(), object);
+        }
+        return true;
+    } // TiffEncoder::encodeModified
+
     TiffReader::TiffReader(const byte*    pData,
                            size_t size,
                            TiffComponent* pRoot,
@@ -1219,7 +1444,12 @@ namespace Exiv2 {
           pRoot_(pRoot),
           origState_(state),
           mnState_(state),
-          postProc_(false)
+          postProc_(false),
+          pTasks_(0),
+          failed_(false),
+          mnTask_(-1),
+          makeKnown_(false),
+          hasMake_(false)
     {
         pState_ = &origState_;
         assert(pData_);
@@ -1227,10 +1457,158 @@ namespace Exiv2 {
 
     } // TiffReader::TiffReader
 
+    //! A reader of a subtree and where it was found
+    struct TiffReader::Task {
+        size_t postPos_;                     //!< Size of the postList_ before the subtree
+        size_t logPos_;                      //!< Number of log messages before the subtree
+        bool mnState_;                       //!< True if the makernote state was in effect
+        std::unique_ptr<TiffReader> reader_; //!< Reader of the subtree
+    };
+
+    //! The results of all readers in the order of reading in place
+    struct TiffReader::Merge {
+        DirList dirList_;                               //!< IFD pointers of all readers
+        IdxSeq idxSeq_;                                 //!< Sequences of all readers
+        std::map<uint16_t, const TiffReader*> groups_;  //!< The readers of the groups
+        PostList postList_;                             //!< Deferred components of all readers
+        LogMessages messages_;                          //!< Log messages of all readers
+        const TiffRwState* pMnState_;                   //!< The makernote state set last, if any
+        int mnStates_;                                  //!< Number of readers which set a makernote state
+    };
+
     TiffReader::~TiffReader()
     {
     }
 
+    void TiffReader::setTasks(TiffTaskQueue* tasks)
+    {
+        pTasks_ = tasks;
+        setGo(geSubtrees, tasks == 0);
+    }
+
+    void TiffReader::run(TiffComponent* object)
+    {
+        LogCapture capture(messages_);
+        try {
+            object->accept(*this);
+        }
+        catch (...) {
+            // Reading again in place reports the error
+            failed_ = true;
+        }
+    }
+
+    void TiffReader::visitSubtree(TiffComponent* object)
+    {
+        assert(object != 0);
+        assert(pTasks_ != 0);
+
+        std::unique_ptr<Task> task(new Task);
+        task->postPos_ = postList_.size();
+        task->logPos_ = messages_.size();
+        task->mnState_ = pState_ == &mnState_;
+        // The task continues in the state of this reader
+        TiffReader* const reader = new TiffReader(pData_, size_, object, origState_);
+        task->reader_.reset(reader);
+        reader->mnState_ = mnState_;
+        if (task->mnState_) reader->pState_ = &reader->mnState_;
+        reader->setTasks(pTasks_);
+        reader->hasMake_ = findMake(reader->make_);
+        reader->makeKnown_ = true;
+        tasks_.push_back(std::move(task));
+        pTasks_->push([reader, object] { reader->run(object); });
+    }
+
+    bool TiffReader::merge(Merge& merge) const
+    {
+        if (failed_ || !go(geKnownMakernote)) return false;
+        // A directory read twice is ignored the second time when reading in place
+        for (auto&& dir : dirList_) {
+            if (!merge.dirList_.insert(dir).second) return false;
+        }
+        // Components of a group must be read, numbered and searched by one reader
+        std::vector<uint16_t> groups;
+        for (auto&& seq : idxSeq_) groups.push_back(seq.first);
+        for (auto&& dir : dirList_) groups.push_back(static_cast<uint16_t>(dir.second));
+        for (auto&& group : lookups_) groups.push_back(static_cast<uint16_t>(group));
+        for (auto&& group : groups) {
+            const auto pos = merge.groups_.insert(std::make_pair(group, this)).first;
+            if (pos->second != this) return false;
+        }
+        merge.idxSeq_.insert(idxSeq_.begin(), idxSeq_.end());
+
+        size_t postPos = 0;
+        size_t logPos = 0;
+        for (size_t i = 0; i <= tasks_.size(); ++i) {
+            const bool last = i == tasks_.size();
+            const size_t postEnd = last ? postList_.size() : tasks_[i]->postPos_;
+            const size_t logEnd = last ? messages_.size() : tasks_[i]->logPos_;
+            merge.postList_.insert(merge.postList_.end(), postList_.begin() + postPos, postList_.begin() + postEnd);
+            merge.messages_.insert(merge.messages_.end(), messages_.begin() + logPos, messages_.begin() + logEnd);
+            postPos = postEnd;
+            logPos = logEnd;
+            if (mnTask_ == static_cast<int>(i)) {
+                merge.pMnState_ = &mnState_;
+                ++merge.mnStates_;
+            }
+            if (last) break;
+
+            const Task& task = *tasks_[i];
+            const int mnStates = merge.mnStates_;
+            if (!task.reader_->merge(merge)) return false;
+            // Reading in place continues in the state the subtree ends with
+            const TiffReader& reader = *task.reader_;
+            if ((reader.pState_ == &reader.mnState_) != task.mnState_) return false;
+            if (task.mnState_ && merge.mnStates_ != mnStates) return false;
+        }
+        return true;
+    }
+
+    bool TiffReader::mergeTasks()
+    {
+        Merge merge;
+        merge.pMnState_ = 0;
+        merge.mnStates_ = 0;
+        const bool merged = this->merge(merge);
+        if (merged) {
+            dirList_.swap(merge.dirList_);
+            idxSeq_.swap(merge.idxSeq_);
+            postList_.swap(merge.postList_);
+            if (merge.pMnState_) mnState_ = *merge.pMnState_;
+            logMessages(merge.messages_, 0, merge.messages_.size());
+        }
+        setTasks(0);
+        tasks_.clear();
+        messages_.clear();
+        lookups_.clear();
+        return merged;
+    }
+
+    TiffComponent* TiffReader::findObject(uint16_t tag, IfdId group)
+    {
+        TiffFinder finder(tag, group);
+        if (pTasks_) {
+            finder.setGo(geSubtrees, false);
+            lookups_.push_back(group);
+        }
+        pRoot_->accept(finder);
+        return finder.result();
+    }
+
+    bool TiffReader::findMake(std::string& make)
+    {
+        if (makeKnown_) {
+            make = make_;
+            return hasMake_;
+        }
+        TiffEntryBase* te = dynamic_cast<TiffEntryBase*>(findObject(0x010f, ifd0Id));
+        if (te && te->pValue()) {
+            make = te->pValue()->toString();
+            return true;
+        }
+        return false;
+    }
+
     void TiffReader::setOrigState()
     {
         pState_ = &origState_;
@@ -1246,6 +1624,7 @@ namespace Exiv2 {
             else {
                 mnState_ = *state;
             }
+            mnTask_ = static_cast<int>(tasks_.size());
         }
         pState_ = &mnState_;
     }
@@ -1262,14 +1641,24 @@ namespace Exiv2 {
         return pState_->baseOffset();
     }
 
+    bool TiffReader::bigTiff() const
+    {
+        assert(pState_);
+        return pState_->bigTiff();
+    }
+
+    uint64_t TiffReader::absoluteOffset(uint64_t offset) const
+    {
+        if (bigTiff()) return baseOffset() + offset;
+        return static_cast<uint32_t>(baseOffset() + offset);
+    }
+
     void TiffReader::readDataEntryBase(TiffDataEntryBase* object)
     {
         assert(object != 0);
 
         readTiffEntry(object);
-        TiffFinder finder(object->szTag(), object->szGroup());
-        pRoot_->accept(finder);
-        TiffEntryBase* te = dynamic_cast<TiffEntryBase*>(finder.result());
+        TiffEntryBase* te = dynamic_cast<TiffEntryBase*>(findObject(object->szTag(), object->szGroup()));
         if (te && te->pValue()) {
             object->setStrips(te->pValue(), pData_, size_, baseOffset());
         }
@@ -1295,9 +1684,7 @@ namespace Exiv2 {
         assert(object != 0);
 
         readTiffEntry(object);
-        TiffFinder finder(object->dtTag(), object->dtGroup());
-        pRoot_->accept(finder);
-        TiffDataEntryBase* te = dynamic_cast<TiffDataEntryBase*>(finder.result());
+        TiffDataEntryBase* te = dynamic_cast<TiffDataEntryBase*>(findObject(object->dtTag(), object->dtGroup()));
         if (te && te->pValue()) {
             te->setStrips(object->pValue(), pData_, size_, baseOffset());
         }
@@ -1342,15 +1729,20 @@ namespace Exiv2 {
 
         if (circularReference(object->start(), object->group())) return;
 
-        if (p + 2 > pLast_) {
+        // BigTIFF IFDs have 8 byte entry counts and next pointers and 20 byte entries
+        const size_t countSize = bigTiff() ? 8 : 2;
+        const size_t entrySize = bigTiff() ? 20 : 12;
+        const size_t nextSize  = bigTiff() ? 8 : 4;
+
+        if (p + countSize > pLast_) {
 #ifndef SUPPRESS_WARNINGS
             EXV_ERROR << "Directory " << groupName(object->group())
                       << ": IFD exceeds data buffer, cannot read entry count.\n";
 #endif
             return;
         }
-        const uint16_t n = getUShort(p, byteOrder());
-        p += 2;
+        const uint64_t n = bigTiff() ? getULongLong(p, byteOrder()) : getUShort(p, byteOrder());
+        p += countSize;
         // Sanity check with an "unreasonably" large number
         if (n > 256) {
 #ifndef SUPPRESS_WARNINGS
@@ -1360,7 +1752,7 @@ namespace Exiv2 {
             return;
         }
         for (uint16_t i = 0; i < n; ++i) {
-            if (p + 12 > pLast_) {
+            if (p + entrySize > pLast_) {
 #ifndef SUPPRESS_WARNINGS
                 EXV_ERROR << "Directory " << groupName(object->group())
                           << ": IFD entry " << i
@@ -1376,11 +1768,11 @@ namespace Exiv2 {
             } else {
                EXV_WARNING << "Unable to handle tag " << tag << ".\n";
             }
-            p += 12;
+            p += entrySize;
         }
 
         if (object->hasNext()) {
-            if (p + 4 > pLast_) {
+            if (p + nextSize > pLast_) {
 #ifndef SUPPRESS_WARNINGS
                 EXV_ERROR << "Directory " << groupName(object->group())
                           << ": IFD exceeds data buffer, cannot read next pointer.\n";
@@ -1388,7 +1780,7 @@ namespace Exiv2 {
                 return;
             }
             TiffComponent::UniquePtr tc;
-            uint32_t next = getLong(p, byteOrder());
+            const uint64_t next = bigTiff() ? getULongLong(p, byteOrder()) : getULong(p, byteOrder());
             if (next) {
                 tc = TiffCreator::create(Tag::next, object->group());
 #ifndef SUPPRESS_WARNINGS
@@ -1399,7 +1791,7 @@ namespace Exiv2 {
 #endif
             }
             if (tc.get()) {
-                if (baseOffset() + next > size_) {
+                if (absoluteOffset(next) > size_) {
 #ifndef SUPPRESS_WARNINGS
                     EXV_ERROR << "Directory " << groupName(object->group())
                               << ": Next pointer is out of bounds; ignored.\n";
@@ -1418,15 +1810,17 @@ namespace Exiv2 {
         assert(object != 0);
 
         readTiffEntry(object);
+        const bool ifd8 = object->tiffType() == ttUnsignedLongLong || object->tiffType() == ttTiffIfd8;
         if (   (object->tiffType() == ttUnsignedLong || object->tiffType() == ttSignedLong
-                || object->tiffType() == ttTiffIfd)
+                || object->tiffType() == ttTiffIfd || ifd8)
             && object->count() >= 1) {
             // Todo: Fix hack
             uint32_t maxi = 9;
             if (object->group() == ifd1Id) maxi = 1;
             for (uint32_t i = 0; i < object->count(); ++i) {
-                uint32_t offset = getLong(object->pData() + 4*i, byteOrder());
-                if (   baseOffset() + offset > size_ ) {
+                const uint64_t offset = ifd8 ? getULongLong(object->pData() + 8*i, byteOrder())
+                                             : getULong(object->pData() + 4*i, byteOrder());
+                if (   absoluteOffset(offset) > size_ ) {
 #ifndef SUPPRESS_WARNINGS
                     EXV_ERROR << "Directory " << groupName(object->group())
                               << ", entry 0x" << std::setw(4)
@@ -1469,12 +1863,8 @@ namespace Exiv2 {
 
         readTiffEntry(object);
         // Find camera make
-        TiffFinder finder(0x010f, ifd0Id);
-        pRoot_->accept(finder);
-        TiffEntryBase* te = dynamic_cast<TiffEntryBase*>(finder.result());
         std::string make;
-        if (te && te->pValue()) {
-            make = te->pValue()->toString();
+        if (findMake(make)) {
             // create concrete makernote, based on make and makernote contents
             object->mn_ = TiffMnCreator::create(object->tag(),
                                                 object->mnGroup_,
@@ -1532,7 +1922,9 @@ namespace Exiv2 {
         byte* p = object->start();
         assert(p >= pData_);
 
-        if (p + 12 > pLast_) {
+        // BigTIFF entries have 8 byte counts and offsets, which hold values of up to 8 bytes
+        const size_t fieldSize = bigTiff() ? 8 : 4;
+        if (p + 4 + 2 * fieldSize > pLast_) {
 #ifndef SUPPRESS_WARNINGS
             EXV_ERROR << "Entry in directory " << groupName(object->group())
                       << "requests access to memory beyond the data buffer. "
@@ -1556,30 +1948,31 @@ namespace Exiv2 {
             typeSize = 1;
         }
         p += 2;
-        uint32_t count = getULong(p, byteOrder());
-        if (count >= 0x10000000) {
+        const uint64_t count64 = bigTiff() ? getULongLong(p, byteOrder()) : getULong(p, byteOrder());
+        if (count64 >= 0x10000000) {
 #ifndef SUPPRESS_WARNINGS
             EXV_ERROR << "Directory " << groupName(object->group())
                       << ", entry 0x" << std::setw(4)
                       << std::setfill('0') << std::hex << object->tag()
                       << " has invalid size "
-                      << std::dec << count << "*" << typeSize
+                      << std::dec << count64 << "*" << typeSize
                       << "; skipping entry.\n";
 #endif
             return;
         }
-        p += 4;
+        const uint32_t count = static_cast<uint32_t>(count64);
+        p += fieldSize;
         size_t isize= 0; // size of Exif.Sony1.PreviewImage
 
         if (count > std::numeric_limits<uint32_t>::max() / typeSize) {
             throw Error(kerArithmeticOverflow);
         }
         size_t size = typeSize * count;
-        uint32_t offset = getLong(p, byteOrder());
+        const uint64_t offset = bigTiff() ? getULongLong(p, byteOrder()) : getULong(p, byteOrder());
         byte* pData = p;
-        if (   size > 4
-            && (   baseOffset() + offset >= size_
-                || static_cast<int32_t>(baseOffset()) + offset <= 0)) {
+        if (   size > fieldSize
+            && (   absoluteOffset(offset) >= size_
+                || absoluteOffset(offset) == 0)) {
                 // #1143
                 if ( object->tag() == 0x2001 && std::string(groupName(object->group())) == "Sony1" ) {
                     isize=size;
@@ -1596,7 +1989,7 @@ namespace Exiv2 {
                 }
                 size = 0;
         }
-        if (size > 4) {
+        if (size > fieldSize) {
             // setting pData to pData_ + baseOffset() + offset can result in pData pointing to invalid memory,
             // as offset can be arbitrarily large
             if ((static_cast<uintptr_t>(baseOffset()) > std::numeric_limits<uintptr_t>::max() - static_cast<uintptr_t>(offset))
@@ -1644,7 +2037,7 @@ namespace Exiv2 {
 
         object->setValue(std::move(v));
         object->setData(pData, (int32_t)size);
-        object->setOffset(offset);
+        object->setOffset(static_cast<int64_t>(offset));
         object->setIdx(nextIdx(object->group()));
 
     } // TiffReader::readTiffEntry
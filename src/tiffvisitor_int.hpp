@@ -31,6 +31,7 @@
 // included header files
 #include "exif.hpp"
 #include "tifffwd_int.hpp"
+#include "tifftasks_int.hpp"
 #include "types.hpp"
 
 // + standard includes
@@ -40,6 +41,7 @@
 #include <cassert>
 #include <map>
 #include <set>
+#include <string>
 #include <vector>
 
 // *****************************************************************************
@@ -76,12 +78,14 @@ namespace Exiv2 {
             //! Signal to control traversing of the composite tree.
             geTraverse       = 0,
             //! Signal used by TiffReader to signal an unknown makernote.
-            geKnownMakernote = 1
+            geKnownMakernote = 1,
+            //! Signal to visit sub-IFDs and makernotes in place, else visitSubtree() is called.
+            geSubtrees       = 2
             // Note: If you add more events here, adjust the events_ constant too!
         };
 
     private:
-        static const int events_ = 2;  //!< The number of stop/go flags.
+        static const int events_ = 3;  //!< The number of stop/go flags.
         bool go_[events_];             //!< Array of stop/go flags. See setGo().
 
     public:
@@ -102,7 +106,10 @@ namespace Exiv2 {
           events. Specifically, TiffFinder sets the geTraverse flag as soon as
           it finds the correct component to signal to components that the search
           should be aborted. TiffReader uses geKnownMakernote to signal problems
-          reading a makernote to the TiffMnEntry component. There is an array
+          reading a makernote to the TiffMnEntry component. Visitors which
+          process the sub-IFDs and makernotes as separate tasks clear
+          geSubtrees, the components then pass these subtrees to
+          visitSubtree() instead of visiting them. There is an array
           of flags, one for each defined \em event, so different signals can be
           used independent of each other.
          */
@@ -144,6 +151,12 @@ namespace Exiv2 {
         virtual void visitBinaryArrayEnd(TiffBinaryArray* object);
         //! Operation to perform for an element of a binary array
         virtual void visitBinaryElement(TiffBinaryElement* object) =0;
+        /*!
+          @brief Operation to perform for a sub-IFD or makernote \em object,
+                 which is not visited in place because geSubtrees is clear.
+                 The default does nothing, i.e., skips the subtree.
+         */
+        virtual void visitSubtree(TiffComponent* object);
         //@}
 
         //! @name Accessors
@@ -215,6 +228,68 @@ namespace Exiv2 {
         TiffComponent* tiffComponent_;
     }; // class TiffFinder
 
+    /*!
+      @brief Collect the entries of the Exif IFDs of a parsed composite together
+             with the location of their IFD entry, to update single entries
+             without encoding the whole tree.
+    */
+    class TiffDirEntryCollector : public TiffVisitor {
+    public:
+        //! A TIFF entry and its 12 byte IFD entry
+        struct DirEntry {
+            TiffEntryBase* object_;     //!< The TIFF entry, 0 if there are several with the same tag and group
+            byte*          pDirEntry_;  //!< Start of the IFD entry
+        };
+
+        //! @name Creators
+        //@{
+        //! Default constructor
+        TiffDirEntryCollector() {}
+        //! Virtual destructor
+        ~TiffDirEntryCollector() override;
+        //@}
+
+        //! @name Manipulators
+        //@{
+        //! Nothing to do for a TIFF entry
+        void visitEntry(TiffEntry* object) override;
+        //! Nothing to do for a TIFF data entry
+        void visitDataEntry(TiffDataEntry* object) override;
+        //! Nothing to do for a TIFF image entry
+        void visitImageEntry(TiffImageEntry* object) override;
+        //! Nothing to do for a TIFF size entry
+        void visitSizeEntry(TiffSizeEntry* object) override;
+        //! Nothing to do for a TIFF directory
+        void visitDirectory(TiffDirectory* object) override;
+        //! Collect the entries of a directory
+        void visitDirectoryNext(TiffDirectory* object) override;
+        //! Nothing to do for a TIFF sub-IFD
+        void visitSubIfd(TiffSubIfd* object) override;
+        //! Nothing to do for a TIFF makernote
+        void visitMnEntry(TiffMnEntry* object) override;
+        //! Nothing to do for an IFD makernote
+        void visitIfdMakernote(TiffIfdMakernote* object) override;
+        //! Nothing to do for a binary array
+        void visitBinaryArray(TiffBinaryArray* object) override;
+        //! Nothing to do for an element of a binary array
+        void visitBinaryElement(TiffBinaryElement* object) override;
+        //@}
+
+        //! @name Accessors
+        //@{
+        /*!
+          @brief Return the entry with \em tag and \em group. Return 0 if
+                 there is no such entry and a DirEntry with object_ 0 if
+                 there are several.
+         */
+        const DirEntry* find(uint16_t tag, IfdId group) const;
+        //@}
+
+    private:
+        typedef std::map<std::pair<uint16_t, IfdId>, DirEntry> DirEntries;
+        DirEntries dirEntries_; //!< Entries of the Exif IFDs by tag and group
+    }; // class TiffDirEntryCollector
+
     /*!
       @brief Copy all image tags from the source tree (the tree that is traversed) to a
              target tree, which is empty except for the root element provided in the
@@ -333,11 +408,57 @@ namespace Exiv2 {
         void decodeXmp(const TiffEntryBase* object);
         //! Decode Exif.Canon.AFInfo
         void decodeCanonAFInfo(const TiffEntryBase* object);
+
+        /*!
+          @brief Decode the sub-IFDs and makernotes as tasks of \em tasks,
+                 into metadata containers of their own, instead of in place.
+                 Decode the composite with run() and call mergeTasks() when
+                 the tasks are done.
+         */
+        void setTasks(TiffTaskQueue* tasks);
+        /*!
+          @brief Decode the subtree \em object, collect the log messages and
+                 remember if it threw an exception. Used to decode with tasks.
+         */
+        void run(TiffComponent* object);
+        //! Queue a task to decode the subtree \em object
+        void visitSubtree(TiffComponent* object) override;
+        /*!
+          @brief Add the metadata decoded by the tasks to the metadata
+                 containers, after the tasks are done, in the order in which
+                 decoding in place adds it, and log the messages in the same
+                 order. Return false if that isn't possible, e.g., because a
+                 task failed. The composite must then be decoded again without
+                 tasks, the metadata containers hold part of the metadata.
+         */
+        bool mergeTasks();
         //@}
 
     private:
+        //! A subtree which is decoded by a task
+        struct Task;
+        typedef std::vector<std::unique_ptr<Task> > Tasks;
+
+        //! @name Creators
+        //@{
+        //! Constructor of the decoder of a subtree for the \em parent decoder
+        TiffDecoder(const TiffDecoder& parent,
+                    ExifData&          exifData,
+                    IptcData&          iptcData,
+                    XmpData&           xmpData);
+        //@}
+
         //! @name Manipulators
         //@{
+        //! Return the Exifdatum with \em key, add one if there is none
+        Exifdatum& exifDatum(const std::string& key);
+        /*!
+          @brief Move the metadata of the decoder and its tasks to \em exifData
+                 and their messages to \em messages, in the order of decoding
+                 in place. Add the keys looked up with exifDatum() to \em keys.
+                 Return false if a task failed.
+         */
+        bool merge(ExifData& exifData, LogMessages& messages, std::vector<std::string>& keys);
         /*!
           @brief Get the data for a \em tag and \em group, either from the
                  \em object provided, if it matches or from the matching element
@@ -362,6 +483,12 @@ namespace Exiv2 {
         const FindDecoderFct findDecoderFct_; //!< Ptr to the function to find special decoding functions
         std::string make_;           //!< Camera make, determined from the tags to decode
         bool decodedIptc_;           //!< Indicates if IPTC has been decoded yet
+        TiffTaskQueue* pTasks_;      //!< Queue for the tasks of the subtrees, 0 to decode them in place
+        const bool task_;            //!< True if the decoder decodes a subtree for another decoder
+        bool failed_;                //!< True if decoding with run() threw an exception
+        Tasks tasks_;                //!< Subtrees decoded by tasks, in the order they were found
+        LogMessages messages_;       //!< Log messages collected by run()
+        std::vector<std::string> keys_; //!< Keys looked up with exifDatum() while decoding with tasks
 
     }; // class TiffDecoder
 
@@ -500,6 +627,22 @@ namespace Exiv2 {
             TiffComponent* pSourceDir,
             uint32_t       root
         );
+        /*!
+          @brief Encode only the metadata which was modified since it was
+                 read from the composite tree, for non-intrusive writing.
+
+          Instead of visiting the tree, the entries of the modified metadata
+          are looked up and updated in place. This is possible only if all
+          modified metadata belong to existing plain entries in the Exif IFDs
+          and fit into them. Nothing is changed if it is not possible.
+
+          @note The Exif data must have been decoded from the composite, see
+                ExifData::setOrigin().
+
+          @return true if the metadata was encoded, false if the tree needs to
+                  be visited.
+         */
+        bool encodeModified();
         //! Set the dirty flag and end of traversing signal.
         void setDirty(bool flag =true);
         //@}
@@ -590,9 +733,11 @@ namespace Exiv2 {
         //@{
         //! Constructor.
         TiffRwState(ByteOrder byteOrder,
-                    uint32_t  baseOffset)
+                    uint32_t  baseOffset,
+                    bool      bigTiff =false)
             : byteOrder_(byteOrder),
-              baseOffset_(baseOffset) {}
+              baseOffset_(baseOffset),
+              bigTiff_(bigTiff) {}
         //@}
 
         //! @name Accessors
@@ -614,11 +759,19 @@ namespace Exiv2 {
           to the basis for such makernote offsets.
          */
         uint32_t           baseOffset() const { return baseOffset_; }
+        /*!
+          @brief Return true if IFDs use the BigTIFF layout: 8 byte entry
+                 counts and next pointers and 20 byte entries with 8 byte
+                 counts and offsets. Makernote IFDs always use the
+                 standard TIFF layout.
+         */
+        bool               bigTiff()    const { return bigTiff_; }
         //@}
 
     private:
         ByteOrder byteOrder_;
         uint32_t  baseOffset_;
+        bool      bigTiff_;
     }; // TiffRwState
 
     /*!
@@ -698,6 +851,31 @@ namespace Exiv2 {
           at the time the deferred components are processed.
          */
         void postProcess();
+
+        /*!
+          @brief Read the sub-IFDs and makernotes as tasks of \em tasks
+                 instead of in place. Read the composite with run() and call
+                 mergeTasks() when the tasks are done.
+         */
+        void setTasks(TiffTaskQueue* tasks);
+        /*!
+          @brief Read the subtree \em object, collect the log messages and
+                 remember if it threw an exception. Used to read with tasks.
+         */
+        void run(TiffComponent* object);
+        //! Queue a task to read the subtree \em object
+        void visitSubtree(TiffComponent* object) override;
+        /*!
+          @brief Take over the results of the tasks, after they are done, as
+                 if the subtrees had been read in place, and log the messages
+                 in the same order. Return false if that isn't possible,
+                 because a task failed or the subtrees depend on each other,
+                 e.g., share directories or groups. The composite must then be
+                 read again without tasks.
+
+          Call postProcess() after this, as after reading in place.
+         */
+        bool mergeTasks();
         //@}
 
         //! @name Accessors
@@ -706,12 +884,35 @@ namespace Exiv2 {
         ByteOrder byteOrder() const;
         //! Return the base offset. See class TiffRwState for details
         uint32_t baseOffset() const;
+        //! Return true if IFDs use the BigTIFF layout. See class TiffRwState for details
+        bool bigTiff() const;
+        /*!
+          @brief Return the base offset plus \em offset. The sum wraps around
+                 at 32 bits, unless IFDs use the BigTIFF layout.
+         */
+        uint64_t absoluteOffset(uint64_t offset) const;
         //@}
 
     private:
         typedef std::map<const byte*, IfdId> DirList;
         typedef std::map<uint16_t, int> IdxSeq;
         typedef std::vector<TiffComponent*> PostList;
+        //! A subtree which is read by a task
+        struct Task;
+        typedef std::vector<std::unique_ptr<Task> > Tasks;
+        //! The results of all readers, collected by mergeTasks()
+        struct Merge;
+
+        /*!
+          @brief Find the component with \em tag and \em group. While reading
+                 with tasks, only the components of this reader are searched,
+                 since other tasks may be reading the subtrees.
+         */
+        TiffComponent* findObject(uint16_t tag, IfdId group);
+        //! Find the camera make in IFD0, return false if there is none
+        bool findMake(std::string& make);
+        //! Add the results of this reader and its tasks to \em merge, return false if they conflict
+        bool merge(Merge& merge) const;
 
         // DATA
         const byte*          pData_;      //!< Pointer to the memory buffer
@@ -725,6 +926,15 @@ namespace Exiv2 {
         IdxSeq               idxSeq_;     //!< Sequences for group, used for the entry's idx
         PostList             postList_;   //!< List of components with deferred reading
         bool                 postProc_;   //!< True in postProcessList()
+        TiffTaskQueue*       pTasks_;     //!< Queue for the tasks of the subtrees, 0 to read them in place
+        bool                 failed_;     //!< True if reading with run() threw an exception
+        int                  mnTask_;     //!< Number of tasks when setMnState() last set a state, -1 if never
+        bool                 makeKnown_;  //!< True if hasMake_ and make_ are taken over from the parent reader
+        bool                 hasMake_;    //!< True if IFD0 has a camera make, if makeKnown_
+        std::string          make_;       //!< Camera make, if makeKnown_
+        Tasks                tasks_;      //!< Subtrees read by tasks, in the order they were found
+        LogMessages          messages_;   //!< Log messages collected by run()
+        std::vector<IfdId>   lookups_;    //!< Groups searched by findObject() while reading with tasks
     }; // class TiffReader
 
 }}                                      // namespace Internal, Exiv2
@@ -87,6 +87,9 @@ namespace {
         { Exiv2::tiffFloat,        "Float",       4 },
         { Exiv2::tiffDouble,       "Double",      8 },
         { Exiv2::tiffIfd,          "Ifd",         4 },
+        { Exiv2::unsignedLongLong, "LongLong",    8 },
+        { Exiv2::signedLongLong,   "SLongLong",   8 },
+        { Exiv2::tiffIfd8,         "Ifd8",        8 },
         { Exiv2::string,           "String",      1 },
         { Exiv2::date,             "Date",        8 },
         { Exiv2::time,             "Time",       11 },
@@ -445,6 +448,15 @@ namespace Exiv2 {
         return 4;
     }
 
+    long ull2Data(byte* buf, uint64_t l, ByteOrder byteOrder)
+    {
+        for (int i = 0; i < 8; ++i) {
+            const int shift = byteOrder == littleEndian ? 8 * i : 8 * (7 - i);
+            buf[i] = (byte)((l >> shift) & 0xff);
+        }
+        return 8;
+    }
+
     long ur2Data(byte* buf, URational l, ByteOrder byteOrder)
     {
         long o = ul2Data(buf, l.first, byteOrder);
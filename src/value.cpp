@@ -137,6 +137,13 @@ namespace Exiv2 {
         case tiffDouble:
             value = UniquePtr(new ValueType<double>);
             break;
+        case unsignedLongLong:
+        case tiffIfd8:
+            value = UniquePtr(new ValueType<uint64_t>(typeId));
+            break;
+        case signedLongLong:
+            value = UniquePtr(new ValueType<int64_t>);
+            break;
         case string:
             value = UniquePtr(new StringValue);
             break;
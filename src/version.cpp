@@ -263,6 +263,12 @@ void Exiv2::dumpLibraryInfo(std::ostream& os,const exv_grep_keys_t& keys)
     constexpr int enable_webready = 0;
 #endif
 
+#ifdef EXV_ENABLE_STATS
+    constexpr int enable_stats = 1;
+#else
+    constexpr int enable_stats = 0;
+#endif
+
 #ifdef EXV_ENABLE_NLS
     constexpr int enable_nls = 1;
 #else
@@ -328,6 +334,7 @@ void Exiv2::dumpLibraryInfo(std::ostream& os,const exv_grep_keys_t& keys)
     output(os,keys,"have_unicode_path" ,have_unicode_path);
     output(os,keys,"enable_webready"   ,enable_webready  );
     output(os,keys,"enable_nls"        ,enable_nls       );
+    output(os,keys,"enable_stats"      ,enable_stats     );
     output(os,keys,"use_curl"          ,use_curl         );
 
     output(os,keys,"config_path"       ,Exiv2::Internal::getExiv2ConfigPath());
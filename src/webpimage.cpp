@@ -33,6 +33,7 @@
 #include "image_int.hpp"
 #include "enforce.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 #include "basicio.hpp"
 #include "tags.hpp"
 #include "tags_int.hpp"
@@ -42,6 +43,7 @@
 #include "convert.hpp"
 #include "safe_op.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <string>
@@ -53,6 +55,27 @@
 
 #define CHECK_BIT(var,pos) ((var) & (1<<(pos)))
 
+// *****************************************************************************
+// local declarations
+namespace {
+    /*!
+      @brief Write a chunk with \em tag and the \em size bytes of \em data to
+             \em out with one call. Pad odd sized data with a null byte.
+     */
+    void writeChunk(Exiv2::BasicIo& out, const char* tag, const Exiv2::byte* data, size_t size)
+    {
+        Exiv2::byte head[8];
+        std::memcpy(head, tag, 4);
+        Exiv2::ul2Data(head + 4, static_cast<uint32_t>(size), Exiv2::littleEndian);
+        static const Exiv2::byte pad = 0;
+        const Exiv2::IoBlock blocks[] = {{head, 8}, {data, size}, {&pad, 1}};
+        const size_t count = (out.tell() + 8 + size) % 2 ? 3 : 2;
+        const size_t total = count == 3 ? 8 + size + 1 : 8 + size;
+        if (out.writev(blocks, count) != total)
+            throw Exiv2::Error(Exiv2::kerImageWriteFailed);
+    }
+}
+
 // *****************************************************************************
 // class member definitions
 namespace Exiv2 {
@@ -114,6 +137,7 @@ namespace Exiv2 {
 
     void WebPImage::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
         if (io_->open() != 0) {
             throw Error(kerDataSourceOpenFailed, io_->path(), strError());
         }
@@ -183,10 +207,11 @@ namespace Exiv2 {
             io_->read(chunkId.pData_, WEBP_TAG_SIZE);
             io_->read(size_buff, WEBP_TAG_SIZE);
             long size = Exiv2::getULong(size_buff, littleEndian);
-            DataBuf payload(size);
-            io_->read(payload.pData_, payload.size_);
-            byte c;
-            if ( payload.size_ % 2 ) io_->read(&c,1);
+            // Only the start of the payload is inspected, skip the rest and the padding byte
+            DataBuf payload(WEBP_TAG_SIZE * 3);
+            const long start = std::min(size, static_cast<long>(payload.size_));
+            io_->read(payload.pData_, start);
+            io_->seek(size - start + size % 2, BasicIo::cur);
 
             /* Chunk with information about features
              used in the file. */
@@ -309,6 +334,30 @@ namespace Exiv2 {
 
             long size = Exiv2::getULong(size_buff, littleEndian);
 
+            if (!io_->eof() && !equalsWebPTag(chunkId, WEBP_CHUNK_HEADER_VP8X) &&
+                !equalsWebPTag(chunkId, WEBP_CHUNK_HEADER_ICCP) && !equalsWebPTag(chunkId, WEBP_CHUNK_HEADER_EXIF) &&
+                !equalsWebPTag(chunkId, WEBP_CHUNK_HEADER_XMP)) {
+                // Copy all other chunks, like the image data, without reading them into a buffer
+                const size_t chunkSize = 8 + static_cast<size_t>(size);
+                io_->seek(-8, BasicIo::cur);
+                const size_t copied = outIo.copyRange(*io_, chunkSize);
+                if (copied != chunkSize) {
+                    if (io_->error() || !io_->eof())
+                        throw Error(kerImageWriteFailed);
+                    // Keep the size of a truncated chunk
+                    DataBuf zeros(chunkSize - copied);
+                    if (outIo.write(zeros.pData_, zeros.size_) != zeros.size_)
+                        throw Error(kerImageWriteFailed);
+                }
+                if ( io_->tell() % 2 ) io_->seek(+1,BasicIo::cur); // skip pad
+
+                // Encoder required to pad odd sized data with a null byte
+                if (outIo.tell() % 2) {
+                    if (outIo.write(&WEBP_PAD_ODD, 1) != 1) throw Error(kerImageWriteFailed);
+                }
+                continue;
+            }
+
             DataBuf payload(size);
             io_->read(payload.pData_, size);
             if ( io_->tell() % 2 ) io_->seek(+1,BasicIo::cur); // skip pad
@@ -332,23 +381,10 @@ namespace Exiv2 {
                     payload.pData_[0] &= ~WEBP_VP8X_EXIF_BIT;
                 }
 
-                if (outIo.write(chunkId.pData_, WEBP_TAG_SIZE) != WEBP_TAG_SIZE)
-                    throw Error(kerImageWriteFailed);
-                if (outIo.write(size_buff, WEBP_TAG_SIZE) != WEBP_TAG_SIZE)
-                    throw Error(kerImageWriteFailed);
-                if (outIo.write(payload.pData_, payload.size_) != payload.size_)
-                    throw Error(kerImageWriteFailed);
-                if (outIo.tell() % 2) {
-                    if (outIo.write(&WEBP_PAD_ODD, 1) != 1) throw Error(kerImageWriteFailed);
-                }
+                writeChunk(outIo, WEBP_CHUNK_HEADER_VP8X, payload.pData_, payload.size_);
 
                 if (has_icc) {
-                    if (outIo.write((const byte*)WEBP_CHUNK_HEADER_ICCP, WEBP_TAG_SIZE) != WEBP_TAG_SIZE) throw Error(kerImageWriteFailed);
-                    ul2Data(data, (uint32_t) iccProfile_.size_, littleEndian);
-                    if (outIo.write(data, WEBP_TAG_SIZE) != WEBP_TAG_SIZE) throw Error(kerImageWriteFailed);
-                    if (outIo.write(iccProfile_.pData_, iccProfile_.size_) != iccProfile_.size_) {
-                        throw Error(kerImageWriteFailed);
-                    }
+                    writeChunk(outIo, WEBP_CHUNK_HEADER_ICCP, iccProfile_.pData_, iccProfile_.size_);
                     has_icc = false;
                 }
             } else if (equalsWebPTag(chunkId, WEBP_CHUNK_HEADER_ICCP)) {
@@ -358,12 +394,7 @@ namespace Exiv2 {
             } else if (equalsWebPTag(chunkId, WEBP_CHUNK_HEADER_XMP)) {
                 // Skip and add new data afterwards
             } else {
-                if (outIo.write(chunkId.pData_, WEBP_TAG_SIZE) != WEBP_TAG_SIZE)
-                    throw Error(kerImageWriteFailed);
-                if (outIo.write(size_buff, WEBP_TAG_SIZE) != WEBP_TAG_SIZE)
-                    throw Error(kerImageWriteFailed);
-                if (outIo.write(payload.pData_, payload.size_) != payload.size_)
-                    throw Error(kerImageWriteFailed);
+                writeChunk(outIo, reinterpret_cast<const char*>(chunkId.pData_), payload.pData_, payload.size_);
             }
 
             // Encoder required to pad odd sized data with a null byte
@@ -373,29 +404,11 @@ namespace Exiv2 {
         }
 
         if (has_exif) {
-            if (outIo.write((const byte*)WEBP_CHUNK_HEADER_EXIF, WEBP_TAG_SIZE) != WEBP_TAG_SIZE) throw Error(kerImageWriteFailed);
-            us2Data(data, (uint16_t) blob.size()+8, bigEndian);
-            ul2Data(data, (uint32_t) blob.size(), littleEndian);
-            if (outIo.write(data, WEBP_TAG_SIZE) != WEBP_TAG_SIZE) throw Error(kerImageWriteFailed);
-            if (outIo.write((const byte*)&blob[0], blob.size()) != blob.size())
-            {
-                throw Error(kerImageWriteFailed);
-            }
-            if (outIo.tell() % 2) {
-                if (outIo.write(&WEBP_PAD_ODD, 1) != 1) throw Error(kerImageWriteFailed);
-            }
+            writeChunk(outIo, WEBP_CHUNK_HEADER_EXIF, &blob[0], blob.size());
         }
 
         if (has_xmp) {
-            if (outIo.write((const byte*)WEBP_CHUNK_HEADER_XMP, WEBP_TAG_SIZE) != WEBP_TAG_SIZE) throw Error(kerImageWriteFailed);
-            ul2Data(data, (uint32_t) xmpPacket().size(), littleEndian);
-            if (outIo.write(data, WEBP_TAG_SIZE) != WEBP_TAG_SIZE) throw Error(kerImageWriteFailed);
-            if (outIo.write((const byte*)xmp.data(), xmp.size()) != xmp.size()) {
-                throw Error(kerImageWriteFailed);
-            }
-            if (outIo.tell() % 2) {
-                if (outIo.write(&WEBP_PAD_ODD, 1) != 1) throw Error(kerImageWriteFailed);
-            }
+            writeChunk(outIo, WEBP_CHUNK_HEADER_XMP, reinterpret_cast<const byte*>(xmp.data()), xmp.size());
         }
 
         // Fix File Size Payload Data
@@ -421,7 +434,8 @@ namespace Exiv2 {
         }
 
         bool bPrint  = option==kpsBasic || option==kpsRecursive;
-        if ( bPrint || option == kpsXMP || option == kpsIccProfile || option == kpsIptcErase ) {
+        bool bJson   = option==kpsJson;
+        if ( bPrint || option == kpsXMP || option == kpsIccProfile || option == kpsIptcErase || bJson ) {
             byte      data [WEBP_TAG_SIZE * 2];
             io_->read(data, WEBP_TAG_SIZE * 2);
             uint64_t filesize = Exiv2::getULong(data + WEBP_TAG_SIZE, littleEndian);
@@ -437,6 +451,9 @@ namespace Exiv2 {
                 << Internal::stringFormat(" Chunk |   Length |   Offset | Payload")
                 << std::endl;
             }
+            if ( bJson ) {
+                Internal::JsonRecord("WebP", "structure", depth).add("path", io().path()).write(out);
+            }
 
             io_->seek(0,BasicIo::beg); // rewind
             while ( !io_->eof() && (uint64_t) io_->tell() < filesize) {
@@ -454,8 +471,15 @@ namespace Exiv2 {
                     << Internal::binaryToString(makeSlice(payload, 0, payload.size_ > 32 ? 32 : payload.size_))
                     << std::endl;
                 }
+                if ( bJson ) {
+                    Internal::JsonRecord("WebP", "chunk", depth)
+                        .add("address", offset)
+                        .add("type", (const char*)chunkId.pData_)
+                        .add("length", (uint32_t)size)
+                        .write(out);
+                }
 
-                if ( equalsWebPTag(chunkId, WEBP_CHUNK_HEADER_EXIF) && option==kpsRecursive ) {
+                if ( equalsWebPTag(chunkId, WEBP_CHUNK_HEADER_EXIF) && (option==kpsRecursive || bJson) ) {
                     // create memio object with the payload, then print the structure
                     BasicIo::UniquePtr p = BasicIo::UniquePtr(new MemIo(payload.pData_,payload.size_));
                     printTiffStructure(*p,out,option,depth);
@@ -477,6 +501,7 @@ namespace Exiv2 {
 
     void WebPImage::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
         if (io_->open() != 0) throw Error(kerDataSourceOpenFailed, io_->path(), strError());
         IoCloser closer(*io_);
         // Ensure that this is the correct image type
@@ -29,6 +29,10 @@
 #include "error.hpp"
 #include "value.hpp"
 #include "properties.hpp"
+#include "metadatum_int.hpp"
+#include "rdfreader_int.hpp"
+#include "rdfwriter_int.hpp"
+#include "stats_int.hpp"
 
 // + standard includes
 #include <iostream>
@@ -97,6 +101,23 @@ namespace {
     //! Make an XMP key from a schema namespace and property path
     Exiv2::XmpKey::UniquePtr makeXmpKey(const std::string& schemaNs,
                                       const std::string& propPath);
+
+#ifndef EXV_ADOBE_XMPSDK
+    //! Get the prefix the XMP toolkit has registered for a namespace, without the colon
+    bool xmpToolkitPrefix(const std::string& ns, std::string& prefix);
+
+    //! Check if a top-level property can be decoded by the streaming RDF reader, i.e., it is no alias
+    bool isPlainXmpProperty(const std::string& ns, const std::string& name);
+
+    //! Get the namespace the XMP toolkit has registered for a prefix without the colon
+    bool xmpToolkitNamespace(const std::string& prefix, std::string& ns);
+
+    //! Get the version message the XMP toolkit writes to the x:xmptk attribute
+    std::string xmpToolkitVersion();
+
+    //! Registry lookups for the RDF writer, using the XMP toolkit
+    const Exiv2::Internal::RdfRegistry& rdfRegistry();
+#endif
 #endif // EXV_HAVE_XMP_TOOLKIT
 
     //! Helper class used to serialize critical sections
@@ -350,7 +371,7 @@ namespace Exiv2 {
 
     void XmpData::sortByKey()
     {
-        std::sort(xmpMetadata_.begin(), xmpMetadata_.end(), cmpMetadataByKey);
+        Internal::sortByKey(xmpMetadata_);
     }
 
     XmpData::const_iterator XmpData::begin() const
@@ -591,7 +612,9 @@ namespace Exiv2 {
 #ifdef EXV_HAVE_XMP_TOOLKIT
     int XmpParser::decode(      XmpData&     xmpData,
                           const std::string& xmpPacket)
-    { try {
+    {
+        EXV_STATS_TIMER(xmpDecode, xmpPacket.size());
+#ifndef EXV_ADOBE_XMPSDK
         xmpData.clear();
         xmpData.setPacket(xmpPacket);
         if (xmpPacket.empty()) return 0;
@@ -602,6 +625,24 @@ namespace Exiv2 {
 #endif
             return 2;
         }
+        // Most packets only use the common RDF forms, read them without building the toolkit's trees
+        if (Internal::decodeRdf(xmpData, xmpPacket, xmpToolkitPrefix, isPlainXmpProperty)) return 0;
+#endif
+        return Internal::decodeXmpToolkit(xmpData, xmpPacket);
+    } // XmpParser::decode
+
+    int Internal::decodeXmpToolkit(XmpData& xmpData, const std::string& xmpPacket)
+    { try {
+        xmpData.clear();
+        xmpData.setPacket(xmpPacket);
+        if (xmpPacket.empty()) return 0;
+
+        if (!XmpParser::initialize()) {
+#ifndef SUPPRESS_WARNINGS
+            EXV_ERROR << "XMP toolkit initialization failed.\n";
+#endif
+            return 2;
+        }
 
         SXMPMeta meta(xmpPacket.data(), static_cast<XMP_StringLen>(xmpPacket.size()));
         SXMPIterator iter(meta);
@@ -719,7 +760,7 @@ namespace Exiv2 {
         return 3;
     }
 #endif // SUPPRESS_WARNINGS
-    } // XmpParser::decode
+    } // Internal::decodeXmpToolkit
 #else
     int XmpParser::decode(      XmpData&     xmpData,
                           const std::string& xmpPacket)
@@ -739,7 +780,8 @@ namespace Exiv2 {
                           const XmpData&     xmpData,
                                 uint16_t     formatFlags,
                                 uint32_t     padding)
-    { try {
+    {
+        EXV_STATS_TIMER(xmpEncode, 0);
         if (xmpData.empty()) {
             xmpPacket.clear();
             return 0;
@@ -759,6 +801,26 @@ namespace Exiv2 {
 #endif
             registerNs(i->first, i->second.prefix_);
         }
+#ifndef EXV_ADOBE_XMPSDK
+        // Most properties use the common forms, write them without building the toolkit's tree
+        if (Internal::encodeRdf(xmpPacket, xmpData, formatFlags, padding, rdfRegistry())) return 0;
+#endif
+        return Internal::encodeXmpToolkit(xmpPacket, xmpData, formatFlags, padding);
+    } // XmpParser::encode
+
+    int Internal::encodeXmpToolkit(std::string& xmpPacket, const XmpData& xmpData, uint16_t formatFlags, uint32_t padding)
+    { try {
+        if (xmpData.empty()) {
+            xmpPacket.clear();
+            return 0;
+        }
+
+        if (!XmpParser::initialize()) {
+#ifndef SUPPRESS_WARNINGS
+            EXV_ERROR << "XMP toolkit initialization failed.\n";
+#endif
+            return 2;
+        }
         SXMPMeta meta;
         for (XmpData::const_iterator i = xmpData.begin(); i != xmpData.end(); ++i) {
             const std::string ns = XmpProperties::ns(i->groupName());
@@ -817,7 +879,7 @@ namespace Exiv2 {
             throw Error(kerUnhandledXmpdatum, i->tagName(), i->typeName());
         }
         std::string tmpPacket;
-        meta.SerializeToBuffer(&tmpPacket, xmpFormatOptionBits(static_cast<XmpFormatFlags>(formatFlags)), padding); // throws
+        meta.SerializeToBuffer(&tmpPacket, xmpFormatOptionBits(static_cast<XmpParser::XmpFormatFlags>(formatFlags)), padding); // throws
         xmpPacket = tmpPacket;
 
         return 0;
@@ -832,7 +894,7 @@ namespace Exiv2 {
         return 3;
     }
 #endif // SUPPRESS_WARNINGS
-    } // XmpParser::decode
+    } // Internal::encodeXmpToolkit
 #else
     int XmpParser::encode(      std::string& /*xmpPacket*/,
                           const XmpData&     xmpData,
@@ -992,6 +1054,41 @@ namespace {
         }
         return Exiv2::XmpKey::UniquePtr(new Exiv2::XmpKey(prefix, property));
     } // makeXmpKey
+
+#ifndef EXV_ADOBE_XMPSDK
+    bool xmpToolkitPrefix(const std::string& ns, std::string& prefix)
+    {
+        if (!SXMPMeta::GetNamespacePrefix(ns.c_str(), &prefix)) return false;
+        prefix.erase(prefix.size() - 1);
+        return true;
+    }
+
+    bool isPlainXmpProperty(const std::string& ns, const std::string& name)
+    {
+        XMP_OptionBits arrayForm = 0;
+        return !SXMPMeta::ResolveAlias(ns.c_str(), name.c_str(), 0, 0, &arrayForm);
+    }
+
+    bool xmpToolkitNamespace(const std::string& prefix, std::string& ns)
+    {
+        return SXMPMeta::GetNamespaceURI(prefix.c_str(), &ns);
+    }
+
+    std::string xmpToolkitVersion()
+    {
+        XMP_VersionInfo info;
+        SXMPMeta::GetVersionInfo(&info);
+        return info.message;
+    }
+
+    const Exiv2::Internal::RdfRegistry& rdfRegistry()
+    {
+        static const Exiv2::Internal::RdfRegistry registry = {
+            xmpToolkitPrefix, xmpToolkitNamespace, isPlainXmpProperty, xmpToolkitVersion()
+        };
+        return registry;
+    }
+#endif
 #endif // EXV_HAVE_XMP_TOOLKIT
 
 }
@@ -33,6 +33,7 @@
 #include "error.hpp"
 #include "xmp_exiv2.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 #include "convert.hpp"
 
 // + standard includes
@@ -75,6 +76,7 @@ namespace Exiv2 {
 
     void XmpSidecar::readMetadata()
     {
+        EXV_STATS_TIMER(readMetadata, 0);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Reading XMP file " << io_->path() << "\n";
 #endif
@@ -134,6 +136,7 @@ namespace Exiv2 {
 
     void XmpSidecar::writeMetadata()
     {
+        EXV_STATS_TIMER(writeMetadata, 0);
         if (io_->open() != 0) {
             throw Error(kerDataSourceOpenFailed, io_->path(), strError());
         }
@@ -216,16 +219,20 @@ namespace Exiv2 {
          */
         const int32_t len = 80;
         byte buf[len];
+        const int64 pos = iIo.tell();
         iIo.read(buf, xmlHdrCnt + 1);
         if (   iIo.eof()
             && 0 == strncmp(reinterpret_cast<const char*>(buf), xmlHeader, xmlHdrCnt)) {
             return true;
         }
         if (iIo.error() || iIo.eof()) {
+            iIo.seek(pos, BasicIo::beg);
             return false;
         }
         iIo.read(buf + xmlHdrCnt + 1, len - xmlHdrCnt - 1);
         if (iIo.error() || iIo.eof()) {
+            // Rewind, for the checks of other image types
+            iIo.seek(pos, BasicIo::beg);
             return false;
         }
         // Skip leading BOM
@@ -0,0 +1,55 @@
+# -*- coding: utf-8 -*-
+
+import struct
+
+import system_tests
+
+
+class PrintJsonLinesAndBinaryRecords(metaclass=system_tests.CaseMeta):
+
+    Reagan = system_tests.path("$data_path/Reagan.jpg")
+    pentax = system_tests.path("$data_path/exiv2-bug884a.jpg")
+
+    commands = [
+        "$exiv2 -pj -K Exif.Image.Model -K Xmp.xmp.CreateDate $Reagan $pentax",
+        "$exiv2 -pj -g MakerNote $pentax",
+        "$exiv2 -b -pj -K Exif.Photo.MakerNote $pentax",
+        "$exiv2 -pb -K Exif.Image.Model $Reagan",
+        "$exiv2 -pj -K Exif.Image.Artist $Reagan",
+        "$exiv2 -pj -K Exif.Image.HostComputer $Reagan",
+    ]
+
+    stdout = [
+        """{"file":"$Reagan","key":"Exif.Image.Model","type":"Ascii","count":10,"raw":"TklLT04gRDFYAA==","value":"NIKON D1X"}
+{"file":"$Reagan","key":"Xmp.xmp.CreateDate","type":"XmpText","count":25,"raw":"MjAwNC0wNi0yMVQyMzozNzo1MyswMTowMA==","value":"2004-06-21T23:37:53+01:00"}
+{"file":"$pentax","key":"Exif.Image.Model","type":"Ascii","count":20,"raw":"UEVOVEFYICppc3QgREwgICAgIAA=","value":"PENTAX *ist DL     "}
+""",
+        """{"file":"$pentax","key":"Exif.Photo.MakerNote","type":"Undefined","count":12420,"raw":null,"value":null}
+{"file":"$pentax","key":"Exif.MakerNote.Offset","type":"Long","count":1,"raw":"AAACfA==","value":"636"}
+{"file":"$pentax","key":"Exif.MakerNote.ByteOrder","type":"Ascii","count":3,"raw":"TU0A","value":"MM"}
+""",
+        None,
+        None,
+        """{"file":"$Reagan","key":"Exif.Image.Artist","type":"Ascii","count":34,"raw":"UGhvdG9ncmFwaGVyw61zIE1hdGUgM3JkIENsYXNzIChBAA==","value":"Photographerís Mate 3rd Class (A"}
+""",
+        "",
+    ]
+
+    stderr = [""] * 6
+    retval = [0, 0, 0, 0, 0, 1]
+
+    def compare_stdout(self, i, command, got_stdout, expected_stdout):
+        if i == 2:
+            # the value isn't suppressed with -b
+            self.assertTrue(got_stdout.startswith(
+                '{"file":"' + self.pentax + '","key":"Exif.Photo.MakerNote","type":"Undefined","count":12420,'
+                '"raw":"QU9DAE1NAFkAAQAD'))
+            self.assertNotIn('"value":null', got_stdout)
+        elif i == 3:
+            fields = b"".join(
+                struct.pack("<I", len(field)) + field
+                for field in (self.Reagan.encode(), b"Exif.Image.Model", b"NIKON D1X\0", b"NIKON D1X"))
+            record = struct.pack("<HI", 2, 10) + fields
+            self.assertEqual(struct.pack("<I", len(record)) + record, got_stdout.encode())
+        else:
+            super().compare_stdout(i, command, got_stdout, expected_stdout)
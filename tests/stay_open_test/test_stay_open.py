@@ -0,0 +1,45 @@
+# -*- coding: utf-8 -*-
+
+import system_tests
+
+
+@system_tests.CopyFiles("$data_path/exiv2-empty.jpg")
+class StayOpenFromStdin(metaclass=system_tests.CaseMeta):
+
+    filename = system_tests.path("$data_path/exiv2-empty_copy.jpg")
+    Reagan = system_tests.path("$data_path/Reagan.jpg")
+    nosuch = system_tests.path("$data_path/exiv2-nosuch.jpg")
+
+    commands = ["$exiv2 -q -s -"]
+
+    stdin = ["""-pt -K Exif.Image.Model $Reagan
+
+-M"set Exif.Image.Artist 'Mr. Me'" -M'set Exif.Image.Make "Exiv2"' mo $filename
+-pt -g Image $filename
+-Qw $nosuch
+-M"set Exif.Image.Artist X" -pt $Reagan
+"unclosed
+exit
+-pt $Reagan
+"""]
+
+    stdout = ["""Exif.Image.Model                             Ascii      10  NIKON D1X
+{ready 0}
+{ready 0}
+Exif.Image.Make                              Ascii       6  Exiv2
+Exif.Image.Artist                            Ascii       7  Mr. Me
+{ready 0}
+{ready 255}
+Usage: exiv2 [ options ] [ action ] file ...
+
+Manipulate the Exif metadata of images.
+{ready 1}
+{ready 1}
+"""]
+
+    stderr = ["""$nosuch: Failed to open the file
+exiv2: Option -p is not compatible with a previous option
+exiv2: Unbalanced quotes in the command line
+"""]
+
+    retval = [0]
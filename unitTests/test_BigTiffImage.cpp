@@ -0,0 +1,157 @@
+#include <bigtiffimage.hpp> // Unit under test
+
+#include <basicio.hpp>
+#include <error.hpp>
+#include <exif.hpp>
+#include <image.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace Exiv2;
+
+namespace
+{
+    void put16(std::vector<byte>& buf, uint16_t v)
+    {
+        for (int i = 0; i < 2; ++i) buf.push_back(static_cast<byte>(v >> (8 * i)));
+    }
+
+    void put32(std::vector<byte>& buf, uint32_t v)
+    {
+        for (int i = 0; i < 4; ++i) buf.push_back(static_cast<byte>(v >> (8 * i)));
+    }
+
+    void put64(std::vector<byte>& buf, uint64_t v)
+    {
+        for (int i = 0; i < 8; ++i) buf.push_back(static_cast<byte>(v >> (8 * i)));
+    }
+
+    //! Little endian BigTIFF header and IFD0. The Exif IFD and the Model string are at \em exifOffset.
+    std::vector<byte> bigTiffHead(uint64_t exifOffset)
+    {
+        std::vector<byte> buf = {'I', 'I', 0x2b, 0x00, 0x08, 0x00, 0x00, 0x00};
+        put64(buf, 16);
+        put64(buf, 4);
+        // Make, ASCII, value inline
+        put16(buf, 0x010f); put16(buf, 2); put64(buf, 6);
+        const char make[8] = "Canon";
+        buf.insert(buf.end(), make, make + 8);
+        // Model, ASCII, value at the offset
+        put16(buf, 0x0110); put16(buf, 2); put64(buf, 12); put64(buf, exifOffset + 56);
+        // StripByteCounts, LONG8
+        put16(buf, 0x0117); put16(buf, 16); put64(buf, 1); put64(buf, 0x123456789ULL);
+        // ExifTag, IFD8
+        put16(buf, 0x8769); put16(buf, 18); put64(buf, 1); put64(buf, exifOffset);
+        put64(buf, 0);
+        return buf;
+    }
+
+    //! Exif IFD with ExposureTime and ISOSpeedRatings, followed by the Model string
+    std::vector<byte> bigTiffExif()
+    {
+        std::vector<byte> buf;
+        put64(buf, 2);
+        // ExposureTime, RATIONAL, value inline
+        put16(buf, 0x829a); put16(buf, 5); put64(buf, 1); put32(buf, 1); put32(buf, 100);
+        // ISOSpeedRatings, SHORT
+        put16(buf, 0x8827); put16(buf, 3); put64(buf, 1); put64(buf, 400);
+        put64(buf, 0);
+        const char model[12] = "Model 12345";
+        buf.insert(buf.end(), model, model + 12);
+        return buf;
+    }
+
+    void expectExif(ExifData& exifData)
+    {
+        ASSERT_EQ("Canon", exifData["Exif.Image.Make"].toString());
+        ASSERT_EQ("Model 12345", exifData["Exif.Image.Model"].toString());
+        ASSERT_EQ(unsignedLongLong, exifData["Exif.Image.StripByteCounts"].typeId());
+        ASSERT_EQ("4886718345", exifData["Exif.Image.StripByteCounts"].toString());
+        ASSERT_EQ("1/100", exifData["Exif.Photo.ExposureTime"].toString());
+        ASSERT_EQ(400, exifData["Exif.Photo.ISOSpeedRatings"].toLong());
+    }
+}
+
+TEST(ABigTiffImage, readsExifWithLong8AndIfd8Entries)
+{
+    std::vector<byte> data = bigTiffHead(112);
+    ASSERT_EQ(112u, data.size());
+    const std::vector<byte> exif = bigTiffExif();
+    data.insert(data.end(), exif.begin(), exif.end());
+
+    Image::UniquePtr image = ImageFactory::open(&data[0], static_cast<long>(data.size()));
+    ASSERT_EQ(ImageType::bigtiff, image->imageType());
+    image->readMetadata();
+    expectExif(image->exifData());
+    ASSERT_EQ(littleEndian, image->byteOrder());
+}
+
+TEST(ABigTiffImage, readsOffsetsBeyond4GB)
+{
+    if (sizeof(size_t) < 8) return; // the file cannot be memory mapped
+
+    // A sparse file, with the Exif IFD at 5 GB
+    const std::string path("bigtiff-5gb.tif");
+    const uint64_t exifOffset = 5ULL << 30;
+    {
+        std::ofstream file(path.c_str(), std::ios::binary);
+        const std::vector<byte> head = bigTiffHead(exifOffset);
+        file.write(reinterpret_cast<const char*>(&head[0]), head.size());
+        file.seekp(static_cast<std::streamoff>(exifOffset));
+        const std::vector<byte> exif = bigTiffExif();
+        file.write(reinterpret_cast<const char*>(&exif[0]), exif.size());
+        ASSERT_TRUE(file.good());
+    }
+
+    Image::UniquePtr image = ImageFactory::open(path);
+    image->readMetadata();
+    expectExif(image->exifData());
+    image.reset();
+    std::remove(path.c_str());
+}
+
+TEST(ABigTiffImage, cannotWriteMetadata)
+{
+    std::vector<byte> data = bigTiffHead(112);
+    const std::vector<byte> exif = bigTiffExif();
+    data.insert(data.end(), exif.begin(), exif.end());
+
+    Image::UniquePtr image = ImageFactory::open(&data[0], static_cast<long>(data.size()));
+    ASSERT_THROW(image->writeMetadata(), Error);
+}
+
+TEST(ABigTiffImage, printsTheStructureAsJsonLines)
+{
+    std::vector<byte> data = bigTiffHead(112);
+    const std::vector<byte> exif = bigTiffExif();
+    data.insert(data.end(), exif.begin(), exif.end());
+
+    Image::UniquePtr image = ImageFactory::open(&data[0], static_cast<long>(data.size()));
+    std::ostringstream text;
+    image->printStructure(text, kpsBasic);
+    std::ostringstream json;
+    image->printStructure(json, kpsJson);
+
+    std::istringstream lines(json.str());
+    std::string line;
+    std::vector<std::string> records;
+    while (std::getline(lines, line)) records.push_back(line);
+    ASSERT_EQ(8u, records.size());
+    ASSERT_EQ("{\"format\":\"BigTIFF\",\"kind\":\"structure\",\"depth\":0,\"path\":\"MemIo\",\"offset\":16,\"entries\":4}",
+              records[0]);
+    ASSERT_EQ("{\"format\":\"BigTIFF\",\"kind\":\"entry\",\"depth\":0,\"address\":18,\"tag\":271,\"name\":\"Make\","
+              "\"type\":\"ASCII\",\"count\":6,\"value\":\"Canon\"}",
+              records[1]);
+    // the Exif IFD follows the ExifTag entry, one level deeper, like with kpsRecursive
+    ASSERT_NE(std::string::npos, records[4].find("\"name\":\"ExifTag\""));
+    ASSERT_EQ("{\"format\":\"BigTIFF\",\"kind\":\"structure\",\"depth\":1,\"path\":\"MemIo\",\"offset\":112,\"entries\":2}",
+              records[5]);
+    ASSERT_NE(std::string::npos, records[6].find("\"value\":\"1/100\""));
+    // the text output does not recurse
+    ASSERT_NE(std::string::npos, text.str().find("Canon"));
+    ASSERT_EQ(std::string::npos, text.str().find("1/100"));
+}
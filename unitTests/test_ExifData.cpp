@@ -0,0 +1,141 @@
+#include <exif.hpp> // Unit under test
+
+#include <image.hpp>
+#include <makernote_int.hpp>
+#include <value.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+
+using namespace Exiv2;
+using Exiv2::Internal::findIndexedKey;
+
+namespace
+{
+    const std::string testData(TESTDATA_PATH); /// \todo use filesystem library with C++17
+
+    void expectIndexedLikeFindKey(const ExifData& exifData, const std::string& key)
+    {
+        ASSERT_TRUE(exifData.findKey(ExifKey(key)) == findIndexedKey(exifData, key)) << key;
+    }
+}
+
+TEST(ExifData, findsIndexedKeysLikeFindKey)
+{
+    for (auto&& file : {"_DSC8437.exv", "RAW_PENTAX_K100.exv", "exiv2-bug1044.tif"}) {
+        Image::UniquePtr image = ImageFactory::open(testData + "/" + file);
+        image->readMetadata();
+        const ExifData& exifData = image->exifData();
+        for (auto&& exifdatum : exifData) {
+            expectIndexedLikeFindKey(exifData, exifdatum.key());
+        }
+        expectIndexedLikeFindKey(exifData, "Exif.Image.HostComputer");
+    }
+}
+
+TEST(ExifData, dropsTheKeyIndexWhenMetadataIsAddedErasedOrSorted)
+{
+    ExifData exifData;
+    exifData["Exif.Image.Model"] = "first";
+    exifData["Exif.Image.Make"] = "Make";
+    const ExifData& data = exifData;
+    ASSERT_EQ("first", findIndexedKey(data, "Exif.Image.Model")->toString());
+    ASSERT_TRUE(findIndexedKey(data, "Exif.Image.Artist") == data.end());
+
+    exifData.add(ExifKey("Exif.Image.Artist"), AsciiValue("Me").clone().get());
+    exifData.add(ExifKey("Exif.Image.Model"), AsciiValue("second").clone().get());
+    ASSERT_EQ("Me", findIndexedKey(data, "Exif.Image.Artist")->toString());
+    ASSERT_EQ("first", findIndexedKey(data, "Exif.Image.Model")->toString());
+
+    exifData.erase(exifData.findKey(ExifKey("Exif.Image.Model")));
+    ASSERT_EQ("second", findIndexedKey(data, "Exif.Image.Model")->toString());
+
+    // Values changed through iterators are found, they are not copied to the index
+    exifData.findKey(ExifKey("Exif.Image.Model"))->setValue("third");
+    ASSERT_EQ("third", findIndexedKey(data, "Exif.Image.Model")->toString());
+
+    exifData.sortByKey();
+    expectIndexedLikeFindKey(data, "Exif.Image.Make");
+    ExifData copy(exifData);
+    expectIndexedLikeFindKey(copy, "Exif.Image.Make");
+    ASSERT_TRUE(findIndexedKey(copy, "Exif.Image.Make") != findIndexedKey(data, "Exif.Image.Make"));
+
+    exifData.clear();
+    ASSERT_TRUE(findIndexedKey(data, "Exif.Image.Make") == data.end());
+}
+
+TEST(ExifData, findsIndexedKeysChangedByAssignment)
+{
+    ExifData exifData;
+    exifData["Exif.Image.Model"] = "Model";
+    exifData["Exif.Image.Make"] = "Make";
+    const ExifData& data = exifData;
+    ASSERT_TRUE(findIndexedKey(data, "Exif.Image.Model") != data.end());
+
+    Exifdatum artist(ExifKey("Exif.Image.Artist"));
+    artist.setValue("Me");
+    *exifData.findKey(ExifKey("Exif.Image.Model")) = artist;
+    ASSERT_TRUE(findIndexedKey(data, "Exif.Image.Model") == data.end());
+    ASSERT_EQ("Make", findIndexedKey(data, "Exif.Image.Make")->toString());
+}
+
+TEST(ExifData, appendMovesTheMetadataOfAnotherContainer)
+{
+    ExifData exifData;
+    exifData["Exif.Image.Make"] = "Make";
+    int origin = 0;
+    exifData.setOrigin(&origin);
+    ExifData other;
+    other["Exif.Image.Model"] = "Model";
+    other["Exif.Image.Make"] = "Other";
+    other.setOrigin(&origin);
+    const ExifData& data = exifData;
+    ASSERT_EQ("Make", findIndexedKey(data, "Exif.Image.Make")->toString());
+
+    exifData.append(other);
+    ASSERT_EQ(3, exifData.count());
+    ASSERT_TRUE(other.empty());
+    ASSERT_EQ(0, other.origin());
+    ASSERT_EQ(&origin, exifData.origin());
+    ExifData::const_iterator pos = data.begin();
+    ASSERT_EQ("Make", (pos++)->toString());
+    ASSERT_EQ("Model", pos->toString());
+    ASSERT_TRUE(pos->modified());
+    ASSERT_EQ("Model", findIndexedKey(data, "Exif.Image.Model")->toString());
+    ASSERT_EQ("Make", findIndexedKey(data, "Exif.Image.Make")->toString());
+
+    exifData.append(exifData);
+    ASSERT_EQ(3, exifData.count());
+}
+
+TEST(ExifData, moveTakesTheMetadataWithoutCopyingIt)
+{
+    ExifData exifData;
+    exifData["Exif.Image.Make"] = "Make";
+    exifData["Exif.Image.Model"] = "Model";
+    int origin = 0;
+    exifData.setOrigin(&origin);
+    const Exifdatum* make = &*exifData.begin();
+
+    ExifData moved(std::move(exifData));
+    ASSERT_EQ(2, moved.count());
+    ASSERT_EQ(make, &*moved.begin());
+    ASSERT_EQ(&origin, moved.origin());
+    ASSERT_TRUE(exifData.empty());
+    ASSERT_EQ(0, exifData.origin());
+
+    ExifData assigned;
+    assigned["Exif.Image.Artist"] = "Artist";
+    assigned = std::move(moved);
+    ASSERT_EQ(2, assigned.count());
+    ASSERT_EQ(make, &*assigned.begin());
+    ASSERT_EQ(0, assigned.origin());
+    ASSERT_EQ("Model", assigned.findKey(ExifKey("Exif.Image.Model"))->toString());
+    ASSERT_TRUE(moved.empty());
+
+    // the moved-from containers can be used again
+    exifData["Exif.Image.Make"] = "Other";
+    ASSERT_EQ(1, exifData.count());
+}
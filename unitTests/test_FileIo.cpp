@@ -4,6 +4,7 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <vector>
 
 using namespace Exiv2;
 
@@ -194,6 +195,114 @@ TEST_F(AOpenedFileIo, canBeTransferedToAMemIo)
     ASSERT_EQ(fileSize, mem.size());
 }
 
+TEST(FileIo, receivesTheBlocksOfAMemIoInATransfer)
+{
+    MemIo mem;
+    std::array<byte, 1000> chunk;
+    for (size_t i = 0; i < 300; ++i) {
+        chunk.fill(static_cast<byte>(i));
+        ASSERT_EQ(chunk.size(), mem.write(chunk.data(), chunk.size()));
+    }
+    ASSERT_LT(1u, mem.blocks().size());
+
+    FileIo file(tmpPath);
+    file.transfer(mem);
+    ASSERT_EQ(0, file.open("rb"));
+    ASSERT_EQ(300u * chunk.size(), file.size());
+    ASSERT_EQ(0, file.seek(299 * chunk.size() - 1, BasicIo::beg));
+    ASSERT_EQ(static_cast<byte>(298), file.getb());
+    ASSERT_EQ(static_cast<byte>(299), file.getb());
+    ASSERT_EQ(0, file.close());
+    ASSERT_EQ(0, std::remove(tmpPath.c_str()));
+}
+
+TEST(FileIo, writesAMemIoFromItsPosition)
+{
+    MemIo mem;
+    std::array<byte, 100000> data;
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<byte>(i);
+    }
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(data.size(), mem.write(data.data(), data.size()));
+    }
+    ASSERT_EQ(0, mem.seek(100001, BasicIo::beg));
+
+    FileIo file(tmpPath);
+    ASSERT_EQ(0, file.open("w+b"));
+    ASSERT_EQ(199999u, file.write(mem));
+    ASSERT_EQ(300000, mem.tell());
+    ASSERT_EQ(199999u, file.size());
+    ASSERT_EQ(0, file.seek(0, BasicIo::beg));
+    ASSERT_EQ(1, file.getb());
+    ASSERT_EQ(0, file.close());
+    ASSERT_EQ(0, std::remove(tmpPath.c_str()));
+}
+
+TEST(FileIo, writesSeveralBlocksAtOnce)
+{
+    const byte head[] = {'a', 'b'};
+    const std::vector<byte> payload(10000, 'c');
+    const IoBlock blocks[] = {{head, sizeof(head)}, {payload.data(), payload.size()}, {head, 1}};
+
+    FileIo file(tmpPath);
+    ASSERT_EQ(0, file.open("w+b"));
+    ASSERT_EQ(10003u, file.writev(blocks, 3));
+    ASSERT_EQ(10003, file.tell());
+    ASSERT_EQ(10003u, file.size());
+    ASSERT_EQ(0, file.seek(1, BasicIo::beg));
+    ASSERT_EQ('b', file.getb());
+    ASSERT_EQ(0, file.seek(-1, BasicIo::end));
+    ASSERT_EQ('a', file.getb());
+    ASSERT_EQ(0, file.close());
+    ASSERT_EQ(0, std::remove(tmpPath.c_str()));
+}
+
+TEST(FileIo, copiesARangeOfAnotherFileIo)
+{
+    FileIo src(jpegPath);
+    ASSERT_EQ(0, src.open());
+    ASSERT_EQ(0, src.seek(100, BasicIo::beg));
+    byte expected[2];
+    ASSERT_EQ(2u, src.read(expected, 2));
+    ASSERT_EQ(0, src.seek(-2, BasicIo::cur));
+
+    FileIo file(tmpPath);
+    ASSERT_EQ(0, file.open("w+b"));
+    ASSERT_EQ(1, file.putb(1));
+    ASSERT_EQ(50000u, file.copyRange(src, 50000));
+    ASSERT_EQ(50100, src.tell());
+    ASSERT_EQ(50001, file.tell());
+    // Copy the rest, more than there is
+    ASSERT_EQ(fileSize - 50100, file.copyRange(src, fileSize));
+    ASSERT_EQ(fileSize - 100 + 1, file.size());
+
+    ASSERT_EQ(0, file.seek(1, BasicIo::beg));
+    byte buf[2];
+    ASSERT_EQ(2u, file.read(buf, 2));
+    ASSERT_EQ(expected[0], buf[0]);
+    ASSERT_EQ(expected[1], buf[1]);
+    ASSERT_EQ(0, src.close());
+    ASSERT_EQ(0, file.close());
+    ASSERT_EQ(0, std::remove(tmpPath.c_str()));
+}
+
+TEST(FileIo, copiesARangeOfAMemIo)
+{
+    MemIo mem;
+    const std::vector<byte> data(100000, 5);
+    ASSERT_EQ(data.size(), mem.write(data.data(), data.size()));
+    ASSERT_EQ(0, mem.seek(10, BasicIo::beg));
+
+    FileIo file(tmpPath);
+    ASSERT_EQ(0, file.open("w+b"));
+    ASSERT_EQ(20000u, file.copyRange(mem, 20000));
+    ASSERT_EQ(20010, mem.tell());
+    ASSERT_EQ(20000u, file.size());
+    ASSERT_EQ(0, file.close());
+    ASSERT_EQ(0, std::remove(tmpPath.c_str()));
+}
+
 // -------------------------------------------------------------------------
 
 TEST(readFile, throwsWithNonExistingFile)
@@ -1,11 +1,57 @@
 #include <image.hpp> // Unit under test
 
+#include <basicio.hpp>
 #include <error.hpp> // Need to include this header for the Exiv2::Error exception
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+
 using namespace Exiv2;
 
+namespace
+{
+    //! Image types in the order in which ImageFactory checks them
+    const ImageType checkOrder[] = {
+        ImageType::jpeg, ImageType::exv, ImageType::cr2, ImageType::crw, ImageType::mrw,
+        ImageType::tiff, ImageType::bigtiff, ImageType::webp, ImageType::dng, ImageType::nef,
+        ImageType::pef, ImageType::arw, ImageType::rw2, ImageType::sr2, ImageType::srw,
+        ImageType::orf, ImageType::png, ImageType::pgf, ImageType::raf, ImageType::xmp,
+        ImageType::gif, ImageType::psd, ImageType::tga, ImageType::bmp, ImageType::jp2,
+    };
+
+    //! Detect the image type by calling each type check in turn, -1 if a check throws
+    int checkSequentially(BasicIo& io)
+    {
+        if (io.open() != 0) return static_cast<int>(ImageType::none);
+        IoCloser closer(io);
+        try {
+            for (auto&& type : checkOrder) {
+                if (ImageFactory::checkType(type, io, false)) return static_cast<int>(type);
+            }
+        } catch (const Error&) {
+            return -1;
+        }
+        return static_cast<int>(ImageType::none);
+    }
+
+    //! Detect the image type with the image factory, -1 if it throws
+    int getType(BasicIo& io)
+    {
+        try {
+            return static_cast<int>(ImageFactory::getType(io));
+        } catch (const Error&) {
+            return -1;
+        }
+    }
+
+    void expectSameType(const byte* data, size_t size, const std::string& what)
+    {
+        MemIo memIo(data, size);
+        ASSERT_EQ(checkSequentially(memIo), getType(memIo)) << what << ", " << size << " bytes";
+    }
+}
+
 TEST(TheImageFactory, createsInstancesForFewSupportedTypesInMemory)
 {
     // Note that the constructor of these Image classes take an 'create' argument
@@ -130,6 +176,44 @@ TEST(TheImageFactory, loadInstancesDifferentImageTypes)
     ASSERT_NO_THROW(ImageFactory::open(testData + "/Reagan.jp2", false));
 }
 
+TEST(TheImageFactory, detectsTheSameTypesAsTheSequentialTypeChecks)
+{
+    /// \todo use filesystem library with C++17
+    const std::string testData(TESTDATA_PATH);
+    const char* files[] = {
+        "DSC_3079.jpg", "exiv2-bug1108.exv", "exiv2-canon-powershot-s40.crw", "exiv2-bug1044.tif",
+        "2018-01-09-exiv2-crash-001.tiff", "exiv2-bug1199.webp", "issue_839_poc.rw2", "ReaganSmallPng.png",
+        "imagemagick.pgf", "issue_857_coverage.raf", "BlueSquare.xmp",
+        "exiv2-photoshop.psd", "Reagan.jp2", "exiv2-bug1026.jpg",
+    };
+    for (auto&& file : files) {
+        const std::string path = testData + "/" + file;
+        FileIo fileIo(path);
+        ASSERT_EQ(checkSequentially(fileIo), getType(fileIo)) << file;
+
+        const DataBuf buf = readFile(path);
+        const size_t size = buf.size_;
+        for (size_t n = 0; n <= 80 && n <= size; ++n) {
+            expectSameType(buf.pData_, n, file);
+        }
+        expectSameType(buf.pData_, size, file);
+    }
+
+    // Magic numbers followed by zeros, also for types without test files
+    const std::string heads[] = {
+        std::string("\0MRM", 4), "GIF89a", "BMxxxx", std::string("MM\0\x2b\0\x08\0\0", 8),
+        std::string("II*\0\x10\0\0\0CR\x02\0", 11), "<?xml version", "\xef\xbb\xbf<?xpacket", "FUJIFILM",
+        std::string("8BPS\0\x01", 6),
+    };
+    for (auto&& head : heads) {
+        byte data[100] = {};
+        std::memcpy(data, head.data(), head.size());
+        for (size_t n = 0; n <= sizeof(data); ++n) {
+            expectSameType(data, n, head);
+        }
+    }
+}
+
 TEST(TheImageFactory, getsExpectedModesForJp2Images)
 {
     ASSERT_EQ(amNone, ImageFactory::checkMode(ImageType::jp2, mdNone));
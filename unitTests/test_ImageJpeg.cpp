@@ -1,12 +1,79 @@
 #include <image.hpp> // Unit under test
 
+#include <basicio.hpp>
+#include <jpgimage.hpp>
+
 #include <gtest/gtest.h>
 
+#include <vector>
+
 using namespace Exiv2;
 
 namespace
 {
     const std::string testData(TESTDATA_PATH); /// \todo use filesystem library with C++17
+
+    //! A MemIo which counts the calls which read or move in the data
+    class CountingMemIo : public MemIo {
+    public:
+        CountingMemIo(const byte* data, size_t size) : MemIo(data, size), calls_(0)
+        {
+        }
+        DataBuf read(size_t rcount) noexcept override
+        {
+            ++calls_;
+            return MemIo::read(rcount);
+        }
+        size_t read(byte* buf, size_t rcount) override
+        {
+            ++calls_;
+            return MemIo::read(buf, rcount);
+        }
+        int getb() override
+        {
+            ++calls_;
+            return MemIo::getb();
+        }
+        int seek(int64 offset, Position pos) override
+        {
+            ++calls_;
+            return MemIo::seek(offset, pos);
+        }
+
+        size_t calls_;
+    };
+
+    //! A JPEG image in memory, which counts the reads of writeMetadata()
+    class IndexedJpegImage : public JpegImage {
+    public:
+        explicit IndexedJpegImage(const DataBuf& data)
+            : JpegImage(BasicIo::UniquePtr(new CountingMemIo(data.pData_, data.size_)), false)
+        {
+        }
+        //! Write the metadata, return the number of reads and seeks in the data
+        size_t countedWriteMetadata()
+        {
+            CountingMemIo& io = static_cast<CountingMemIo&>(this->io());
+            io.calls_ = 0;
+            writeMetadata();
+            return io.calls_;
+        }
+    };
+
+    DataBuf readTestFile(const std::string& file)
+    {
+        FileIo io(testData + "/" + file);
+        EXPECT_EQ(0, io.open());
+        return io.read(io.size());
+    }
+
+    std::vector<byte> contents(BasicIo& io)
+    {
+        io.open();
+        IoCloser closer(io);
+        DataBuf buf = io.read(io.size());
+        return std::vector<byte>(buf.pData_, buf.pData_ + buf.size_);
+    }
 }
 
 TEST(AJpegImage, canReadMetadata)
@@ -56,3 +123,32 @@ TEST(AJpegImage, hasNoMetadataWhenCreatedFromScratch)
 
     ASSERT_EQ(0, std::remove(filePath.c_str()));
 }
+
+TEST(AJpegImage, writesTheSameWithAndWithoutTheSegmentIndex)
+{
+    const char* files[] = {"DSC_3079.jpg", "Reagan.jpg", "exiv2-bug1229.jpg", "FurnaceCreekInn.jpg", "exiv2-bug884a.jpg"};
+    for (auto&& file : files) {
+        const DataBuf data = readTestFile(file);
+        IndexedJpegImage indexed(data);
+        indexed.readMetadata();
+        indexed.exifData()["Exif.Image.Software"] = "Edited";
+        indexed.iptcData()["Iptc.Application2.Caption"] = "Caption";
+        indexed.setComment("Comment");
+
+        // The same metadata, but the image was not read
+        IndexedJpegImage scanned(data);
+        scanned.setMetadata(indexed);
+        if (indexed.iccProfileDefined()) {
+            DataBuf icc(indexed.iccProfile()->pData_, indexed.iccProfile()->size_);
+            scanned.setIccProfile(icc);
+        }
+
+        // The segments found by readMetadata() spare the scan of the markers
+        ASSERT_LT(indexed.countedWriteMetadata(), scanned.countedWriteMetadata()) << file;
+        ASSERT_TRUE(contents(indexed.io()) == contents(scanned.io())) << file;
+
+        // Writing drops the index
+        ASSERT_EQ(indexed.countedWriteMetadata(), scanned.countedWriteMetadata()) << file;
+        ASSERT_TRUE(contents(indexed.io()) == contents(scanned.io())) << file;
+    }
+}
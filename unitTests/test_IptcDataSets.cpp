@@ -0,0 +1,64 @@
+#include <exiv2/datasets.hpp>
+#include <exiv2/error.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+using namespace Exiv2;
+
+namespace
+{
+    const DataSet* recordList(uint16_t recordId)
+    {
+        return recordId == IptcDataSets::envelope ? IptcDataSets::envelopeRecordList()
+                                                  : IptcDataSets::application2RecordList();
+    }
+
+    //! The first dataset with \em number in the list of \em recordId, or 0
+    const DataSet* findByNumber(uint16_t number, uint16_t recordId)
+    {
+        for (const DataSet* d = recordList(recordId); d->number_ != 0xffff; ++d) {
+            if (d->number_ == number) return d;
+        }
+        return 0;
+    }
+}
+
+TEST(IptcDataSets, findsDataSetsByNumberLikeASearchOfTheList)
+{
+    const uint16_t recordIds[] = {IptcDataSets::envelope, IptcDataSets::application2};
+    for (auto&& recordId : recordIds) {
+        for (uint16_t number = 0; number < 300; ++number) {
+            const DataSet* d = findByNumber(number, recordId);
+            if (d) {
+                ASSERT_EQ(std::string(d->name_), IptcDataSets::dataSetName(number, recordId));
+                ASSERT_STREQ(d->title_, IptcDataSets::dataSetTitle(number, recordId));
+                ASSERT_EQ(d->type_, IptcDataSets::dataSetType(number, recordId));
+                ASSERT_EQ(d->repeatable_, IptcDataSets::dataSetRepeatable(number, recordId));
+            } else {
+                ASSERT_EQ(0u, IptcDataSets::dataSetName(number, recordId).find("0x")) << number;
+                ASSERT_STREQ("Unknown dataset", IptcDataSets::dataSetTitle(number, recordId));
+                ASSERT_EQ(string, IptcDataSets::dataSetType(number, recordId));
+            }
+        }
+    }
+}
+
+TEST(IptcDataSets, findsDataSetsByName)
+{
+    const uint16_t recordIds[] = {IptcDataSets::envelope, IptcDataSets::application2};
+    for (auto&& recordId : recordIds) {
+        for (const DataSet* d = recordList(recordId); d->number_ != 0xffff; ++d) {
+            ASSERT_EQ(d->number_, IptcDataSets::dataSet(d->name_, recordId)) << d->name_;
+            IptcKey key(std::string("Iptc.") + IptcDataSets::recordName(recordId) + "." + d->name_);
+            ASSERT_EQ(d->number_, key.tag());
+            ASSERT_EQ(recordId, key.record());
+        }
+    }
+    ASSERT_EQ(0x1234, IptcDataSets::dataSet("0x1234", IptcDataSets::application2));
+    ASSERT_THROW(IptcDataSets::dataSet("Keywords", IptcDataSets::envelope), Error);
+    ASSERT_THROW(IptcDataSets::dataSet("Keywords", 7), Error);
+    ASSERT_EQ("Iptc.Application2.Keywords", IptcKey("Iptc.0x0002.0x0019").key());
+    ASSERT_EQ("Iptc.0x0007.0x0019", IptcKey(25, 7).key());
+}
@@ -0,0 +1,127 @@
+#include <exiv2/error.hpp>
+#include <exiv2/image.hpp>
+#include <exiv2/iptc.hpp>
+#include <exiv2/jpgimage.hpp>
+#include <exiv2/value.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+using namespace Exiv2;
+
+namespace
+{
+    const std::string testData(TESTDATA_PATH); /// \todo use filesystem library with C++17
+
+    //! The encoder as it was before it wrote in one pass, as the reference
+    DataBuf encodeReference(const IptcData& iptcData)
+    {
+        DataBuf buf(iptcData.size());
+        byte* pWrite = buf.pData_;
+
+        IptcMetadata sortedIptcData;
+        std::copy(iptcData.begin(), iptcData.end(), std::back_inserter(sortedIptcData));
+        std::stable_sort(sortedIptcData.begin(), sortedIptcData.end(),
+                         [](const Iptcdatum& lhs, const Iptcdatum& rhs) { return lhs.record() < rhs.record(); });
+
+        for (auto&& datum : sortedIptcData) {
+            *pWrite++ = 0x1c;
+            *pWrite++ = static_cast<byte>(datum.record());
+            *pWrite++ = static_cast<byte>(datum.tag());
+            size_t dataSize = datum.size();
+            if (dataSize > 32767) {
+                us2Data(pWrite, 4 | 0x8000, bigEndian);
+                pWrite += 2;
+                ul2Data(pWrite, static_cast<uint32_t>(dataSize), bigEndian);
+                pWrite += 4;
+            } else {
+                us2Data(pWrite, static_cast<uint16_t>(dataSize), bigEndian);
+                pWrite += 2;
+            }
+            pWrite += datum.value().copy(pWrite, bigEndian);
+        }
+        return buf;
+    }
+
+    void expectEncodedLikeTheReference(const IptcData& iptcData, const std::string& what)
+    {
+        const DataBuf expected = encodeReference(iptcData);
+        const DataBuf actual = IptcParser::encode(iptcData);
+        ASSERT_EQ(expected.size_, actual.size_) << what;
+        ASSERT_TRUE(expected.size_ == 0 || 0 == std::memcmp(expected.pData_, actual.pData_, expected.size_)) << what;
+
+        Blob blob(3, 0xaa);
+        IptcParser::encode(blob, iptcData);
+        ASSERT_EQ(3 + expected.size_, blob.size()) << what;
+        ASSERT_TRUE(std::equal(blob.begin() + 3, blob.end(), expected.pData_)) << what;
+    }
+
+    void add(IptcData& iptcData, const std::string& key, TypeId typeId, const std::string& value)
+    {
+        Value::UniquePtr v = Value::create(typeId);
+        v->read(value);
+        ASSERT_EQ(0, iptcData.add(IptcKey(key), v.get()));
+    }
+}
+
+TEST(IptcParser, encodesLikeTheReferenceEncoder)
+{
+    IptcData empty;
+    expectEncodedLikeTheReference(empty, "empty");
+
+    IptcData iptcData;
+    add(iptcData, "Iptc.Application2.Headline", string, "Headline");
+    add(iptcData, "Iptc.Application2.Keywords", string, "one");
+    add(iptcData, "Iptc.Envelope.ModelVersion", unsignedShort, "4");
+    add(iptcData, "Iptc.Application2.Keywords", string, "two");
+    add(iptcData, "Iptc.Application2.DateCreated", date, "2019-05-07");
+    add(iptcData, "Iptc.Application2.TimeCreated", Exiv2::time, "12:34:56+02:00");
+    add(iptcData, "Iptc.Envelope.CharacterSet", string, "\x1b%G");
+    add(iptcData, "Iptc.Application2.Caption", string, "");
+    add(iptcData, "Iptc.0x0007.0x0010", undefined, "1 2 3");
+    add(iptcData, "Iptc.Application2.Preview", undefined, std::string(40000, '7'));
+    add(iptcData, "Iptc.Application2.SpecialInstructions", string, std::string(32767, 'x'));
+    add(iptcData, "Iptc.Application2.Credit", string, std::string(32768, 'y'));
+    expectEncodedLikeTheReference(iptcData, "synthetic");
+}
+
+TEST(IptcParser, encodesTestDataLikeTheReferenceEncoder)
+{
+    const char* files[] = {
+        "Reagan.jpg", "exiv2-bug440.jpg", "exiv2-bug501.jpg", "exiv2-bug784.jpg",
+        "exiv2-bug800-8BIM.jpg", "smiley1.jpg", "table.jpg", "exiv2-bug1225.exv",
+    };
+    for (auto&& file : files) {
+        auto image = ImageFactory::open(testData + "/" + file);
+        image->readMetadata();
+        ASSERT_FALSE(image->iptcData().empty()) << file;
+        expectEncodedLikeTheReference(image->iptcData(), file);
+    }
+}
+
+TEST(Photoshop, setsTheIptcIrbWithTheEncodedData)
+{
+    IptcData iptcData;
+    add(iptcData, "Iptc.Application2.Headline", string, "Odd");
+    const DataBuf rawIptc = encodeReference(iptcData);
+    ASSERT_EQ(8, rawIptc.size_);
+
+    const DataBuf irb = Photoshop::setIptcIrb(0, 0, iptcData);
+    ASSERT_EQ(12 + 8, irb.size_);
+    ASSERT_EQ(0, std::memcmp(irb.pData_, "8BIM\x04\x04\0\0\0\0\0\x08", 12));
+    ASSERT_EQ(0, std::memcmp(irb.pData_ + 12, rawIptc.pData_, 8));
+
+    add(iptcData, "Iptc.Application2.Keywords", string, "four");
+    const DataBuf irb2 = Photoshop::setIptcIrb(0, 0, iptcData);
+    // padded to be even
+    ASSERT_EQ(12 + 17 + 1, irb2.size_);
+    ASSERT_EQ(17, getULong(irb2.pData_ + 8, bigEndian));
+    ASSERT_EQ(0, irb2.pData_[12 + 17]);
+
+    // an irb without IPTC data is removed
+    const DataBuf irb3 = Photoshop::setIptcIrb(irb2.pData_, irb2.size_, IptcData());
+    ASSERT_EQ(0, irb3.size_);
+}
@@ -3,6 +3,7 @@
 
 #include <gtest/gtest.h>
 #include <array>
+#include <vector>
 
 using namespace Exiv2;
 
@@ -234,3 +235,115 @@ TEST_F(MemIoOutOfBounds, seek_out_of_bounds_03)
     // The seek was invalid, so the offset didn't change and this read still works.
     ASSERT_EQ(io.read(tmp.data(), tmp.size()), tmp.size());
 }
+
+TEST(MemIo, keepsTheDataInBlocksWhileItGrows)
+{
+    MemIo io;
+    std::vector<byte> data(1000);
+    for (size_t i = 0; i < 500; ++i) {
+        for (size_t j = 0; j < data.size(); ++j) {
+            data[j] = static_cast<byte>(i + j);
+        }
+        ASSERT_EQ(data.size(), io.write(data.data(), data.size()));
+    }
+    ASSERT_EQ(500000u, io.size());
+    const std::vector<IoBlock> blocks = io.blocks();
+    ASSERT_LT(1u, blocks.size());
+    size_t size = 0;
+    for (auto&& block : blocks) {
+        size += block.size_;
+    }
+    ASSERT_EQ(io.size(), size);
+
+    // Read across the ends of the blocks
+    ASSERT_EQ(0, io.seek(0, BasicIo::beg));
+    std::vector<byte> buf(io.size());
+    ASSERT_EQ(buf.size(), io.read(buf.data(), buf.size()));
+    for (size_t i = 0; i < buf.size(); i += 997) {
+        ASSERT_EQ(static_cast<byte>(i / 1000 + i % 1000), buf[i]);
+    }
+    ASSERT_EQ(0, io.seek(123456, BasicIo::beg));
+    ASSERT_EQ(static_cast<byte>(123 + 456), io.getb());
+}
+
+TEST(MemIo, joinsTheBlocksForMmap)
+{
+    MemIo io;
+    std::vector<byte> data(70000, 7);
+    ASSERT_EQ(data.size(), io.write(data.data(), data.size()));
+    ASSERT_EQ(8, io.putb(8));
+    ASSERT_EQ(data.size(), io.write(data.data(), data.size()));
+    ASSERT_LT(1u, io.blocks().size());
+
+    const byte* p = io.mmap();
+    ASSERT_EQ(1u, io.blocks().size());
+    ASSERT_EQ(7, p[0]);
+    ASSERT_EQ(8, p[70000]);
+    ASSERT_EQ(7, p[140000]);
+    ASSERT_EQ(140001, io.tell());
+
+    // Overwrite across the end of the joined block
+    ASSERT_EQ(0, io.seek(-1, BasicIo::end));
+    ASSERT_EQ(data.size(), io.write(data.data(), data.size()));
+    ASSERT_EQ(210000u, io.size());
+    ASSERT_EQ(0, io.seek(140000, BasicIo::beg));
+    ASSERT_EQ(7, io.getb());
+}
+
+TEST(MemIo, transfersTheBlocksOfAnotherMemIo)
+{
+    MemIo src;
+    std::vector<byte> data(100000, 3);
+    ASSERT_EQ(data.size(), src.write(data.data(), data.size()));
+    ASSERT_EQ(data.size(), src.write(data.data(), data.size()));
+    MemIo io;
+    io.transfer(src);
+    ASSERT_EQ(200000u, io.size());
+    ASSERT_EQ(0u, src.size());
+    ASSERT_TRUE(src.blocks().empty());
+    ASSERT_EQ(0, io.seek(199999, BasicIo::beg));
+    ASSERT_EQ(3, io.getb());
+}
+
+TEST(MemIo, writesSeveralBlocksAtOnce)
+{
+    const byte head[] = {1, 2, 3};
+    const std::vector<byte> payload(100000, 4);
+    const IoBlock blocks[] = {{head, sizeof(head)}, {payload.data(), payload.size()}, {head, 0}, {head, 1}};
+    MemIo io;
+    ASSERT_EQ(100004u, io.writev(blocks, 4));
+    ASSERT_EQ(100004u, io.size());
+    ASSERT_EQ(100004, io.tell());
+    ASSERT_EQ(0, io.seek(2, BasicIo::beg));
+    ASSERT_EQ(3, io.getb());
+    ASSERT_EQ(4, io.getb());
+    ASSERT_EQ(0, io.seek(-1, BasicIo::end));
+    ASSERT_EQ(1, io.getb());
+}
+
+TEST(MemIo, copiesARangeOfAnotherMemIo)
+{
+    MemIo src;
+    std::vector<byte> data(100000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<byte>(i);
+    }
+    ASSERT_EQ(data.size(), src.write(data.data(), data.size()));
+    ASSERT_EQ(0, src.seek(1000, BasicIo::beg));
+
+    MemIo io;
+    ASSERT_EQ(9, io.putb(9));
+    ASSERT_EQ(50000u, io.copyRange(src, 50000));
+    ASSERT_EQ(51000, src.tell());
+    ASSERT_EQ(50001u, io.size());
+    ASSERT_EQ(0, io.seek(1, BasicIo::beg));
+    ASSERT_EQ(static_cast<byte>(1000), io.getb());
+
+    // Overwrite from the middle and copy more than there is
+    ASSERT_EQ(0, io.seek(25000, BasicIo::beg));
+    ASSERT_EQ(49000u, io.copyRange(src, 100000));
+    ASSERT_TRUE(src.eof());
+    ASSERT_EQ(74000u, io.size());
+    ASSERT_EQ(0, io.seek(-1, BasicIo::end));
+    ASSERT_EQ(static_cast<byte>(99999), io.getb());
+}
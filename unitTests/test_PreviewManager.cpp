@@ -0,0 +1,143 @@
+#include <preview.hpp> // Unit under test
+
+#include <basicio.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace Exiv2;
+
+namespace
+{
+    const std::string testData(TESTDATA_PATH); /// \todo use filesystem library with C++17
+
+    void expectWrittenPreviewsMatchPreviewImages(const std::string& path)
+    {
+        auto image = ImageFactory::open(path);
+        image->readMetadata();
+
+        PreviewManager manager(*image);
+        const PreviewPropertiesList list = manager.getPreviewProperties();
+        ASSERT_FALSE(list.empty());
+
+        for (auto&& properties : list) {
+            const PreviewImage preview = manager.getPreviewImage(properties);
+            MemIo io;
+            ASSERT_EQ(preview.size(), manager.writePreviewImage(properties, io));
+            ASSERT_EQ(preview.size(), io.size());
+            ASSERT_EQ(0, std::memcmp(preview.pData(), io.mmap(), preview.size()));
+        }
+    }
+
+    void put16(std::vector<byte>& buf, uint16_t value)
+    {
+        buf.push_back(static_cast<byte>(value & 0xff));
+        buf.push_back(static_cast<byte>(value >> 8));
+    }
+
+    void put32(std::vector<byte>& buf, uint32_t value)
+    {
+        put16(buf, static_cast<uint16_t>(value & 0xffff));
+        put16(buf, static_cast<uint16_t>(value >> 16));
+    }
+
+    void putEntry(std::vector<byte>& buf, uint16_t tag, uint16_t type, uint32_t count, uint32_t value)
+    {
+        put16(buf, tag);
+        put16(buf, type);
+        put32(buf, count);
+        put32(buf, value);
+    }
+
+    //! A little endian TIFF image with a reduced resolution IFD0 and two strips in reverse order
+    std::vector<byte> tiffWithStripsInReverseOrder()
+    {
+        std::vector<byte> buf = {'I', 'I', 42, 0, 8, 0, 0, 0};
+        put16(buf, 5);
+        putEntry(buf, 0x00fe, 4, 1, 1);         // NewSubfileType, reduced resolution
+        putEntry(buf, 0x0100, 3, 1, 3);         // ImageWidth
+        putEntry(buf, 0x0101, 3, 1, 3);         // ImageLength
+        putEntry(buf, 0x0111, 4, 2, 74);        // StripOffsets
+        putEntry(buf, 0x0117, 4, 2, 82);        // StripByteCounts
+        put32(buf, 0);
+        put32(buf, 100);                        // 74: offsets
+        put32(buf, 92);
+        put32(buf, 5);                          // 82: sizes
+        put32(buf, 4);
+        put16(buf, 0);                          // 90
+        const byte strips[] = {0xb1, 0xb2, 0xb3, 0xb4, 0, 0, 0, 0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5};
+        buf.insert(buf.end(), strips, strips + sizeof(strips));
+        return buf;
+    }
+}
+
+TEST(APreviewManager, writesJpegPreviewsIdenticalToPreviewImage)
+{
+    expectWrittenPreviewsMatchPreviewImages(testData + "/exiv2-nikon-d70.jpg");
+}
+
+TEST(APreviewManager, writesTiffPreviewsIdenticalToPreviewImage)
+{
+    expectWrittenPreviewsMatchPreviewImages(testData + "/exiv2-kodak-dc210.jpg");
+    expectWrittenPreviewsMatchPreviewImages(testData + "/ReaganLargeTiff.tiff");
+}
+
+TEST(APreviewManager, writesPreviewToFileWithExtension)
+{
+    auto image = ImageFactory::open(testData + "/exiv2-nikon-d70.jpg");
+    image->readMetadata();
+
+    PreviewManager manager(*image);
+    const PreviewPropertiesList list = manager.getPreviewProperties();
+    ASSERT_FALSE(list.empty());
+
+    const std::string filePath("./preview-test");
+    const size_t written = manager.writePreviewImage(list.back(), filePath);
+    ASSERT_EQ(list.back().size_, written);
+
+    const DataBuf buf = readFile(filePath + ".jpg");
+    ASSERT_EQ(written, buf.size_);
+    ASSERT_EQ(0, std::remove((filePath + ".jpg").c_str()));
+}
+
+TEST(APreviewManager, writesTiffPreviewStripByStrip)
+{
+    const std::vector<byte> tiff = tiffWithStripsInReverseOrder();
+    auto image = ImageFactory::open(tiff.data(), tiff.size());
+    image->readMetadata();
+
+    PreviewManager manager(*image);
+    const PreviewPropertiesList list = manager.getPreviewProperties();
+    ASSERT_EQ(1u, list.size());
+    ASSERT_EQ("image/tiff", list.front().mimeType_);
+
+    const PreviewImage preview = manager.getPreviewImage(list.front());
+    MemIo io;
+    ASSERT_EQ(preview.size(), manager.writePreviewImage(list.front(), io));
+    ASSERT_EQ(preview.size(), io.size());
+    ASSERT_EQ(0, std::memcmp(preview.pData(), io.mmap(), preview.size()));
+
+    // both strips, one after the other, aligned to a word boundary
+    const byte strips[] = {0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xb1, 0xb2, 0xb3, 0xb4, 0};
+    ASSERT_LE(sizeof(strips), io.size());
+    ASSERT_EQ(0, std::memcmp(strips, io.mmap() + io.size() - sizeof(strips), sizeof(strips)));
+}
+
+TEST(APreviewManager, createsNoFileWithoutPreview)
+{
+    const std::vector<byte> tiff = tiffWithStripsInReverseOrder();
+    auto image = ImageFactory::open(tiff.data(), tiff.size());
+    image->readMetadata();
+
+    PreviewManager manager(*image);
+    PreviewProperties properties;
+    properties.id_ = 0;  // a native preview, which the image has not
+    properties.extension_ = ".jpg";
+
+    const std::string filePath("./preview-none");
+    ASSERT_EQ(0u, manager.writePreviewImage(properties, filePath));
+    ASSERT_EQ(nullptr, std::fopen((filePath + ".jpg").c_str(), "rb"));
+}
@@ -0,0 +1,54 @@
+// File under test
+#include <exiv2/stats.hpp>
+
+// Auxiliary headers
+#include <exiv2/image.hpp>
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace Exiv2;
+
+TEST(Stats, everyCounterHasAName)
+{
+    for (int i = 0; i < Stats::lastCounter; ++i) {
+        ASSERT_STRNE("", Stats::name(static_cast<Stats::Counter>(i)));
+    }
+    ASSERT_STREQ("TiffParser::decode", Stats::name(Stats::tiffDecode));
+}
+
+TEST(Stats, snapshotHasAnEntryPerCounter)
+{
+    ASSERT_EQ(static_cast<size_t>(Stats::lastCounter), Stats::snapshot().size());
+}
+
+TEST(Stats, countsReadMetadataOnlyIfEnabled)
+{
+    Stats::reset();
+    Image::UniquePtr image = ImageFactory::open(std::string(TESTDATA_PATH) + "/Reagan.jpg");
+    image->readMetadata();
+
+    const Stats::Snapshot snapshot = Stats::snapshot();
+    if (Stats::enabled()) {
+        ASSERT_EQ(1u, snapshot[Stats::imageFactoryOpen].calls_);
+        ASSERT_EQ(1u, snapshot[Stats::readMetadata].calls_);
+        ASSERT_EQ(1u, snapshot[Stats::tiffDecode].calls_);
+        ASSERT_LT(0u, snapshot[Stats::tiffDecode].bytes_);
+        ASSERT_LT(0u, snapshot[Stats::ioRead].bytes_);
+    }
+    else {
+        ASSERT_EQ(0u, snapshot[Stats::readMetadata].calls_);
+    }
+}
+
+TEST(Stats, printsOnlyTheCountersWhichWereUsed)
+{
+    Stats::Snapshot snapshot(Stats::lastCounter, Stats::Entry());
+    snapshot[Stats::ioSeek].calls_ = 3;
+    std::ostringstream os;
+    Stats::print(os, snapshot);
+    ASSERT_NE(std::string::npos, os.str().find("BasicIo::seek"));
+    ASSERT_EQ(std::string::npos, os.str().find("BasicIo::read"));
+}
@@ -0,0 +1,164 @@
+#include <exiv2/basicio.hpp>  // SUT
+#include <exiv2/error.hpp>
+#include <exiv2/image.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <vector>
+
+using namespace Exiv2;
+
+namespace
+{
+    //! A StdinIo reading a temporary file of 200 KiB with the bytes 0, 1, ... 255, 0, 1, ...
+    struct StdinIoFromFile : public testing::Test
+    {
+        void SetUp() override
+        {
+            input = std::tmpfile();
+            ASSERT_NE(nullptr, input);
+            std::vector<byte> data(200 * 1024);
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = static_cast<byte>(i);
+            }
+            ASSERT_EQ(data.size(), std::fwrite(data.data(), 1, data.size(), input));
+            std::rewind(input);
+        }
+
+        void TearDown() override
+        {
+            std::fclose(input);
+        }
+
+        //! Bytes of the input which are not read yet
+        long unread()
+        {
+            const long pos = std::ftell(input);
+            std::fseek(input, 0, SEEK_END);
+            const long end = std::ftell(input);
+            std::fseek(input, pos, SEEK_SET);
+            return end - pos;
+        }
+
+        std::FILE* input{nullptr};
+    };
+}  // namespace
+
+TEST_F(StdinIoFromFile, readsTheInputOnlyAsFarAsItIsRead)
+{
+    StdinIo io(input);
+    ASSERT_EQ(0, io.open());
+    byte buf[16];
+    ASSERT_EQ(sizeof(buf), io.read(buf, sizeof(buf)));
+    ASSERT_EQ(15, buf[15]);
+    ASSERT_LT(0, unread());
+    ASSERT_FALSE(io.eof());
+}
+
+TEST_F(StdinIoFromFile, seeksBeyondTheDataInMemory)
+{
+    StdinIo io(input);
+    ASSERT_EQ(0, io.seek(100 * 1024 + 3, BasicIo::beg));
+    ASSERT_EQ(3, io.getb());
+    ASSERT_EQ(0, io.seek(-2, BasicIo::cur));
+    ASSERT_EQ(2, io.getb());
+    ASSERT_LT(0, unread());
+}
+
+TEST_F(StdinIoFromFile, readsAllOfTheInputForTheSize)
+{
+    StdinIo io(input);
+    ASSERT_EQ(200u * 1024, io.size());
+    ASSERT_EQ(0, unread());
+    ASSERT_EQ(0, io.seek(-1, BasicIo::end));
+    ASSERT_EQ(255, io.getb());
+    ASSERT_EQ(EOF, io.getb());
+    ASSERT_TRUE(io.eof());
+}
+
+TEST_F(StdinIoFromFile, readsAllOfTheInputBeforeAWrite)
+{
+    StdinIo io(input);
+    ASSERT_EQ(0, io.seek(1, BasicIo::beg));
+    ASSERT_EQ(42, io.putb(42));
+    ASSERT_EQ(200u * 1024, io.size());
+    ASSERT_EQ(0, io.seek(0, BasicIo::beg));
+    const DataBuf buf = io.read(3);
+    ASSERT_EQ(3u, buf.size_);
+    ASSERT_EQ(42, buf.pData_[1]);
+    ASSERT_EQ(2, buf.pData_[2]);
+}
+
+TEST_F(StdinIoFromFile, failsToReadMoreThanTheInput)
+{
+    StdinIo io(input);
+    ASSERT_EQ(0u, io.read(300 * 1024).size_);
+    ASSERT_EQ(1, io.seek(300 * 1024, BasicIo::beg));
+}
+
+TEST_F(StdinIoFromFile, stopsReadingTheInputAfterATransfer)
+{
+    StdinIo io(input);
+    const byte data[] = {1, 2, 3};
+    MemIo src(data, sizeof(data));
+    io.transfer(src);
+    ASSERT_EQ(3u, io.size());
+    ASSERT_LT(0, unread());
+}
+
+TEST(StdinIo, throwsIfReadingTheInputFails)
+{
+    // reading a stream opened for writing only sets its error indicator
+    const char* path = "exiv2-test-stdinio.bin";
+    std::FILE* input = std::fopen(path, "wb");
+    ASSERT_NE(nullptr, input);
+    {
+        StdinIo io(input);
+        byte buf[16];
+        ASSERT_THROW(io.read(buf, sizeof(buf)), Error);
+    }
+    std::fclose(input);
+    ASSERT_EQ(0, std::remove(path));
+}
+
+TEST(StdinIo, readsTheMetadataOfAJpegImage)
+{
+    std::FILE* input = std::fopen(TESTDATA_PATH "/Reagan.jpg", "rb");
+    ASSERT_NE(nullptr, input);
+    {
+        Image::UniquePtr image = ImageFactory::open(BasicIo::UniquePtr(new StdinIo(input)));
+        ASSERT_NE(nullptr, image.get());
+        image->readMetadata();
+        ASSERT_EQ("NIKON CORPORATION", image->exifData()["Exif.Image.Make"].toString());
+        ASSERT_EQ("-", image->io().path());
+    }
+    std::fclose(input);
+}
+
+TEST(StdinIo, readsTheMetadataOfAJpegImageWithoutTheImageData)
+{
+    // Reagan.jpg followed by 1 MiB, which stands for more image data
+    std::FILE* jpeg = std::fopen(TESTDATA_PATH "/Reagan.jpg", "rb");
+    ASSERT_NE(nullptr, jpeg);
+    std::vector<byte> data(1024 * 1024);
+    const size_t size = std::fread(data.data(), 1, data.size(), jpeg);
+    std::fclose(jpeg);
+    ASSERT_LT(0u, size);
+    ASSERT_GT(data.size(), size);
+    data.resize(size + data.size());
+
+    std::FILE* input = std::tmpfile();
+    ASSERT_NE(nullptr, input);
+    ASSERT_EQ(data.size(), std::fwrite(data.data(), 1, data.size(), input));
+    std::rewind(input);
+    {
+        Image::UniquePtr image = ImageFactory::open(BasicIo::UniquePtr(new StdinIo(input)));
+        ASSERT_NE(nullptr, image.get());
+        image->readMetadata();
+        ASSERT_EQ("NIKON CORPORATION", image->exifData()["Exif.Image.Make"].toString());
+        // The segment index of the image did not ask for the size of the input
+        ASSERT_GT(static_cast<long>(data.size() / 2), std::ftell(input));
+    }
+    std::fclose(input);
+}
@@ -0,0 +1,282 @@
+#include <tiffimage.hpp> // Unit under test
+
+#include <basicio.hpp>
+#include <error.hpp>
+#include <exif.hpp>
+#include <image.hpp>
+#include <value.hpp>
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Exiv2;
+
+namespace
+{
+    const std::string testData(TESTDATA_PATH); /// \todo use filesystem library with C++17
+
+    typedef std::vector<byte> Bytes;
+
+    Bytes readTestFile(const std::string& file)
+    {
+        FileIo io(testData + "/" + file);
+        EXPECT_EQ(0, io.open());
+        DataBuf buf = io.read(static_cast<long>(io.size()));
+        return Bytes(buf.pData_, buf.pData_ + buf.size_);
+    }
+
+    Bytes contents(BasicIo& io)
+    {
+        io.open();
+        IoCloser closer(io);
+        DataBuf buf = io.read(static_cast<long>(io.size()));
+        return Bytes(buf.pData_, buf.pData_ + buf.size_);
+    }
+
+    //! A TIFF image without image data with the Exif data of \em file, which may have makernotes
+    Bytes tiffWithExifOf(const std::string& file)
+    {
+        Image::UniquePtr source = ImageFactory::open(testData + "/" + file);
+        source->readMetadata();
+        MemIo io;
+        TiffParser::encode(io, 0, 0, littleEndian, source->exifData(), IptcData(), XmpData());
+        return contents(io);
+    }
+
+    typedef std::function<void(ExifData&)> Edit;
+
+    //! Read \em tiff, \em edit the Exif data and write it, tracking changes or not
+    Bytes writeEdited(const Bytes& tiff, const Edit& edit, bool tracked)
+    {
+        Image::UniquePtr image = ImageFactory::open(&tiff[0], static_cast<long>(tiff.size()));
+        image->readMetadata();
+        edit(image->exifData());
+        if (!tracked) image->exifData().setOrigin(0);
+        image->writeMetadata();
+        return contents(image->io());
+    }
+
+    void expectWrittenLikeUntracked(const Bytes& tiff, const Edit& edit, const std::string& what)
+    {
+        const Bytes expected = writeEdited(tiff, edit, false);
+        const Bytes actual = writeEdited(tiff, edit, true);
+        ASSERT_EQ(expected.size(), actual.size()) << what;
+        ASSERT_TRUE(expected == actual) << what;
+    }
+
+    void set(ExifData& exifData, const std::string& key, const std::string& value)
+    {
+        exifData[key] = value;
+    }
+
+    //! Log messages, collected by collectMessage()
+    std::string messages;
+
+    void collectMessage(int level, const char* s)
+    {
+        messages += std::to_string(level) + ": " + s;
+    }
+
+    //! Collect the log messages and restore the log handler and the decode threads
+    struct MessageCollector {
+        MessageCollector() : handler_(LogMsg::handler()), level_(LogMsg::level())
+        {
+            LogMsg::setHandler(collectMessage);
+            LogMsg::setLevel(LogMsg::info);
+        }
+        ~MessageCollector()
+        {
+            LogMsg::setHandler(handler_);
+            LogMsg::setLevel(level_);
+            TiffParser::setDecodeThreads(1);
+        }
+        const LogMsg::Handler handler_;
+        const LogMsg::Level level_;
+    };
+
+    //! The metadata of \em file and the messages logged while reading it with \em threads
+    std::string decodedWith(const std::string& file, unsigned int threads)
+    {
+        TiffParser::setDecodeThreads(threads);
+        messages.clear();
+        std::ostringstream os;
+        try {
+            Image::UniquePtr image = ImageFactory::open(testData + "/" + file);
+            image->readMetadata();
+            for (auto&& md : image->exifData()) {
+                os << md.key() << " " << md.idx() << " " << md.typeName() << " " << md.value() << "\n";
+            }
+            for (auto&& md : image->iptcData()) {
+                os << md.key() << " " << md.value() << "\n";
+            }
+            for (auto&& md : image->xmpData()) {
+                os << md.key() << " " << md.value() << "\n";
+            }
+        }
+        catch (const AnyError& error) {
+            os << "error " << error.code() << "\n";
+        }
+        return os.str() + messages;
+    }
+}
+
+TEST(ExifData, tracksModifiedMetadataFromItsOrigin)
+{
+    ExifData exifData;
+    ASSERT_EQ(0, exifData.origin());
+    exifData["Exif.Image.Make"] = "Canon";
+    exifData["Exif.Image.Model"] = "EOS";
+    exifData["Exif.Photo.ISOSpeedRatings"] = uint16_t(100);
+    ASSERT_TRUE(exifData["Exif.Image.Make"].modified());
+
+    int origin = 0;
+    exifData.setOrigin(&origin);
+    ASSERT_EQ(&origin, exifData.origin());
+    for (auto&& exifdatum : exifData) {
+        ASSERT_FALSE(exifdatum.modified()) << exifdatum.key();
+    }
+
+    exifData["Exif.Image.Make"] = "Nikon";
+    exifData["Exif.Photo.ISOSpeedRatings"] = uint16_t(200);
+    exifData["Exif.Photo.ExposureTime"] = URational(1, 250);
+    ASSERT_TRUE(exifData["Exif.Image.Make"].modified());
+    ASSERT_FALSE(exifData["Exif.Image.Model"].modified());
+    ASSERT_TRUE(exifData["Exif.Photo.ISOSpeedRatings"].modified());
+    ASSERT_TRUE(exifData["Exif.Photo.ExposureTime"].modified());
+    ASSERT_EQ(&origin, exifData.origin());
+
+    // Copies keep the origin and the modifications, assignments don't keep the origin
+    ExifData copy(exifData);
+    ASSERT_EQ(&origin, copy.origin());
+    ASSERT_TRUE(copy["Exif.Image.Make"].modified());
+    ExifData assigned;
+    assigned = exifData;
+    ASSERT_EQ(0, assigned.origin());
+    ASSERT_EQ(exifData.count(), assigned.count());
+
+    exifData.setOrigin(&origin);
+    exifData.erase(exifData.findKey(ExifKey("Exif.Image.Model")));
+    ASSERT_EQ(0, exifData.origin());
+
+    exifData.setOrigin(&origin);
+    exifData.erase(exifData.end(), exifData.end());
+    ASSERT_EQ(&origin, exifData.origin());
+    exifData.clear();
+    ASSERT_EQ(0, exifData.origin());
+}
+
+TEST(ATiffImage, writesModifiedTagsLikeTheFullEncoder)
+{
+    std::vector<std::pair<std::string, Bytes> > images;
+    for (auto&& file : {"Reagan.tiff", "mini9.tif", "exiv2-bug1044.tif"}) {
+        images.push_back(std::make_pair(std::string(file), readTestFile(file)));
+    }
+    // Makernotes and IFDs which this tree can't modify in place
+    for (auto&& file : {"_DSC8437.exv", "RAW_PENTAX_K100.exv", "Stonehenge.exv", "exiv2-bug1108.exv"}) {
+        images.push_back(std::make_pair(std::string(file), tiffWithExifOf(file)));
+    }
+
+    const std::vector<std::pair<std::string, Edit> > edits = {
+        {"nothing", [](ExifData&) {}},
+        {"shorter string", [](ExifData& exifData) { set(exifData, "Exif.Image.Software", "Ed"); }},
+        {"longer string", [](ExifData& exifData) { set(exifData, "Exif.Image.Software", std::string(300, 'x')); }},
+        {"inline value", [](ExifData& exifData) { exifData["Exif.Image.Orientation"] = uint16_t(6); }},
+        {"rational", [](ExifData& exifData) { exifData["Exif.Photo.ExposureTime"] = URational(1, 250); }},
+        {"GPS", [](ExifData& exifData) { set(exifData, "Exif.GPSInfo.GPSLatitudeRef", "S"); }},
+        {"new tag", [](ExifData& exifData) { set(exifData, "Exif.Image.Artist", "Me"); }},
+        {"makernote tag", [](ExifData& exifData) {
+            for (auto&& exifdatum : exifData) {
+                if (exifdatum.groupName() == "Nikon3" || exifdatum.groupName() == "Pentax") {
+                    exifdatum.setValue(exifdatum.value().toString());
+                    break;
+                }
+            }
+        }},
+        {"two tags", [](ExifData& exifData) {
+            set(exifData, "Exif.Image.Software", "Ed");
+            exifData["Exif.Photo.ExposureTime"] = URational(1, 250);
+        }},
+    };
+    for (auto&& image : images) {
+        for (auto&& edit : edits) {
+            expectWrittenLikeUntracked(image.second, edit.second, image.first + ", " + edit.first);
+        }
+    }
+}
+
+TEST(ATiffImage, writesOnlyModifiedTagsWhenTheMetadataIsFromTheImage)
+{
+    // Mark the metadata as unmodified after erasing a tag: the tag is not deleted
+    const Bytes tiff = readTestFile("Reagan.tiff");
+    Image::UniquePtr image = ImageFactory::open(&tiff[0], static_cast<long>(tiff.size()));
+    image->readMetadata();
+    ExifData& exifData = image->exifData();
+    const ExifData::iterator pos = exifData.findKey(ExifKey("Exif.Image.Software"));
+    ASSERT_TRUE(pos != exifData.end());
+    const std::string software = pos->toString();
+    exifData.erase(pos);
+    exifData.setOrigin(&image->io());
+    exifData["Exif.Image.Orientation"] = uint16_t(8);
+    image->writeMetadata();
+
+    const Bytes written = contents(image->io());
+    ASSERT_EQ(tiff.size(), written.size());
+    Image::UniquePtr reread = ImageFactory::open(&written[0], static_cast<long>(written.size()));
+    reread->readMetadata();
+    ASSERT_EQ(software, reread->exifData()["Exif.Image.Software"].toString());
+    ASSERT_EQ(8, reread->exifData()["Exif.Image.Orientation"].toLong());
+
+    // Replacing the metadata with a copy is not tracked, the tag is deleted
+    ExifData copy = reread->exifData();
+    copy.erase(copy.findKey(ExifKey("Exif.Image.Software")));
+    copy.setOrigin(&reread->io());
+    reread->setExifData(copy);
+    reread->writeMetadata();
+    reread->readMetadata();
+    ASSERT_TRUE(reread->exifData().findKey(ExifKey("Exif.Image.Software")) == reread->exifData().end());
+}
+
+TEST(TiffParser, decodesSubtreesWithThreadsLikeInPlace)
+{
+    MessageCollector collector;
+    // Sub-IFDs, makernotes with binary arrays and sub-IFDs, Canon AFInfo and corrupted files
+    for (auto&& file : {"_DSC8437.exv", "RAW_PENTAX_K100.exv", "CanonEF100mmF2.8LMacroISUSM.exv",
+                        "exiv2-bug1044.tif", "exiv2-canon-eos-20d.jpg", "exiv2-nikon-d70.jpg",
+                        "exiv2-sony-dsc-w7.jpg", "pocIssue283.jpg", "issue_839_poc.rw2"}) {
+        const std::string expected = decodedWith(file, 1);
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_EQ(expected, decodedWith(file, 4)) << file;
+        }
+    }
+}
+
+TEST(TiffParser, decodesWithThreadsIntoContainersWhichHoldMetadata)
+{
+    MessageCollector collector;
+    for (auto&& file : {"exiv2-bug1044.tif", "Reagan.tiff"}) {
+        const Bytes tiff = readTestFile(file);
+        ExifData expected;
+        IptcData iptcData;
+        XmpData xmpData;
+        TiffParser::decode(expected, iptcData, xmpData, &tiff[0], tiff.size());
+        const long iptcCount = iptcData.count();
+        const long xmpCount = xmpData.count();
+
+        TiffParser::setDecodeThreads(4);
+        ExifData exifData;
+        exifData["Exif.Image.Artist"] = "Someone";
+        iptcData["Iptc.Application2.Caption"] = "Caption";
+        xmpData["Xmp.dc.title"] = "Title";
+        for (int i = 0; i < 2; ++i) {
+            TiffParser::decode(exifData, iptcData, xmpData, &tiff[0], tiff.size());
+            ASSERT_EQ(expected.count(), exifData.count()) << file;
+            ASSERT_EQ(iptcCount, iptcData.count()) << file;
+            ASSERT_EQ(xmpCount, xmpData.count()) << file;
+        }
+        TiffParser::setDecodeThreads(1);
+    }
+}
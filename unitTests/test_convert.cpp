@@ -0,0 +1,294 @@
+#include <convert.hpp> // Unit under test
+
+#include <exif.hpp>
+#include <iptc.hpp>
+#include <xmp_exiv2.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace Exiv2;
+
+// The expected metadata is what the converter produced when it looked up the
+// source of each conversion rule with a linear search, before the rules
+// without a source were skipped with an index of the source keys.
+
+namespace
+{
+    //! Exif data with a source for each kind of Exif conversion
+    ExifData exifSource()
+    {
+        ExifData exifData;
+        exifData["Exif.Image.ImageWidth"] = uint32_t(4000);
+        exifData["Exif.Image.Orientation"] = uint16_t(6);
+        exifData["Exif.Image.XResolution"] = URational(300, 1);
+        exifData["Exif.Image.DateTime"] = "2019:03:04 05:06:07";
+        exifData["Exif.Image.ImageDescription"] = "A description";
+        exifData["Exif.Image.Make"] = "Maker";
+        exifData["Exif.Image.Artist"] = "An artist";
+        exifData["Exif.Image.Copyright"] = "A copyright";
+        exifData["Exif.Photo.ExifVersion"] = "48 50 51 48";
+        exifData["Exif.Photo.ComponentsConfiguration"] = "1 2 3 0";
+        exifData["Exif.Photo.UserComment"] = "charset=Ascii A comment";
+        exifData["Exif.Photo.DateTimeOriginal"] = "2019:03:04 05:06:07";
+        exifData["Exif.Photo.SubSecTimeOriginal"] = "25";
+        exifData["Exif.Photo.ExposureTime"] = URational(1, 250);
+        exifData["Exif.Photo.FNumber"] = URational(56, 10);
+        exifData["Exif.Photo.ISOSpeedRatings"] = uint16_t(400);
+        exifData["Exif.Photo.Flash"] = uint16_t(0x19);
+        exifData["Exif.Photo.FocalLengthIn35mmFilm"] = uint16_t(50);
+        exifData["Exif.GPSInfo.GPSVersionID"] = "2 2 0 0";
+        exifData["Exif.GPSInfo.GPSLatitudeRef"] = "N";
+        exifData["Exif.GPSInfo.GPSLatitude"] = "47/1 30/1 15/1";
+        exifData["Exif.GPSInfo.GPSLongitudeRef"] = "W";
+        exifData["Exif.GPSInfo.GPSLongitude"] = "8/1 15/1 30/1";
+        exifData["Exif.GPSInfo.GPSTimeStamp"] = "10/1 20/1 30/1";
+        exifData["Exif.GPSInfo.GPSDateStamp"] = "2019:03:04";
+        return exifData;
+    }
+
+    //! IPTC data with single and repeated datasets
+    IptcData iptcSource()
+    {
+        IptcData iptcData;
+        iptcData["Iptc.Application2.ObjectName"] = "A title";
+        iptcData["Iptc.Application2.Urgency"] = "5";
+        iptcData["Iptc.Application2.City"] = "A city";
+        iptcData["Iptc.Application2.Caption"] = "A caption";
+        iptcData["Iptc.Application2.DateCreated"] = "2019-03-04";
+        for (const char* keyword : {"one", "two", "three"}) {
+            Iptcdatum datum(IptcKey("Iptc.Application2.Keywords"));
+            datum.setValue(keyword);
+            iptcData.add(datum);
+        }
+        return iptcData;
+    }
+
+    //! XMP data with simple properties, arrays, lang-alt values and the fields of a struct
+    XmpData xmpSource()
+    {
+        XmpData xmpData;
+        xmpData["Xmp.tiff.ImageWidth"] = "4000";
+        xmpData["Xmp.tiff.Orientation"] = "6";
+        xmpData["Xmp.xmp.ModifyDate"] = "2019-03-04T05:06:07";
+        xmpData["Xmp.dc.description"] = "lang=x-default A description";
+        xmpData["Xmp.dc.rights"] = "lang=x-default A copyright";
+        Value::UniquePtr creator = Value::create(xmpSeq);
+        creator->read("An artist");
+        xmpData.add(XmpKey("Xmp.dc.creator"), creator.get());
+        Value::UniquePtr subject = Value::create(xmpBag);
+        subject->read("one");
+        subject->read("two");
+        xmpData.add(XmpKey("Xmp.dc.subject"), subject.get());
+        xmpData["Xmp.exif.ExifVersion"] = "0230";
+        xmpData["Xmp.exif.UserComment"] = "lang=x-default A comment";
+        xmpData["Xmp.exif.ExposureTime"] = "1/250";
+        xmpData["Xmp.exif.ISOSpeedRatings"] = "400";
+        xmpData["Xmp.exif.FocalLengthIn35mmFilm"] = "50";
+        xmpData["Xmp.exif.Flash/exif:Fired"] = "True";
+        xmpData["Xmp.exif.Flash/exif:Return"] = "0";
+        xmpData["Xmp.exif.Flash/exif:Mode"] = "3";
+        xmpData["Xmp.exif.Flash/exif:Function"] = "False";
+        xmpData["Xmp.exif.Flash/exif:RedEyeMode"] = "False";
+        xmpData["Xmp.exif.GPSLatitude"] = "47,30.25N";
+        xmpData["Xmp.exif.GPSTimeStamp"] = "2019-03-04T10:20:30Z";
+        xmpData["Xmp.photoshop.City"] = "A city";
+        xmpData["Xmp.photoshop.DateCreated"] = "2019-03-04";
+        return xmpData;
+    }
+
+    //! The keys and values of \em data, in order
+    template <typename Data>
+    std::vector<std::string> entries(const Data& data)
+    {
+        std::vector<std::string> result;
+        for (auto&& datum : data) {
+            result.push_back(datum.key() + " " + datum.value().toString());
+        }
+        return result;
+    }
+}
+
+TEST(Converter, copiesExifAndIptcToTheSameXmpLikeALinearScan)
+{
+    const ExifData exifData = exifSource();
+    const IptcData iptcData = iptcSource();
+    XmpData xmpData;
+    copyExifToXmp(exifData, xmpData);
+    copyIptcToXmp(iptcData, xmpData);
+
+    const std::vector<std::string> expectedXmp = {
+        "Xmp.tiff.ImageWidth 4000",
+        "Xmp.tiff.Orientation 6",
+        "Xmp.tiff.XResolution 300/1",
+        "Xmp.xmp.ModifyDate 2019-03-04T05:06:07",
+        "Xmp.tiff.Make Maker",
+        "Xmp.dc.creator An artist",
+        "Xmp.dc.rights lang=\"x-default\" A copyright",
+        "Xmp.exif.ExifVersion 0230",
+        "Xmp.exif.ComponentsConfiguration 1, 2, 3, 0",
+        "Xmp.exif.UserComment lang=\"x-default\" A comment",
+        "Xmp.photoshop.DateCreated 2019-03-04T05:06:07.25",
+        "Xmp.exif.ExposureTime 1/250",
+        "Xmp.exif.FNumber 56/10",
+        "Xmp.exif.ISOSpeedRatings 400",
+        "Xmp.exif.Flash/exif:Fired True",
+        "Xmp.exif.Flash/exif:Return 0",
+        "Xmp.exif.Flash/exif:Mode 3",
+        "Xmp.exif.Flash/exif:Function False",
+        "Xmp.exif.Flash/exif:RedEyeMode False",
+        "Xmp.exif.FocalLengthIn35mmFilm 50",
+        "Xmp.exif.GPSVersionID 2.2.0.0",
+        "Xmp.exif.GPSLatitude 47,30.2500000N",
+        "Xmp.exif.GPSLongitude 8,15.5000000W",
+        "Xmp.exif.GPSTimeStamp 2019-03-04T10:20:30.000000000",
+        "Xmp.dc.title lang=\"x-default\" A title",
+        "Xmp.photoshop.Urgency 5",
+        "Xmp.dc.subject one, two, three",
+        "Xmp.photoshop.City A city",
+        "Xmp.dc.description lang=\"x-default\" A caption",
+    };
+    ASSERT_EQ(expectedXmp, entries(xmpData));
+}
+
+TEST(Converter, copiesXmpToExifAndIptcLikeALinearScan)
+{
+    const XmpData xmpData = xmpSource();
+    ExifData exifData;
+    IptcData iptcData;
+    copyXmpToExif(xmpData, exifData);
+    copyXmpToIptc(xmpData, iptcData);
+
+    const std::vector<std::string> expectedExif = {
+        "Exif.Image.ImageWidth 4000",
+        "Exif.Image.Orientation 6",
+        "Exif.Image.DateTime 2019:03:04 05:06:07",
+        "Exif.Image.ImageDescription A description",
+        "Exif.Image.Artist An artist",
+        "Exif.Image.Copyright A copyright",
+        "Exif.Photo.ExifVersion 48 50 51 48",
+        "Exif.Photo.UserComment charset=\"Unicode\" A comment",
+        "Exif.Photo.DateTimeOriginal 2019:03:04 00:00:00",
+        "Exif.Photo.ExposureTime 1/250",
+        "Exif.Photo.ISOSpeedRatings 400",
+        "Exif.Photo.Flash 25",
+        "Exif.Photo.FocalLengthIn35mmFilm 50",
+        "Exif.GPSInfo.GPSLatitude 47/1 30/1 15/1",
+        "Exif.GPSInfo.GPSLatitudeRef N",
+        "Exif.GPSInfo.GPSTimeStamp 10/1 20/1 30/1",
+        "Exif.GPSInfo.GPSDateStamp 2019:03:04",
+    };
+    const std::vector<std::string> expectedIptc = {
+        "Iptc.Application2.Keywords one",
+        "Iptc.Application2.Keywords two",
+        "Iptc.Envelope.CharacterSet %G",
+        "Iptc.Application2.DateCreated 2019-03-04",
+        "Iptc.Application2.Byline An artist",
+        "Iptc.Application2.City A city",
+        "Iptc.Application2.Copyright A copyright",
+        "Iptc.Application2.Caption A description",
+    };
+    ASSERT_EQ(expectedExif, entries(exifData));
+    ASSERT_EQ(expectedIptc, entries(iptcData));
+}
+
+TEST(Converter, movesExifToXmpLikeALinearScan)
+{
+    ExifData exifData = exifSource();
+    XmpData xmpData;
+    moveExifToXmp(exifData, xmpData);
+
+    const std::vector<std::string> movedXmp = {
+        "Xmp.tiff.ImageWidth 4000",
+        "Xmp.tiff.Orientation 6",
+        "Xmp.tiff.XResolution 300/1",
+        "Xmp.xmp.ModifyDate 2019-03-04T05:06:07",
+        "Xmp.dc.description lang=\"x-default\" A description",
+        "Xmp.tiff.Make Maker",
+        "Xmp.dc.creator An artist",
+        "Xmp.dc.rights lang=\"x-default\" A copyright",
+        "Xmp.exif.ExifVersion 0230",
+        "Xmp.exif.ComponentsConfiguration 1, 2, 3, 0",
+        "Xmp.exif.UserComment lang=\"x-default\" A comment",
+        "Xmp.photoshop.DateCreated 2019-03-04T05:06:07.25",
+        "Xmp.exif.ExposureTime 1/250",
+        "Xmp.exif.FNumber 56/10",
+        "Xmp.exif.ISOSpeedRatings 400",
+        "Xmp.exif.Flash/exif:Fired True",
+        "Xmp.exif.Flash/exif:Return 0",
+        "Xmp.exif.Flash/exif:Mode 3",
+        "Xmp.exif.Flash/exif:Function False",
+        "Xmp.exif.Flash/exif:RedEyeMode False",
+        "Xmp.exif.FocalLengthIn35mmFilm 50",
+        "Xmp.exif.GPSVersionID 2.2.0.0",
+        "Xmp.exif.GPSLatitude 47,30.2500000N",
+        "Xmp.exif.GPSLongitude 8,15.5000000W",
+        "Xmp.exif.GPSTimeStamp 2019-03-04T10:20:30.000000000",
+    };
+    const std::vector<std::string> movedExif = {
+        "Exif.GPSInfo.GPSDateStamp 2019:03:04",
+    };
+    ASSERT_EQ(movedXmp, entries(xmpData));
+    ASSERT_EQ(movedExif, entries(exifData));
+}
+
+TEST(Converter, movesXmpToExifLikeALinearScan)
+{
+    XmpData xmpData = xmpSource();
+    ExifData exifData;
+    moveXmpToExif(xmpData, exifData);
+
+    const std::vector<std::string> movedExif = {
+        "Exif.Image.ImageWidth 4000",
+        "Exif.Image.Orientation 6",
+        "Exif.Image.DateTime 2019:03:04 05:06:07",
+        "Exif.Image.ImageDescription A description",
+        "Exif.Image.Artist An artist",
+        "Exif.Image.Copyright A copyright",
+        "Exif.Photo.ExifVersion 48 50 51 48",
+        "Exif.Photo.UserComment charset=\"Unicode\" A comment",
+        "Exif.Photo.DateTimeOriginal 2019:03:04 00:00:00",
+        "Exif.Photo.ExposureTime 1/250",
+        "Exif.Photo.ISOSpeedRatings 400",
+        "Exif.Photo.Flash 25",
+        "Exif.Photo.FocalLengthIn35mmFilm 50",
+        "Exif.GPSInfo.GPSLatitude 47/1 30/1 15/1",
+        "Exif.GPSInfo.GPSLatitudeRef N",
+        "Exif.GPSInfo.GPSTimeStamp 10/1 20/1 30/1",
+        "Exif.GPSInfo.GPSDateStamp 2019:03:04",
+    };
+    const std::vector<std::string> movedXmp = {
+        "Xmp.dc.subject one, two",
+        "Xmp.exif.Flash/exif:Fired True",
+        "Xmp.exif.Flash/exif:Return 0",
+        "Xmp.exif.Flash/exif:Mode 3",
+        "Xmp.exif.Flash/exif:Function False",
+        "Xmp.photoshop.City A city",
+    };
+    ASSERT_EQ(movedExif, entries(exifData));
+    ASSERT_EQ(movedXmp, entries(xmpData));
+}
+
+TEST(Converter, movesIptcToXmpLikeALinearScan)
+{
+    IptcData iptcData = iptcSource();
+    iptcData["Iptc.Application2.Headline"] = "A headline";
+    XmpData xmpData;
+    moveIptcToXmp(iptcData, xmpData);
+
+    const std::vector<std::string> movedXmp = {
+        "Xmp.dc.title lang=\"x-default\" A title",
+        "Xmp.photoshop.Urgency 5",
+        "Xmp.dc.subject one, two, three",
+        "Xmp.photoshop.City A city",
+        "Xmp.photoshop.Headline A headline",
+        "Xmp.dc.description lang=\"x-default\" A caption",
+    };
+    const std::vector<std::string> movedIptc = {
+        "Iptc.Application2.DateCreated 2019-03-04",
+    };
+    ASSERT_EQ(movedXmp, entries(xmpData));
+    ASSERT_EQ(movedIptc, entries(iptcData));
+}
@@ -0,0 +1,95 @@
+#include <easyaccess.hpp> // Unit under test
+
+#include <image.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace Exiv2;
+
+namespace
+{
+    const std::string testData(TESTDATA_PATH); /// \todo use filesystem library with C++17
+
+    typedef ExifData::const_iterator (*EasyAccessFct)(const ExifData& ed);
+
+    const EasyAccessFct easyAccessFcts[] = {
+        orientation, isoSpeed, flashBias, exposureMode, sceneMode, macroMode, imageQuality, whiteBalance,
+        lensName, saturation, sharpness, contrast, sceneCaptureType, meteringMode, make, model,
+        exposureTime, fNumber, subjectDistance, serialNumber, focalLength, afPoint
+    };
+
+    std::vector<EasyAccessId> allIds()
+    {
+        std::vector<EasyAccessId> ids;
+        for (int id = eaOrientation; id <= eaAfPoint; ++id) {
+            ids.push_back(static_cast<EasyAccessId>(id));
+        }
+        return ids;
+    }
+
+    ExifData readExifData(const std::string& file)
+    {
+        auto image = ImageFactory::open(testData + "/" + file);
+        image->readMetadata();
+        return image->exifData();
+    }
+}
+
+TEST(EasyAccess, findsTheFirstAvailableKey)
+{
+    ExifData ed;
+    ed["Exif.Sony2Cs.Rotation"] = uint16_t(1);
+    ed["Exif.Image.Orientation"] = uint16_t(6);
+    ed["Exif.Image.Make"] = "Make";
+
+    ASSERT_EQ("Exif.Image.Orientation", orientation(ed)->key());
+    ASSERT_EQ("Exif.Image.Make", make(ed)->key());
+    ASSERT_EQ(ed.end(), model(ed));
+}
+
+TEST(EasyAccess, skipsZeroIsoValues)
+{
+    ExifData ed;
+    ed["Exif.Photo.ISOSpeedRatings"] = uint16_t(0);
+    ed["Exif.Image.ISOSpeedRatings"] = uint16_t(200);
+
+    ASSERT_EQ("Exif.Image.ISOSpeedRatings", isoSpeed(ed)->key());
+}
+
+TEST(EasyAccess, usesSensitivityTypeForIsoOverflow)
+{
+    ExifData ed;
+    ed["Exif.Photo.ISOSpeedRatings"] = uint16_t(65535);
+    ed["Exif.Photo.SensitivityType"] = uint16_t(2);
+    ed["Exif.Photo.RecommendedExposureIndex"] = uint32_t(102400);
+
+    ASSERT_EQ("Exif.Photo.RecommendedExposureIndex", isoSpeed(ed)->key());
+}
+
+TEST(EasyAccess, batchedLookupMatchesIndividualFunctions)
+{
+    const std::vector<EasyAccessId> ids = allIds();
+    ASSERT_EQ(EXV_COUNTOF(easyAccessFcts), ids.size());
+
+    const char* files[] = { "exiv2-nikon-d70.jpg", "exiv2-canon-eos-20d.jpg", "exiv2-olympus-c8080wz.jpg",
+                            "exiv2-sony-dsc-w7.jpg", "RAW_PENTAX_K30.exv", "exiv2-bug1044.tif" };
+    for (auto&& file : files) {
+        const ExifData ed = readExifData(file);
+        const std::vector<ExifData::const_iterator> result = easyAccess(ed, ids);
+        ASSERT_EQ(ids.size(), result.size());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            ASSERT_TRUE(easyAccessFcts[i](ed) == result[i]) << file << ", id " << i;
+        }
+    }
+}
+
+TEST(EasyAccess, batchedLookupKeepsTheRequestedOrder)
+{
+    const ExifData ed = readExifData("exiv2-nikon-d70.jpg");
+    const std::vector<ExifData::const_iterator> result = easyAccess(ed, { eaModel, eaMake, eaModel });
+
+    ASSERT_EQ(3u, result.size());
+    ASSERT_EQ("Exif.Image.Model", result[0]->key());
+    ASSERT_EQ("Exif.Image.Make", result[1]->key());
+    ASSERT_TRUE(result[0] == result[2]);
+}
@@ -1,7 +1,12 @@
 #include <image_int.hpp>
 
+#include <basicio.hpp>
+
 #include <gtest/gtest.h>
 
+#include <sstream>
+#include <vector>
+
 using namespace Exiv2::Internal;
 using Exiv2::makeSlice;
 using Exiv2::Slice;
@@ -53,3 +58,82 @@ TEST(stringFormat, badInitialGuessOfBufferSize)
     const char str[] = "Long string with more than 16 characters.";
     ASSERT_EQ(stringFormat(fmt, str), std::string(str));
 }
+
+TEST(tiffTagName, findsTheNamesOfTheTiffTags)
+{
+    ASSERT_EQ("ImageWidth", tiffTagName(0x0100));
+    ASSERT_EQ("ExifTag", tiffTagName(0x8769));
+    ASSERT_EQ("", tiffTagName(0xfffe));
+    ASSERT_STREQ("SHORT", tiffTypeName(Exiv2::unsignedShort));
+    ASSERT_STREQ("unknown", tiffTypeName(0));
+}
+
+TEST(IoView, readsAcrossBlocksAndStopsAtTheEnd)
+{
+    std::vector<Exiv2::byte> data(200000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<Exiv2::byte>(i * 7);
+    Exiv2::MemIo io(data.data(), static_cast<long>(data.size()));
+    IoView view(io);
+    ASSERT_EQ(data.size(), view.size());
+
+    const uint64_t offsets[] = {0, 65530, 131070, 199990, 65536 * 3 - 1};
+    for (auto&& offset : offsets) {
+        std::vector<Exiv2::byte> out(20, 0xff);
+        const size_t expected = std::min<size_t>(out.size(), data.size() - offset);
+        ASSERT_EQ(expected, view.read(out.data(), offset, out.size())) << offset;
+        ASSERT_TRUE(std::equal(out.begin(), out.begin() + expected, data.begin() + offset)) << offset;
+    }
+
+    // larger than a block
+    std::vector<Exiv2::byte> out(100000);
+    ASSERT_EQ(out.size(), view.read(out.data(), 12345, out.size()));
+    ASSERT_TRUE(std::equal(out.begin(), out.end(), data.begin() + 12345));
+
+    Exiv2::byte b = 0;
+    ASSERT_EQ(0u, view.read(&b, data.size(), 1));
+    ASSERT_EQ(0u, view.read(&b, data.size() + 100000, 1));
+}
+
+TEST(SegmentIndex, isValidOnlyForTheDataItWasCompletedFor)
+{
+    std::vector<Exiv2::byte> data(100, 0);
+    Exiv2::MemIo io(data.data(), static_cast<long>(data.size()));
+    Exiv2::MemIo other(data.data(), static_cast<long>(data.size()));
+
+    SegmentIndex index;
+    ASSERT_FALSE(index.valid(io));
+    index.add(0xe1, 1, 4, 20);
+    index.add(0xda, 0, 26, 0);
+    ASSERT_FALSE(index.valid(io));
+    index.complete(io);
+    ASSERT_TRUE(index.valid(io));
+    ASSERT_FALSE(index.valid(other));
+    ASSERT_EQ(2u, index.segments().size());
+    ASSERT_EQ(0xe1u, index.segments()[0].type_);
+    ASSERT_EQ(1u, index.segments()[0].id_);
+    ASSERT_EQ(4u, index.segments()[0].offset_);
+    ASSERT_EQ(20u, index.segments()[0].size_);
+
+    // the size of the data changed
+    const Exiv2::byte more[] = {1, 2, 3};
+    io.seek(0, Exiv2::BasicIo::end);
+    io.write(more, sizeof(more));
+    ASSERT_FALSE(index.valid(io));
+
+    index.complete(io);
+    ASSERT_TRUE(index.valid(io));
+    index.clear();
+    ASSERT_FALSE(index.valid(io));
+    ASSERT_TRUE(index.segments().empty());
+}
+
+TEST(JsonRecord, writesOneEscapedObjectPerLine)
+{
+    std::ostringstream out;
+    JsonRecord("TIFF", "entry", 2).add("name", "a\"b\\c\n\x7f").add("count", 42).write(out);
+    JsonRecord("JPEG", "segment", 1).write(out);
+    ASSERT_EQ("{\"format\":\"TIFF\",\"kind\":\"entry\",\"depth\":2,"
+              "\"name\":\"a\\\"b\\\\c\\u000a\\u007f\",\"count\":42}\n"
+              "{\"format\":\"JPEG\",\"kind\":\"segment\",\"depth\":1}\n",
+              out.str());
+}
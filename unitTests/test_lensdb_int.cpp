@@ -0,0 +1,80 @@
+#include <lensdb_int.hpp> // Unit under test
+
+#include <value.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+using namespace Exiv2;
+
+namespace
+{
+    const Internal::TagDetails lenses[] = {
+        {7, "Lens A 24-70mm f/2.8"},
+        {3, "Lens B 50mm f/1.8"},
+        {7, "Lens C 24-70mm f/4 | Lens D 70-200mm f/2.8"},
+        {1, "Lens E 14mm f/2.8"},
+        {7, "Lens F 70-200mm f/5.6"},
+        {-1, "Lens G"},
+    };
+
+    const Internal::TagDetails* linearFind(int64_t id)
+    {
+        for (auto&& td : lenses) {
+            if (td.val_ == id) return &td;
+        }
+        return nullptr;
+    }
+
+    std::string printed(const Internal::TagDetailsIndex& index, long id)
+    {
+        std::ostringstream os;
+        ValueType<int32_t> value(static_cast<int32_t>(id), signedLong);
+        Internal::printLens(os, index, value);
+        return os.str();
+    }
+}
+
+TEST(ALensIndex, findsTheFirstLensOfAnIdLikeALinearSearch)
+{
+    const Internal::TagDetailsIndex index = Internal::makeLensIndex(lenses);
+    ASSERT_EQ(6u, index.size());
+    for (int64_t id = -2; id < 10; ++id) {
+        ASSERT_EQ(linearFind(id), index.find(id)) << id;
+    }
+}
+
+TEST(ALensIndex, keepsTheOrderOfTheTableForLensesWithTheSameId)
+{
+    const Internal::TagDetailsIndex index = Internal::makeLensIndex(lenses);
+    const Internal::TagDetailsIndex::Range r = index.lenses(7);
+    ASSERT_EQ(3, r.second - r.first);
+    ASSERT_EQ(&lenses[0], r.first[0].lens_);
+    ASSERT_EQ(&lenses[2], r.first[1].lens_);
+    ASSERT_EQ(&lenses[4], r.first[2].lens_);
+    const Internal::TagDetailsIndex::Range none = index.lenses(2);
+    ASSERT_TRUE(none.first == none.second);
+}
+
+TEST(ALensIndex, findsLensesByFocalLengthAndMaxAperture)
+{
+    const Internal::TagDetailsIndex index = Internal::makeLensIndex(lenses);
+    ASSERT_EQ(&lenses[0], Internal::findLens(index, 7, "", ""));
+    ASSERT_EQ(&lenses[0], Internal::findLens(index, 7, "24-70mm", ""));
+    ASSERT_EQ(&lenses[2], Internal::findLens(index, 7, "24-70mm", "f/4"));
+    ASSERT_EQ(&lenses[2], Internal::findLens(index, 7, "70-200mm", "2.8"));
+    ASSERT_EQ(&lenses[4], Internal::findLens(index, 7, "70-200mm", "f/5.6"));
+    ASSERT_EQ(nullptr, Internal::findLens(index, 7, "14mm", ""));
+    ASSERT_EQ(nullptr, Internal::findLens(index, 2, "", ""));
+}
+
+TEST(ALensIndex, printsLensesLikePrintTag)
+{
+    const Internal::TagDetailsIndex index = Internal::makeLensIndex(lenses);
+    ASSERT_EQ("Lens B 50mm f/1.8", printed(index, 3));
+    ASSERT_EQ("Lens A 24-70mm f/2.8", printed(index, 7));
+    ASSERT_EQ("Lens G", printed(index, -1));
+    ASSERT_EQ("(2)", printed(index, 2));
+}
@@ -0,0 +1,77 @@
+#include <makernote_int.hpp> // Unit under test
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace Exiv2;
+
+namespace
+{
+    const std::string configPath("exiv2-test-config.ini");
+
+    void writeConfig(const std::string& contents)
+    {
+        std::ofstream file(configPath.c_str(), std::ios::binary);
+        file << contents;
+    }
+}
+
+TEST(AConfigFile, returnsTheDefaultWithoutAFile)
+{
+    std::remove(configPath.c_str());
+    Internal::ConfigFile config(configPath);
+    ASSERT_EQ("default", config.get("nikon", "146", "default"));
+}
+
+TEST(AConfigFile, readsValuesCaseInsensitively)
+{
+    writeConfig("[Nikon]\n146 = My Lens\n[canon]\nKey=Canon Lens\n");
+    Internal::ConfigFile config(configPath);
+    ASSERT_EQ("My Lens", config.get("nikon", "146", "default"));
+    ASSERT_EQ("Canon Lens", config.get("Canon", "key", "default"));
+    ASSERT_EQ("default", config.get("nikon", "147", "default"));
+    std::remove(configPath.c_str());
+}
+
+TEST(AConfigFile, readsTheFileAgainWhenItChanges)
+{
+    writeConfig("[nikon]\n146 = My Lens\n");
+    Internal::ConfigFile config(configPath);
+    ASSERT_EQ("My Lens", config.get("nikon", "146", "default"));
+
+    // A different size is detected without a reload
+    writeConfig("[nikon]\n146 = Another Lens\n");
+    ASSERT_EQ("Another Lens", config.get("nikon", "146", "default"));
+
+    // The same size in the same second may only be seen after a reload
+    writeConfig("[nikon]\n146 = Other12 Lens\n");
+    config.reload();
+    ASSERT_EQ("Other12 Lens", config.get("nikon", "146", "default"));
+
+    std::remove(configPath.c_str());
+    ASSERT_EQ("default", config.get("nikon", "146", "default"));
+    writeConfig("[nikon]\n146 = My Lens\n");
+    ASSERT_EQ("My Lens", config.get("nikon", "146", "default"));
+    std::remove(configPath.c_str());
+}
+
+TEST(AConfigFile, ignoresFilesWithParseErrors)
+{
+    writeConfig("[nikon]\n146 = My Lens\nno equals sign\n");
+    Internal::ConfigFile config(configPath);
+    ASSERT_EQ("default", config.get("nikon", "146", "default"));
+    std::remove(configPath.c_str());
+}
+
+TEST(AConfigFile, readsAnotherFileAfterSetPath)
+{
+    writeConfig("[nikon]\n146 = My Lens\n");
+    Internal::ConfigFile config("exiv2-test-no-config.ini");
+    ASSERT_EQ("default", config.get("nikon", "146", "default"));
+    config.setPath(configPath);
+    ASSERT_EQ("My Lens", config.get("nikon", "146", "default"));
+    std::remove(configPath.c_str());
+}
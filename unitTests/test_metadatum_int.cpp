@@ -0,0 +1,99 @@
+#include <metadatum_int.hpp> // Unit under test
+
+#include <exif.hpp>
+#include <iptc.hpp>
+#include <xmp_exiv2.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace Exiv2;
+
+namespace
+{
+    //! Minimal metadatum, the value tells entries with the same key apart
+    struct Datum {
+        std::string key() const
+        {
+            return key_;
+        }
+
+        std::string key_;
+        int value_;
+    };
+
+    template <typename Metadata>
+    void expectOrder(const Metadata& metadata, const std::vector<std::pair<std::string, int> >& expected)
+    {
+        ASSERT_EQ(expected.size(), metadata.size());
+        auto e = expected.begin();
+        for (auto&& datum : metadata) {
+            ASSERT_EQ(e->first, datum.key_);
+            ASSERT_EQ(e->second, datum.value_);
+            ++e;
+        }
+    }
+}
+
+TEST(sortByKey, sortsAListStably)
+{
+    std::list<Datum> metadata = {{"b", 1}, {"a", 2}, {"c", 3}, {"a", 4}, {"b", 5}};
+    const Datum* first = &metadata.front();
+    Internal::sortByKey(metadata);
+    expectOrder(metadata, {{"a", 2}, {"a", 4}, {"b", 1}, {"b", 5}, {"c", 3}});
+    // The nodes are relinked, not copied
+    ASSERT_EQ(first, &*std::next(metadata.begin(), 2));
+}
+
+TEST(sortByKey, sortsAVectorStably)
+{
+    std::vector<Datum> metadata = {{"b", 1}, {"a", 2}, {"c", 3}, {"a", 4}, {"b", 5}};
+    Internal::sortByKey(metadata);
+    expectOrder(metadata, {{"a", 2}, {"a", 4}, {"b", 1}, {"b", 5}, {"c", 3}});
+
+    std::vector<Datum> sorted = {{"a", 1}, {"a", 2}, {"b", 3}};
+    const Datum* data = sorted.data();
+    Internal::sortByKey(sorted);
+    expectOrder(sorted, {{"a", 1}, {"a", 2}, {"b", 3}});
+    ASSERT_EQ(data, sorted.data());
+
+    std::vector<Datum> empty;
+    Internal::sortByKey(empty);
+    ASSERT_TRUE(empty.empty());
+}
+
+TEST(sortByKey, sortsTheMetadataContainers)
+{
+    ExifData exifData;
+    exifData["Exif.Photo.ExposureTime"] = "1/100";
+    exifData["Exif.Image.Model"] = "Model";
+    exifData["Exif.Image.Make"] = "Make";
+    exifData.sortByKey();
+    ASSERT_EQ("Exif.Image.Make", exifData.begin()->key());
+    ASSERT_EQ("Exif.Photo.ExposureTime", std::prev(exifData.end())->key());
+
+    IptcData iptcData;
+    StringValue one("one");
+    StringValue city("City");
+    StringValue two("two");
+    UShortValue version(4);
+    iptcData.add(IptcKey("Iptc.Application2.Keywords"), &one);
+    iptcData.add(IptcKey("Iptc.Application2.City"), &city);
+    iptcData.add(IptcKey("Iptc.Application2.Keywords"), &two);
+    iptcData.add(IptcKey("Iptc.Envelope.ModelVersion"), &version);
+    iptcData.sortByKey();
+    const char* iptcKeys[] = {"Iptc.Application2.City", "Iptc.Application2.Keywords",
+                              "Iptc.Application2.Keywords", "Iptc.Envelope.ModelVersion"};
+    auto i = iptcData.begin();
+    for (auto&& key : iptcKeys) {
+        ASSERT_EQ(key, (i++)->key());
+    }
+    ASSERT_EQ("one", std::next(iptcData.begin(), 1)->toString());
+    ASSERT_EQ("two", std::next(iptcData.begin(), 2)->toString());
+
+    XmpData xmpData;
+    xmpData["Xmp.xmp.Rating"] = "3";
+    xmpData["Xmp.dc.format"] = "image/jpeg";
+    xmpData.sortByKey();
+    ASSERT_EQ("Xmp.dc.format", xmpData.begin()->key());
+    ASSERT_EQ("Xmp.xmp.Rating", std::prev(xmpData.end())->key());
+}
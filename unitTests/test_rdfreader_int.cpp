@@ -0,0 +1,264 @@
+#include <rdfreader_int.hpp> // Unit under test
+#include <rdfwriter_int.hpp> // Unit under test
+
+#include <image.hpp>
+#include <xmp_exiv2.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace Exiv2;
+
+namespace
+{
+    const std::string testData(TESTDATA_PATH); /// \todo use filesystem library with C++17
+
+    bool exiv2Prefix(const std::string& ns, std::string& prefix)
+    {
+        prefix = XmpProperties::prefix(ns);
+        return !prefix.empty();
+    }
+
+    bool acceptAll(const std::string&, const std::string&)
+    {
+        return true;
+    }
+
+    std::string packet(const std::string& description)
+    {
+        return "<?xpacket begin=\"\xef\xbb\xbf\" id=\"W5M0MpCehiHzreSzNTczkc9d\"?>\n"
+               "<x:xmpmeta xmlns:x=\"adobe:ns:meta/\" x:xmptk=\"XMP Core 4.4.0-Exiv2\">\n"
+               " <rdf:RDF xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\">\n" +
+               description +
+               " </rdf:RDF>\n"
+               "</x:xmpmeta>\n"
+               "<?xpacket end=\"w\"?>";
+    }
+
+    void expectSameXmpData(const XmpData& expected, const XmpData& actual, const std::string& what)
+    {
+        ASSERT_EQ(expected.count(), actual.count()) << what;
+        XmpData::const_iterator e = expected.begin();
+        for (XmpData::const_iterator a = actual.begin(); a != actual.end(); ++a, ++e) {
+            ASSERT_EQ(e->key(), a->key()) << what;
+            ASSERT_EQ(e->typeId(), a->typeId()) << what << ": " << e->key();
+            ASSERT_EQ(e->count(), a->count()) << what << ": " << e->key();
+            ASSERT_EQ(e->toString(), a->toString()) << what << ": " << e->key();
+        }
+    }
+
+    void expectDecodedLikeToolkit(const std::string& xmpPacket, const std::string& what)
+    {
+        XmpData expected;
+        XmpData actual;
+        ASSERT_EQ(Internal::decodeXmpToolkit(expected, xmpPacket), XmpParser::decode(actual, xmpPacket)) << what;
+        expectSameXmpData(expected, actual, what);
+    }
+
+    /*!
+      Decode \em xmpPacket, encode the result and decode that again, once with
+      XmpParser, which uses the RDF reader and writer where it can, and once
+      with the toolkit only. Both must give the same properties and packets.
+     */
+    void expectRoundTripLikeToolkit(const std::string& xmpPacket, bool readerTakesIt, const std::string& what)
+    {
+        XmpData direct;
+        ASSERT_EQ(readerTakesIt, Internal::decodeRdf(direct, xmpPacket, exiv2Prefix, acceptAll)) << what;
+
+        XmpData expected;
+        XmpData actual;
+        ASSERT_EQ(0, Internal::decodeXmpToolkit(expected, xmpPacket)) << what;
+        ASSERT_EQ(0, XmpParser::decode(actual, xmpPacket)) << what;
+        expectSameXmpData(expected, actual, what);
+
+        for (uint16_t format : {uint16_t(XmpParser::useCompactFormat), uint16_t(0)}) {
+            std::string expectedPacket;
+            std::string actualPacket;
+            ASSERT_EQ(0, Internal::encodeXmpToolkit(expectedPacket, expected, format, 0)) << what;
+            ASSERT_EQ(0, XmpParser::encode(actualPacket, actual, format, 0)) << what;
+            ASSERT_EQ(expectedPacket, actualPacket) << what << ", format " << format;
+
+            XmpData expectedAgain;
+            XmpData actualAgain;
+            ASSERT_EQ(0, Internal::decodeXmpToolkit(expectedAgain, expectedPacket)) << what;
+            ASSERT_EQ(0, XmpParser::decode(actualAgain, actualPacket)) << what;
+            expectSameXmpData(expectedAgain, actualAgain, what + ", decoded again");
+            expectSameXmpData(expected, actualAgain, what + ", round trip");
+        }
+    }
+}
+
+TEST(decodeRdf, readsTheCommonFormsLikeTheToolkit)
+{
+    const std::string xmpPacket = packet(
+        "  <rdf:Description rdf:about=\"\"\n"
+        "    xmlns:xmp=\"http://ns.adobe.com/xap/1.0/\"\n"
+        "    xmlns:dc=\"http://purl.org/dc/elements/1.1/\"\n"
+        "    xmlns:tiff=\"http://ns.adobe.com/tiff/1.0/\"\n"
+        "   xmp:Rating=\"3\" tiff:Make=\"Make &amp; Co\">\n"
+        "   <xmp:Label> Red </xmp:Label>\n"
+        "   <dc:subject><rdf:Bag><rdf:li>one</rdf:li><rdf:li/></rdf:Bag></dc:subject>\n"
+        "   <dc:creator>\n    <rdf:Seq>\n     <rdf:li>Me</rdf:li>\n    </rdf:Seq>\n   </dc:creator>\n"
+        "   <dc:title><rdf:Alt><rdf:li xml:lang=\"x-default\">T</rdf:li><rdf:li xml:lang=\"DE-ch\">Titel</rdf:li></rdf:Alt></dc:title>\n"
+        "   <xmp:Identifier><rdf:Alt/></xmp:Identifier>\n"
+        "  </rdf:Description>\n"
+        "  <rdf:Description rdf:about=\"\" xmlns:xmp=\"http://ns.adobe.com/xap/1.0/\">\n"
+        "   <xmp:CreatorTool>Tool<![CDATA[ <1>]]></xmp:CreatorTool>\n"
+        "  </rdf:Description>\n");
+
+    XmpData expected;
+    ASSERT_EQ(0, Internal::decodeXmpToolkit(expected, xmpPacket));
+    XmpData actual;
+    ASSERT_TRUE(Internal::decodeRdf(actual, xmpPacket, exiv2Prefix, acceptAll));
+
+    expectSameXmpData(expected, actual, "common forms");
+    ASSERT_EQ("Xmp.xmp.Rating", actual.begin()->key());
+    ASSERT_EQ("Tool <1>", actual["Xmp.xmp.CreatorTool"].toString());
+    ASSERT_EQ(langAlt, actual["Xmp.dc.title"].typeId());
+}
+
+TEST(decodeRdf, readsStructsAndNestedArraysLikeTheToolkit)
+{
+    const std::string xmpPacket = packet(
+        "  <rdf:Description rdf:about=\"\"\n"
+        "    xmlns:xmpMM=\"http://ns.adobe.com/xap/1.0/mm/\"\n"
+        "    xmlns:stEvt=\"http://ns.adobe.com/xap/1.0/sType/ResourceEvent#\"\n"
+        "    xmlns:stRef=\"http://ns.adobe.com/xap/1.0/sType/ResourceRef#\"\n"
+        "    xmlns:exif=\"http://ns.adobe.com/exif/1.0/\"\n"
+        "    xmlns:Iptc4xmpCore=\"http://iptc.org/std/Iptc4xmpCore/1.0/xmlns/\">\n"
+        "   <xmpMM:DerivedFrom stRef:instanceID=\"i\" stRef:documentID=\"d\"/>\n"
+        "   <xmpMM:History>\n"
+        "    <rdf:Seq>\n"
+        "     <rdf:li rdf:parseType=\"Resource\"><stEvt:action>saved</stEvt:action><stEvt:when/></rdf:li>\n"
+        "     <rdf:li stEvt:action=\"converted\" stEvt:parameters=\"to JPEG\"/>\n"
+        "     <rdf:li><rdf:Description rdf:about=\"\" stEvt:action=\"derived\"><stEvt:changed>/</stEvt:changed></rdf:Description></rdf:li>\n"
+        "    </rdf:Seq>\n"
+        "   </xmpMM:History>\n"
+        "   <exif:Flash rdf:parseType=\"Resource\"><exif:Fired>False</exif:Fired></exif:Flash>\n"
+        "   <Iptc4xmpCore:CreatorContactInfo>\n"
+        "    <rdf:Description><Iptc4xmpCore:CiAdrCity>Here</Iptc4xmpCore:CiAdrCity></rdf:Description>\n"
+        "   </Iptc4xmpCore:CreatorContactInfo>\n"
+        "   <exif:ISOSpeedRatings><rdf:Seq><rdf:li>100</rdf:li></rdf:Seq></exif:ISOSpeedRatings>\n"
+        "   <xmpMM:Manifest><rdf:Bag><rdf:li><rdf:Seq><rdf:li>a</rdf:li><rdf:li>b</rdf:li></rdf:Seq></rdf:li></rdf:Bag></xmpMM:Manifest>\n"
+        "  </rdf:Description>\n");
+
+    XmpData actual;
+    ASSERT_TRUE(Internal::decodeRdf(actual, xmpPacket, exiv2Prefix, acceptAll));
+    ASSERT_EQ("converted", actual["Xmp.xmpMM.History[2]/stEvt:action"].toString());
+    ASSERT_EQ(XmpValue::xsStruct, dynamic_cast<const XmpValue&>(actual["Xmp.xmpMM.DerivedFrom"].value()).xmpStruct());
+    ASSERT_EQ(xmpSeq, actual["Xmp.xmpMM.Manifest[1]"].typeId());
+    expectDecodedLikeToolkit(xmpPacket, "structs");
+}
+
+TEST(decodeRdf, givesUpOnFormsItDoesNotHandle)
+{
+    const char* descriptions[] = {
+        // resource reference
+        "<rdf:Description xmlns:xmpMM=\"http://ns.adobe.com/xap/1.0/mm/\"><xmpMM:DerivedFrom rdf:resource=\"x\"/></rdf:Description>",
+        // struct with text
+        "<rdf:Description xmlns:xmpMM=\"http://ns.adobe.com/xap/1.0/mm/\" xmlns:stRef=\"http://ns.adobe.com/xap/1.0/sType/ResourceRef#\"><xmpMM:DerivedFrom rdf:parseType=\"Resource\">x</xmpMM:DerivedFrom></rdf:Description>",
+        // array of simple and struct items
+        "<rdf:Description xmlns:xmpMM=\"http://ns.adobe.com/xap/1.0/mm/\" xmlns:stEvt=\"http://ns.adobe.com/xap/1.0/sType/ResourceEvent#\"><xmpMM:History><rdf:Seq><rdf:li>a</rdf:li><rdf:li stEvt:action=\"saved\"/></rdf:Seq></xmpMM:History></rdf:Description>",
+        // qualifier
+        "<rdf:Description xmlns:xmp=\"http://ns.adobe.com/xap/1.0/\"><xmp:Label xml:lang=\"en\">x</xmp:Label></rdf:Description>",
+        // simple value which the toolkit converts to an array
+        "<rdf:Description xmlns:dc=\"http://purl.org/dc/elements/1.1/\"><dc:subject>x</dc:subject></rdf:Description>",
+        // unknown namespace
+        "<rdf:Description xmlns:ns=\"http://example.com/unknown/\" ns:a=\"1\"/>",
+        // duplicate property
+        "<rdf:Description xmlns:xmp=\"http://ns.adobe.com/xap/1.0/\" xmp:Label=\"a\"><xmp:Label>b</xmp:Label></rdf:Description>",
+        // instance ID in rdf:about
+        "<rdf:Description rdf:about=\"uuid:faf5bdd5-ba3d-11da-ad31-d33d75182f1b\" xmlns:xmp=\"http://ns.adobe.com/xap/1.0/\" xmp:Label=\"a\"/>",
+        // mixed languages
+        "<rdf:Description xmlns:xmp=\"http://ns.adobe.com/xap/1.0/\"><xmp:Identifier><rdf:Alt><rdf:li xml:lang=\"en\">a</rdf:li><rdf:li>b</rdf:li></rdf:Alt></xmp:Identifier></rdf:Description>",
+        // control character escape, which the toolkit replaces
+        "<rdf:Description xmlns:xmp=\"http://ns.adobe.com/xap/1.0/\" xmp:Label=\"a&#x01;\"/>",
+    };
+    for (auto&& description : descriptions) {
+        XmpData xmpData;
+        ASSERT_FALSE(Internal::decodeRdf(xmpData, packet(description), exiv2Prefix, acceptAll)) << description;
+        ASSERT_TRUE(xmpData.empty());
+        expectDecodedLikeToolkit(packet(description), description);
+    }
+}
+
+TEST(decodeRdf, givesUpOnRejectedProperties)
+{
+    const std::string xmpPacket = packet(
+        "<rdf:Description xmlns:xmp=\"http://ns.adobe.com/xap/1.0/\" xmp:Label=\"a\"/>");
+    XmpData xmpData;
+    ASSERT_FALSE(Internal::decodeRdf(xmpData, xmpPacket, exiv2Prefix, [](const std::string&, const std::string&) { return false; }));
+}
+
+TEST(XmpParser, decodesTestDataLikeTheToolkit)
+{
+    const char* files[] = {
+        "BlueSquare.xmp", "StaffPhotographer-Example.xmp", "exiv2-bug1108.xmp", "exiv2-bug1112.xmp",
+        "exiv2-pre-in-xmp.xmp", "DSC_3079.jpg", "FurnaceCreekInn.jpg", "Reagan.jpg",
+        "exiv2-bug1026.jpg", "exiv2-bug1040.jpg", "exiv2-bug1062.jpg", "exiv2-bug1229.jpg",
+        "exiv2-bug784.jpg", "exiv2-bug884a.jpg", "exiv2-bug937.jpg", "Stonehenge.exv", "_DSC8437.exv",
+        "exiv2-bug1166.exv", "exiv2-bug1225.exv", "exiv2-g20.exv", "exiv2-pr906.exv", "ReaganSmallPng.png",
+        "exiv2-bug1199.webp", "exiv2-photoshop.psd",
+    };
+    for (auto&& file : files) {
+        auto image = ImageFactory::open(testData + "/" + file);
+        image->readMetadata();
+        ASSERT_FALSE(image->xmpPacket().empty()) << file;
+        expectDecodedLikeToolkit(image->xmpPacket(), file);
+    }
+}
+
+TEST(XmpParser, roundTripsArraysStructsAndLangAltLikeTheToolkit)
+{
+    const std::string xmpPacket = packet(
+        "  <rdf:Description rdf:about=\"\"\n"
+        "    xmlns:xmp=\"http://ns.adobe.com/xap/1.0/\"\n"
+        "    xmlns:dc=\"http://purl.org/dc/elements/1.1/\"\n"
+        "    xmlns:xmpMM=\"http://ns.adobe.com/xap/1.0/mm/\"\n"
+        "    xmlns:stEvt=\"http://ns.adobe.com/xap/1.0/sType/ResourceEvent#\"\n"
+        "    xmlns:stRef=\"http://ns.adobe.com/xap/1.0/sType/ResourceRef#\"\n"
+        "    xmlns:exif=\"http://ns.adobe.com/exif/1.0/\"\n"
+        "   xmp:Rating=\"3\" xmp:Label=\"Red &amp; &lt;blue&gt;\">\n"
+        "   <dc:title><rdf:Alt>"
+        "<rdf:li xml:lang=\"x-default\">Title</rdf:li>"
+        "<rdf:li xml:lang=\"de-CH\">Titel</rdf:li>"
+        "<rdf:li xml:lang=\"fr\">Titre</rdf:li>"
+        "</rdf:Alt></dc:title>\n"
+        "   <dc:description><rdf:Alt><rdf:li xml:lang=\"x-default\">A line\nand another</rdf:li></rdf:Alt></dc:description>\n"
+        "   <dc:subject><rdf:Bag><rdf:li>one</rdf:li><rdf:li>two, three</rdf:li><rdf:li/></rdf:Bag></dc:subject>\n"
+        "   <dc:creator><rdf:Seq><rdf:li>Me</rdf:li><rdf:li>\xc3\x9c\xe2\x82\xac</rdf:li></rdf:Seq></dc:creator>\n"
+        "   <xmp:Identifier><rdf:Bag><rdf:li>id</rdf:li></rdf:Bag></xmp:Identifier>\n"
+        "   <xmpMM:DerivedFrom stRef:instanceID=\"i\" stRef:documentID=\"d\"/>\n"
+        "   <xmpMM:History><rdf:Seq>\n"
+        "    <rdf:li rdf:parseType=\"Resource\"><stEvt:action>saved</stEvt:action><stEvt:when>2019-03-04T05:06:07</stEvt:when></rdf:li>\n"
+        "    <rdf:li stEvt:action=\"converted\" stEvt:parameters=\"to JPEG\"/>\n"
+        "   </rdf:Seq></xmpMM:History>\n"
+        "   <xmpMM:Manifest><rdf:Bag><rdf:li><rdf:Seq><rdf:li>a</rdf:li><rdf:li>b</rdf:li></rdf:Seq></rdf:li></rdf:Bag></xmpMM:Manifest>\n"
+        "   <exif:Flash rdf:parseType=\"Resource\"><exif:Fired>False</exif:Fired><exif:Mode>2</exif:Mode></exif:Flash>\n"
+        "   <exif:ISOSpeedRatings><rdf:Seq><rdf:li>100</rdf:li><rdf:li>200</rdf:li></rdf:Seq></exif:ISOSpeedRatings>\n"
+        "  </rdf:Description>\n");
+
+    expectRoundTripLikeToolkit(xmpPacket, true, "arrays, structs and lang-alt");
+}
+
+TEST(XmpParser, roundTripsQualifiersLikeTheToolkit)
+{
+    // Qualifiers make the reader fall back to the toolkit for the whole packet
+    const std::string xmpPacket = packet(
+        "  <rdf:Description rdf:about=\"\"\n"
+        "    xmlns:xmp=\"http://ns.adobe.com/xap/1.0/\"\n"
+        "    xmlns:dc=\"http://purl.org/dc/elements/1.1/\"\n"
+        "    xmlns:xmpRights=\"http://ns.adobe.com/xap/1.0/rights/\">\n"
+        "   <xmp:Label xml:lang=\"en\">Red</xmp:Label>\n"
+        "   <dc:creator><rdf:Seq>"
+        "<rdf:li rdf:parseType=\"Resource\"><rdf:value>Me</rdf:value><xmpRights:Owner>Myself</xmpRights:Owner></rdf:li>"
+        "<rdf:li>You</rdf:li>"
+        "</rdf:Seq></dc:creator>\n"
+        "   <dc:title><rdf:Alt>"
+        "<rdf:li xml:lang=\"x-default\">Title</rdf:li>"
+        "<rdf:li xml:lang=\"de\">Titel</rdf:li>"
+        "</rdf:Alt></dc:title>\n"
+        "   <dc:subject><rdf:Bag><rdf:li>one</rdf:li><rdf:li xml:lang=\"en\">two</rdf:li></rdf:Bag></dc:subject>\n"
+        "  </rdf:Description>\n");
+
+    expectRoundTripLikeToolkit(xmpPacket, false, "qualifiers");
+}
@@ -0,0 +1,243 @@
+#include <rdfwriter_int.hpp> // Unit under test
+
+#include <error.hpp>
+#include <image.hpp>
+#include <properties.hpp>
+#include <value.hpp>
+#include <xmp_exiv2.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace Exiv2;
+
+namespace
+{
+    const std::string testData(TESTDATA_PATH); /// \todo use filesystem library with C++17
+
+    bool exiv2Prefix(const std::string& ns, std::string& prefix)
+    {
+        prefix = XmpProperties::prefix(ns);
+        return !prefix.empty();
+    }
+
+    bool exiv2Namespace(const std::string& prefix, std::string& ns)
+    {
+        try {
+            ns = XmpProperties::ns(prefix);
+        } catch (const Error&) {
+            return false;
+        }
+        return true;
+    }
+
+    bool acceptAll(const std::string&, const std::string&)
+    {
+        return true;
+    }
+
+    const Internal::RdfRegistry registry = {exiv2Prefix, exiv2Namespace, acceptAll, "XMP Core 4.4.0-Exiv2"};
+
+    const uint16_t formats[] = {
+        XmpParser::useCompactFormat,
+        XmpParser::useCompactFormat | XmpParser::omitAllFormatting,
+        0,
+        XmpParser::omitAllFormatting,
+        XmpParser::readOnlyPacket,
+        XmpParser::useCompactFormat | XmpParser::omitPacketWrapper,
+        XmpParser::includeThumbnailPad,
+        XmpParser::useCompactFormat | XmpParser::writeAliasComments,
+    };
+
+    void expectEncodedLikeToolkit(const XmpData& xmpData, uint16_t formatFlags, uint32_t padding, const std::string& what)
+    {
+        std::string expected("unchanged");
+        std::string actual("unchanged");
+        ASSERT_EQ(Internal::encodeXmpToolkit(expected, xmpData, formatFlags, padding),
+                  XmpParser::encode(actual, xmpData, formatFlags, padding))
+            << what << ", format " << formatFlags << ", padding " << padding;
+        ASSERT_EQ(expected, actual) << what << ", format " << formatFlags << ", padding " << padding;
+    }
+
+    void expectEncodedLikeToolkit(const XmpData& xmpData, const std::string& what)
+    {
+        for (auto&& format : formats) {
+            expectEncodedLikeToolkit(xmpData, format, 0, what);
+            expectEncodedLikeToolkit(xmpData, format, 1, what);
+            expectEncodedLikeToolkit(xmpData, format, 250, what);
+        }
+        std::string packet;
+        ASSERT_EQ(0, Internal::encodeXmpToolkit(packet, xmpData, XmpParser::useCompactFormat, 0));
+        expectEncodedLikeToolkit(xmpData, XmpParser::exactPacketLength, static_cast<uint32_t>(packet.size() + 3000), what);
+        expectEncodedLikeToolkit(xmpData, XmpParser::exactPacketLength, 100, what);
+    }
+
+    void add(XmpData& xmpData, const std::string& key, TypeId typeId, const std::string& value)
+    {
+        Value::UniquePtr v = Value::create(typeId);
+        if (!value.empty()) v->read(value);
+        xmpData.add(XmpKey(key), v.get());
+    }
+
+    void addStruct(XmpData& xmpData, const std::string& key)
+    {
+        XmpTextValue v;
+        v.setXmpStruct();
+        xmpData.add(XmpKey(key), &v);
+    }
+
+    void addArray(XmpData& xmpData, const std::string& key, XmpValue::XmpArrayType type)
+    {
+        XmpTextValue v;
+        v.setXmpArrayType(type);
+        xmpData.add(XmpKey(key), &v);
+    }
+
+    XmpData sampleXmpData()
+    {
+        XmpData xmpData;
+        xmpData["Xmp.xmp.Rating"] = "3";
+        xmpData["Xmp.xmp.Label"] = "Red & <blue> \"quoted\"\ttab\nline\rreturn\x01\x7F";
+        xmpData["Xmp.xmp.Nickname"] = "";
+        xmpData["Xmp.tiff.Make"] = "Make";
+        add(xmpData, "Xmp.dc.subject", xmpBag, "one");
+        xmpData["Xmp.dc.subject"] = "two";
+        add(xmpData, "Xmp.dc.creator", xmpSeq, "Me, myself");
+        add(xmpData, "Xmp.dc.type", xmpBag, "");
+        add(xmpData, "Xmp.dc.title", langAlt, "lang=de-ch Titel");
+        xmpData["Xmp.dc.title"] = "lang=x-default Title";
+        xmpData["Xmp.dc.title"] = "lang=EN-gb Title";
+        add(xmpData, "Xmp.dc.description", langAlt, "");
+        add(xmpData, "Xmp.xmp.Identifier", xmpAlt, "a");
+        addStruct(xmpData, "Xmp.xmpMM.DerivedFrom");
+        xmpData["Xmp.xmpMM.DerivedFrom/stRef:instanceID"] = "i";
+        xmpData["Xmp.xmpMM.DerivedFrom/stRef:documentID"] = "d";
+        addArray(xmpData, "Xmp.xmpMM.History", XmpValue::xaSeq);
+        addStruct(xmpData, "Xmp.xmpMM.History[1]");
+        xmpData["Xmp.xmpMM.History[1]/stEvt:action"] = "saved";
+        add(xmpData, "Xmp.xmpMM.History[1]/stEvt:changed", xmpBag, "/metadata");
+        xmpData["Xmp.xmpMM.History[2]/stEvt:action"] = "converted";
+        addStruct(xmpData, "Xmp.xmpMM.Ingredients");
+        addStruct(xmpData, "Xmp.exif.Flash");
+        add(xmpData, "Xmp.exif.Flash/exif:Fired", xmpText, "False");
+        add(xmpData, "Xmp.exif.Flash/exif:Mode", xmpSeq, "2");
+        addArray(xmpData, "Xmp.xmpMM.Manifest", XmpValue::xaBag);
+        add(xmpData, "Xmp.xmpMM.Manifest[1]", xmpSeq, "a");
+        xmpData["Xmp.xmpMM.Manifest[1]"] = "b";
+        xmpData["Xmp.photoshop.City"] = "\xc3\x9c" "berlingen \xe2\x82\xac \xf0\x9f\x93\xb7";
+        return xmpData;
+    }
+}
+
+TEST(encodeRdf, writesLikeTheToolkit)
+{
+    // The prefixes of Exiv2 differ from those of the toolkit, so XmpParser::encode()
+    // is compared with the toolkit and the direct calls only check the fast path is taken
+    const XmpData xmpData = sampleXmpData();
+    for (auto&& format : formats) {
+        std::string packet;
+        ASSERT_TRUE(Internal::encodeRdf(packet, xmpData, format, 0, registry)) << format;
+        expectEncodedLikeToolkit(xmpData, format, 0, "sample");
+    }
+    std::string packet;
+    ASSERT_TRUE(Internal::encodeRdf(packet, xmpData, XmpParser::useCompactFormat, 0, registry));
+    ASSERT_NE(std::string::npos, packet.find("xmp:Label=\"Red &amp; &lt;blue&gt; &quot;quoted&quot;&#x9;tab&#xA;line&#xD;return  \""));
+    ASSERT_NE(std::string::npos, packet.find("<rdf:li xml:lang=\"en-GB\">Title</rdf:li>"));
+    expectEncodedLikeToolkit(xmpData, "sample");
+}
+
+TEST(encodeRdf, writesSimplePropertiesOnlyLikeTheToolkit)
+{
+    XmpData xmpData;
+    xmpData["Xmp.xmp.Rating"] = "3";
+    xmpData["Xmp.dc.format"] = "image/jpeg";
+    expectEncodedLikeToolkit(xmpData, "attributes only");
+
+    XmpData emptyLangAlt;
+    add(emptyLangAlt, "Xmp.dc.title", langAlt, "");
+    expectEncodedLikeToolkit(emptyLangAlt, "empty tree");
+
+    XmpData thumbnails;
+    addArray(thumbnails, "Xmp.xmp.Thumbnails", XmpValue::xaAlt);
+    expectEncodedLikeToolkit(thumbnails, "thumbnails");
+}
+
+TEST(encodeRdf, givesUpOnWhatItDoesNotHandle)
+{
+    XmpData alias;
+    alias["Xmp.xmp.Author"] = "Me";
+
+    XmpData invalidUtf8;
+    invalidUtf8["Xmp.xmp.Label"] = "\xc3(";
+
+    XmpData mismatch;
+    add(mismatch, "Xmp.dc.subject", xmpBag, "one");
+    addStruct(mismatch, "Xmp.dc.subject");
+
+    XmpData valueOnStruct;
+    addStruct(valueOnStruct, "Xmp.xmpMM.DerivedFrom");
+    valueOnStruct["Xmp.xmpMM.DerivedFrom"] = "x";
+
+    XmpData indexGap;
+    addArray(indexGap, "Xmp.xmpMM.History", XmpValue::xaSeq);
+    indexGap["Xmp.xmpMM.History[2]/stEvt:action"] = "saved";
+
+    XmpData fieldOfSimple;
+    fieldOfSimple["Xmp.xmpMM.DerivedFrom"] = "x";
+    fieldOfSimple["Xmp.xmpMM.DerivedFrom/stRef:instanceID"] = "i";
+
+    XmpData langAltTwice;
+    add(langAltTwice, "Xmp.dc.title", langAlt, "lang=x-default one");
+    add(langAltTwice, "Xmp.dc.title", langAlt, "lang=x-default two");
+
+    const struct {
+        const XmpData* xmpData_;
+        const char*    what_;
+        bool           toolkitFails_;
+    } cases[] = {
+        {&invalidUtf8, "invalid UTF-8", true},
+        {&mismatch, "composite form mismatch", true},
+        {&valueOnStruct, "value on struct", true},
+        {&indexGap, "index gap", true},
+        {&fieldOfSimple, "field of simple property", true},
+        {&langAltTwice, "language alternative twice", false},
+    };
+    for (auto&& c : cases) {
+        std::string packet("unchanged");
+        ASSERT_FALSE(Internal::encodeRdf(packet, *c.xmpData_, XmpParser::useCompactFormat, 0, registry)) << c.what_;
+        ASSERT_EQ("unchanged", packet) << c.what_;
+        if (c.toolkitFails_) {
+            ASSERT_EQ(3, Internal::encodeXmpToolkit(packet, *c.xmpData_, XmpParser::useCompactFormat, 0)) << c.what_;
+        }
+        expectEncodedLikeToolkit(*c.xmpData_, XmpParser::useCompactFormat, 0, c.what_);
+    }
+
+    // The toolkit writes aliases to their actual property
+    expectEncodedLikeToolkit(alias, "alias");
+
+    // Inconsistent format options and packets which don't fit
+    const XmpData xmpData = sampleXmpData();
+    std::string packet("unchanged");
+    ASSERT_FALSE(Internal::encodeRdf(packet, xmpData, XmpParser::exactPacketLength, 100, registry));
+    ASSERT_FALSE(Internal::encodeRdf(packet, xmpData, XmpParser::readOnlyPacket | XmpParser::includeThumbnailPad, 0, registry));
+    ASSERT_FALSE(Internal::encodeRdf(packet, xmpData, XmpParser::omitPacketWrapper | XmpParser::includeThumbnailPad, 0, registry));
+    ASSERT_EQ("unchanged", packet);
+    expectEncodedLikeToolkit(xmpData, XmpParser::readOnlyPacket | XmpParser::includeThumbnailPad, 0, "inconsistent");
+}
+
+TEST(XmpParser, encodesTestDataLikeTheToolkit)
+{
+    const char* files[] = {
+        "BlueSquare.xmp", "StaffPhotographer-Example.xmp", "exiv2-bug1108.xmp", "exiv2-bug1112.xmp",
+        "exiv2-pre-in-xmp.xmp", "DSC_3079.jpg", "FurnaceCreekInn.jpg", "Reagan.jpg",
+        "exiv2-bug1040.jpg", "exiv2-bug1062.jpg", "exiv2-bug1229.jpg",
+        "exiv2-bug784.jpg", "exiv2-bug884a.jpg", "exiv2-bug937.jpg", "Stonehenge.exv", "_DSC8437.exv",
+        "exiv2-bug1166.exv", "exiv2-bug1225.exv", "exiv2-g20.exv", "exiv2-pr906.exv", "ReaganSmallPng.png",
+        "exiv2-bug1199.webp", "exiv2-photoshop.psd",
+    };
+    for (auto&& file : files) {
+        auto image = ImageFactory::open(testData + "/" + file);
+        image->readMetadata();
+        ASSERT_FALSE(image->xmpData().empty()) << file;
+        expectEncodedLikeToolkit(image->xmpData(), file);
+    }
+}
@@ -0,0 +1,78 @@
+#include <tags_int.hpp> // Unit under test
+
+#include <value.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+using namespace Exiv2;
+
+namespace
+{
+    constexpr Internal::TagDetails sorted[] = {
+        {-5, "minus five"}, {0, "zero"}, {1, "one"}, {1, "one again"}, {7, "seven"},
+        {0x80000327, "large"}, {0x80000350, "larger"},
+    };
+    static_assert(Internal::isSorted(sorted, EXV_COUNTOF(sorted)), "sorted must be sorted");
+
+    constexpr Internal::TagDetails unsorted[] = {
+        {3, "three"}, {1, "one"}, {3, "three again"}, {2, "two"},
+    };
+    static_assert(!Internal::isSorted(unsorted, EXV_COUNTOF(unsorted)), "unsorted must not be sorted");
+
+    template <int N>
+    const Internal::TagDetails* linearFind(const Internal::TagDetails (&array)[N], long key)
+    {
+        return find(array, key);
+    }
+
+    std::string printed(std::ostream& (*print)(std::ostream&, const Value&, const ExifData*), long val)
+    {
+        ULongValue value(static_cast<uint32_t>(val));
+        std::ostringstream os;
+        print(os, value, nullptr);
+        return os.str();
+    }
+}
+
+TEST(isSorted, checksTheOrderOfTheValues)
+{
+    ASSERT_TRUE(Internal::isSorted(sorted, 0));
+    ASSERT_TRUE(Internal::isSorted(unsorted, 1));
+    ASSERT_TRUE(Internal::isSorted(unsorted + 1, 3) == false);
+    ASSERT_TRUE(Internal::isSorted(unsorted + 1, 2));
+}
+
+TEST(findSorted, findsTheFirstEntryLikeALinearSearch)
+{
+    const long keys[] = {-6, -5, -1, 0, 1, 2, 7, 8, 0x80000327, 0x80000340, 0x80000350, 0x80000351};
+    for (size_t n = 0; n <= EXV_COUNTOF(sorted); ++n) {
+        for (auto&& key : keys) {
+            const Internal::TagDetails* expected = nullptr;
+            for (size_t i = 0; i < n && !expected; ++i) {
+                if (sorted[i].val_ == key) expected = sorted + i;
+            }
+            ASSERT_EQ(expected, Internal::findSorted(sorted, n, key)) << n << ", " << key;
+        }
+    }
+    ASSERT_EQ(&sorted[2], Internal::findSorted(sorted, EXV_COUNTOF(sorted), 1));
+}
+
+TEST(findTagDetails, searchesSortedAndUnsortedTables)
+{
+    for (long key = -6; key < 10; ++key) {
+        ASSERT_EQ(linearFind(sorted, key), (Internal::findTagDetails<EXV_COUNTOF(sorted), sorted>(key))) << key;
+        ASSERT_EQ(linearFind(unsorted, key), (Internal::findTagDetails<EXV_COUNTOF(unsorted), unsorted>(key))) << key;
+    }
+}
+
+TEST(printTag, printsTheLabelOfTheFirstEntry)
+{
+    ASSERT_EQ("one", printed(Internal::EXV_PRINT_TAG(sorted), 1));
+    ASSERT_EQ("large", printed(Internal::EXV_PRINT_TAG(sorted), 0x80000327));
+    ASSERT_EQ("(2)", printed(Internal::EXV_PRINT_TAG(sorted), 2));
+    ASSERT_EQ("three", printed(Internal::EXV_PRINT_TAG(unsorted), 3));
+    ASSERT_EQ("(4)", printed(Internal::EXV_PRINT_TAG(unsorted), 4));
+}
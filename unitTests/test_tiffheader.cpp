@@ -63,3 +63,30 @@ TEST_F(ATiffHeader, printsDefaultValues)
     header.print(str, "");
     ASSERT_STREQ("TIFF header, offset = 0x00000008, little endian encoded\n", str.str().c_str());
 }
+
+TEST(ABigTiffHeader, readsTheRootOffsetWith64Bits)
+{
+    static const byte bigTiffBigEndian[] = {0x4d, 0x4d, 0x00, 0x2b, 0x00, 0x08, 0x00, 0x00,
+                                            0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x10};
+    Internal::BigTiffHeader header;
+    ASSERT_TRUE(header.read(bigTiffBigEndian, 16));
+    ASSERT_EQ(bigEndian, header.byteOrder());
+    ASSERT_EQ(0x100000010ULL, header.rootOffset());
+    ASSERT_TRUE(header.isBigTiff());
+    ASSERT_FALSE(header.read(bigTiffBigEndian, 15));
+    ASSERT_FALSE(header.read(tiffLittleEndian, 8));
+}
+
+TEST(ABigTiffHeader, failsToReadInvalidOffsetSizes)
+{
+    static const byte offsetSize4[] = {0x49, 0x49, 0x2b, 0x00, 0x04, 0x00, 0x00, 0x00,
+                                       0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    Internal::BigTiffHeader header;
+    ASSERT_FALSE(header.read(offsetSize4, 16));
+}
+
+TEST_F(ATiffHeader, isNotBigTiff)
+{
+    ASSERT_FALSE(header.isBigTiff());
+    ASSERT_EQ(8u, header.rootOffset());
+}